@@ -494,6 +494,12 @@ main(int argc, char** argv)
     }
     outConf.key() = outConf.value("driver");
 
+    // MBTiles output is much faster when tile writes are batched into transactions
+    if (startsWith(outConf.key(), "mbtiles") && !outConf.hasValue("write_batch_size"))
+    {
+        outConf.set("write_batch_size", 1024);
+    }
+
     // are we changing profiles?
     osg::ref_ptr<const Profile> outputProfile = input->getProfile();
     std::string profileString;
@@ -0,0 +1,165 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/Notify>
+#include <osgEarth/Registry>
+#include <osgEarth/HTTPClient>
+#include <osgEarth/StringUtils>
+#include <osg/ArgumentParser>
+#include <osg/Timer>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+#define LC "[httpbench] "
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+int
+usage(const char* name, const std::string& error)
+{
+    OE_NOTICE
+        << "Compares blocking and asynchronous (multiplexed) HTTP tile fetching."
+        << "\nError: " << error
+        << "\nUsage:"
+        << "\n" << name
+        << "\n  --url <template>     ; tile URL with {z}, {x} and {y} placeholders"
+        << "\n  [--lod <n>]          ; level of detail to fetch (default = 10)"
+        << "\n  [--count <n>]        ; number of tiles to fetch (default = 256)"
+        << "\n  [--threads <n>]      ; threads for the blocking test (default = 8)"
+        << "\n  [--max-transfers <n>]; simultaneous asynchronous transfers"
+        << std::endl;
+
+    return -1;
+}
+
+struct Result
+{
+    unsigned ok = 0u, failed = 0u;
+    std::size_t bytes = 0u;
+    double seconds = 0.0;
+
+    void report(const std::string& name) const
+    {
+        OE_NOTICE << LC << name << ": "
+            << ok << " ok, " << failed << " failed, "
+            << (bytes / 1024u) << " KB in " << std::setprecision(4) << seconds << "s ("
+            << ((double)(ok + failed) / std::max(seconds, 1e-6)) << " req/s)"
+            << std::endl;
+    }
+};
+
+std::vector<std::string>
+makeURLs(const std::string& tmpl, unsigned lod, unsigned count)
+{
+    std::vector<std::string> urls;
+    unsigned dim = 1u << std::min(lod, 20u);
+    unsigned side = (unsigned)std::ceil(std::sqrt((double)count));
+    unsigned x0 = dim / 2u, y0 = dim / 2u;
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        std::string url = tmpl;
+        replaceIn(url, "{z}", std::to_string(lod));
+        replaceIn(url, "{x}", std::to_string((x0 + i % side) % dim));
+        replaceIn(url, "{y}", std::to_string((y0 + i / side) % dim));
+        urls.push_back(url);
+    }
+    return urls;
+}
+
+Result
+runBlocking(const std::vector<std::string>& urls, unsigned threads)
+{
+    Result result;
+    std::mutex mutex;
+    std::atomic<unsigned> next(0u);
+
+    osg::Timer_t start = osg::Timer::instance()->tick();
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]()
+            {
+                unsigned i;
+                while ((i = next++) < urls.size())
+                {
+                    HTTPResponse r = HTTPClient::get(HTTPRequest(urls[i]));
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (r.isOK()) {
+                        ++result.ok;
+                        result.bytes += r.getPartSize(0);
+                    }
+                    else ++result.failed;
+                }
+            });
+    }
+
+    for (auto& w : workers)
+        w.join();
+
+    result.seconds = osg::Timer::instance()->delta_s(start, osg::Timer::instance()->tick());
+    return result;
+}
+
+Result
+runAsync(const std::vector<std::string>& urls)
+{
+    Result result;
+
+    osg::Timer_t start = osg::Timer::instance()->tick();
+
+    std::vector<jobs::future<HTTPResponse>> futures;
+    futures.reserve(urls.size());
+    for (auto& url : urls)
+    {
+        futures.emplace_back(HTTPClient::getAsync(HTTPRequest(url)));
+    }
+
+    for (auto& f : futures)
+    {
+        const HTTPResponse& r = f.join();
+        if (r.isOK()) {
+            ++result.ok;
+            result.bytes += r.getPartSize(0);
+        }
+        else ++result.failed;
+    }
+
+    result.seconds = osg::Timer::instance()->delta_s(start, osg::Timer::instance()->tick());
+    return result;
+}
+
+int
+main(int argc, char** argv)
+{
+    osgEarth::initialize();
+
+    osg::ArgumentParser arguments(&argc, argv);
+
+    std::string tmpl;
+    if (!arguments.read("--url", tmpl))
+        return usage(argv[0], "Missing --url");
+
+    unsigned lod = 10u, count = 256u, threads = 8u, maxTransfers = 0u;
+    arguments.read("--lod", lod);
+    arguments.read("--count", count);
+    arguments.read("--threads", threads);
+    if (arguments.read("--max-transfers", maxTransfers))
+        HTTPClient::setMaxAsyncTransfers(maxTransfers);
+
+    // Distinct tile sets so neither test benefits from server-side warm-up by the other
+    std::vector<std::string> blockingURLs = makeURLs(tmpl, lod, count);
+    std::vector<std::string> asyncURLs = makeURLs(tmpl, lod + 1u, count);
+
+    runBlocking(blockingURLs, threads).report(Stringify() << "blocking (" << threads << " threads)");
+    runAsync(asyncURLs).report(Stringify() << "async (" << HTTPClient::getMaxAsyncTransfers() << " transfers)");
+
+    return 0;
+}
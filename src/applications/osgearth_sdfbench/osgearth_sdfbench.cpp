@@ -0,0 +1,288 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/Notify>
+#include <osgEarth/Registry>
+#include <osgEarth/SDF>
+#include <osgEarth/ImageUtils>
+#include <osgEarth/GeoData>
+#include <osgEarth/Random>
+#include <osgEarth/SpatialReference>
+#include <osgEarth/StringUtils>
+#include <osg/ArgumentParser>
+#include <osg/Timer>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+#define LC "[sdfbench] "
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+int
+usage(const char* name, const std::string& error)
+{
+    OE_NOTICE
+        << "Compares the parallel SDFGenerator CPU paths against the original serial ones."
+        << "\nError: " << error
+        << "\nUsage:"
+        << "\n" << name
+        << "\n  [--size <n>]         ; raster size to test; repeatable (default = 256, 512, 1024)"
+        << "\n  [--iterations <n>]   ; runs per test (default = 10)"
+        << std::endl;
+
+    return -1;
+}
+
+// The original single-threaded, per-pixel implementations, kept here as the baseline.
+namespace reference
+{
+    constexpr float NODATA = 32767.0f;
+    constexpr float INF = 1E20f;
+
+    void edt1d(const float* f, float* d, int* v, float* z, unsigned int n)
+    {
+        int k = 0;
+        v[0] = 0;
+        z[0] = -INF;
+        z[1] = INF;
+        for (int q = 1; q <= (int)(n - 1); ++q) {
+            float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+            while (s <= z[k]) {
+                k--;
+                s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+            }
+            k++;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = INF;
+        }
+
+        k = 0;
+        for (int q = 0; q <= (int)(n - 1); ++q) {
+            while (z[k + 1] < q)
+                k++;
+            int r = v[k];
+            d[q] = (q - r) * (q - r) + f[r];
+        }
+    }
+
+    osg::Image* createDistanceField(const osg::Image* image, float minPixels, float maxPixels)
+    {
+        ImageUtils::PixelReader read(image);
+        unsigned width = image->s(), height = image->t();
+
+        std::vector<float> grid(width * height, INF);
+        osg::Vec4 pixel;
+        for (unsigned y = 0; y < height; ++y)
+            for (unsigned x = 0; x < width; ++x) {
+                read(pixel, x, y);
+                if (pixel.a() > 0.0f)
+                    grid[y * width + x] = 0;
+            }
+
+        unsigned maxLength = std::max(width, height);
+        std::vector<float> f(maxLength), d(maxLength), z(maxLength + 1);
+        std::vector<int> v(maxLength);
+
+        for (unsigned x = 0; x < width; ++x) {
+            for (unsigned y = 0; y < height; ++y) f[y] = grid[width * y + x];
+            edt1d(f.data(), d.data(), v.data(), z.data(), height);
+            for (unsigned y = 0; y < height; ++y) grid[width * y + x] = d[y];
+        }
+
+        for (unsigned y = 0; y < height; ++y) {
+            for (unsigned x = 0; x < width; ++x) f[x] = grid[width * y + x];
+            edt1d(f.data(), d.data(), v.data(), z.data(), width);
+            for (unsigned x = 0; x < width; ++x) grid[width * y + x] = d[x];
+        }
+
+        osg::Image* sdf = new osg::Image();
+        sdf->allocateImage(width, height, 1, GL_RED, GL_UNSIGNED_BYTE);
+        ImageUtils::PixelWriter write(sdf);
+        osg::Vec4 p;
+        for (unsigned y = 0; y < height; ++y)
+            for (unsigned x = 0; x < width; ++x) {
+                float dist = std::sqrt(grid[width * y + x]);
+                p.set(unitremap(dist, minPixels, maxPixels), 1, 1, 1);
+                write(p, x, y);
+            }
+        return sdf;
+    }
+
+    osg::Image* createNearestNeighborField(const osg::Image* input)
+    {
+        int n = input->s();
+        osg::Image* buf = new osg::Image();
+        buf->allocateImage(input->s(), input->t(), 1, GL_RG, GL_FLOAT);
+
+        ImageUtils::PixelReader read(input);
+        ImageUtils::PixelWriter write(buf);
+        osg::Vec4f pixel, coord, nodata(NODATA, NODATA, NODATA, NODATA);
+        for (int t = 0; t < input->t(); ++t)
+            for (int s = 0; s < input->s(); ++s) {
+                read(pixel, s, t);
+                if (pixel.a() >= 0.5f) coord.set((float)s, (float)t, 0, 0);
+                else coord = nodata;
+                write(coord, s, t);
+            }
+
+        float* data = (float*)buf->data();
+        int w = buf->s(), h = buf->t();
+        osg::Vec4f me, remote, remote_points_to;
+
+        for (int L = n / 2; L >= 1; L /= 2)
+            for (int iterT = 0; iterT < h; ++iterT)
+                for (int iterS = 0; iterS < w; ++iterS)
+                {
+                    float* mine = &data[(iterT * w + iterS) * 2];
+                    me.set(mine[0], mine[1], 0, 0);
+                    if (me.x() == NODATA)
+                        continue;
+
+                    for (int s = iterS - L; s <= iterS + L; s += L)
+                    {
+                        if (s < 0 || s >= w) continue;
+                        remote[0] = (float)s;
+                        for (int t = iterT - L; t <= iterT + L; t += L)
+                        {
+                            if (t < 0 || t >= h || (s == iterS && t == iterT)) continue;
+                            remote[1] = (float)t;
+                            float* theirs = &data[(t * w + s) * 2];
+                            remote_points_to.set(theirs[0], theirs[1], 0, 0);
+                            if (remote_points_to.x() == NODATA ||
+                                distanceSquared2D(remote, me) < distanceSquared2D(remote, remote_points_to))
+                            {
+                                theirs[0] = me.x(), theirs[1] = me.y();
+                            }
+                        }
+                    }
+                }
+
+        return buf;
+    }
+}
+
+// Random filled boxes and thin lines, roughly what rasterized features look like
+osg::Image*
+makeInput(unsigned size)
+{
+    osg::Image* image = new osg::Image();
+    image->allocateImage(size, size, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+    ImageUtils::PixelWriter write(image);
+    write.assign(Color(1, 1, 1, 0));
+
+    Random prng(size);
+    unsigned count = size / 8u;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        unsigned x0 = prng.next(size), y0 = prng.next(size);
+        bool line = (i % 2u) == 0u;
+        unsigned w = line ? 1u + prng.next(size / 4u) : 1u + prng.next(size / 32u);
+        unsigned h = line ? 1u : 1u + prng.next(size / 32u);
+        for (unsigned y = y0; y < std::min(size, y0 + h); ++y)
+            for (unsigned x = x0; x < std::min(size, x0 + w); ++x)
+                write(Color::Black, x, y);
+    }
+    return image;
+}
+
+template<typename FUNC>
+double
+timeIt(unsigned iterations, FUNC&& func)
+{
+    osg::Timer_t start = osg::Timer::instance()->tick();
+    for (unsigned i = 0; i < iterations; ++i)
+        func();
+    return 1000.0 * osg::Timer::instance()->delta_s(start, osg::Timer::instance()->tick()) / (double)iterations;
+}
+
+void
+report(const std::string& name, unsigned size, double baseline, double parallel, const std::string& check)
+{
+    OE_NOTICE << LC << std::setw(8) << name << " " << std::setw(5) << size
+        << ": baseline " << std::fixed << std::setprecision(2) << baseline << " ms"
+        << ", parallel " << parallel << " ms"
+        << " (" << (baseline / std::max(parallel, 1e-6)) << "x)"
+        << ", " << check
+        << std::endl;
+}
+
+void
+benchmark(unsigned size, unsigned iterations)
+{
+    SDFGenerator gen;
+    osg::ref_ptr<osg::Image> input = makeInput(size);
+    GeoExtent extent(SpatialReference::get("wgs84"), 0.0, 0.0, 1.0, 1.0);
+    GeoImage geoInput(input.get(), extent);
+    const float minPixels = 0.0f, maxPixels = 32.0f;
+
+    // Felzenszwalb distance transform (the FeatureSDFLayer path)
+    osg::ref_ptr<osg::Image> ref, out;
+    double baseline = timeIt(iterations, [&]() { ref = reference::createDistanceField(input.get(), minPixels, maxPixels); });
+    double parallel = timeIt(iterations, [&]() { out = gen.createDistanceField(input.get(), minPixels, maxPixels); });
+
+    int maxDiff = 0;
+    for (unsigned i = 0; i < size * size; ++i)
+        maxDiff = std::max(maxDiff, std::abs((int)ref->data()[i] - (int)out->data()[i]));
+
+    report("EDT", size, baseline, parallel, Stringify() << "max diff " << maxDiff << "/255");
+
+    // Jump-flood nearest neighbor field
+    osg::ref_ptr<osg::Image> refNNF;
+    GeoImage nnf;
+    baseline = timeIt(iterations, [&]() { refNNF = reference::createNearestNeighborField(input.get()); });
+    parallel = timeIt(iterations, [&]() { nnf = GeoImage(); gen.createNearestNeighborField(geoInput, false, nnf, nullptr); });
+
+    // JFA is approximate, and the two versions propagate in a different
+    // order; compare the distances to the seeds they found.
+    double worst = 0.0, total = 0.0;
+    const float* a = (const float*)refNNF->data();
+    const float* b = (const float*)nnf.getImage()->data();
+    for (unsigned t = 0; t < size; ++t)
+        for (unsigned s = 0; s < size; ++s)
+        {
+            unsigned i = (t * size + s) * 2;
+            double da = std::sqrt((a[i] - s) * (a[i] - s) + (a[i + 1] - t) * (a[i + 1] - t));
+            double db = std::sqrt((b[i] - s) * (b[i] - s) + (b[i + 1] - t) * (b[i + 1] - t));
+            worst = std::max(worst, std::abs(da - db));
+            total += std::abs(da - db);
+        }
+
+    report("JFA", size, baseline, parallel,
+        Stringify() << std::setprecision(3) << "distance diff max " << worst << " px, mean " << (total / (double)(size * size)) << " px");
+}
+
+int
+main(int argc, char** argv)
+{
+    osgEarth::initialize();
+
+    osg::ArgumentParser arguments(&argc, argv);
+
+    if (arguments.read("--help"))
+        return usage(argv[0], "Help");
+
+    std::vector<unsigned> sizes;
+    unsigned size;
+    while (arguments.read("--size", size))
+    {
+        if (size == 0u || (size & (size - 1u)) != 0u)
+            return usage(argv[0], "Size must be a power of 2");
+        sizes.push_back(size);
+    }
+    if (sizes.empty())
+        sizes = { 256u, 512u, 1024u };
+
+    unsigned iterations = 10u;
+    arguments.read("--iterations", iterations);
+    iterations = std::max(iterations, 1u);
+
+    for (auto s : sizes)
+        benchmark(s, iterations);
+
+    return 0;
+}
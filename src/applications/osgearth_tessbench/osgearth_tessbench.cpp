@@ -0,0 +1,303 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/Notify>
+#include <osgEarth/Registry>
+#include <osgEarth/Tessellator>
+#include <osgEarth/BuildGeometryFilter>
+#include <osgEarth/FilterContext>
+#include <osgEarth/OGRFeatureSource>
+#include <osgEarth/Random>
+#include <osgEarth/StringUtils>
+#include <osg/ArgumentParser>
+#include <osg/Timer>
+#include <osg/TriangleFunctor>
+#include <osgUtil/Tessellator>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+#define LC "[tessbench] "
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+int
+usage(const char* name, const std::string& error)
+{
+    OE_NOTICE
+        << "Compares the earcut polygon tessellator against the GLU tessellator (osgUtil)."
+        << "\nError: " << error
+        << "\nUsage:"
+        << "\n" << name
+        << "\n  [--file <path>]      ; polygon feature source (shapefile, GeoPackage, ...) to tessellate;"
+        << "\n                       ; default is a synthetic set of building footprints and lakes"
+        << "\n  [--count <n>]        ; number of synthetic footprints (default = 20000)"
+        << "\n  [--iterations <n>]   ; runs per test (default = 5)"
+        << std::endl;
+
+    return -1;
+}
+
+// Random star-shaped rings around a center, roughly what building footprints,
+// courtyards and lake shores look like. Placed at UTM-sized coordinates to
+// exercise precision.
+Ring*
+makeRing(Random& prng, const osg::Vec3d& center, double radius, unsigned points, bool clockwise)
+{
+    Ring* ring = new Ring();
+    ring->reserve(points);
+    for (unsigned i = 0; i < points; ++i)
+    {
+        double a = 2.0 * osg::PI * (double)i / (double)points;
+        if (clockwise) a = -a;
+        double r = radius * (0.6 + 0.4 * prng.next());
+        ring->push_back(center + osg::Vec3d(cos(a) * r, sin(a) * r, 0.0));
+    }
+    return ring;
+}
+
+void
+makeSyntheticFeatures(unsigned count, FeatureList& output)
+{
+    Random prng(count);
+    const osg::Vec3d origin(500000.0, 4000000.0, 0.0);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        osg::Vec3d center = origin + osg::Vec3d(prng.next() * 10000.0, prng.next() * 10000.0, 0.0);
+        osg::ref_ptr<Ring> outer = makeRing(prng, center, 5.0 + 25.0 * prng.next(), 6u + prng.next(34u), false);
+
+        osg::ref_ptr<osgEarth::Polygon> polygon = new osgEarth::Polygon(&outer->asVector());
+
+        // every tenth building has a courtyard
+        if (i % 10u == 0u)
+            polygon->getHoles().push_back(makeRing(prng, center, 2.0, 4u + prng.next(8u), true));
+
+        output.push_back(new Feature(polygon.get(), nullptr));
+    }
+
+    // a few large lakes with islands
+    for (unsigned i = 0; i < std::max(1u, count / 2000u); ++i)
+    {
+        osg::Vec3d center = origin + osg::Vec3d(prng.next() * 10000.0, prng.next() * 10000.0, 0.0);
+        osg::ref_ptr<Ring> outer = makeRing(prng, center, 2000.0, 2000u + prng.next(3000u), false);
+        osg::ref_ptr<osgEarth::Polygon> polygon = new osgEarth::Polygon(&outer->asVector());
+
+        for (unsigned h = 0; h < 8u; ++h)
+        {
+            osg::Vec3d island = center + osg::Vec3d(-600.0 + 400.0 * (h % 4u), h < 4u ? -400.0 : 400.0, 0.0);
+            polygon->getHoles().push_back(makeRing(prng, island, 100.0, 50u + prng.next(200u), true));
+        }
+
+        output.push_back(new Feature(polygon.get(), nullptr));
+    }
+}
+
+bool
+loadFeatures(const std::string& path, FeatureList& output)
+{
+    osg::ref_ptr<OGRFeatureSource> source = new OGRFeatureSource();
+    source->setURL(path);
+    if (source->open().isError())
+    {
+        OE_WARN << LC << "Failed to open " << path << ": " << source->getStatus().message() << std::endl;
+        return false;
+    }
+
+    osg::ref_ptr<FeatureCursor> cursor = source->createFeatureCursor();
+    if (!cursor.valid())
+        return false;
+
+    while (cursor->hasMore())
+    {
+        osg::ref_ptr<Feature> feature = cursor->nextFeature();
+        if (feature.valid() && feature->getGeometry() && feature->getGeometry()->isPolygon())
+            output.push_back(feature);
+    }
+    return true;
+}
+
+// Localizes each polygon part into an osg::Geometry with one GL_POLYGON
+// DrawArrays per ring, the input format both tessellators accept.
+void
+makeGeometries(const FeatureList& features, std::vector<osg::ref_ptr<osg::Geometry>>& output)
+{
+    for (auto& feature : features)
+    {
+        ConstGeometryIterator iter(feature->getGeometry(), false);
+        while (iter.hasMore())
+        {
+            const Geometry* part = iter.next();
+            if (part->size() < 3)
+                continue;
+
+            osg::Vec3d anchor = part->front();
+            osg::Geometry* geom = new osg::Geometry();
+            osg::Vec3Array* verts = new osg::Vec3Array();
+            geom->setVertexArray(verts);
+
+            ConstGeometryIterator rings(part, true);
+            while (rings.hasMore())
+            {
+                const Geometry* ring = rings.next();
+                unsigned first = verts->size();
+                for (auto& p : *ring)
+                    verts->push_back(p - anchor);
+                geom->addPrimitiveSet(new osg::DrawArrays(GL_POLYGON, first, verts->size() - first));
+            }
+
+            output.push_back(geom);
+        }
+    }
+}
+
+struct AreaOp
+{
+    double area = 0.0;
+    unsigned triangles = 0u;
+
+    void operator()(const osg::Vec3& v0, const osg::Vec3& v1, const osg::Vec3& v2)
+    {
+        area += 0.5 * ((v1 - v0) ^ (v2 - v0)).length();
+        ++triangles;
+    }
+};
+
+void
+measure(const std::vector<osg::ref_ptr<osg::Geometry>>& geoms, double& area, unsigned& triangles)
+{
+    osg::TriangleFunctor<AreaOp> op;
+    for (auto& geom : geoms)
+        geom->accept(op);
+    area = op.area;
+    triangles = op.triangles;
+}
+
+template<typename FUNC>
+double
+timeTessellation(
+    const std::vector<osg::ref_ptr<osg::Geometry>>& input,
+    unsigned iterations,
+    std::vector<osg::ref_ptr<osg::Geometry>>& output,
+    FUNC&& func)
+{
+    double total = 0.0;
+    for (unsigned i = 0; i < iterations; ++i)
+    {
+        output.clear();
+        for (auto& geom : input)
+            output.push_back(new osg::Geometry(*geom, osg::CopyOp::DEEP_COPY_PRIMITIVES));
+
+        osg::Timer_t start = osg::Timer::instance()->tick();
+        for (auto& geom : output)
+            func(*geom);
+        total += osg::Timer::instance()->delta_m(start, osg::Timer::instance()->tick());
+    }
+    return total / (double)iterations;
+}
+
+void
+benchmark(const FeatureList& features, unsigned iterations)
+{
+    std::vector<osg::ref_ptr<osg::Geometry>> input, glu, earcut;
+    makeGeometries(features, input);
+
+    unsigned points = 0u;
+    for (auto& geom : input)
+        points += geom->getVertexArray()->getNumElements();
+
+    OE_NOTICE << LC << input.size() << " polygons, " << points << " points" << std::endl;
+
+    double gluTime = timeTessellation(input, iterations, glu, [](osg::Geometry& geom)
+    {
+        osgUtil::Tessellator tess;
+        tess.setTessellationType(osgUtil::Tessellator::TESS_TYPE_GEOMETRY);
+        tess.setWindingType(osgUtil::Tessellator::TESS_WINDING_ODD);
+        tess.retessellatePolygons(geom);
+    });
+
+    unsigned failures = 0u;
+    Tessellator oeTess;
+    double earcutTime = timeTessellation(input, iterations, earcut, [&](osg::Geometry& geom)
+    {
+        if (!oeTess.tessellateGeometry(geom))
+            ++failures;
+    });
+    failures /= iterations;
+
+    double gluArea, earcutArea;
+    unsigned gluTris, earcutTris;
+    measure(glu, gluArea, gluTris);
+    measure(earcut, earcutArea, earcutTris);
+
+    OE_NOTICE << LC << "GLU:    " << std::fixed << std::setprecision(2) << gluTime << " ms, "
+        << gluTris << " triangles, area " << gluArea << std::endl;
+
+    OE_NOTICE << LC << "earcut: " << earcutTime << " ms, "
+        << earcutTris << " triangles, area " << earcutArea
+        << " (" << (gluTime / std::max(earcutTime, 1e-6)) << "x"
+        << ", area diff " << std::setprecision(4) << (100.0 * std::abs(earcutArea - gluArea) / std::max(gluArea, 1e-9)) << "%"
+        << ", " << failures << " failed)" << std::endl;
+
+    // End to end polygon build, which tessellates the parts in parallel
+    Style style;
+    style.getOrCreate<PolygonSymbol>()->fill()->color() = Color::White;
+
+    double buildTime = 0.0;
+    for (unsigned i = 0; i < iterations; ++i)
+    {
+        FeatureList copies;
+        for (auto& feature : features)
+            copies.push_back(new Feature(*feature));
+
+        FilterContext context;
+        BuildGeometryFilter filter(style);
+
+        osg::Timer_t start = osg::Timer::instance()->tick();
+        osg::ref_ptr<osg::Node> node = filter.push(copies, context);
+        buildTime += osg::Timer::instance()->delta_m(start, osg::Timer::instance()->tick());
+    }
+
+    OE_NOTICE << LC << "BuildGeometryFilter: " << std::setprecision(2) << (buildTime / (double)iterations) << " ms" << std::endl;
+}
+
+int
+main(int argc, char** argv)
+{
+    osgEarth::initialize();
+
+    osg::ArgumentParser arguments(&argc, argv);
+
+    if (arguments.read("--help"))
+        return usage(argv[0], "Help");
+
+    unsigned count = 20000u;
+    arguments.read("--count", count);
+
+    unsigned iterations = 5u;
+    arguments.read("--iterations", iterations);
+    iterations = std::max(iterations, 1u);
+
+    FeatureList features;
+
+    std::string file;
+    if (arguments.read("--file", file))
+    {
+        if (!loadFeatures(file, features))
+            return usage(argv[0], "Unable to load features from " + file);
+    }
+    else
+    {
+        makeSyntheticFeatures(count, features);
+    }
+
+    if (features.empty())
+        return usage(argv[0], "No polygons to tessellate");
+
+    benchmark(features, iterations);
+
+    return 0;
+}
@@ -7,8 +7,52 @@
 #include <osgEarth/GeoData>
 #include <osgEarth/Registry>
 #include <osgEarth/MemCache>
+#include <osgEarthDrivers/cache_pack/PackCache>
+#include <osgDB/FileUtils>
+#include <osgDB/FileNameUtils>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <thread>
 
 using namespace osgEarth;
+using namespace osgEarth::Drivers;
+
+namespace
+{
+    const std::string PACK_TEST_PATH = "osgearth_tests_pack_cache";
+    const std::string PACK_TEST_BIN = "test_bin";
+
+    std::string packBinFile(const std::string& name)
+    {
+        return osgDB::concatPaths(osgDB::concatPaths(PACK_TEST_PATH, PACK_TEST_BIN), name);
+    }
+
+    void removePackCache()
+    {
+        ::remove(packBinFile("data.pack").c_str());
+        ::remove(packBinFile("index.idx").c_str());
+        ::remove(packBinFile("data.lock").c_str());
+    }
+
+    osg::ref_ptr<Cache> openPackCache()
+    {
+        PackCacheOptions options;
+        options.rootPath() = PACK_TEST_PATH;
+        return CacheFactory::create(options);
+    }
+
+    osg::ref_ptr<StringObject> str(const std::string& value)
+    {
+        return new StringObject(value);
+    }
+
+    std::string readString(CacheBin* bin, const std::string& key)
+    {
+        ReadResult r = bin->readString(key, nullptr);
+        return r.succeeded() ? r.getString() : std::string();
+    }
+}
 
 TEST_CASE( "Cache" ) {
 
@@ -66,3 +110,162 @@ TEST_CASE( "Cache" ) {
         REQUIRE(r2.failed());
     }  
 }
+
+TEST_CASE("Pack cache")
+{
+    removePackCache();
+
+    osg::ref_ptr<Cache> cache = openPackCache();
+    REQUIRE(cache.valid());
+    REQUIRE(cache->getStatus().isOK());
+
+    osg::ref_ptr<CacheBin> bin = cache->addBin(PACK_TEST_BIN);
+    REQUIRE(bin.valid());
+
+    SECTION("Write and read")
+    {
+        REQUIRE(bin->write("a", str("alpha").get(), Config(), nullptr));
+        REQUIRE(bin->write("b", str("bravo").get(), Config(), nullptr));
+        REQUIRE(readString(bin.get(), "a") == "alpha");
+        REQUIRE(readString(bin.get(), "b") == "bravo");
+
+        // overwrite and remove
+        REQUIRE(bin->write("a", str("alpha2").get(), Config(), nullptr));
+        REQUIRE(readString(bin.get(), "a") == "alpha2");
+        REQUIRE(bin->remove("b"));
+        REQUIRE(bin->readString("b", nullptr).failed());
+        REQUIRE(bin->getRecordStatus("b") == CacheBin::STATUS_NOT_FOUND);
+    }
+
+    SECTION("Reopen")
+    {
+        Config meta("meta");
+        meta.set("color", "red");
+        REQUIRE(bin->write("a", str("alpha").get(), meta, nullptr));
+        REQUIRE(bin->write("b", str("bravo").get(), Config(), nullptr));
+        REQUIRE(bin->remove("b"));
+
+        bin = nullptr;
+        cache = nullptr;
+
+        cache = openPackCache();
+        bin = cache->addBin(PACK_TEST_BIN);
+        REQUIRE(bin.valid());
+
+        ReadResult r = bin->readString("a", nullptr);
+        REQUIRE(r.succeeded());
+        REQUIRE(r.getString() == "alpha");
+        REQUIRE(r.metadata().value("color") == "red");
+        REQUIRE(bin->readString("b", nullptr).failed());
+    }
+
+    SECTION("Compact")
+    {
+        for (int i = 0; i < 100; ++i)
+            REQUIRE(bin->write(std::to_string(i), str("first " + std::to_string(i)).get(), Config(), nullptr));
+        for (int i = 0; i < 100; i += 2)
+            REQUIRE(bin->write(std::to_string(i), str("second " + std::to_string(i)).get(), Config(), nullptr));
+        for (int i = 1; i < 100; i += 4)
+            REQUIRE(bin->remove(std::to_string(i)));
+
+        unsigned before = bin->getStorageSize();
+        REQUIRE(bin->compact());
+        REQUIRE(bin->getStorageSize() < before);
+
+        auto check = [](CacheBin* bin)
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                INFO("key " << i);
+                std::string value = readString(bin, std::to_string(i));
+                if (i % 2 == 0)
+                    REQUIRE(value == "second " + std::to_string(i));
+                else if (i % 4 == 1)
+                    REQUIRE(value.empty());
+                else
+                    REQUIRE(value == "first " + std::to_string(i));
+            }
+        };
+
+        check(bin.get());
+
+        // still writable after the swap
+        REQUIRE(bin->write("new", str("after").get(), Config(), nullptr));
+
+        bin = nullptr;
+        cache = nullptr;
+
+        cache = openPackCache();
+        bin = cache->addBin(PACK_TEST_BIN);
+        check(bin.get());
+        REQUIRE(readString(bin.get(), "new") == "after");
+    }
+
+    SECTION("Clear during a compaction")
+    {
+        // enough dead data that the compaction is still copying when clear() runs
+        const std::string payload(16 * 1024, 'x');
+        for (int pass = 0; pass < 2; ++pass)
+            for (int i = 0; i < 500; ++i)
+                REQUIRE(bin->write(std::to_string(i), str(payload).get(), Config(), nullptr));
+
+        std::atomic_bool started = { false };
+        std::thread compactor([&]() { started = true; bin->compact(); });
+        while (!started)
+            std::this_thread::yield();
+
+        REQUIRE(bin->clear());
+        compactor.join();
+
+        for (int i = 0; i < 500; i += 50)
+            REQUIRE(bin->readString(std::to_string(i), nullptr).failed());
+
+        REQUIRE(bin->write("a", str("alpha").get(), Config(), nullptr));
+        REQUIRE(readString(bin.get(), "a") == "alpha");
+
+        bin = nullptr;
+        cache = nullptr;
+
+        cache = openPackCache();
+        bin = cache->addBin(PACK_TEST_BIN);
+        REQUIRE(readString(bin.get(), "a") == "alpha");
+        REQUIRE(bin->readString("0", nullptr).failed());
+    }
+
+    SECTION("Corrupt records are not returned")
+    {
+        REQUIRE(bin->write("a", str("alpha").get(), Config(), nullptr));
+
+        bin = nullptr;
+        cache = nullptr;
+
+        // flip the last byte of the pack, which belongs to the record's data
+        {
+            std::fstream f(packBinFile("data.pack"), std::ios::in | std::ios::out | std::ios::binary);
+            REQUIRE(f.good());
+            f.seekg(-1, std::ios::end);
+            char c = (char)f.get();
+            f.seekp(-1, std::ios::end);
+            f.put((char)~c);
+        }
+
+        cache = openPackCache();
+        bin = cache->addBin(PACK_TEST_BIN);
+        REQUIRE(bin->readString("a", nullptr).failed());
+    }
+
+    SECTION("Single writer")
+    {
+        // a second cache on the same folder must not append to the same pack
+        osg::ref_ptr<Cache> other = openPackCache();
+        REQUIRE(other.valid());
+        osg::ref_ptr<CacheBin> otherBin = other->addBin(PACK_TEST_BIN);
+        REQUIRE(otherBin.valid());
+        REQUIRE(otherBin->write("a", str("alpha").get(), Config(), nullptr) == false);
+        REQUIRE(bin->write("a", str("alpha").get(), Config(), nullptr));
+    }
+
+    bin = nullptr;
+    cache = nullptr;
+    removePackCache();
+}
@@ -0,0 +1,91 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+#include <osgEarth/Containers>
+#include <thread>
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+TEST_CASE("ConcurrentLRUCache") {
+
+    using Cache = ConcurrentLRUCache<int, std::string>;
+
+    SECTION("Insert and get")
+    {
+        Cache cache(true, 100);
+        cache.insert(1, "one");
+        cache.insert(2, "two");
+
+        Cache::Record r;
+        REQUIRE(cache.get(1, r));
+        REQUIRE(r.value() == "one");
+        REQUIRE(cache.has(2));
+
+        cache.erase(2);
+        REQUIRE(!cache.has(2));
+
+        Cache::Record r2;
+        REQUIRE(!cache.get(2, r2));
+
+        auto stats = cache.getStatistics();
+        REQUIRE(stats.hits == 1u);
+        REQUIRE(stats.misses == 1u);
+        REQUIRE(stats.entries == 1u);
+    }
+
+    SECTION("Entry limit")
+    {
+        Cache cache(true, 50);
+        for (int i = 0; i < 1000; ++i)
+            cache.insert(i, std::to_string(i));
+
+        // each shard rounds its share of the limit up, so the bound is
+        // per shard and not exactly the requested maximum
+        auto stats = cache.getStatistics();
+        REQUIRE(stats.entries <= cache.getNumShards() * cache.getMaxSizePerShard());
+        REQUIRE(stats.entries > 0u);
+        REQUIRE(stats.evictions + stats.entries == 1000u);
+    }
+
+    SECTION("Byte limit")
+    {
+        Cache cache(false, 1000);
+        cache.setMaxBytes(10 * sizeof(std::string));
+        for (int i = 0; i < 100; ++i)
+            cache.insert(i, std::to_string(i));
+
+        REQUIRE(cache.getStatistics().bytes <= 10 * sizeof(std::string));
+    }
+
+    SECTION("Concurrent access")
+    {
+        Cache cache(true, 128);
+        std::vector<std::thread> threads;
+        std::atomic<int> errors = { 0 };
+
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&cache, &errors, t]() {
+                for (int i = 0; i < 10000; ++i)
+                {
+                    int key = (i * 7 + t) % 300;
+                    Cache::Record r;
+                    if (!cache.get(key, r))
+                        cache.insert(key, std::to_string(key));
+                    else if (r.value() != std::to_string(key))
+                        ++errors;
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        REQUIRE(errors == 0);
+        REQUIRE(cache.getStatistics().entries <= 128u);
+    }
+}
@@ -0,0 +1,105 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/Map>
+#include <osgEarth/ElevationPool>
+#include <osgEarth/GDAL>
+#include <osgEarth/Random>
+
+#include <chrono>
+
+using namespace osgEarth;
+
+namespace
+{
+    osg::ref_ptr<Map> createElevationMap()
+    {
+        osg::ref_ptr<Map> map = new Map();
+
+        GDALElevationLayer* layer = new GDALElevationLayer();
+        layer->setURL("../data/mt_fuji_90m.tif");
+        map->addLayer(layer);
+
+        return layer->isOpen() ? map : nullptr;
+    }
+
+    // Random points around the summit, in map (geographic) coordinates
+    std::vector<osg::Vec3d> createPoints(unsigned count)
+    {
+        Random prng(0);
+        std::vector<osg::Vec3d> points(count);
+        for (auto& p : points)
+        {
+            p.set(
+                138.6274 + 0.2 * prng.next(),
+                35.2606 + 0.2 * prng.next(),
+                0.0);
+        }
+        return points;
+    }
+}
+
+TEST_CASE("ElevationPool::sampleMapCoordsBatch matches sampleMapCoords")
+{
+    osg::ref_ptr<Map> map = createElevationMap();
+    REQUIRE(map.valid());
+
+    ElevationPool* pool = map->getElevationPool();
+    Distance resolution(90.0, Units::METERS);
+
+    // an odd count exercises both the vector and the scalar tail of the kernel
+    std::vector<osg::Vec3d> expected = createPoints(4099);
+    std::vector<osg::Vec3d> actual = expected;
+
+    int expectedCount = pool->sampleMapCoords(expected.begin(), expected.end(), resolution, nullptr, nullptr);
+
+    ElevationPool::BatchStats stats;
+    int actualCount = pool->sampleMapCoordsBatch(actual.begin(), actual.end(), resolution, nullptr, nullptr, NO_DATA_VALUE, &stats);
+
+    REQUIRE(expectedCount > 0);
+    REQUIRE(actualCount == expectedCount);
+    REQUIRE(stats.points == actual.size());
+    REQUIRE(stats.sampled == (std::size_t)actualCount);
+    REQUIRE(stats.buckets > 0u);
+
+    for (std::size_t i = 0; i < actual.size(); ++i)
+    {
+        INFO("point " << i);
+        REQUIRE(actual[i].x() == expected[i].x());
+        REQUIRE(actual[i].y() == expected[i].y());
+        REQUIRE(actual[i].z() == Approx(expected[i].z()).epsilon(1e-5));
+    }
+}
+
+TEST_CASE("ElevationPool batch sampling benchmark", "[.][benchmark]")
+{
+    osg::ref_ptr<Map> map = createElevationMap();
+    REQUIRE(map.valid());
+
+    ElevationPool* pool = map->getElevationPool();
+    Distance resolution(90.0, Units::METERS);
+
+    const std::vector<osg::Vec3d> points = createPoints(1000000);
+
+    // warm up the tile cache so both paths measure sampling only
+    std::vector<osg::Vec3d> work = points;
+    ElevationPool::WorkingSet ws;
+    pool->sampleMapCoords(work.begin(), work.end(), resolution, &ws, nullptr);
+
+    work = points;
+    auto t0 = std::chrono::steady_clock::now();
+    pool->sampleMapCoords(work.begin(), work.end(), resolution, &ws, nullptr);
+    auto t1 = std::chrono::steady_clock::now();
+
+    work = points;
+    ElevationPool::BatchStats stats;
+    pool->sampleMapCoordsBatch(work.begin(), work.end(), resolution, &ws, nullptr, NO_DATA_VALUE, &stats);
+
+    double scalar = std::chrono::duration<double>(t1 - t0).count();
+    WARN("sampleMapCoords: " << (double)points.size() / scalar << " points/s");
+    WARN("sampleMapCoordsBatch: " << stats.pointsPerSecond() << " points/s in " << stats.buckets << " buckets");
+}
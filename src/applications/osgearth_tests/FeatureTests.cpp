@@ -6,8 +6,16 @@
 #include <osgEarth/catch.hpp>
 
 #include <osgEarth/Feature>
+#include <osgEarth/FeatureExpression>
+#include <osgEarth/FeatureModelGraph>
+#include <osgEarth/OGRFeatureSource>
 #include <osgEarth/Geometry>
 #include <osgEarth/GeometryUtils>
+#include <osgEarth/JsonUtils>
+#include <osgEarth/Tessellator>
+#include <cstdio>
+#include <fstream>
+#include <set>
 
 using namespace osgEarth;
 
@@ -40,6 +48,19 @@ namespace
 
         return false;
     }
+
+    // Total area of the triangles in an index list
+    template<class V>
+    inline double triangles_area(const V& verts, const std::vector<uint32_t>& indices)
+    {
+        double area = 0.0;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            osg::Vec3d a = verts[indices[i]], b = verts[indices[i + 1]], c = verts[indices[i + 2]];
+            area += 0.5 * std::abs((b.x() - a.x()) * (c.y() - a.y()) - (c.x() - a.x()) * (b.y() - a.y()));
+        }
+        return area;
+    }
 }
 
 //TEST_CASE("Geometry::crop line against line")
@@ -215,3 +236,426 @@ TEST_CASE("Feature handles attributes correctly.")
         REQUIRE(feature->getBool("bool") == false);
     }
 }
+
+TEST_CASE("Feature reads attributes through an AttributeStore")
+{
+    osg::ref_ptr<AttributeStore> store = new AttributeStore();
+    int name = store->addColumn("Name");
+    int levels = store->addColumn("levels");
+    int height = store->addColumn("height");
+    REQUIRE(store->addColumn("NAME") == name);
+
+    osg::ref_ptr<Feature> feature = new Feature(new Point(), osgEarth::SpatialReference::create("wgs84"));
+    unsigned row = store->addRow();
+    feature->setAttributeStore(store.get(), row);
+    store->set(row, name, std::string("tower"));
+    store->set(row, levels, 12);
+    store->setNull(row, height, ATTRTYPE_DOUBLE);
+
+    SECTION("Getters see the store row") {
+        REQUIRE(feature->getString("name") == "tower");
+        REQUIRE(feature->getInt("LEVELS") == 12);
+        REQUIRE(feature->getDouble("levels") == 12.0);
+        REQUIRE(feature->hasAttr("height") == true);
+        REQUIRE(feature->isSet("height") == false);
+        REQUIRE(feature->getDouble("height", -1.0) == -1.0);
+        REQUIRE(feature->hasAttr("missing") == false);
+        REQUIRE(feature->getLocalAttrs().size() == 0);
+        REQUIRE(feature->getNumAttrs() == 3);
+        REQUIRE(feature->getAllAttrs().size() == 3);
+
+        // the full table, for callers that still iterate getAttrs()
+        const AttributeTable& attrs = feature->getAttrs();
+        REQUIRE(attrs.size() == 3);
+        REQUIRE(attrs.find("name") != attrs.end());
+        REQUIRE(attrs.find("name")->second.getString() == "tower");
+        REQUIRE(&feature->getAttrs() == &attrs);
+    }
+
+    SECTION("Local values override the store") {
+        REQUIRE(feature->getAttrs().find("levels")->second.getInt() == 12);
+
+        feature->set("levels", 3.5);
+        REQUIRE(feature->getDouble("levels") == 3.5);
+        REQUIRE(store->getInt(row, levels) == 12);
+        REQUIRE(feature->getLocalAttrs().size() == 1);
+        REQUIRE(feature->getNumAttrs() == 3);
+
+        // the table built by getAttrs() follows the change
+        REQUIRE(feature->getAttrs().size() == 3);
+        REQUIRE(feature->getAttrs().find("levels")->second.getDouble() == 3.5);
+
+        // the local value replaces the stored one, and comes first
+        std::vector<std::string> names;
+        double visitedLevels = 0.0;
+        feature->forEachAttr([&](const std::string& name, const AttributeValue& value) {
+            names.push_back(name);
+            if (name == "levels")
+                visitedLevels = value.getDouble();
+        });
+        REQUIRE(names.size() == 3);
+        REQUIRE(names[0] == "levels");
+        REQUIRE(visitedLevels == 3.5);
+    }
+
+    SECTION("Removing a stored attribute detaches the feature") {
+        feature->removeAttribute("name");
+        REQUIRE(feature->hasAttr("name") == false);
+        REQUIRE(feature->getInt("levels") == 12);
+        REQUIRE(feature->getAttributeStore() == nullptr);
+        REQUIRE(store->getString(row, name) == "tower");
+    }
+
+    SECTION("Compiled expressions read the store") {
+        FeatureList features{ feature };
+        std::vector<double> results;
+        CompiledNumericExpression(NumericExpression("[levels]*3.5")).eval(features, nullptr, results);
+        REQUIRE(results[0] == 42.0);
+    }
+}
+
+TEST_CASE("GeoJSON features stream through a lazy JSON document")
+{
+    const char* geojson = R"({
+        "type": "FeatureCollection",
+        "features": [
+            { "type": "Feature", "id": 7,
+              "geometry": { "type": "Point", "coordinates": [10, 20] },
+              "properties": { "name": "a \"b\" }", "levels": 3, "height": 12.5, "open": true, "note": null } },
+            { "type": "Feature", "id": 8,
+              "geometry": { "type": "LineString", "coordinates": [[0, 0], [1, 1]] },
+              "properties": { "tags": [1, 2] } }
+        ]
+    })";
+
+    SECTION("Views find members without materializing the document") {
+        Util::Json::Document doc;
+        REQUIRE(doc.load(geojson));
+        Util::Json::View features = doc.root()["features"];
+        REQUIRE(features.isArray());
+        REQUIRE(features.size() == 2);
+
+        Util::Json::View props;
+        features.forEach([&](const Util::Json::View& f) { props = f["properties"]; return false; });
+        REQUIRE(props["name"].asString() == "a \"b\" }");
+        REQUIRE(props["levels"].type() == Util::Json::intValue);
+        REQUIRE(props["height"].asDouble() == 12.5);
+        REQUIRE(props["open"].asBool() == true);
+        REQUIRE(props["note"].isNull());
+        REQUIRE(props["missing"].valid() == false);
+
+        Util::Json::Value value;
+        REQUIRE(doc.root()["features"].materialize(value));
+        REQUIRE(value.size() == 2u);
+        REQUIRE(value[1u]["id"].asInt() == 8);
+
+        REQUIRE(doc.load("{ \"unterminated\": [1, 2 }") == false);
+    }
+
+    SECTION("Feature::readGeoJSON emits each feature") {
+        const std::string path = "osgearth_tests_stream.geojson";
+        std::ofstream(path) << geojson;
+
+        FeatureList features;
+        REQUIRE(Feature::readGeoJSON(path, [&](Feature* f) { features.push_back(f); return true; }));
+        std::remove(path.c_str());
+
+        REQUIRE(features.size() == 2);
+        REQUIRE(features[0]->getFID() == 7);
+        REQUIRE(features[0]->getGeometry()->getType() == Geometry::TYPE_POINT);
+        REQUIRE(features[0]->getString("name") == "a \"b\" }");
+        REQUIRE(features[0]->getInt("levels") == 3);
+        REQUIRE(features[0]->getDouble("height") == 12.5);
+        REQUIRE(features[0]->getBool("open") == true);
+        REQUIRE(features[1]->getGeometry()->getType() == Geometry::TYPE_LINESTRING);
+        REQUIRE(features[1]->getString("tags") == "[1, 2]");
+    }
+}
+
+TEST_CASE("Compiled feature expressions match Feature::eval")
+{
+    FeatureList features;
+    for (int i = 0; i < 600; ++i)
+    {
+        osg::ref_ptr<Feature> feature = new Feature(new Point(), osgEarth::SpatialReference::create("wgs84"));
+        // vary the attribute layout so the cached column lookups have to miss sometimes
+        if (i % 7 == 0)
+            feature->set("name", std::string("building"));
+        if (i % 5 != 0)
+            feature->set("levels", i % 12);
+        feature->set("height", 2.5 * (double)i);
+        features.push_back(feature);
+    }
+
+    SECTION("Numeric expressions") {
+        for (auto& source : {
+            "[levels]*3.5",
+            "max([height], [levels]*3.5) + 1",
+            "2*3+[levels]",
+            "[height] % 4 - min([levels], 6) / 2",
+            "([LEVELS]+1)*(2+2)",
+            "10" })
+        {
+            NumericExpression expr(source);
+            CompiledNumericExpression compiled(expr);
+
+            std::vector<double> results;
+            compiled.eval(features, nullptr, results);
+            REQUIRE(results.size() == features.size());
+
+            for (unsigned i = 0; i < features.size(); ++i)
+            {
+                double expected = features[i]->eval(expr, (FilterContext*)nullptr);
+                REQUIRE(results[i] == expected);
+                REQUIRE(compiled.eval(features[i].get(), nullptr) == expected);
+            }
+        }
+    }
+
+    SECTION("String expressions") {
+        StringExpression expr("\"id-\" + [name] + \"-\" + [levels]");
+        CompiledStringExpression compiled(expr);
+
+        std::vector<std::string> results;
+        compiled.eval(features, nullptr, results);
+        REQUIRE(results.size() == features.size());
+
+        for (unsigned i = 0; i < features.size(); ++i)
+        {
+            REQUIRE(results[i] == features[i]->eval(expr, (FilterContext*)nullptr));
+        }
+    }
+}
+
+TEST_CASE("Polygon::rasterize2D covers the same points as contains2D")
+{
+    // a concave star with a hole, sampled on a grid that does not line up with it
+    osg::ref_ptr<osgEarth::Polygon> star = new osgEarth::Polygon();
+    for (int i = 0; i < 14; ++i)
+    {
+        double a = osg::PI * 2.0 * (double)i / 14.0;
+        double r = (i & 1) ? 12.0 : 40.0;
+        star->push_back(osg::Vec3d(50.0 + r * cos(a), 50.0 + r * sin(a), 0.0));
+    }
+
+    osg::ref_ptr<Ring> hole = new Ring();
+    hole->push_back(osg::Vec3d(45, 45, 0));
+    hole->push_back(osg::Vec3d(45, 55, 0));
+    hole->push_back(osg::Vec3d(55, 55, 0));
+    hole->push_back(osg::Vec3d(55, 45, 0));
+    star->getHoles().push_back(hole);
+
+    auto compare = [](const osgEarth::Polygon* polygon, double x0, double y0, double dx, double dy, unsigned cols, unsigned rows)
+    {
+        std::vector<int> hits(cols * rows, 0);
+        polygon->rasterize2D(x0, y0, dx, dy, cols, rows, [&](unsigned c, unsigned r) { hits[r * cols + c]++; });
+
+        unsigned mismatches = 0, covered = 0;
+        for (unsigned r = 0; r < rows; ++r)
+        {
+            for (unsigned c = 0; c < cols; ++c)
+            {
+                bool inside = polygon->contains2D(x0 + dx * (double)c, y0 + dy * (double)r);
+                if (hits[r * cols + c] != (inside ? 1 : 0))
+                    ++mismatches;
+                if (inside)
+                    ++covered;
+            }
+        }
+        REQUIRE(covered > 0u);
+        REQUIRE(mismatches == 0u);
+    };
+
+    SECTION("Open ring") {
+        compare(star.get(), -3.3, 1.7, 0.77, 0.91, 160, 120);
+    }
+
+    SECTION("Closed ring, grid points on the vertices") {
+        star->push_back(star->front());
+        compare(star.get(), 0.0, 0.0, 1.0, 1.0, 101, 101);
+    }
+
+    SECTION("Grid larger than the polygon") {
+        compare(star.get(), -500.0, -500.0, 7.0, 7.0, 200, 200);
+    }
+}
+
+TEST_CASE("Tessellator triangulates polygons with holes")
+{
+    Tessellator tess;
+
+    osg::ref_ptr<osgEarth::Polygon> square = new osgEarth::Polygon();
+    square->push_back(osg::Vec3d(0, 0, 0));
+    square->push_back(osg::Vec3d(10, 0, 0));
+    square->push_back(osg::Vec3d(10, 10, 0));
+    square->push_back(osg::Vec3d(0, 10, 0));
+
+    osg::ref_ptr<Ring> hole = new Ring();
+    hole->push_back(osg::Vec3d(4, 4, 0));
+    hole->push_back(osg::Vec3d(4, 6, 0));
+    hole->push_back(osg::Vec3d(6, 6, 0));
+    hole->push_back(osg::Vec3d(6, 4, 0));
+    square->getHoles().push_back(hole);
+
+    SECTION("Polygon with a hole") {
+        Vec verts;
+        ConstGeometryIterator iter(square.get(), true);
+        while (iter.hasMore())
+        {
+            auto part = iter.next();
+            verts.insert(verts.end(), part->begin(), part->end());
+        }
+
+        std::vector<uint32_t> indices;
+        REQUIRE(tess.tessellate2D(square.get(), indices));
+        REQUIRE(indices.size() % 3 == 0);
+        REQUIRE(triangles_area(verts, indices) == Approx(96.0));
+    }
+
+    SECTION("Multipolygon indices follow the iteration order") {
+        osg::ref_ptr<osgEarth::Polygon> other = new osgEarth::Polygon();
+        other->push_back(osg::Vec3d(20, 0, 0));
+        other->push_back(osg::Vec3d(22, 0, 0));
+        other->push_back(osg::Vec3d(22, 2, 0));
+        other->push_back(osg::Vec3d(20, 2, 0));
+
+        osg::ref_ptr<MultiGeometry> multi = new MultiGeometry();
+        multi->add(square.get());
+        multi->add(other.get());
+
+        Vec verts;
+        ConstGeometryIterator iter(multi.get(), true);
+        while (iter.hasMore())
+        {
+            auto part = iter.next();
+            verts.insert(verts.end(), part->begin(), part->end());
+        }
+
+        std::vector<uint32_t> indices;
+        REQUIRE(tess.tessellate2D(multi.get(), indices));
+        REQUIRE(triangles_area(verts, indices) == Approx(100.0));
+        REQUIRE(*std::max_element(indices.begin(), indices.end()) == verts.size() - 1);
+    }
+
+    SECTION("Line loops in a vertical plane, hole found by containment") {
+        // same square and hole in the XZ plane, starting at vertex 2
+        osg::ref_ptr<osg::Vec3Array> verts = new osg::Vec3Array();
+        verts->push_back(osg::Vec3(-1, -1, -1));
+        verts->push_back(osg::Vec3(-1, -1, -1));
+        for (auto& p : *square) verts->push_back(osg::Vec3(p.x(), 7, p.y()));
+        for (auto& p : *hole) verts->push_back(osg::Vec3(p.x(), 7, p.y()));
+
+        osg::ref_ptr<osg::Geometry> geom = new osg::Geometry();
+        geom->setVertexArray(verts.get());
+        geom->addPrimitiveSet(new osg::DrawArrays(GL_LINE_LOOP, 6, 4));
+        geom->addPrimitiveSet(new osg::DrawArrays(GL_LINE_LOOP, 2, 4));
+
+        REQUIRE(tess.tessellateGeometry(*geom));
+        REQUIRE(geom->getNumPrimitiveSets() == 1);
+
+        auto* de = dynamic_cast<osg::DrawElementsUInt*>(geom->getPrimitiveSet(0));
+        REQUIRE(de != nullptr);
+
+        Vec flat;
+        for (auto& v : *verts) flat.push_back(osg::Vec3d(v.x(), v.z(), 0));
+        std::vector<uint32_t> indices(de->begin(), de->end());
+        REQUIRE(*std::min_element(indices.begin(), indices.end()) >= 2u);
+        REQUIRE(triangles_area(flat, indices) == Approx(96.0));
+    }
+}
+
+TEST_CASE("FeatureModelGraph cache revision follows its inputs")
+{
+    osg::ref_ptr<OGRFeatureSource> source = new OGRFeatureSource();
+    source->setURL("../data/boston-parks.shp");
+
+    osg::ref_ptr<StyleSheet> styles = new StyleSheet();
+    FeatureModelOptions options;
+
+    const std::string revision = FeatureModelGraph::makeCacheRevision(source.get(), styles.get(), options);
+    REQUIRE(revision.empty() == false);
+    REQUIRE(FeatureModelGraph::makeCacheRevision(source.get(), styles.get(), options) == revision);
+
+    SECTION("Changing the styles changes the revision") {
+        Style style("parks");
+        style.getOrCreate<PolygonSymbol>()->fill().mutable_value().color() = Color::Green;
+        styles->addStyle(style);
+        REQUIRE(FeatureModelGraph::makeCacheRevision(source.get(), styles.get(), options) != revision);
+    }
+
+    SECTION("Changing the options changes the revision") {
+        options.backfaceCulling() = false;
+        REQUIRE(FeatureModelGraph::makeCacheRevision(source.get(), styles.get(), options) != revision);
+    }
+
+    SECTION("Changing the source changes the revision") {
+        source->setURL("../data/world.shp");
+        REQUIRE(FeatureModelGraph::makeCacheRevision(source.get(), styles.get(), options) != revision);
+    }
+}
+
+TEST_CASE("OGRFeatureSource memory index matches a layer scan")
+{
+    // a 10x10 grid of unit squares; every other feature is "tagged"
+    const std::string path = "osgearth_tests_grid.geojson";
+    {
+        std::ofstream out(path);
+        out << "{ \"type\": \"FeatureCollection\", \"features\": [";
+        for (int i = 0; i < 100; ++i)
+        {
+            int x = i % 10, y = i / 10;
+            out << (i > 0 ? "," : "")
+                << "{ \"type\": \"Feature\", \"properties\": { \"index\": " << i;
+            if (i % 2 == 0)
+                out << ", \"tagged\": 1";
+            out << " }, \"geometry\": { \"type\": \"Polygon\", \"coordinates\": [[["
+                << x << "," << y << "],[" << x + 1 << "," << y << "],["
+                << x + 1 << "," << y + 1 << "],[" << x << "," << y + 1 << "],["
+                << x << "," << y << "]]] } }";
+        }
+        out << "] }";
+    }
+
+    auto open = [&](bool indexed) {
+        osg::ref_ptr<OGRFeatureSource> source = new OGRFeatureSource();
+        source->setURL(path);
+        source->setMemorySpatialIndex(indexed);
+        source->options().filters().push_back(ConfigOptions(Config("attributes", "tagged")));
+        return source;
+    };
+
+    osg::ref_ptr<OGRFeatureSource> indexed = open(true);
+    osg::ref_ptr<OGRFeatureSource> scanned = open(false);
+    REQUIRE(indexed->open().isOK());
+    REQUIRE(scanned->open().isOK());
+
+    auto read = [](OGRFeatureSource* source, const Bounds& bounds) {
+        Query query;
+        query.bounds() = bounds;
+        std::set<long long> result;
+        osg::ref_ptr<FeatureCursor> cursor = source->createFeatureCursor(query, {}, nullptr, nullptr);
+        while (cursor.valid() && cursor->hasMore())
+            result.insert(cursor->nextFeature()->getInt("index"));
+        return result;
+    };
+
+    for (auto& bounds : {
+        Bounds(2.5, 2.5, 0, 4.5, 6.5, 0),
+        Bounds(-5, -5, 0, 0.5, 0.5, 0),
+        Bounds(20, 20, 0, 30, 30, 0),
+        Bounds(0, 0, 0, 10, 10, 0) })
+    {
+        INFO("bounds " << bounds.xMin() << "," << bounds.yMin() << " " << bounds.xMax() << "," << bounds.yMax());
+        std::set<long long> expected = read(scanned.get(), bounds);
+        std::set<long long> actual = read(indexed.get(), bounds);
+        REQUIRE(actual == expected);
+        for (auto i : actual)
+            REQUIRE(i % 2 == 0);
+    }
+
+    REQUIRE(read(indexed.get(), Bounds(0, 0, 0, 10, 10, 0)).size() == 50u);
+
+    indexed->close();
+    scanned->close();
+    std::remove(path.c_str());
+}
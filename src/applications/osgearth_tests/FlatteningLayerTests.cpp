@@ -0,0 +1,391 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/FlatteningLayer>
+#include <osgEarth/FeatureCursor>
+#include <osgEarth/GDAL>
+#include <osgEarth/Map>
+#include <osgEarth/OGRFeatureSource>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+using namespace osgEarth;
+
+namespace
+{
+    // exposes the heightfield factory so the test skips the layer caches
+    class FlatteningProbe : public Contrib::FlatteningLayer
+    {
+    public:
+        using Contrib::FlatteningLayer::createHeightFieldImplementation;
+    };
+
+    double smootherstep(double a, double b, double t)
+    {
+        t = t * t * t * (t * (t * 6.0 - 15.0) + 10.0);
+        return a + (b - a) * t;
+    }
+
+    double clamp(double a, double lo, double hi)
+    {
+        return osg::maximum(osg::minimum(a, hi), lo);
+    }
+
+    // Writes features to a GeoJSON file in spherical mercator. Each part's
+    // points are fractions of the given extent.
+    void writeGeoJSON(const std::string& path, const GeoExtent& extent,
+        const std::vector<std::vector<osg::Vec2d>>& parts, bool polygons)
+    {
+        std::ofstream out(path);
+        out << std::setprecision(15)
+            << "{ \"type\": \"FeatureCollection\", "
+            << "\"crs\": { \"type\": \"name\", \"properties\": { \"name\": \"EPSG:3857\" } }, "
+            << "\"features\": [";
+
+        for (unsigned i = 0; i < parts.size(); ++i)
+        {
+            out << (i > 0 ? "," : "") << "{ \"type\": \"Feature\", \"properties\": {}, \"geometry\": { "
+                << "\"type\": \"" << (polygons ? "Polygon" : "LineString") << "\", \"coordinates\": "
+                << (polygons ? "[[" : "[");
+
+            std::vector<osg::Vec2d> points = parts[i];
+            if (polygons)
+                points.push_back(points.front());
+
+            for (unsigned j = 0; j < points.size(); ++j)
+            {
+                out << (j > 0 ? "," : "") << "["
+                    << extent.xMin() + points[j].x() * extent.width() << ","
+                    << extent.yMin() + points[j].y() * extent.height() << "]";
+            }
+            out << (polygons ? "]]" : "]") << " } }";
+        }
+        out << "] }";
+    }
+
+    // Features in the layer's working SRS, with widths in that SRS's units,
+    // prepared the same way FlatteningLayer prepares them.
+    struct Input
+    {
+        FeatureList features;
+        const SpatialReference* srs;
+        double lineWidth;
+        double bufferWidth;
+    };
+
+    Input prepare(FeatureSource* source, const TileKey& key, double lineWidth, double bufferWidth)
+    {
+        Input input;
+        source->createFeatureCursor()->fill(input.features);
+
+        const SpatialReference* featureSRS = source->getFeatureProfile()->getSRS();
+        input.srs = SpatialReference::get("spherical-mercator");
+        if (!featureSRS->isHorizEquivalentTo(input.srs))
+        {
+            for (auto& feature : input.features)
+                feature->transform(input.srs);
+        }
+
+        double lat = key.getExtent().transform(featureSRS->getGeographicSRS()).getCentroid().y();
+        input.lineWidth = SpatialReference::transformUnits(Distance(lineWidth, Units::METERS), featureSRS, lat);
+        input.bufferWidth = SpatialReference::transformUnits(Distance(bufferWidth, Units::METERS), featureSRS, lat);
+        return input;
+    }
+
+    // Natural elevations at the grid points of an extent
+    std::vector<osg::Vec3d> sampleGrid(const GeoExtent& ex, unsigned numCols, unsigned numRows,
+        ElevationPool* pool, ElevationPool::WorkingSet* ws)
+    {
+        std::vector<osg::Vec3d> points;
+        for (unsigned row = 0; row < numRows; ++row)
+            for (unsigned col = 0; col < numCols; ++col)
+                points.emplace_back(
+                    ex.xMin() + (double)col * ex.width() / (double)(numCols - 1),
+                    ex.yMin() + (double)row * ex.height() / (double)(numRows - 1),
+                    0.0);
+
+        ex.getSRS()->transform(points, pool->getMapSRS());
+        pool->sampleMapCoords(points.begin(), points.end(), Distance(0.0, Units::METERS), ws, nullptr);
+        return points;
+    }
+
+    // Polygon flattening by brute force: every cell tests every polygon and
+    // measures every edge. The polygons are convex, so each one's flattening
+    // height comes from the center of its bounds.
+    std::vector<float> flattenPolygons(const TileKey& key, unsigned numCols, unsigned numRows,
+        const Input& input, ElevationPool* pool, ElevationPool::WorkingSet* ws)
+    {
+        const GeoExtent& ex = key.getExtent();
+
+        std::vector<osg::Vec3d> centers;
+        for (auto& feature : input.features)
+        {
+            osg::Vec3d c = feature->getGeometry()->getBounds().center();
+            centers.emplace_back(c.x(), c.y(), 0.0);
+        }
+        input.srs->transform(centers, pool->getMapSRS());
+        pool->sampleMapCoords(centers.begin(), centers.end(), Distance(0.0, Units::METERS), ws, nullptr);
+
+        std::vector<osg::Vec3d> natural = sampleGrid(ex, numCols, numRows, pool, ws);
+
+        std::vector<float> result(numCols * numRows, NO_DATA_VALUE);
+        for (unsigned row = 0; row < numRows; ++row)
+        {
+            for (unsigned col = 0; col < numCols; ++col)
+            {
+                osg::Vec3d cell(
+                    ex.xMin() + (double)col * ex.width() / (double)(numCols - 1),
+                    ex.yMin() + (double)row * ex.height() / (double)(numRows - 1),
+                    0.0);
+                osg::Vec3d P;
+                ex.getSRS()->transform(cell, input.srs, P);
+
+                double minD2 = DBL_MAX;
+                int best = -1;
+                for (unsigned i = 0; i < input.features.size() && minD2 >= 0.0; ++i)
+                {
+                    const Geometry* polygon = input.features[i]->getGeometry();
+                    if (static_cast<const Polygon*>(polygon)->contains2D(P.x(), P.y()))
+                    {
+                        minD2 = -1.0;
+                        best = i;
+                        break;
+                    }
+
+                    ConstSegmentIterator edges(polygon, true);
+                    while (edges.hasMore())
+                    {
+                        auto& edge = edges.next();
+                        osg::Vec3d AP = P - edge.first, AB = edge.second - edge.first;
+                        double t = clamp((AP * AB) / AB.length2(), 0.0, 1.0);
+                        double D2 = (P - (edge.first + AB * t)).length2();
+                        if (D2 < minD2)
+                        {
+                            minD2 = D2;
+                            best = i;
+                        }
+                    }
+                }
+
+                float elevNatural = natural[row * numCols + col].z();
+                float& h = result[row * numCols + col];
+
+                if (best >= 0 && minD2 != 0.0)
+                {
+                    float elevInternal = centers[best].z();
+                    if (minD2 < 0.0)
+                        h = elevInternal;
+                    else
+                        h = smootherstep(elevInternal, elevNatural, clamp(sqrt(minD2) / input.bufferWidth, 0.0, 1.0));
+                }
+                else
+                {
+                    h = elevNatural;
+                }
+            }
+        }
+        return result;
+    }
+
+    // Line flattening by brute force: every cell measures every segment.
+    // Keep the set to four segments or fewer, so every segment in reach is
+    // a sample and the layer's sample cap never applies.
+    std::vector<float> flattenLines(const TileKey& key, unsigned numCols, unsigned numRows,
+        const Input& input, ElevationPool* pool, ElevationPool::WorkingSet* ws)
+    {
+        struct Segment { osg::Vec3d A, B; float AElev, BElev; };
+        std::vector<Segment> segments;
+        std::vector<osg::Vec3d> ends;
+        for (auto& feature : input.features)
+        {
+            const Geometry* line = feature->getGeometry();
+            for (unsigned i = 0; i + 1 < line->size(); ++i)
+            {
+                segments.push_back(Segment{ (*line)[i], (*line)[i + 1], 0.0f, 0.0f });
+                ends.push_back((*line)[i]);
+                ends.push_back((*line)[i + 1]);
+            }
+        }
+        REQUIRE(segments.size() <= 4u);
+
+        input.srs->transform(ends, pool->getMapSRS());
+        pool->sampleMapCoords(ends.begin(), ends.end(), Distance(0.0, Units::METERS), ws, nullptr);
+        for (unsigned i = 0; i < segments.size(); ++i)
+        {
+            segments[i].AElev = ends[i * 2].z();
+            segments[i].BElev = ends[i * 2 + 1].z();
+        }
+
+        std::vector<osg::Vec3d> natural = sampleGrid(key.getExtent(), numCols, numRows, pool, ws);
+
+        GeoExtent ex = key.getExtent().transform(input.srs);
+        double innerRadius = input.lineWidth * 0.5;
+        double outerRadius = innerRadius + input.bufferWidth;
+
+        struct Sample { const Segment* segment; double D2, T; };
+        auto same = [](const osg::Vec3d& a, const osg::Vec3d& b) {
+            return osg::equivalent(a.x(), b.x()) && osg::equivalent(a.y(), b.y());
+        };
+
+        std::vector<float> result(numCols * numRows, NO_DATA_VALUE);
+        for (unsigned row = 0; row < numRows; ++row)
+        {
+            for (unsigned col = 0; col < numCols; ++col)
+            {
+                osg::Vec3d P(
+                    ex.xMin() + (double)col * ex.width() / (double)(numCols - 1),
+                    ex.yMin() + (double)row * ex.height() / (double)(numRows - 1),
+                    0.0);
+
+                std::vector<Sample> samples;
+                for (auto& segment : segments)
+                {
+                    osg::Vec3d AP = P - segment.A, AB = segment.B - segment.A;
+                    double t = AB.length2() == 0.0 ? 0.0 : clamp((AP * AB) / AB.length2(), 0.0, 1.0);
+                    double D2 = (P - (segment.A + AB * t)).length2();
+                    if (D2 <= outerRadius * outerRadius)
+                        samples.push_back(Sample{ &segment, D2, t });
+                }
+
+                // drop samples at an endpoint shared with another sampled segment
+                std::vector<Sample> valid;
+                for (auto& s : samples)
+                {
+                    bool ok = true;
+                    for (auto& other : samples)
+                    {
+                        if (&s == &other) continue;
+                        if (s.T == 0.0 && (same(s.segment->A, other.segment->A) || same(s.segment->A, other.segment->B))) ok = false;
+                        if (s.T == 1.0 && (same(s.segment->B, other.segment->A) || same(s.segment->B, other.segment->B))) ok = false;
+                    }
+                    if (ok) valid.push_back(s);
+                }
+
+                float elevP = natural[row * numCols + col].z();
+                float& h = result[row * numCols + col];
+
+                if (valid.empty())
+                {
+                    h = elevP;
+                    continue;
+                }
+
+                // inverse distance weighting of each sample's blended height
+                double numer = 0.0, denom = 0.0;
+                for (auto& s : valid)
+                {
+                    double D = sqrt(s.D2);
+                    float elevA = s.segment->AElev == NO_DATA_VALUE ? elevP : s.segment->AElev;
+                    float elevB = s.segment->BElev == NO_DATA_VALUE ? elevP : s.segment->BElev;
+                    float elevPROJ = elevA + (elevB - elevA) * s.T;
+                    double blend = clamp((D - innerRadius) / (outerRadius - innerRadius), 0.0, 1.0);
+                    float elev = smootherstep(elevPROJ, elevP, blend);
+
+                    if (valid.size() == 1u)
+                    {
+                        numer = elev, denom = 1.0;
+                    }
+                    else if (osg::equivalent(D, 0.0))
+                    {
+                        numer = elev, denom = 1.0;
+                        break;
+                    }
+                    else
+                    {
+                        double w = pow(1.0 / D, 2.5);
+                        numer += w * elev;
+                        denom += w;
+                    }
+                }
+                h = numer / denom;
+            }
+        }
+        return result;
+    }
+}
+
+TEST_CASE("FlatteningLayer matches a brute-force flattening")
+{
+    const double lineWidth = 30.0, bufferWidth = 60.0;
+
+    osg::ref_ptr<Map> map = new Map();
+    osg::ref_ptr<GDALElevationLayer> elevation = new GDALElevationLayer();
+    elevation->setURL("../data/mt_fuji_90m.tif");
+    map->addLayer(elevation.get());
+    REQUIRE(elevation->isOpen());
+
+    ElevationPool::WorkingSet ws;
+    ws.setElevationLayers({ elevation.get() });
+
+    TileKey key = map->getProfile()->createTileKey(138.72, 35.36, 13);
+    GeoExtent mercatorExtent = key.getExtent().transform(SpatialReference::get("spherical-mercator"));
+
+    const std::string path = "osgearth_tests_flattening.geojson";
+    bool polygons = false;
+
+    SECTION("Polygons")
+    {
+        polygons = true;
+        writeGeoJSON(path, mercatorExtent, {
+            { { 0.20, 0.20 }, { 0.40, 0.20 }, { 0.40, 0.40 }, { 0.20, 0.40 } },
+            { { 0.55, 0.50 }, { 0.80, 0.50 }, { 0.80, 0.70 }, { 0.55, 0.70 } },
+            { { 0.30, 0.60 }, { 0.50, 0.65 }, { 0.35, 0.90 } } }, true);
+    }
+
+    SECTION("Lines")
+    {
+        writeGeoJSON(path, mercatorExtent, {
+            { { 0.10, 0.30 }, { 0.50, 0.45 }, { 0.90, 0.35 } },
+            { { 0.30, 0.90 }, { 0.45, 0.60 }, { 0.70, 0.10 } } }, false);
+    }
+
+    osg::ref_ptr<OGRFeatureSource> features = new OGRFeatureSource();
+    features->setURL(path);
+    REQUIRE(features->open().isOK());
+
+    osg::ref_ptr<FlatteningProbe> flattening = new FlatteningProbe();
+    flattening->setFeatureSource(features.get());
+    flattening->setLineWidth(lineWidth);
+    flattening->setBufferWidth(bufferWidth);
+    flattening->setFill(true);
+    map->addLayer(flattening.get());
+    REQUIRE(flattening->isOpen());
+
+    GeoHeightField actual = flattening->createHeightFieldImplementation(key, nullptr);
+    REQUIRE(actual.valid());
+    const osg::HeightField* hf = actual.getHeightField();
+    unsigned numCols = hf->getNumColumns(), numRows = hf->getNumRows();
+
+    Input input = prepare(features.get(), key, lineWidth, bufferWidth);
+    std::vector<float> expected = polygons ?
+        flattenPolygons(key, numCols, numRows, input, map->getElevationPool(), &ws) :
+        flattenLines(key, numCols, numRows, input, map->getElevationPool(), &ws);
+
+    // the features have to change the terrain for the comparison to mean anything
+    std::vector<osg::Vec3d> natural = sampleGrid(key.getExtent(), numCols, numRows, map->getElevationPool(), &ws);
+    unsigned flattened = 0u;
+
+    for (unsigned row = 0; row < numRows; ++row)
+    {
+        for (unsigned col = 0; col < numCols; ++col)
+        {
+            INFO("cell " << col << ", " << row);
+            float e = expected[row * numCols + col];
+            REQUIRE(hf->getHeight(col, row) == Approx(e).margin(0.01));
+            if (fabs(e - natural[row * numCols + col].z()) > 0.1)
+                ++flattened;
+        }
+    }
+    REQUIRE(flattened > numCols);
+
+    map->removeLayer(flattening.get());
+    features->close();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,87 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/HTTPClient>
+#include <osgEarth/Registry>
+#include <osgDB/FileNameUtils>
+#include <osgDB/FileUtils>
+
+#include <fstream>
+#include <sstream>
+
+using namespace osgEarth;
+
+namespace
+{
+    std::string fileURL(const std::string& path)
+    {
+        std::string full = osgDB::convertFileNameToUnixStyle(osgDB::getRealPath(path));
+        return full[0] == '/' ? "file://" + full : "file:///" + full;
+    }
+
+    std::string readFile(const std::string& path)
+    {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        std::stringstream buf;
+        buf << in.rdbuf();
+        return buf.str();
+    }
+}
+
+TEST_CASE("HTTPClient async requests")
+{
+    // make sure curl is initialized
+    Registry::instance();
+
+    const std::string path = "../data/KML_Samples.kml";
+    const std::string expected = readFile(path);
+    REQUIRE(!expected.empty());
+
+    SECTION("getAsync reads a local file")
+    {
+        auto result = HTTPClient::getAsync(HTTPRequest(fileURL(path)));
+        const HTTPResponse& response = result.join();
+
+        REQUIRE(result.available());
+        REQUIRE(response.isCanceled() == false);
+        REQUIRE(response.getNumParts() == 1u);
+        REQUIRE(response.getPartAsString(0) == expected);
+    }
+
+    SECTION("Many concurrent requests")
+    {
+        std::vector<jobs::future<HTTPResponse>> results;
+        for (int i = 0; i < 32; ++i)
+            results.emplace_back(HTTPClient::getAsync(HTTPRequest(fileURL(path))));
+
+        for (auto& result : results)
+        {
+            const HTTPResponse& response = result.join();
+            REQUIRE(response.getNumParts() == 1u);
+            REQUIRE(response.getPartAsString(0) == expected);
+        }
+    }
+
+    SECTION("Missing file fails")
+    {
+        auto result = HTTPClient::getAsync(HTTPRequest(fileURL("../data/no_such_file.xyz")));
+        const HTTPResponse& response = result.join();
+
+        REQUIRE(result.available());
+        REQUIRE(response.getNumParts() == 0u);
+        REQUIRE(response.getMessage().empty() == false);
+    }
+
+    SECTION("Abandoned requests do not block others")
+    {
+        for (int i = 0; i < 16; ++i)
+            HTTPClient::getAsync(HTTPRequest(fileURL(path))); // dropped immediately
+
+        auto result = HTTPClient::getAsync(HTTPRequest(fileURL(path)));
+        REQUIRE(result.join().getPartAsString(0) == expected);
+    }
+}
@@ -8,6 +8,7 @@
 #include <osgEarth/ImageLayer>
 #include <osgEarth/Registry>
 #include <osgEarth/GDAL>
+#include <osgEarth/ImageUtils>
 
 using namespace osgEarth;
 
@@ -50,4 +51,59 @@ TEST_CASE("Attribution works")
 
     REQUIRE(status.isOK());
     REQUIRE(layer->getAttribution() == attribution);
-}
\ No newline at end of file
+}
+TEST_CASE("GDAL block cache reads match direct reads")
+{
+    const RasterInterpolation interpolations[] = {
+        INTERP_NEAREST, INTERP_BILINEAR, INTERP_CUBIC, INTERP_CUBICSPLINE
+    };
+
+    for (auto interpolation : interpolations)
+    {
+        osg::ref_ptr<GDALImageLayer> cached = new GDALImageLayer();
+        cached->setURL("../data/world.tif");
+        cached->setInterpolation(interpolation);
+        REQUIRE(cached->open().isOK());
+
+        osg::ref_ptr<GDALImageLayer> direct = new GDALImageLayer();
+        direct->setURL("../data/world.tif");
+        direct->setInterpolation(interpolation);
+        direct->options().blockCacheSize() = 0u;
+        REQUIRE(direct->open().isOK());
+
+        // high enough LODs that the reads upsample and go through the cache,
+        // including tiles on the raster's edges
+        const TileKey keys[] = {
+            TileKey(4, 0, 0, cached->getProfile()),
+            TileKey(4, 13, 5, cached->getProfile()),
+            TileKey(5, 63, 31, cached->getProfile()),
+            TileKey(6, 40, 20, cached->getProfile())
+        };
+
+        for (auto& key : keys)
+        {
+            INFO("interpolation " << (int)interpolation << " key " << key.str());
+
+            GeoImage a = cached->createImage(key);
+            GeoImage b = direct->createImage(key);
+            REQUIRE(a.valid());
+            REQUIRE(b.valid());
+            REQUIRE(a.getImage()->s() == b.getImage()->s());
+            REQUIRE(a.getImage()->t() == b.getImage()->t());
+
+            ImageUtils::PixelReader readA(a.getImage());
+            ImageUtils::PixelReader readB(b.getImage());
+            osg::Vec4f pa, pb;
+            for (int t = 0; t < a.getImage()->t(); ++t)
+            {
+                for (int s = 0; s < a.getImage()->s(); ++s)
+                {
+                    readA(pa, s, t);
+                    readB(pb, s, t);
+                    for (int c = 0; c < 4; ++c)
+                        REQUIRE(pa[c] == Approx(pb[c]).margin(1.0 / 255.0));
+                }
+            }
+        }
+    }
+}
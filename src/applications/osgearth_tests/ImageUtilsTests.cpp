@@ -0,0 +1,127 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/ImageUtils>
+#include <cstring>
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+namespace
+{
+    osg::Image* makeTestImage(GLenum pixelFormat, GLenum dataType, int s, int t)
+    {
+        osg::Image* image = new osg::Image();
+        image->allocateImage(s, t, 1, pixelFormat, dataType);
+        ImageUtils::PixelWriter write(image);
+        for (int y = 0; y < t; ++y)
+            for (int x = 0; x < s; ++x)
+                write(osg::Vec4(
+                    (float)((x * 7 + y) % 256) / 255.0f,
+                    (float)((x + y * 3) % 256) / 255.0f,
+                    (float)((x * y) % 256) / 255.0f,
+                    (float)((x + y) % 2 == 0 ? 255 : 128) / 255.0f), x, y);
+        return image;
+    }
+}
+
+TEST_CASE("PixelReader row reads match pixel reads")
+{
+    const GLenum formats[][2] = {
+        { GL_RGBA, GL_UNSIGNED_BYTE },
+        { GL_RGB, GL_UNSIGNED_BYTE },
+        { GL_LUMINANCE, GL_UNSIGNED_BYTE },
+        { GL_RED, GL_FLOAT },
+        { GL_RGBA, GL_FLOAT },
+        { GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE }
+    };
+
+    for (auto& format : formats)
+    {
+        osg::ref_ptr<osg::Image> image = makeTestImage(format[0], format[1], 37, 5);
+        ImageUtils::PixelReader read(image.get());
+        ImageUtils::PixelRow row;
+
+        for (int t = 0; t < image->t(); ++t)
+        {
+            read.readRow(row, t);
+            REQUIRE(row.size() >= (unsigned)image->s());
+            for (int s = 0; s < image->s(); ++s)
+            {
+                osg::Vec4f expected = read(s, t);
+                for (int c = 0; c < 4; ++c)
+                    REQUIRE(row.get(s)[c] == Approx(expected[c]).margin(1e-6));
+            }
+        }
+    }
+}
+
+TEST_CASE("RGBA8 conversion round trip is lossless")
+{
+    osg::ref_ptr<osg::Image> image = makeTestImage(GL_RGBA, GL_UNSIGNED_BYTE, 61, 7);
+    osg::ref_ptr<osg::Image> f = ImageUtils::convert(image.get(), GL_RGBA, GL_FLOAT);
+    REQUIRE(f.valid());
+    osg::ref_ptr<osg::Image> back = ImageUtils::convert(f.get(), GL_RGBA, GL_UNSIGNED_BYTE);
+    REQUIRE(back.valid());
+    REQUIRE(::memcmp(image->data(), back->data(), image->getTotalSizeInBytes()) == 0);
+}
+
+TEST_CASE("PixelWriter row writes match pixel writes")
+{
+    const GLenum formats[][2] = {
+        { GL_RGBA, GL_UNSIGNED_BYTE },
+        { GL_RGB, GL_UNSIGNED_BYTE },
+        { GL_LUMINANCE, GL_UNSIGNED_BYTE },
+        { GL_RED, GL_FLOAT },
+        { GL_RGBA, GL_FLOAT },
+        { GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE }
+    };
+
+    // values between 8-bit steps, exact halves, and out of range, so the
+    // rounding and clamping of both paths are exercised
+    const int width = 37;
+    ImageUtils::PixelRow row;
+    row.resize(width);
+    for (int s = 0; s < width; ++s)
+    {
+        row.set(s, osg::Vec4f(
+            -0.25f + 1.5f * (float)s / (float)(width - 1),
+            ((float)s + 0.5f) / 255.0f,
+            (float)(s * 13 % width) / (float)width,
+            1.0f - (float)s / (float)width));
+    }
+
+    for (auto& format : formats)
+    {
+        osg::ref_ptr<osg::Image> rowImage = new osg::Image();
+        rowImage->allocateImage(width, 1, 1, format[0], format[1]);
+        osg::ref_ptr<osg::Image> pixelImage = new osg::Image();
+        pixelImage->allocateImage(width, 1, 1, format[0], format[1]);
+
+        ImageUtils::PixelWriter writeRow(rowImage.get());
+        writeRow.writeRow(row, 0);
+
+        ImageUtils::PixelWriter writePixel(pixelImage.get());
+        for (int s = 0; s < width; ++s)
+            writePixel(row.get(s), s, 0);
+
+        INFO("format " << format[0] << " type " << format[1]);
+        REQUIRE(::memcmp(rowImage->data(), pixelImage->data(), rowImage->getTotalSizeInBytes()) == 0);
+    }
+}
+
+TEST_CASE("Row access on an empty reader and writer does nothing")
+{
+    ImageUtils::PixelReader read;
+    ImageUtils::PixelRow row;
+    read.readRow(row, 0);
+    REQUIRE(row.size() == 0u);
+
+    ImageUtils::PixelWriter write(nullptr);
+    row.resize(4);
+    write.writeRow(row, 0);
+}
@@ -0,0 +1,138 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/MBTiles>
+#include <osgEarth/ImageUtils>
+#include <osgEarth/Registry>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+using namespace osgEarth;
+
+namespace
+{
+    const char* MBTILES_FILE = "osgearth_tests_write_batch.mbtiles";
+
+    // small image whose pixels are unique to the tile key
+    osg::ref_ptr<osg::Image> createTileImage(const TileKey& key)
+    {
+        osg::ref_ptr<osg::Image> image = new osg::Image();
+        image->allocateImage(16, 16, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+        for (int t = 0; t < 16; ++t)
+        {
+            for (int s = 0; s < 16; ++s)
+            {
+                unsigned char* p = image->data(s, t);
+                p[0] = (unsigned char)(key.getLOD() * 40 + s);
+                p[1] = (unsigned char)(key.getTileX() * 16 + t);
+                p[2] = (unsigned char)(key.getTileY() * 16 + s);
+                p[3] = 255;
+            }
+        }
+        return image;
+    }
+
+    std::vector<TileKey> createKeys(const Profile* profile)
+    {
+        std::vector<TileKey> keys;
+        for (unsigned lod = 0; lod < 3; ++lod)
+        {
+            unsigned tx, ty;
+            profile->getNumTiles(lod, tx, ty);
+            for (unsigned y = 0; y < ty; ++y)
+                for (unsigned x = 0; x < tx; ++x)
+                    keys.emplace_back(lod, x, y, profile);
+        }
+        return keys;
+    }
+}
+
+TEST_CASE("MBTiles batched writes and pooled reads")
+{
+    Registry::instance();
+    std::remove(MBTILES_FILE);
+
+    osg::ref_ptr<const Profile> profile = Profile::create(Profile::GLOBAL_GEODETIC);
+    std::vector<TileKey> keys = createKeys(profile.get());
+
+    // write with a batch size that does not divide the tile count, so the
+    // final partial batch is only committed by the close-time flush.
+    {
+        MBTiles::Options options;
+        options.url() = URI(MBTILES_FILE);
+        options.format() = "png";
+        options.writeBatchSize() = 5u;
+
+        DataExtentList dataExtents;
+        MBTiles::Driver driver;
+        Status status = driver.open("test", options, true, options.format(), profile, dataExtents, nullptr);
+        REQUIRE(status.isOK());
+
+        for (auto& key : keys)
+        {
+            osg::ref_ptr<osg::Image> image = createTileImage(key);
+            REQUIRE(driver.write(key, image.get(), nullptr).isOK());
+        }
+    }
+
+    SECTION("All tiles survive the write batches")
+    {
+        MBTiles::Options options;
+        options.url() = URI(MBTILES_FILE);
+
+        osg::ref_ptr<const Profile> readProfile;
+        DataExtentList dataExtents;
+        MBTiles::Driver driver;
+        REQUIRE(driver.open("test", options, false, optional<std::string>(), readProfile, dataExtents, nullptr).isOK());
+
+        for (auto& key : keys)
+        {
+            INFO(key.str());
+            ReadResult r = driver.read(key, nullptr, nullptr);
+            REQUIRE(r.succeeded());
+            osg::ref_ptr<osg::Image> expected = createTileImage(key);
+            REQUIRE(ImageUtils::areEquivalent(r.getImage(), expected.get()));
+        }
+    }
+
+    SECTION("Concurrent reads on a connection pool")
+    {
+        MBTiles::Options options;
+        options.url() = URI(MBTILES_FILE);
+        options.readConnections() = 2u;
+
+        osg::ref_ptr<const Profile> readProfile;
+        DataExtentList dataExtents;
+        MBTiles::Driver driver;
+        REQUIRE(driver.open("test", options, false, optional<std::string>(), readProfile, dataExtents, nullptr).isOK());
+
+        // more threads than connections, so readers must wait on the pool
+        std::atomic_int failures(0);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 8; ++i)
+        {
+            threads.emplace_back([&]()
+                {
+                    for (auto& key : keys)
+                    {
+                        ReadResult r = driver.read(key, nullptr, nullptr);
+                        osg::ref_ptr<osg::Image> expected = createTileImage(key);
+                        if (!r.succeeded() || !ImageUtils::areEquivalent(r.getImage(), expected.get()))
+                            ++failures;
+                    }
+                });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        REQUIRE(failures == 0);
+    }
+
+    std::remove(MBTILES_FILE);
+}
@@ -0,0 +1,199 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/MVT>
+
+#ifdef OSGEARTH_HAVE_MVT
+
+#include <osgEarth/Geometry>
+#include <osgEarth/TileKey>
+#include <cstring>
+
+using namespace osgEarth;
+
+namespace
+{
+    // Minimal protobuf writer for building vector tiles by hand
+    struct PbfWriter
+    {
+        std::string buf;
+
+        void varint(std::uint64_t v)
+        {
+            while (v >= 0x80)
+            {
+                buf.push_back((char)((v & 0x7f) | 0x80));
+                v >>= 7;
+            }
+            buf.push_back((char)v);
+        }
+
+        void key(unsigned field, unsigned wire) { varint((field << 3) | wire); }
+
+        void uint(unsigned field, std::uint64_t v) { key(field, 0); varint(v); }
+
+        void sint(unsigned field, std::int64_t v) { key(field, 0); varint((std::uint64_t)((v << 1) ^ (v >> 63))); }
+
+        void bytes(unsigned field, const std::string& v) { key(field, 2); varint(v.size()); buf += v; }
+
+        void fixed64(unsigned field, double v) { key(field, 1); char b[8]; std::memcpy(b, &v, 8); buf.append(b, 8); }
+
+        void fixed32(unsigned field, float v) { key(field, 5); char b[4]; std::memcpy(b, &v, 4); buf.append(b, 4); }
+
+        void packed(unsigned field, const std::vector<std::uint32_t>& values)
+        {
+            PbfWriter p;
+            for (auto v : values)
+                p.varint(v);
+            bytes(field, p.buf);
+        }
+    };
+
+    std::uint32_t zz(int v) { return (std::uint32_t)((v << 1) ^ (v >> 31)); }
+    std::uint32_t command(unsigned id, unsigned count) { return (id & 0x7) | (count << 3); }
+
+    std::string value(const std::function<void(PbfWriter&)>& write)
+    {
+        PbfWriter v;
+        write(v);
+        return v.buf;
+    }
+
+    // Layer "roads": one line with every kind of value, in the usual order.
+    // Layer "buildings": one square polygon, with the features written before
+    // the keys and values (which the spec allows).
+    std::string buildTile()
+    {
+        PbfWriter road;
+        road.uint(1, 300); // id (two-byte varint)
+        road.packed(2, { 0,0, 1,1, 2,2, 3,3, 4,4, 5,5 });
+        road.uint(3, 2); // LineString
+        road.packed(4, {
+            command(1, 1), zz(10), zz(20),                     // MoveTo (10,20)
+            command(2, 2), zz(30), zz(-5), zz(-15), zz(40) }); // LineTo (40,15) (25,55)
+
+        PbfWriter roads;
+        roads.uint(15, 2); // version
+        roads.bytes(1, "roads");
+        roads.bytes(2, road.buf);
+        for (auto& k : { "name", "lanes", "offset", "oneway", "width", "grade" })
+            roads.bytes(3, k);
+        roads.bytes(4, value([](PbfWriter& v) { v.bytes(1, "Main St"); }));
+        roads.bytes(4, value([](PbfWriter& v) { v.uint(5, 2); }));
+        roads.bytes(4, value([](PbfWriter& v) { v.sint(6, -3); }));
+        roads.bytes(4, value([](PbfWriter& v) { v.uint(7, 1); }));
+        roads.bytes(4, value([](PbfWriter& v) { v.fixed64(3, 12.5); }));
+        roads.bytes(4, value([](PbfWriter& v) { v.fixed32(2, 1.5f); }));
+        roads.uint(5, 4096); // extent (two-byte varint)
+
+        PbfWriter building;
+        building.uint(1, 5);
+        building.packed(2, { 0,0 });
+        building.uint(3, 3); // Polygon
+        building.packed(4, {
+            command(1, 1), zz(100), zz(100),
+            command(2, 3), zz(100), zz(0), zz(0), zz(100), zz(-100), zz(0),
+            command(7, 1) });
+
+        PbfWriter buildings;
+        buildings.bytes(1, "buildings");
+        buildings.bytes(2, building.buf);
+        buildings.bytes(3, "height");
+        buildings.bytes(4, value([](PbfWriter& v) { v.fixed64(3, 30.0); }));
+        buildings.uint(5, 4096);
+
+        PbfWriter tile;
+        tile.bytes(3, roads.buf);
+        tile.bytes(3, buildings.buf);
+        return tile.buf;
+    }
+
+    const Feature* findLayer(const FeatureList& features, const std::string& layer)
+    {
+        for (auto& f : features)
+            if (f->getString("mvt_layer") == layer)
+                return f.get();
+        return nullptr;
+    }
+}
+
+TEST_CASE("MVT decodes a hand-built tile")
+{
+    const std::string tile = buildTile();
+    TileKey key(0, 0, 0, Profile::create(Profile::GLOBAL_GEODETIC));
+    const GeoExtent& extent = key.getExtent();
+
+    auto toMap = [&](double x, double y) {
+        return osg::Vec3d(
+            extent.xMin() + extent.width() * x / 4096.0,
+            extent.yMax() - extent.height() * y / 4096.0,
+            0.0);
+    };
+
+    SECTION("All layers")
+    {
+        FeatureList features;
+        REQUIRE(MVT::readTile(tile.data(), tile.size(), key, features));
+        REQUIRE(features.size() == 2u);
+
+        const Feature* road = findLayer(features, "roads");
+        REQUIRE(road != nullptr);
+        REQUIRE(road->getFID() == 300);
+        REQUIRE(road->getString("name") == "Main St");
+        REQUIRE(road->getInt("lanes") == 2);
+        REQUIRE(road->getInt("offset") == -3);
+        REQUIRE(road->getBool("oneway") == true);
+        REQUIRE(road->getDouble("width") == 12.5);
+        REQUIRE(road->getDouble("grade") == 1.5);
+
+        const Geometry* line = road->getGeometry();
+        REQUIRE(line->getType() == Geometry::TYPE_LINESTRING);
+        REQUIRE(line->size() == 3u);
+        REQUIRE(((*line)[0] - toMap(10, 20)).length() < 1e-9);
+        REQUIRE(((*line)[1] - toMap(40, 15)).length() < 1e-9);
+        REQUIRE(((*line)[2] - toMap(25, 55)).length() < 1e-9);
+
+        const Feature* building = findLayer(features, "buildings");
+        REQUIRE(building != nullptr);
+        REQUIRE(building->getFID() == 5);
+        REQUIRE(building->getDouble("height") == 30.0);
+
+        const Geometry* polygon = building->getGeometry();
+        REQUIRE(polygon->getType() == Geometry::TYPE_POLYGON);
+        osg::BoundingBoxd bounds = polygon->getBounds();
+        REQUIRE(bounds.xMin() == Approx(toMap(100, 100).x()));
+        REQUIRE(bounds.xMax() == Approx(toMap(200, 200).x()));
+        REQUIRE(bounds.yMin() == Approx(toMap(200, 200).y()));
+        REQUIRE(bounds.yMax() == Approx(toMap(100, 100).y()));
+    }
+
+    SECTION("Layer selection")
+    {
+        FeatureList features;
+        REQUIRE(MVT::readTile(tile.data(), tile.size(), key, features, { "buildings" }));
+        REQUIRE(features.size() == 1u);
+        REQUIRE(features[0]->getString("mvt_layer") == "buildings");
+    }
+
+    SECTION("Feature filter")
+    {
+        FeatureList features;
+        REQUIRE(MVT::readTile(tile.data(), tile.size(), key, features, {},
+            [](const std::string&, int geometryType) { return geometryType == 2; }));
+        REQUIRE(features.size() == 1u);
+        REQUIRE(features[0]->getString("mvt_layer") == "roads");
+    }
+
+    SECTION("Truncated tile fails cleanly")
+    {
+        FeatureList features;
+        REQUIRE(MVT::readTile(tile.data(), tile.size() - 3, key, features) == false);
+        REQUIRE(features.empty());
+    }
+}
+
+#endif // OSGEARTH_HAVE_MVT
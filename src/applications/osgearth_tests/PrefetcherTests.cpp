@@ -0,0 +1,144 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarthDrivers/engine_rex/PrefetchQueue>
+#include <osgEarth/Profile>
+#include <atomic>
+#include <cfloat>
+#include <functional>
+
+using namespace osgEarth;
+using namespace osgEarth::REX;
+
+namespace
+{
+    // Loads run only when the test takes them from this pool, since it is
+    // constructed directly and starts no threads.
+    struct TestPool
+    {
+        jobs::jobpool pool{ "oe.test.prefetch", 1u };
+
+        bool take(jobs::detail::job& job) {
+            return pool._take_job(job, true);
+        }
+    };
+}
+
+TEST_CASE("Prefetch queue")
+{
+    osg::ref_ptr<const Profile> profile = Profile::create(Profile::GLOBAL_GEODETIC);
+    TileKey key(5, 10, 12, profile.get());
+
+    std::atomic_int loads = { 0 };
+    PrefetchQueue::Loader load = [&loads, key](Cancelable&)
+    {
+        ++loads;
+        return PrefetchQueue::Result(new TerrainTileModel(key, 0));
+    };
+
+    PrefetchQueue queue;
+    TestPool test;
+    jobs::detail::job job;
+    Threading::Future<PrefetchQueue::Result> out;
+    std::function<float()> anyPriority = []() { return 1.0f; };
+
+    SECTION("Claiming a finished load is a hit")
+    {
+        REQUIRE(queue.issue(key, load, 1u, &test.pool));
+        REQUIRE(queue.issue(key, load, 1u, &test.pool) == false);
+        REQUIRE(queue.size() == 1u);
+
+        REQUIRE(test.take(job));
+        REQUIRE(job._delegate());
+        REQUIRE(loads == 1);
+
+        REQUIRE(queue.claim(key, anyPriority, out));
+        REQUIRE(out.available());
+        REQUIRE(out.value()->key == key);
+        REQUIRE(queue.size() == 0u);
+        REQUIRE(queue.getStats().hits == 1u);
+        REQUIRE(queue.getStats().lateHits == 0u);
+    }
+
+    SECTION("Claiming a pending load adopts the tile's live priority")
+    {
+        std::atomic<float> tilePriority = { 5.0f };
+        std::atomic_bool tileReleased = { false };
+        std::function<float()> priority = [&]() { return tileReleased ? FLT_MAX : tilePriority.load(); };
+
+        REQUIRE(queue.issue(key, load, 1u, &test.pool));
+        REQUIRE(test.take(job));
+
+        // speculative loads sit below every real request
+        REQUIRE(job.evaluate_priority() < 0.0f);
+
+        REQUIRE(queue.claim(key, priority, out));
+        REQUIRE(out.working());
+        REQUIRE(queue.getStats().lateHits == 1u);
+
+        REQUIRE(job.evaluate_priority() == 5.0f);
+        tilePriority = 2.0f;
+        REQUIRE(job.evaluate_priority() == 2.0f);
+        tileReleased = true;
+        REQUIRE(job.evaluate_priority() == FLT_MAX);
+
+        // the claimed load still delivers to the tile
+        REQUIRE(job._delegate());
+        REQUIRE(out.available());
+        REQUIRE(loads == 1);
+    }
+
+    SECTION("Loads that leave the predicted path are canceled")
+    {
+        REQUIRE(queue.issue(key, load, 1u, &test.pool));
+
+        // still predicted, or not moving: keep it
+        REQUIRE(queue.touch(key, 4u));
+        queue.prune(5u, true, 2u, 60u);
+        queue.prune(10u, false, 2u, 60u);
+        REQUIRE(queue.size() == 1u);
+
+        queue.prune(10u, true, 2u, 60u);
+        REQUIRE(queue.size() == 0u);
+        REQUIRE(queue.getStats().canceled == 1u);
+
+        // the job is abandoned, so it never runs the load
+        REQUIRE(test.take(job));
+        REQUIRE(job._delegate() == false);
+        REQUIRE(loads == 0);
+
+        REQUIRE(queue.claim(key, anyPriority, out) == false);
+        REQUIRE(queue.touch(key, 11u) == false);
+    }
+
+    SECTION("Unclaimed results expire")
+    {
+        REQUIRE(queue.issue(key, load, 1u, &test.pool));
+        REQUIRE(test.take(job));
+        REQUIRE(job._delegate());
+
+        queue.prune(30u, true, 2u, 60u);
+        REQUIRE(queue.size() == 1u);
+
+        queue.prune(62u, false, 2u, 60u);
+        REQUIRE(queue.size() == 0u);
+        REQUIRE(queue.getStats().expired == 1u);
+    }
+
+    SECTION("Claimed keys are not prefetched until forgotten")
+    {
+        REQUIRE(queue.claim(key, anyPriority, out) == false);
+        REQUIRE(queue.issue(key, load, 1u, &test.pool) == false);
+
+        queue.forget(key);
+        REQUIRE(queue.issue(key, load, 2u, &test.pool));
+        REQUIRE(queue.getStats().issued == 1u);
+
+        queue.clear();
+        REQUIRE(queue.size() == 0u);
+    }
+}
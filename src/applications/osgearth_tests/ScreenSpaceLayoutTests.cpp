@@ -0,0 +1,141 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/ScreenSpaceLayoutOccupancy>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace osgEarth;
+using namespace osgEarth::Internal;
+
+namespace
+{
+    struct Label
+    {
+        const osg::Node* parent;
+        osg::BoundingBox box;
+    };
+
+    osg::BoundingBox makeBox(float x, float y, float width, float height)
+    {
+        return osg::BoundingBox(x, y, 0.0f, x + width, y + height, 0.0f);
+    }
+
+    // The original declutter test: compare against every box placed so far.
+    bool overlapsBruteForce(const std::vector<RenderLeafBox>& used, const osg::BoundingBox& box, const osg::Node* parent)
+    {
+        for (auto& j : used)
+        {
+            bool isClear =
+                box.xMin() > j.second.xMax() ||
+                box.xMax() < j.second.xMin() ||
+                box.yMin() > j.second.yMax() ||
+                box.yMax() < j.second.yMin();
+
+            if (!isClear && parent != j.first)
+                return true;
+        }
+        return false;
+    }
+
+    // Greedy placement as in the declutter pass; returns which labels are visible.
+    std::vector<bool> placeBruteForce(const std::vector<Label>& labels)
+    {
+        std::vector<RenderLeafBox> used;
+        std::vector<bool> visible;
+        for (auto& label : labels)
+        {
+            bool clear = !overlapsBruteForce(used, label.box, label.parent);
+            if (clear)
+                used.emplace_back(label.parent, label.box);
+            visible.push_back(clear);
+        }
+        return visible;
+    }
+
+    std::vector<bool> placeWithGrid(OccupancyGrid& grid, const std::vector<Label>& labels)
+    {
+        std::vector<bool> visible;
+        for (auto& label : labels)
+        {
+            bool clear = !grid.overlaps(label.box, label.parent);
+            if (clear)
+                grid.insert(label.parent, label.box);
+            visible.push_back(clear);
+        }
+        return visible;
+    }
+}
+
+TEST_CASE("Declutter occupancy grid matches the brute-force overlap test")
+{
+    std::vector<osg::ref_ptr<osg::Node>> parents;
+    for (int i = 0; i < 50; ++i)
+        parents.push_back(new osg::Node());
+
+    OccupancyGrid grid;
+
+    SECTION("Hand-picked boxes")
+    {
+        std::vector<Label> labels = {
+            { parents[0].get(), makeBox(10, 10, 100, 20) },
+            { parents[1].get(), makeBox(50, 15, 100, 20) },    // overlaps the first
+            { parents[0].get(), makeBox(60, 12, 30, 30) },     // same parent as the first
+            { parents[2].get(), makeBox(110, 30, 20, 20) },    // touches a corner of the first
+            { parents[3].get(), makeBox(111, 31, 10, 10) },    // inside the one it would touch
+            { parents[4].get(), makeBox(-80, -40, 100, 30) },  // off the lower left
+            { parents[5].get(), makeBox(900, 700, 300, 200) }, // off the upper right
+            { parents[6].get(), makeBox(-500, 300, 2000, 5) }, // spans the window
+            { parents[7].get(), makeBox(400, 290, 10, 10) },   // touches that from below
+            { parents[8].get(), makeBox(400, 200, 10, 10) },
+            { parents[9].get(), makeBox(127.5f, 127.5f, 1, 1) },
+            { parents[10].get(), makeBox(128, 128, 1, 1) },    // overlaps across a cell line
+        };
+
+        grid.reset(0, 0, 1024, 768);
+        auto expected = placeBruteForce(labels);
+        REQUIRE(placeWithGrid(grid, labels) == expected);
+
+        REQUIRE(expected == std::vector<bool>({
+            true, false, true, false, true, true, true, true, false, true, true, false }));
+    }
+
+    SECTION("Many labels")
+    {
+        std::mt19937 gen(1234u);
+        std::uniform_real_distribution<float> x(-100.0f, 2020.0f);
+        std::uniform_real_distribution<float> y(-100.0f, 1180.0f);
+        std::uniform_real_distribution<float> size(2.0f, 180.0f);
+        std::uniform_int_distribution<int> parent(0, (int)parents.size() - 1);
+
+        std::vector<Label> labels;
+        for (int i = 0; i < 4000; ++i)
+        {
+            // snap some to whole pixels so edges meet exactly
+            float lx = x(gen), ly = y(gen);
+            if (i % 3 == 0)
+                lx = std::floor(lx), ly = std::floor(ly);
+            labels.push_back({ parents[parent(gen)].get(), makeBox(lx, ly, size(gen), 0.25f * size(gen)) });
+        }
+
+        grid.reset(0, 0, 1920, 1080);
+        auto expected = placeBruteForce(labels);
+
+        // plenty of labels are placed and plenty are decluttered
+        unsigned placed = (unsigned)std::count(expected.begin(), expected.end(), true);
+        REQUIRE(placed > 100u);
+        REQUIRE(placed < labels.size() / 2u);
+
+        REQUIRE(placeWithGrid(grid, labels) == expected);
+
+        // a reset grid, even with a different viewport, starts over cleanly
+        grid.reset(100, 50, 800, 600);
+        REQUIRE(placeWithGrid(grid, labels) == expected);
+    }
+}
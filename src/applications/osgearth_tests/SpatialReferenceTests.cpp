@@ -5,7 +5,9 @@
 
 #include <osgEarth/catch.hpp>
 #include <cmath>
+#include <algorithm>
 #include <osgEarth/SpatialReference>
+#include <osgEarth/ReprojectionGrid>
 
 using namespace osgEarth;
 
@@ -208,3 +210,37 @@ TEST_CASE("MFE SRS") {
     REQUIRE(p_wgs84.x() == -157.0);
     REQUIRE(p_wgs84.y() == 21.0);
 }
+
+TEST_CASE("ReprojectionGrid matches an exact transform") {
+    const SpatialReference* merc = SpatialReference::get("spherical-mercator");
+    const SpatialReference* wgs84 = SpatialReference::get("wgs84");
+
+    // a mid-latitude 256x256 tile in mercator
+    const unsigned cols = 256, rows = 256;
+    double xmin = 1000000.0, ymin = 5000000.0, xmax = 1156543.0, ymax = 5156543.0;
+    double dx = (xmax - xmin) / (double)(cols - 1);
+    double dy = (ymax - ymin) / (double)(rows - 1);
+
+    std::vector<osg::Vec3d> exact(cols * rows);
+    for (unsigned t = 0; t < rows; ++t)
+        for (unsigned s = 0; s < cols; ++s)
+            exact[t * cols + s].set(xmin + dx * (double)s, ymin + dy * (double)t, 0.0);
+    REQUIRE(merc->transform(exact, wgs84));
+
+    std::vector<osg::Vec3d> approx;
+    REQUIRE(ReprojectionGrid::transform(merc, wgs84, xmin, ymin, xmax, ymax, cols, rows, approx));
+    REQUIRE(approx.size() == exact.size());
+
+    // sample spacing in degrees along each axis, roughly
+    double spacing = std::abs(exact[1].x() - exact[0].x());
+    double maxError = 0.0;
+    for (unsigned i = 0; i < exact.size(); ++i)
+        maxError = std::max(maxError, (approx[i] - exact[i]).length());
+
+    REQUIRE(maxError <= ReprojectionGrid::getTolerance() * spacing);
+
+    // second call comes from the cache and must agree
+    std::vector<osg::Vec3d> again;
+    REQUIRE(ReprojectionGrid::transform(merc, wgs84, xmin, ymin, xmax, ymax, cols, rows, again));
+    REQUIRE(again == approx);
+}
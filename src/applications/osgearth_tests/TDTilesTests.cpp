@@ -0,0 +1,88 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/TDTiles>
+#include <osgEarth/JsonUtils>
+
+using namespace osgEarth;
+using namespace osgEarth::Contrib::ThreeDTiles;
+
+namespace
+{
+    const char* tilesetJSON = R"({
+        "asset": { "version": "1.0", "gltfUpAxis": "Z" },
+        "geometricError": 500,
+        "root": {
+            "boundingVolume": { "sphere": [ 1.0, 2.0, 3.0, 100.0 ] },
+            "geometricError": 100.5,
+            "refine": "REPLACE",
+            "transform": [ 1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  10, 20, 30, 1 ],
+            "extras": { "note": "skipped \"unread\" member", "list": [ [], {} ] },
+            "children": [
+                {
+                    "boundingVolume": { "sphere": [ 1.0, 2.0, 3.0, 50.0 ] },
+                    "geometricError": 0,
+                    "refine": "add",
+                    "content": { "uri": "tiles/0.b3dm" }
+                },
+                {
+                    "boundingVolume": { "sphere": [ 4.0, 5.0, 6.0, 50.0 ] },
+                    "geometricError": 0,
+                    "content": { "url": "tiles/1.json" },
+                    "children": [ { "geometricError": 0 } ]
+                }
+            ]
+        }
+    })";
+}
+
+TEST_CASE("3D Tiles tileset reads through a lazy JSON document")
+{
+    osg::ref_ptr<Tileset> tileset = Tileset::create(tilesetJSON, URIContext("http://example.com/data/tileset.json"));
+    REQUIRE(tileset.valid());
+
+    SECTION("Members")
+    {
+        REQUIRE(tileset->asset()->version() == "1.0");
+        REQUIRE(tileset->asset()->gltfUpAxis() == "Z");
+        REQUIRE(tileset->geometricError() == 500.0);
+
+        Tile* root = tileset->root().get();
+        REQUIRE(root != nullptr);
+        REQUIRE(root->geometricError() == 100.5);
+        REQUIRE(root->refine() == REFINE_REPLACE);
+        REQUIRE(root->boundingVolume()->sphere()->radius() == 100.0);
+        REQUIRE(root->transform()->getTrans() == osg::Vec3d(10, 20, 30));
+
+        REQUIRE(root->children().size() == 2u);
+        REQUIRE(root->children()[0]->refine() == REFINE_ADD);
+        REQUIRE(root->children()[0]->content()->uri()->full() == "http://example.com/data/tiles/0.b3dm");
+        REQUIRE(root->children()[1]->content()->uri()->full() == "http://example.com/data/tiles/1.json");
+        REQUIRE(root->children()[1]->children().size() == 1u);
+    }
+
+    SECTION("Same result as a fully parsed document")
+    {
+        Json::Reader reader;
+        Json::Value value;
+        REQUIRE(reader.parse(tilesetJSON, value, false));
+
+        LoadContext lc;
+        lc._uc = URIContext("http://example.com/data/tileset.json");
+        osg::ref_ptr<Tileset> parsed = new Tileset(value, lc);
+
+        Json::FastWriter writer;
+        REQUIRE(writer.write(tileset->getJSON()) == writer.write(parsed->getJSON()));
+    }
+
+    SECTION("Not a tileset")
+    {
+        REQUIRE(Tileset::create("", URIContext()) == nullptr);
+        REQUIRE(Tileset::create("[ 1, 2 ]", URIContext()) == nullptr);
+        REQUIRE(Tileset::create("{ \"root\": ", URIContext()) == nullptr);
+    }
+}
@@ -0,0 +1,168 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/TerrainTileModelFactory>
+#include <osgEarth/DebugImageLayer>
+#include <osgEarth/GDAL>
+#include <osgEarth/Map>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+namespace
+{
+    // Image layer that either stalls until its progress is canceled, or
+    // cancels its own progress with a retry delay (like a network error).
+    class StallingImageLayer : public DebugImageLayer
+    {
+    public:
+        bool cancelItself = false;
+        mutable std::atomic_int calls{ 0 };
+
+        GeoImage createImageImplementation(const TileKey& key, ProgressCallback* progress) const override
+        {
+            ++calls;
+            if (cancelItself)
+            {
+                progress->setRetryDelay(3.0f);
+                progress->cancel();
+                return GeoImage::INVALID;
+            }
+
+            while (progress && !progress->isCanceled())
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+            return GeoImage::INVALID;
+        }
+    };
+
+    osg::ref_ptr<Map> createMap()
+    {
+        osg::ref_ptr<Map> map = new Map();
+
+        GDALImageLayer* world = new GDALImageLayer();
+        world->setURL("../data/world.tif");
+        map->addLayer(world);
+
+        map->addLayer(new DebugImageLayer());
+
+        GDALElevationLayer* elevation = new GDALElevationLayer();
+        elevation->setURL("../data/mt_fuji_90m.tif");
+        map->addLayer(elevation);
+
+        return map;
+    }
+}
+
+TEST_CASE("TerrainTileModelFactory parallel layer loading")
+{
+    TerrainEngineRequirements requirements;
+    requirements.landCoverTextures = false;
+
+    SECTION("Parallel and sequential loads build the same model")
+    {
+        osg::ref_ptr<Map> map = createMap();
+        TileKey key(3, 14, 2, map->getProfile()); // covers Mt. Fuji
+
+        TerrainOptions sequentialOptions;
+        sequentialOptions.loadLayersInParallel() = false;
+        TerrainOptions parallelOptions;
+        parallelOptions.loadLayersInParallel() = true;
+
+        // on the stack, like osgearth_createtile does
+        TerrainTileModelFactory sequentialFactory(sequentialOptions);
+        TerrainTileModelFactory parallelFactory(parallelOptions);
+
+        osg::ref_ptr<TerrainTileModel> expected = sequentialFactory.createTileModel(
+            map.get(), key, CreateTileManifest(), requirements, nullptr);
+        osg::ref_ptr<TerrainTileModel> actual = parallelFactory.createTileModel(
+            map.get(), key, CreateTileManifest(), requirements, nullptr);
+
+        REQUIRE(expected.valid());
+        REQUIRE(actual.valid());
+        REQUIRE(actual->colorLayers.size() == expected->colorLayers.size());
+        for (unsigned i = 0; i < actual->colorLayers.size(); ++i)
+        {
+            INFO("color layer " << i);
+            REQUIRE(actual->colorLayers[i].layer == expected->colorLayers[i].layer);
+            REQUIRE((actual->colorLayers[i].texture != nullptr) == (expected->colorLayers[i].texture != nullptr));
+        }
+        REQUIRE(actual->sharedLayerIndices == expected->sharedLayerIndices);
+        REQUIRE((actual->elevation.texture != nullptr) == (expected->elevation.texture != nullptr));
+    }
+
+    SECTION("A layer that times out cancels the tile for a retry")
+    {
+        osg::ref_ptr<Map> map = createMap();
+        osg::ref_ptr<StallingImageLayer> stalling = new StallingImageLayer();
+        map->addLayer(stalling.get());
+
+        TerrainOptions options;
+        options.loadLayersInParallel() = true;
+        options.layerLoadTimeout() = 0.1;
+        TerrainTileModelFactory factory(options);
+
+        osg::ref_ptr<ProgressCallback> progress = new ProgressCallback();
+        auto t0 = std::chrono::steady_clock::now();
+        osg::ref_ptr<TerrainTileModel> model = factory.createTileModel(
+            map.get(), TileKey(1, 1, 0, map->getProfile()), CreateTileManifest(), requirements, progress.get());
+        auto elapsed = std::chrono::steady_clock::now() - t0;
+
+        REQUIRE(stalling->calls > 0);
+        REQUIRE(progress->isCanceled());
+        REQUIRE(progress->getRetryDelay() >= Approx(0.1f));
+        REQUIRE(elapsed < std::chrono::seconds(10));
+    }
+
+    SECTION("A layer that cancels itself passes its retry delay to the caller")
+    {
+        osg::ref_ptr<Map> map = createMap();
+        osg::ref_ptr<StallingImageLayer> failing = new StallingImageLayer();
+        failing->cancelItself = true;
+        map->addLayer(failing.get());
+
+        TerrainOptions options;
+        options.loadLayersInParallel() = true;
+        TerrainTileModelFactory factory(options);
+
+        osg::ref_ptr<ProgressCallback> progress = new ProgressCallback();
+        osg::ref_ptr<TerrainTileModel> model = factory.createTileModel(
+            map.get(), TileKey(1, 1, 0, map->getProfile()), CreateTileManifest(), requirements, progress.get());
+
+        REQUIRE(failing->calls > 0);
+        REQUIRE(progress->isCanceled());
+        REQUIRE(progress->getRetryDelay() == Approx(3.0f));
+    }
+
+    SECTION("Canceling the caller's progress stops stalled layers")
+    {
+        osg::ref_ptr<Map> map = createMap();
+        osg::ref_ptr<StallingImageLayer> stalling = new StallingImageLayer();
+        map->addLayer(stalling.get());
+
+        TerrainOptions options;
+        options.loadLayersInParallel() = true;
+        TerrainTileModelFactory factory(options);
+
+        osg::ref_ptr<ProgressCallback> progress = new ProgressCallback();
+        std::thread canceler([progress]()
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                progress->cancel();
+            });
+
+        osg::ref_ptr<TerrainTileModel> model = factory.createTileModel(
+            map.get(), TileKey(1, 1, 0, map->getProfile()), CreateTileManifest(), requirements, progress.get());
+
+        canceler.join();
+        REQUIRE(progress->isCanceled());
+    }
+}
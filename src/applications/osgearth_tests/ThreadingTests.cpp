@@ -5,10 +5,195 @@
 
 #include <osgEarth/catch.hpp>
 #include <osgEarth/Threading>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
 #include <thread>
+#include <vector>
 
 using namespace osgEarth;
 
+namespace
+{
+    // queue a job with a priority function on a pool that has no running threads
+    void queue(jobs::jobpool& pool, std::function<float()> priority)
+    {
+        std::function<bool()> delegate = []() { return true; };
+        jobs::context context;
+        context.priority = priority;
+        pool._dispatch_delegate(delegate, context);
+    }
+}
+
+TEST_CASE("Batched job scheduling takes the highest priority first")
+{
+    // constructed directly so no threads start and the queue stays put
+    jobs::jobpool pool("oe.test.scheduling", 1);
+    pool.set_scheduling(jobs::scheduling::batched);
+    pool.set_reprioritize_interval(std::chrono::milliseconds(60000));
+
+    std::vector<float> priorities = { 3.0f, 1.0f, 4.0f, 1.5f, 9.0f, 2.6f };
+    for (unsigned i = 0; i < priorities.size(); ++i)
+        queue(pool, [&priorities, i]() { return priorities[i]; });
+
+    // the 9 job's priority falls after it was queued; the take re-checks it
+    priorities[4] = 0.5f;
+
+    std::vector<float> order;
+    jobs::detail::job job;
+    while (pool._take_job(job, true))
+        order.push_back(job.evaluate_priority());
+
+    REQUIRE(order == std::vector<float>({ 4.0f, 3.0f, 2.6f, 1.5f, 1.0f, 0.5f }));
+    REQUIRE(pool.metrics()->pending == 0u);
+}
+
+TEST_CASE("Batched job scheduling runs every job")
+{
+    auto pool = jobs::get_pool("oe.test.batched", 4);
+    pool->set_scheduling(jobs::scheduling::batched);
+
+    std::atomic_int count = { 0 };
+    jobs::context context;
+    context.pool = pool;
+    context.group = jobs::jobgroup::create();
+    context.priority = []() { return 1.0f; };
+
+    for (int i = 0; i < 2000; ++i)
+        jobs::dispatch([&count]() { ++count; }, context);
+
+    context.group->join();
+    REQUIRE(count == 2000);
+}
+
+TEST_CASE("Batched jobs queued behind a blocking job still run")
+{
+    auto pool = jobs::get_pool("oe.test.batched.blocking", 2);
+    pool->set_scheduling(jobs::scheduling::batched);
+
+    const int count = 64;
+    std::atomic_int done = { 0 };
+    std::atomic_bool unblocked = { false };
+
+    jobs::context context;
+    context.pool = pool;
+    context.group = jobs::jobgroup::create();
+
+    context.priority = []() { return 1.0f; };
+    for (int i = 0; i < count; ++i)
+    {
+        jobs::dispatch([&done]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++done;
+        }, context);
+    }
+
+    // The blocking job jumps the queue, so the worker that takes it also pulls
+    // a batch of the others into its deque. Only a sibling can run those.
+    context.priority = []() { return 100.0f; };
+    jobs::dispatch([&]() {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (done < count && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        unblocked = (done == count);
+    }, context);
+
+    context.group->join();
+    REQUIRE(unblocked);
+    REQUIRE(done == count);
+}
+
+TEST_CASE("parallelFor covers every index exactly once")
+{
+    const unsigned count = 10000;
+
+    SECTION("Chunks")
+    {
+        std::vector<std::atomic_int> hits(count);
+        for (auto& h : hits) h = 0;
+        std::atomic_int oversized = { 0 };
+
+        Threading::parallelFor("test", count, 16u, 7u, [&](unsigned begin, unsigned end)
+            {
+                if (end - begin > 7u) ++oversized;
+                for (unsigned i = begin; i < end; ++i)
+                    ++hits[i];
+            });
+
+        unsigned wrong = 0;
+        for (auto& h : hits)
+            if (h != 1) ++wrong;
+        REQUIRE(wrong == 0u);
+        REQUIRE(oversized == 0);
+    }
+
+    SECTION("Too little work runs inline")
+    {
+        std::vector<std::pair<unsigned, unsigned>> calls;
+        Threading::parallelFor("test", 20u, 16u, 1u, [&](unsigned begin, unsigned end)
+            {
+                calls.emplace_back(begin, end);
+            });
+        REQUIRE(calls.size() == 1u);
+        REQUIRE(calls[0] == std::make_pair(0u, 20u));
+    }
+
+    SECTION("Nested calls finish")
+    {
+        // every helper thread can end up blocked in an inner call; the
+        // callers must still finish the work themselves
+        std::atomic_int total = { 0 };
+        Threading::parallelFor("test", 64u, 1u, 1u, [&](unsigned begin, unsigned end)
+            {
+                for (unsigned i = begin; i < end; ++i)
+                {
+                    Threading::parallelFor("test.inner", 1000u, 1u, 10u, [&](unsigned b, unsigned e)
+                        {
+                            total += (int)(e - b);
+                        });
+                }
+            });
+        REQUIRE(total == 64 * 1000);
+    }
+}
+
+// Hidden benchmark; run with: osgearth_tests "[benchmark]"
+TEST_CASE("Job dequeue cost with many pending jobs", "[.][benchmark]")
+{
+    const unsigned takes = 1000;
+
+    for (unsigned pending : { 10000u, 100000u })
+    {
+        std::vector<float> priorities(pending);
+        std::mt19937 gen(pending);
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        for (auto& p : priorities)
+            p = dist(gen);
+
+        for (auto mode : { jobs::scheduling::exact, jobs::scheduling::batched })
+        {
+            jobs::jobpool pool("oe.test.dequeue", 1);
+            pool.set_scheduling(mode);
+
+            for (unsigned i = 0; i < pending; ++i)
+                queue(pool, [&priorities, i]() { return priorities[i]; });
+
+            jobs::detail::job job;
+            auto t0 = std::chrono::steady_clock::now();
+            for (unsigned i = 0; i < takes; ++i)
+                REQUIRE(pool._take_job(job, true));
+            auto t1 = std::chrono::steady_clock::now();
+
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+            std::cout
+                << (mode == jobs::scheduling::exact ? "exact  " : "batched")
+                << " pending=" << pending
+                << " dequeue=" << (ns / takes) << " ns/job" << std::endl;
+        }
+    }
+}
+
 #if 0
 namespace ReadWriteMutexTest
 {
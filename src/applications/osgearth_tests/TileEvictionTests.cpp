@@ -0,0 +1,158 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarthDrivers/engine_rex/TileEviction>
+#include <algorithm>
+#include <vector>
+
+using namespace osgEarth::REX;
+
+namespace
+{
+    // Stands in for the registry: a set of quads, each a parent with four
+    // registered children of the given size.
+    struct TestRegistry
+    {
+        std::vector<int> parents;
+        std::vector<TileEviction::Tile> tiles;
+        std::size_t totalBytes = 0u;
+
+        TestRegistry(unsigned numQuads) : parents(numQuads) { }
+
+        // adds the four children of a quad
+        void addQuad(unsigned quad, float priority, std::size_t bytes)
+        {
+            for (unsigned i = 0; i < 4; ++i)
+                addTile(quad, priority, bytes);
+        }
+
+        void addTile(unsigned quad, float priority, std::size_t bytes)
+        {
+            TileEviction::Tile tile;
+            tile.parent = &parents[quad];
+            tile.siblings = 4u;
+            tile.idle = true;
+            tile.priority = priority;
+            tile.bytes = bytes;
+            tiles.push_back(tile);
+            totalBytes += bytes;
+        }
+
+        // the quads in the order their tiles were selected
+        std::vector<unsigned> quadsOf(const std::vector<unsigned>& selected) const
+        {
+            std::vector<unsigned> quads;
+            for (auto i : selected)
+            {
+                unsigned quad = (unsigned)((const int*)tiles[i].parent - parents.data());
+                if (quads.empty() || quads.back() != quad)
+                    quads.push_back(quad);
+            }
+            return quads;
+        }
+
+        // true if every quad in the selection is there in full
+        bool wholeQuads(const std::vector<unsigned>& selected) const
+        {
+            for (auto quad : quadsOf(selected))
+            {
+                auto members = std::count_if(selected.begin(), selected.end(), [&](unsigned i) {
+                    return tiles[i].parent == &parents[quad]; });
+                if (members != 4)
+                    return false;
+            }
+            return true;
+        }
+    };
+}
+
+TEST_CASE("Tile eviction over the memory budget")
+{
+    const std::size_t MB = 1024u * 1024u;
+
+    // interleave the quads' members, as the registry's hash table would
+    TestRegistry reg(4);
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        reg.addTile(0, 3.0f, MB);
+        reg.addTile(1, 1.0f, MB);
+        reg.addTile(2, 4.0f, MB);
+        reg.addTile(3, 2.0f, MB);
+    }
+    REQUIRE(reg.totalBytes == 16u * MB);
+
+    SECTION("Nothing is evicted within the budget")
+    {
+        REQUIRE(TileEviction::select(reg.tiles, reg.totalBytes, 16u * MB, ~0u).empty());
+    }
+
+    SECTION("Whole quads go, in retention order, until under budget")
+    {
+        auto selected = TileEviction::select(reg.tiles, reg.totalBytes, 9u * MB, ~0u);
+
+        REQUIRE(reg.wholeQuads(selected));
+        REQUIRE(reg.quadsOf(selected) == std::vector<unsigned>({ 1u, 3u }));
+        REQUIRE(selected.size() == 8u);
+    }
+
+    SECTION("A quad's most important member sets its priority")
+    {
+        reg.tiles[1].priority = 10.0f; // first member of quad 1
+
+        auto selected = TileEviction::select(reg.tiles, reg.totalBytes, 0u, ~0u);
+        REQUIRE(reg.quadsOf(selected) == std::vector<unsigned>({ 3u, 0u, 2u, 1u }));
+    }
+
+    SECTION("A busy member keeps its whole quad")
+    {
+        reg.tiles[5].idle = false; // second member of quad 1
+
+        auto selected = TileEviction::select(reg.tiles, reg.totalBytes, 12u * MB, ~0u);
+        REQUIRE(reg.wholeQuads(selected));
+        REQUIRE(reg.quadsOf(selected) == std::vector<unsigned>({ 3u }));
+    }
+
+    SECTION("Quads missing a member are skipped")
+    {
+        reg.tiles[3].siblings = 5u; // all of quad 3
+        reg.tiles[7].siblings = 5u;
+        reg.tiles[11].siblings = 5u;
+        reg.tiles[15].siblings = 5u;
+
+        auto selected = TileEviction::select(reg.tiles, reg.totalBytes, 12u * MB, ~0u);
+        REQUIRE(reg.quadsOf(selected) == std::vector<unsigned>({ 1u }));
+    }
+
+    SECTION("Tiles without a parent stay")
+    {
+        TestRegistry roots(1);
+        TileEviction::Tile root;
+        root.idle = true;
+        root.bytes = MB;
+        roots.tiles.push_back(root);
+
+        REQUIRE(TileEviction::select(roots.tiles, MB, 0u, ~0u).empty());
+    }
+
+    SECTION("The tile limit is checked between quads")
+    {
+        auto selected = TileEviction::select(reg.tiles, reg.totalBytes, 0u, 6u);
+        REQUIRE(reg.wholeQuads(selected));
+        REQUIRE(reg.quadsOf(selected) == std::vector<unsigned>({ 1u, 3u }));
+    }
+
+    SECTION("Equal priorities resolve the same way every time")
+    {
+        TestRegistry flat(8);
+        for (unsigned q = 0; q < 8; ++q)
+            flat.addQuad(q, 1.0f, MB);
+
+        auto first = TileEviction::select(flat.tiles, flat.totalBytes, 20u * MB, ~0u);
+        REQUIRE(flat.quadsOf(first) == std::vector<unsigned>({ 0u, 1u, 2u }));
+        REQUIRE(TileEviction::select(flat.tiles, flat.totalBytes, 20u * MB, ~0u) == first);
+    }
+}
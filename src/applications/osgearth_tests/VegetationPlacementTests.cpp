@@ -0,0 +1,201 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarthProcedural/VegetationPlacement>
+#include <osgEarth/Threading>
+#include <osgEarth/rtree.h>
+#include <random>
+#include <vector>
+
+using namespace osgEarth;
+using namespace osgEarth::Procedural;
+using namespace osgEarth::Util;
+
+namespace
+{
+    struct Candidate
+    {
+        float u, v;
+        float asset_index_rand;
+        float rotation_rand;
+        float lush_offset;
+
+        bool rejected = false;
+        double a_min[2], a_max[2];
+    };
+
+    // some candidates fail their biome or lushness checks; a fixed pattern
+    // stands in for that
+    bool rejectedEarly(unsigned i)
+    {
+        return (i % 7u) == 3u || (i % 11u) == 5u;
+    }
+
+    // the collision box of a candidate, from its draws alone, as in placement
+    void computeBox(Candidate& c, double tileSize)
+    {
+        double x = c.u * tileSize, y = c.v * tileSize;
+        double half = 0.5 + 2.0 * c.asset_index_rand;
+        c.a_min[0] = x - half, c.a_min[1] = y - half;
+        c.a_max[0] = x + half, c.a_max[1] = y + half;
+    }
+
+    // snaps candidates onto a coarse lattice so many boxes exactly touch
+    void snapBoxes(std::vector<Candidate>& candidates)
+    {
+        for (auto& c : candidates)
+        {
+            for (int k = 0; k < 2; ++k)
+            {
+                c.a_min[k] = std::floor(c.a_min[k]);
+                c.a_max[k] = std::floor(c.a_max[k]);
+            }
+        }
+    }
+
+    // The original placement loop: draw, reject, then test each candidate
+    // against an R-tree of the ones placed before it.
+    std::vector<unsigned> placeSequentially(unsigned count, unsigned seed, double tileSize, bool snap)
+    {
+        Random prng(0);
+        std::default_random_engine gen(seed);
+        std::normal_distribution<float> normal_dist(0.0f, 1.0f / 6.0f);
+        RTree<int, double, 2> index;
+
+        std::vector<unsigned> placed;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            Candidate c;
+            c.u = prng.next();
+            c.v = prng.next();
+            c.asset_index_rand = prng.next();
+            c.rotation_rand = prng.next();
+            prng.next();
+            c.lush_offset = normal_dist(gen);
+
+            if (rejectedEarly(i))
+                continue;
+
+            computeBox(c, tileSize);
+            if (snap)
+            {
+                std::vector<Candidate> one(1, c);
+                snapBoxes(one);
+                c = one[0];
+            }
+
+            if (index.Search(c.a_min, c.a_max) == 0)
+            {
+                index.Insert(c.a_min, c.a_max, 0);
+                placed.push_back(i);
+            }
+        }
+        return placed;
+    }
+
+    // The current placement: draw everything up front, evaluate candidates
+    // in parallel, then resolve them in order against the collision grid.
+    std::vector<unsigned> placeInParallel(unsigned count, unsigned seed, double tileSize, bool snap, std::vector<Candidate>* drawn = nullptr)
+    {
+        Random prng(0);
+        std::default_random_engine gen(seed);
+        std::normal_distribution<float> normal_dist(0.0f, 1.0f / 6.0f);
+
+        std::vector<Candidate> candidates(count);
+        drawPlacementCandidates(candidates, prng, gen, normal_dist);
+
+        Threading::parallelFor("test", count, 64u, 64u, [&](unsigned begin, unsigned end)
+            {
+                for (unsigned i = begin; i < end; ++i)
+                {
+                    candidates[i].rejected = rejectedEarly(i);
+                    if (!candidates[i].rejected)
+                        computeBox(candidates[i], tileSize);
+                }
+            });
+
+        if (snap)
+            snapBoxes(candidates);
+
+        CollisionGrid grid(0.0, 0.0, tileSize, tileSize, 5.0);
+
+        std::vector<unsigned> placed;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            if (!candidates[i].rejected && grid.insertIfClear(candidates[i].a_min, candidates[i].a_max))
+                placed.push_back(i);
+        }
+
+        if (drawn)
+            *drawn = std::move(candidates);
+
+        return placed;
+    }
+}
+
+TEST_CASE("Vegetation placement matches the sequential path")
+{
+    const unsigned count = 20000;
+    const double tileSize = 500.0;
+
+    SECTION("Up-front draws")
+    {
+        std::vector<Candidate> drawn;
+        placeInParallel(count, 42u, tileSize, false, &drawn);
+
+        Random prng(0);
+        std::default_random_engine gen(42u);
+        std::normal_distribution<float> normal_dist(0.0f, 1.0f / 6.0f);
+
+        unsigned mismatches = 0;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            float u = prng.next();
+            float v = prng.next();
+            float asset_index_rand = prng.next();
+            float rotation_rand = prng.next();
+            prng.next();
+            float lush_offset = normal_dist(gen);
+
+            if (drawn[i].u != u || drawn[i].v != v ||
+                drawn[i].asset_index_rand != asset_index_rand ||
+                drawn[i].rotation_rand != rotation_rand ||
+                drawn[i].lush_offset != lush_offset)
+            {
+                ++mismatches;
+            }
+        }
+        REQUIRE(mismatches == 0u);
+    }
+
+    SECTION("Collision resolve")
+    {
+        auto expected = placeSequentially(count, 42u, tileSize, false);
+        auto actual = placeInParallel(count, 42u, tileSize, false);
+
+        // the tile fills up, so plenty are placed and plenty collide
+        REQUIRE(expected.size() > 1000u);
+        REQUIRE(expected.size() < count / 2u);
+        REQUIRE(actual == expected);
+    }
+
+    SECTION("Touching boxes collide")
+    {
+        auto expected = placeSequentially(count, 7u, tileSize, true);
+        auto actual = placeInParallel(count, 7u, tileSize, true);
+
+        REQUIRE(expected.size() > 1000u);
+        REQUIRE(actual == expected);
+    }
+
+    SECTION("Repeated runs agree")
+    {
+        auto first = placeInParallel(count, 99u, tileSize, false);
+        for (int run = 0; run < 4; ++run)
+            REQUIRE(placeInParallel(count, 99u, tileSize, false) == first);
+    }
+}
@@ -20,6 +20,7 @@
 #include <osgEarth/PointDrawable>
 #include <osgEarth/Registry>
 #include <osgEarth/StyleSheet>
+#include <osgEarth/Threading>
 #include <osg/Geode>
 #include <osg/Geometry>
 #include <osg/TriangleIndexFunctor>
@@ -89,6 +90,32 @@ namespace
         p.x() = (cos(lat)*sin(lon - lon0)) / d;
         p.y() = (cos(lat0)*sin(lat) - sin(lat0)*cos(lat)*cos(lon - lon0)) / d;
     }
+
+    // don't go parallel unless each thread gets at least this many parts
+    constexpr unsigned MIN_PARTS_PER_THREAD = 8u;
+
+    // One polygon part to build and tessellate
+    struct PolygonPart
+    {
+        Feature* feature = nullptr;
+        Geometry* part = nullptr;
+        osg::Vec4f color;
+        osg::Matrixd w2l, l2w;
+        osg::ref_ptr<osg::Geometry> geom;
+    };
+
+    // Calls func(i) for each i in [0, count). Parts vary a lot in size, so
+    // they are handed out one at a time.
+    template<typename FUNC>
+    inline void forEachPolygonPart(unsigned count, FUNC&& func)
+    {
+        Threading::parallelFor("Tessellate polygons", count, MIN_PARTS_PER_THREAD, 1u,
+            [&func](unsigned begin, unsigned end)
+            {
+                for (unsigned i = begin; i < end; ++i)
+                    func(i);
+            });
+    }
 }
 
 BuildGeometryFilter::BuildGeometryFilter(const Style& style) :
@@ -272,7 +299,10 @@ BuildGeometryFilter::processPolygons(FeatureList& features, FilterContext& conte
         }
     }
 
-    // ready, time to iterate the features.
+    // Collect the polygon parts first. Symbol scripts and name expressions
+    // run here, in order, since they may touch the script engine.
+    std::vector<PolygonPart> parts;
+
     for( FeatureList::iterator f = features.begin(); f != features.end(); ++f )
     {
         Feature* input = f->get();
@@ -297,10 +327,10 @@ BuildGeometryFilter::processPolygons(FeatureList& features, FilterContext& conte
         if (input->getGeometry() == 0L)
             continue;
 
-        GeometryIterator parts( input->getGeometry(), false );
-        while( parts.hasMore() )
+        GeometryIterator iter( input->getGeometry(), false );
+        while( iter.hasMore() )
         {
-            Geometry* part = parts.next();
+            Geometry* part = iter.next();
 
             part->removeDuplicates();
 
@@ -310,100 +340,117 @@ BuildGeometryFilter::processPolygons(FeatureList& features, FilterContext& conte
                 continue;
             }
 
+            PolygonPart job;
+            job.feature = input;
+            job.part = part;
+
             // resolve the color:
-            osg::Vec4f primaryColor = poly->fill()->color();
+            job.color = poly->fill()->color();
 
-            osg::ref_ptr<osg::Geometry> osgGeom = new osg::Geometry();
-            osgGeom->setName(typeid(*this).name());
-            osgGeom->setUseVertexBufferObjects(true);
+            job.geom = new osg::Geometry();
+            job.geom->setName(typeid(*this).name());
+            job.geom->setUseVertexBufferObjects(true);
 
             // are we embedding a feature name?
             if ( _featureNameExpr.isSet() )
             {
                 const std::string& name = input->eval( _featureNameExpr.mutable_value(), &context );
-                osgGeom->setName( name );
+                job.geom->setName( name );
             }
 
             // apply the skin if there is one.
             if (skin_stateset.valid())
             {
-                osgGeom->setStateSet(skin_stateset);
+                job.geom->setStateSet(skin_stateset);
             }
 
             // compute localizing matrices or use globals
-            osg::Matrixd w2l, l2w;
             if (makeECEF)
             {
                 osgEarth::GeoExtent partExtent(featureSRS, part->getBounds());
-                computeLocalizers(context, partExtent, w2l, l2w);
+                computeLocalizers(context, partExtent, job.w2l, job.l2w);
             }
             else
             {
-                w2l = _world2local;
-                l2w = _local2world;
+                job.w2l = _world2local;
+                job.l2w = _local2world;
             }
 
-            // collect all the pre-transformation HAT (Z) values.
-            osg::ref_ptr<osg::FloatArray> hats = new osg::FloatArray();
-            hats->reserve( part->size() );
-            for(Geometry::const_iterator i = part->begin(); i != part->end(); ++i )
-                hats->push_back( i->z() );
+            parts.emplace_back(std::move(job));
+        }
+    }
 
-            // build the geometry:
-            tileAndBuildPolygon(part, featureSRS, outputSRS, makeECEF, true, osgGeom.get(), skin_res, w2l);
+    // Build and tessellate the parts. Each one is independent, so large
+    // batches (building footprints, water bodies) run in parallel.
+    forEachPolygonPart((unsigned)parts.size(), [&](unsigned i)
+    {
+        PolygonPart& job = parts[i];
+        osg::Geometry* osgGeom = job.geom.get();
+
+        // build the geometry:
+        tileAndBuildPolygon(job.part, featureSRS, outputSRS, makeECEF, true, osgGeom, skin_res, job.w2l);
 
-            osg::Vec3Array* allPoints = static_cast<osg::Vec3Array*>(osgGeom->getVertexArray());
-            if (allPoints && allPoints->size() > 0)
+        osg::Vec3Array* allPoints = static_cast<osg::Vec3Array*>(osgGeom->getVertexArray());
+        if (allPoints && allPoints->size() > 0)
+        {
+            // subdivide the mesh if necessary to conform to an ECEF globe:
+            if ( makeECEF )
             {
-                // subdivide the mesh if necessary to conform to an ECEF globe:
-                if ( makeECEF )
+                //convert back to world coords
+                for( osg::Vec3Array::iterator v = allPoints->begin(); v != allPoints->end(); ++v )
                 {
-                    //convert back to world coords
-                    for( osg::Vec3Array::iterator i = allPoints->begin(); i != allPoints->end(); ++i )
-                    {
-                        osg::Vec3d v(*i);
-                        v = v * l2w;
-                        v = v * _world2local;
+                    osg::Vec3d world(*v);
+                    world = world * job.l2w;
+                    world = world * _world2local;
 
-                        (*i)._v[0] = v[0];
-                        (*i)._v[1] = v[1];
-                        (*i)._v[2] = v[2];
-                    }
-
-                    double threshold = osg::DegreesToRadians( *_maxAngle_deg );
-                    //OE_TEST << "Running mesh subdivider with threshold " << *_maxAngle_deg << std::endl;
-                    MeshSubdivider ms( _world2local, _local2world );
-                    if ( input->geoInterp().isSet() )
-                        ms.run( *osgGeom, threshold, *input->geoInterp() );
-                    else
-                        ms.run( *osgGeom, threshold, *_geoInterp );
+                    (*v)._v[0] = world[0];
+                    (*v)._v[1] = world[1];
+                    (*v)._v[2] = world[2];
                 }
 
-                // assign the primary color array. PER_VERTEX required in order to support
-                // vertex optimization later
-                unsigned count = osgGeom->getVertexArray()->getNumElements();
-                osg::Vec4Array* colors = new osg::Vec4Array(osg::Array::BIND_PER_VERTEX);
-                colors->assign( count, primaryColor );
-                osgGeom->setColorArray( colors );
+                double threshold = osg::DegreesToRadians( *_maxAngle_deg );
+                //OE_TEST << "Running mesh subdivider with threshold " << *_maxAngle_deg << std::endl;
+                MeshSubdivider ms( _world2local, _local2world );
+                if ( job.feature->geoInterp().isSet() )
+                    ms.run( *osgGeom, threshold, *job.feature->geoInterp() );
+                else
+                    ms.run( *osgGeom, threshold, *_geoInterp );
+            }
+
+            // assign the primary color array. PER_VERTEX required in order to support
+            // vertex optimization later
+            unsigned count = osgGeom->getVertexArray()->getNumElements();
+            osg::Vec4Array* colors = new osg::Vec4Array(osg::Array::BIND_PER_VERTEX);
+            colors->assign( count, job.color );
+            osgGeom->setColorArray( colors );
+        }
+    });
+
+    // Assemble the results in feature order.
+    for (auto& job : parts)
+    {
+        osg::Geometry* osgGeom = job.geom.get();
+        osg::Array* allPoints = osgGeom->getVertexArray();
 
-                geode->addDrawable( osgGeom );
+        if (allPoints && allPoints->getNumElements() > 0)
+        {
+            geode->addDrawable( osgGeom );
 
-                // record the geometry's primitive set(s) in the index:
-                if ( context.featureIndex() )
-                    context.featureIndex()->tagDrawable( osgGeom.get(), input );
+            // record the geometry's primitive set(s) in the index:
+            if ( context.featureIndex() )
+                context.featureIndex()->tagDrawable( osgGeom, job.feature );
 
-                // install clamping attributes if necessary
-                if (_style.has<AltitudeSymbol>() &&
-                    _style.get<AltitudeSymbol>()->technique() == AltitudeSymbol::TECHNIQUE_GPU)
-                {
-                    Clamping::applyDefaultClampingAttrs( osgGeom.get(), input->getDouble("__oe_verticalOffset", 0.0) );
-                }
-            }
-            else
+            // install clamping attributes if necessary
+            if (_style.has<AltitudeSymbol>() &&
+                _style.get<AltitudeSymbol>()->technique() == AltitudeSymbol::TECHNIQUE_GPU)
             {
-                OE_TEST << LC << "Oh no. tileAndBuildPolygon returned nothing.\n";
+                Clamping::applyDefaultClampingAttrs( osgGeom, job.feature->getDouble("__oe_verticalOffset", 0.0) );
             }
         }
+        else
+        {
+            OE_TEST << LC << "Oh no. tileAndBuildPolygon returned nothing.\n";
+        }
     }
 
     OE_TEST << LC << "Num drawables = " << geode->getNumDrawables() << "\n";
@@ -8,6 +8,7 @@
 #include <osgEarth/Metrics>
 #include <osgEarth/NetworkMonitor>
 #include <osgEarth/Math>
+#include <osgEarth/ReprojectionGrid>
 
 using namespace osgEarth;
 
@@ -257,37 +258,25 @@ ElevationLayer::assembleHeightField(const TileKey& key, ProgressCallback* progre
             for(int i=0; i<cols*rows; ++i)
                 heights[i] = NO_DATA_VALUE;
 
-            // Working set of points. it's much faster to xform an entire vector all at once.
+            // Working set of points, sampled edge to edge (unlike with imagery)
             std::vector<osg::Vec3d> points;
-            points.resize(cols * rows);
 
             double minx, miny, maxx, maxy;
             key.getExtent().getBounds(minx, miny, maxx, maxy);
-            double dx = (maxx - minx) / (double)(cols-1);
-            double dy = (maxy - miny) / (double)(rows-1);
 
-            // Source bounds and projection grid. We use cols-1 and rows-1
-            // since we want to sample edge to edge, unlike with imagery
             Bounds sourceBounds;
             sources[0].second.getSRS()->getBounds(sourceBounds);
 
-            // build a grid of sample points:
-            for (unsigned t = 0; t < rows; ++t)
-            {
-                double y = miny + (dy * (double)t);
-                for (unsigned s = 0; s < cols; ++s)
-                {
-                    double x = minx + (dx * (double)s);
-                    points[t * cols + s] = { x, y, 0.0 };
-                }
-            }
-
             // transform the sample points to the SRS of our source data tiles.
             // NOTE: point.z() will hold a vertical offset if the layers' vdatums are different;
             // we will add it back in later.
             if (source_srs && key_srs)
             {
-                key_srs->transform(points, source_srs);
+                ReprojectionGrid::transform(
+                    key_srs, source_srs,
+                    minx, miny, maxx, maxy,
+                    cols, rows,
+                    points);
 
                 if (sourceBounds.valid())
                 {
@@ -299,6 +288,9 @@ ElevationLayer::assembleHeightField(const TileKey& key, ProgressCallback* progre
                 }
             }
 
+            if (points.size() != cols * rows)
+                return output;
+
             // Mosaic our sources into a single output image.
             for (int row = 0; row < rows; ++row)
             {
@@ -13,6 +13,12 @@
 #include <osgEarth/Notify>
 
 #include <thread>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OE_ELEVATION_POOL_SSE2
+#include <emmintrin.h>
+#endif
 
 using namespace osgEarth;
 
@@ -447,6 +453,81 @@ namespace
         a.BOT = a.LL * minusSmix + a.LR * smix;
         out = a.TOP * minusTmis + a.BOT * tmix;
     }
+
+    // Bilinear interpolation of "count" normalized [0..1] (u,v) coordinates
+    // over a single-channel float grid of w x h samples (w,h >= 2).
+    // Matches the results of quickSample above.
+    void bilinearBatch(
+        const float* data, int w, int h,
+        const float* u, const float* v,
+        float* out, std::size_t count)
+    {
+        const float sizeS = (float)(w - 1);
+        const float sizeT = (float)(h - 1);
+        std::size_t i = 0;
+
+#ifdef OE_ELEVATION_POOL_SSE2
+        const __m128 vSizeS = _mm_set1_ps(sizeS);
+        const __m128 vSizeT = _mm_set1_ps(sizeT);
+        const __m128i vMaxS0 = _mm_set1_epi32(w - 2);
+        const __m128i vMaxT0 = _mm_set1_epi32(h - 2);
+
+        // SSE2 has no _mm_min_epi32
+        auto min_epi32 = [](__m128i a, __m128i b) {
+            __m128i mask = _mm_cmpgt_epi32(a, b);
+            return _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a));
+        };
+
+        alignas(16) int s0[4], t0[4];
+        alignas(16) float UL[4], UR[4], LL[4], LR[4];
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 s = _mm_mul_ps(_mm_loadu_ps(u + i), vSizeS);
+            const __m128 t = _mm_mul_ps(_mm_loadu_ps(v + i), vSizeT);
+
+            // inputs are clamped to [0..1] so truncation is the same as floor
+            const __m128i is0 = min_epi32(_mm_cvttps_epi32(s), vMaxS0);
+            const __m128i it0 = min_epi32(_mm_cvttps_epi32(t), vMaxT0);
+
+            const __m128 smix = _mm_sub_ps(s, _mm_cvtepi32_ps(is0));
+            const __m128 tmix = _mm_sub_ps(t, _mm_cvtepi32_ps(it0));
+
+            _mm_store_si128((__m128i*)s0, is0);
+            _mm_store_si128((__m128i*)t0, it0);
+
+            for (int k = 0; k < 4; ++k)
+            {
+                const float* ptr = data + t0[k] * w + s0[k];
+                UL[k] = ptr[0];
+                UR[k] = ptr[1];
+                LL[k] = ptr[w];
+                LR[k] = ptr[w + 1];
+            }
+
+            const __m128 ul = _mm_load_ps(UL);
+            const __m128 ll = _mm_load_ps(LL);
+            const __m128 top = _mm_add_ps(ul, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(UR), ul), smix));
+            const __m128 bot = _mm_add_ps(ll, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(LR), ll), smix));
+            _mm_storeu_ps(out + i, _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bot, top), tmix)));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            const float s = u[i] * sizeS;
+            const float t = v[i] * sizeT;
+            const int s0 = std::min((int)s, w - 2);
+            const int t0 = std::min((int)t, h - 2);
+            const float smix = s - (float)s0;
+            const float tmix = t - (float)t0;
+
+            const float* ptr = data + t0 * w + s0;
+            const float top = ptr[0] + (ptr[1] - ptr[0]) * smix;
+            const float bot = ptr[w] + (ptr[w + 1] - ptr[w]) * smix;
+            out[i] = top + (bot - top) * tmix;
+        }
+    }
 }
 
 bool
@@ -918,6 +999,219 @@ ElevationPool::sampleMapCoords(
     return count;
 }
 
+int
+ElevationPool::sampleMapCoordsBatch(
+    std::vector<osg::Vec3d>::iterator begin,
+    std::vector<osg::Vec3d>::iterator end,
+    const Distance& resolution,
+    WorkingSet* ws,
+    ProgressCallback* progress,
+    float failValue,
+    BatchStats* stats)
+{
+    OE_PROFILING_ZONE;
+
+    if (begin == end)
+        return -1;
+
+    osg::Timer_t startTime = osg::Timer::instance()->tick();
+
+    osg::ref_ptr<const Map> map;
+    if (_map.lock(map) == false || map->getProfile() == NULL)
+        return -1;
+
+    sync(map.get(), ws);
+
+    const std::size_t numPoints = std::distance(begin, end);
+
+    if (stats)
+    {
+        *stats = BatchStats();
+        stats->points = numPoints;
+    }
+
+    if (_elevationLayers.empty())
+    {
+        for (auto i = begin; i != end; ++i)
+            i->z() = failValue;
+        return 0;
+    }
+
+    ScopedReadLock lk(_mutex);
+
+    const Profile* profile = map->getProfile();
+    double pw = profile->getExtent().width();
+    double ph = profile->getExtent().height();
+    double pxmin = profile->getExtent().xMin();
+    double pymin = profile->getExtent().yMin();
+
+    auto* srs = map->getSRS();
+    auto& units = srs->getUnits();
+
+    // Pass 1: compute the tile address of each point so we can bucket them.
+    struct Entry {
+        int lod;
+        unsigned tx, ty;
+        unsigned index;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(numPoints);
+
+    unsigned tw, th;
+    int lod_prev = INT_MAX;
+
+    for (unsigned i = 0; i < numPoints; ++i)
+    {
+        auto& p = *(begin + i);
+
+        double resolutionInMapUnits = srs->transformDistance(resolution, units, p.y());
+
+        int computedLOD = profile->getLevelOfDetailForHorizResolution(
+            resolutionInMapUnits,
+            ELEVATION_TILE_SIZE);
+
+        int lod = osg::minimum(getLOD(p.x(), p.y(), ws), (int)computedLOD);
+
+        if (lod < 0)
+        {
+            p.z() = failValue;
+            continue;
+        }
+
+        if (lod != lod_prev)
+        {
+            profile->getNumTiles(lod, tw, th);
+            lod_prev = lod;
+        }
+
+        double rx = (p.x() - pxmin) / pw, ry = (p.y() - pymin) / ph;
+        unsigned tx = osg::clampBelow((unsigned)(rx * (double)tw), tw - 1u); // TODO: wrap around for geo
+        unsigned ty = osg::clampBelow((unsigned)((1.0 - ry) * (double)th), th - 1u);
+
+        entries.push_back(Entry{ lod, tx, ty, i });
+    }
+
+    // Pass 2: sort into buckets so each tile is resolved exactly once.
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.lod != b.lod) return a.lod < b.lod;
+        if (a.ty != b.ty) return a.ty < b.ty;
+        if (a.tx != b.tx) return a.tx < b.tx;
+        return a.index < b.index;
+    });
+
+    Internal::RevElevationKey key;
+    key._revision = getElevationHash(ws);
+
+    std::vector<float> u, v, heights;
+    osg::Vec4f elev;
+    Envelope::QuickSampleVars qvars;
+    int count = 0;
+    std::size_t numBuckets = 0u;
+
+    // Pass 3: resolve each bucket's raster and interpolate in bulk.
+    for (std::size_t first = 0; first < entries.size(); )
+    {
+        const Entry& head = entries[first];
+
+        std::size_t last = first + 1;
+        while (last < entries.size() &&
+            entries[last].lod == head.lod &&
+            entries[last].tx == head.tx &&
+            entries[last].ty == head.ty)
+        {
+            ++last;
+        }
+
+        ++numBuckets;
+
+        key._tilekey = TileKey(head.lod, head.tx, head.ty, profile);
+
+        osg::ref_ptr<ElevationTexture> raster;
+        if (key._tilekey.valid())
+        {
+            raster = getOrCreateRaster(
+                key,   // key to query
+                map.get(), // map to query
+                true,  // fall back on lower resolution data if necessary
+                ws,    // user's workingset
+                progress);
+
+            if (progress && progress->isCanceled())
+            {
+                return -1;
+            }
+        }
+
+        const osg::Image* image = raster.valid() ? raster->getImage(0) : nullptr;
+
+        if (image == nullptr)
+        {
+            for (std::size_t e = first; e < last; ++e)
+                (begin + entries[e].index)->z() = failValue;
+        }
+        else
+        {
+            const GeoExtent& ex = raster->getExtent();
+            const std::size_t n = last - first;
+
+            u.resize(n);
+            v.resize(n);
+            heights.resize(n);
+
+            for (std::size_t e = 0; e < n; ++e)
+            {
+                const auto& p = *(begin + entries[first + e].index);
+
+                // Note: clamping can happen on the map edges..
+                // TODO: consider looping around for geo and clamping for projected
+                u[e] = (float)osg::clampBetween((p.x() - ex.xMin()) / ex.width(), 0.0, 1.0);
+                v[e] = (float)osg::clampBetween((p.y() - ex.yMin()) / ex.height(), 0.0, 1.0);
+            }
+
+            if (image->getPixelFormat() == GL_RED &&
+                image->getDataType() == GL_FLOAT &&
+                image->s() >= 2 && image->t() >= 2)
+            {
+                bilinearBatch(
+                    reinterpret_cast<const float*>(image->data()),
+                    image->s(), image->t(),
+                    u.data(), v.data(), heights.data(), n);
+            }
+            else
+            {
+                // unexpected format; fall back on the generic reader
+                for (std::size_t e = 0; e < n; ++e)
+                {
+                    quickSample(raster->reader(), u[e], v[e], elev, qvars);
+                    heights[e] = elev.r();
+                }
+            }
+
+            for (std::size_t e = 0; e < n; ++e)
+            {
+                auto& p = *(begin + entries[first + e].index);
+                p.z() = heights[e];
+                if (heights[e] != failValue)
+                    ++count;
+            }
+        }
+
+        first = last;
+    }
+
+    if (stats)
+    {
+        stats->sampled = count;
+        stats->buckets = numBuckets;
+        stats->seconds = osg::Timer::instance()->delta_s(startTime, osg::Timer::instance()->tick());
+    }
+
+    OE_PROFILING_PLOT("ElevationPool batch points", (int64_t)numPoints);
+    OE_PROFILING_PLOT("ElevationPool batch buckets", (int64_t)numBuckets);
+
+    return count;
+}
+
 ElevationSample
 ElevationPool::getSample(
     const GeoPoint& p,
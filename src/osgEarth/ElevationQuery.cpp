@@ -138,13 +138,13 @@ ElevationQuery::getElevations(std::vector<osg::Vec3d>& points,
     }
     else
     {
-        // Call ElevationPool::sampleMapCoords directly if there are no terrain patches as it is significantly faster than doing
+        // Call ElevationPool::sampleMapCoordsBatch directly if there are no terrain patches as it is significantly faster than doing
         // individual getElevationImpl queries
         if (pointsSRS != _map->getSRS())
         {
             std::vector< osg::Vec3d > mapPoints = points;
             pointsSRS->transform(mapPoints, _map->getSRS());
-            int count = _map->getElevationPool()->sampleMapCoords(mapPoints.begin(), mapPoints.end(), Distance(desiredResolution, _map->getSRS()->getUnits()), nullptr, nullptr);
+            int count = _map->getElevationPool()->sampleMapCoordsBatch(mapPoints.begin(), mapPoints.end(), Distance(desiredResolution, _map->getSRS()->getUnits()), nullptr, nullptr);
             for (unsigned int i = 0; i < points.size(); ++i)
             {
                 points[i].z() = mapPoints[i].z();
@@ -153,7 +153,7 @@ ElevationQuery::getElevations(std::vector<osg::Vec3d>& points,
         }
         else
         {
-            return _map->getElevationPool()->sampleMapCoords(points.begin(), points.end(), Distance(desiredResolution, _map->getSRS()->getUnits()), nullptr, nullptr) > 0;
+            return _map->getElevationPool()->sampleMapCoordsBatch(points.begin(), points.end(), Distance(desiredResolution, _map->getSRS()->getUnits()), nullptr, nullptr) > 0;
         }
     }
 }
@@ -185,14 +185,14 @@ ElevationQuery::getElevations(const std::vector<osg::Vec3d>& points,
     }
     else
     {
-        // Call ElevationPool::sampleMapCoords directly if there are no terrain patches as it is significantly faster than doing
+        // Call ElevationPool::sampleMapCoordsBatch directly if there are no terrain patches as it is significantly faster than doing
         // individual getElevationImpl queries
         std::vector< osg::Vec3d > mapPoints = points;
         if (pointsSRS != _map->getSRS())
         {
             pointsSRS->transform(mapPoints, _map->getSRS());
         }
-        int count = _map->getElevationPool()->sampleMapCoords(mapPoints.begin(), mapPoints.end(), Distance(desiredResolution, _map->getSRS()->getUnits()), nullptr, nullptr);
+        int count = _map->getElevationPool()->sampleMapCoordsBatch(mapPoints.begin(), mapPoints.end(), Distance(desiredResolution, _map->getSRS()->getUnits()), nullptr, nullptr);
         for (unsigned int i = 0; i < points.size(); ++i)
         {
             out_elevations.push_back(mapPoints[i].z());
@@ -3,6 +3,7 @@
  * MIT License
  */
 #include <osgEarth/ExtrudeGeometryFilter>
+#include <osgEarth/FeatureExpression>
 #include <osgEarth/Session>
 #include <osgEarth/FeatureSourceIndexNode>
 #include <osgEarth/StyleSheet>
@@ -1147,9 +1148,28 @@ ExtrudeGeometryFilter::addDrawable(osg::Drawable*       drawable,
 bool
 ExtrudeGeometryFilter::process( FeatureList& features, FilterContext& context )
 {
+    // Symbol scripts can change attributes as we go, so we can only evaluate
+    // the height and name expressions up front when there are none.
+    bool batch =
+        !(_polySymbol.valid() && _polySymbol->script().isSet()) &&
+        !_extrusionSymbol->script().isSet();
+
+    std::vector<double> heights;
+    if (batch && !_heightCallback.valid() && _heightExpr.isSet())
+    {
+        CompiledNumericExpression(_heightExpr.get()).eval(features, &context, heights);
+    }
+
+    std::vector<std::string> names;
+    if (batch && !_featureNameExpr.empty())
+    {
+        CompiledStringExpression(_featureNameExpr).eval(features, &context, names);
+    }
+
     for( FeatureList::iterator f = features.begin(); f != features.end(); ++f )
     {
         Feature* input = f->get();
+        std::size_t index = f - features.begin();
 
         // run a symbol script if present.
         if (_polySymbol.valid() && _polySymbol->script().isSet())
@@ -1186,6 +1206,10 @@ ExtrudeGeometryFilter::process( FeatureList& features, FilterContext& context )
             {
                 height = _heightCallback->operator()(input, context);
             }
+            else if (!heights.empty())
+            {
+                height = heights[index];
+            }
             else if (_heightExpr.isSet())
             {
                 height = input->eval(_heightExpr.mutable_value(), &context);
@@ -1197,7 +1221,9 @@ ExtrudeGeometryFilter::process( FeatureList& features, FilterContext& context )
 
             // Set up for feature naming and feature indexing:
             std::string name;
-            if (!_featureNameExpr.empty())
+            if (!names.empty())
+                name = names[index];
+            else if (!_featureNameExpr.empty())
                 name = input->eval(_featureNameExpr, &context);
 
             osg::ref_ptr<osg::StateSet> wallStateSet;
@@ -1391,10 +1417,14 @@ ExtrudeGeometryFilter::process( FeatureList& features, FilterContext& context )
 
             if ( baselines.valid() )
             {
-                osgUtil::Tessellator tess;
-                tess.setTessellationType( osgUtil::Tessellator::TESS_TYPE_GEOMETRY );
-                tess.setWindingType( osgUtil::Tessellator::TESS_WINDING_ODD );
-                tess.retessellatePolygons( *(baselines.get()) );
+                osgEarth::Tessellator oeTess;
+                if (!oeTess.tessellateGeometry(*baselines))
+                {
+                    osgUtil::Tessellator tess;
+                    tess.setTessellationType( osgUtil::Tessellator::TESS_TYPE_GEOMETRY );
+                    tess.setWindingType( osgUtil::Tessellator::TESS_WINDING_ODD );
+                    tess.retessellatePolygons( *(baselines.get()) );
+                }
             }        
         }
     }
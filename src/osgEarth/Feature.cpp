@@ -9,6 +9,7 @@
 
 #include <osgEarth/StringUtils>
 #include <osgEarth/JsonUtils>
+#include <algorithm>
 
 using namespace osgEarth;
 using namespace osgEarth::Util;
@@ -167,6 +168,221 @@ const std::vector<double>& AttributeValue::getDoubleArrayValue() const
 
 //----------------------------------------------------------------------------
 
+int
+AttributeStore::addColumn(const std::string& name)
+{
+    std::string key = toLower(name);
+    auto i = _columnIndex.find(key);
+    if (i != _columnIndex.end())
+        return i->second;
+
+    int c = (int)_names.size();
+    _names.push_back(key);
+    _columnIndex.emplace(std::move(key), c);
+    _columns.emplace_back();
+    _columns.back().reserve(std::max(_numRows, _capacity));
+    return c;
+}
+
+int
+AttributeStore::column(const std::string& lowerCaseName) const
+{
+    auto i = _columnIndex.find(lowerCaseName);
+    return i != _columnIndex.end() ? i->second : -1;
+}
+
+void
+AttributeStore::reserve(unsigned rows)
+{
+    _capacity = rows;
+    for (auto& cells : _columns)
+        cells.reserve(rows);
+}
+
+AttributeStore::Cell&
+AttributeStore::write(unsigned row, int column)
+{
+    OE_HARD_ASSERT(column >= 0 && column < (int)_columns.size() && row < _numRows);
+    auto& cells = _columns[column];
+    if (row >= cells.size())
+        cells.resize(row + 1);
+    return cells[row];
+}
+
+void
+AttributeStore::set(unsigned row, int column, double value)
+{
+    Cell& c = write(row, column);
+    c.v.d = value;
+    c.type = ATTRTYPE_DOUBLE;
+    c.state = VALUE;
+}
+
+void
+AttributeStore::set(unsigned row, int column, long long value)
+{
+    Cell& c = write(row, column);
+    c.v.i = value;
+    c.type = ATTRTYPE_INT;
+    c.state = VALUE;
+}
+
+void
+AttributeStore::set(unsigned row, int column, bool value)
+{
+    Cell& c = write(row, column);
+    c.v.b = value;
+    c.type = ATTRTYPE_BOOL;
+    c.state = VALUE;
+}
+
+void
+AttributeStore::set(unsigned row, int column, const char* value, std::size_t length)
+{
+    Cell& c = write(row, column);
+    c.v.s.offset = (std::uint32_t)_strings.size();
+    c.v.s.length = (std::uint32_t)length;
+    _strings.insert(_strings.end(), value, value + length);
+    c.type = ATTRTYPE_STRING;
+    c.state = VALUE;
+}
+
+void
+AttributeStore::set(unsigned row, int column, const std::vector<double>& value)
+{
+    Cell& c = write(row, column);
+    c.v.array = (std::uint32_t)_arrays.size();
+    _arrays.push_back(value);
+    c.type = ATTRTYPE_DOUBLEARRAY;
+    c.state = VALUE;
+}
+
+void
+AttributeStore::setNull(unsigned row, int column, AttributeType type)
+{
+    Cell& c = write(row, column);
+    c.type = type;
+    c.state = NULL_VALUE;
+}
+
+bool
+AttributeStore::isSet(unsigned row, int column) const
+{
+    const Cell* c = cell(row, column);
+    return c && c->state == VALUE;
+}
+
+AttributeType
+AttributeStore::getType(unsigned row, int column) const
+{
+    const Cell* c = cell(row, column);
+    return c ? (AttributeType)c->type : ATTRTYPE_UNSPECIFIED;
+}
+
+// The conversions below mirror the AttributeValue getters.
+
+std::string
+AttributeStore::getString(unsigned row, int column) const
+{
+    const Cell* c = cell(row, column);
+    if (!c || c->state != VALUE)
+        return "";
+
+    switch (c->type) {
+        case ATTRTYPE_STRING: return str(*c);
+        case ATTRTYPE_DOUBLE: return osgEarth::toString(c->v.d);
+        case ATTRTYPE_INT:    return osgEarth::toString(c->v.i);
+        case ATTRTYPE_BOOL:   return osgEarth::toString(c->v.b);
+    }
+    return EMPTY_STRING;
+}
+
+double
+AttributeStore::getDouble(unsigned row, int column, double defaultValue) const
+{
+    const Cell* c = cell(row, column);
+    if (!c || c->state != VALUE)
+        return defaultValue;
+
+    switch (c->type) {
+        case ATTRTYPE_STRING: return Strings::as<double>(str(*c), defaultValue);
+        case ATTRTYPE_DOUBLE: return c->v.d;
+        case ATTRTYPE_INT:    return (double)c->v.i;
+        case ATTRTYPE_BOOL:   return c->v.b ? 1.0 : 0.0;
+    }
+    return defaultValue;
+}
+
+long long
+AttributeStore::getInt(unsigned row, int column, long long defaultValue) const
+{
+    const Cell* c = cell(row, column);
+    if (!c || c->state != VALUE)
+        return defaultValue;
+
+    switch (c->type) {
+        case ATTRTYPE_STRING: return Strings::as<int>(str(*c), defaultValue);
+        case ATTRTYPE_DOUBLE: return (long long)c->v.d;
+        case ATTRTYPE_INT:    return c->v.i;
+        case ATTRTYPE_BOOL:   return c->v.b ? 1 : 0;
+    }
+    return defaultValue;
+}
+
+bool
+AttributeStore::getBool(unsigned row, int column, bool defaultValue) const
+{
+    const Cell* c = cell(row, column);
+    if (!c || c->state != VALUE)
+        return defaultValue;
+
+    switch (c->type) {
+        case ATTRTYPE_STRING: return Strings::as<bool>(str(*c), defaultValue);
+        case ATTRTYPE_DOUBLE: return c->v.d != 0.0;
+        case ATTRTYPE_INT:    return c->v.i != 0;
+        case ATTRTYPE_BOOL:   return c->v.b;
+    }
+    return defaultValue;
+}
+
+const std::vector<double>*
+AttributeStore::getDoubleArray(unsigned row, int column) const
+{
+    static const std::vector<double> s_empty;
+
+    const Cell* c = cell(row, column);
+    if (!c)
+        return nullptr;
+
+    return c->state == VALUE && c->type == ATTRTYPE_DOUBLEARRAY ? &_arrays[c->v.array] : &s_empty;
+}
+
+bool
+AttributeStore::get(unsigned row, int column, AttributeValue& out) const
+{
+    const Cell* c = cell(row, column);
+    if (!c)
+        return false;
+
+    out = AttributeValue();
+    out.type = (AttributeType)c->type;
+    out.value.set = c->state == VALUE;
+
+    if (out.value.set)
+    {
+        switch (c->type) {
+            case ATTRTYPE_STRING:      out.value.stringValue = str(*c); break;
+            case ATTRTYPE_DOUBLE:      out.value.doubleValue = c->v.d; break;
+            case ATTRTYPE_INT:         out.value.intValue = c->v.i; break;
+            case ATTRTYPE_BOOL:        out.value.boolValue = c->v.b; break;
+            case ATTRTYPE_DOUBLEARRAY: out.value.doubleArrayValue = _arrays[c->v.array]; break;
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+
 Feature::Feature() :
     _fid(0LL),
     _srs(NULL)
@@ -195,6 +411,8 @@ Feature::Feature(Geometry* geom, const SpatialReference* srs, const Style& style
 Feature::Feature(const Feature& rhs) :
     _fid(rhs._fid),
     _attrs(rhs._attrs),
+    _store(rhs._store),
+    _row(rhs._row),
     _style(rhs._style),
     _geoInterp(rhs._geoInterp),
     _srs(rhs._srs.get())
@@ -255,6 +473,7 @@ Feature::dirty()
 void
 Feature::set( const std::string& name, const std::string& value )
 {
+    _allAttrs.reset();
     AttributeValue& a = _attrs[toLower(name)];
     a.type = ATTRTYPE_STRING;
     a.value.stringValue = value;
@@ -264,6 +483,7 @@ Feature::set( const std::string& name, const std::string& value )
 void
 Feature::set( const std::string& name, double value )
 {
+    _allAttrs.reset();
     AttributeValue& a = _attrs[toLower(name)];
     a.type = ATTRTYPE_DOUBLE;
     a.value.doubleValue = value;
@@ -273,6 +493,7 @@ Feature::set( const std::string& name, double value )
 void
 Feature::set( const std::string& name, long long value )
 {
+    _allAttrs.reset();
     AttributeValue& a = _attrs[toLower(name)];
     a.type = ATTRTYPE_INT;
     a.value.intValue = value;
@@ -282,6 +503,7 @@ Feature::set( const std::string& name, long long value )
 void
 Feature::set(const std::string& name, int value)
 {
+    _allAttrs.reset();
     AttributeValue& a = _attrs[toLower(name)];
     a.type = ATTRTYPE_INT;
     a.value.intValue = value;
@@ -291,12 +513,14 @@ Feature::set(const std::string& name, int value)
 void
 Feature::set( const std::string& name, const AttributeValue& value)
 {
+    _allAttrs.reset();
     _attrs[toLower(name)] = value;
 }
 
 void
 Feature::set( const std::string& name, bool value )
 {
+    _allAttrs.reset();
     AttributeValue& a = _attrs[toLower(name)];
     a.type = ATTRTYPE_BOOL;
     a.value.boolValue = value;
@@ -306,6 +530,7 @@ Feature::set( const std::string& name, bool value )
 void
 Feature::set( const std::string& name, const std::vector<double>& value )
 {
+    _allAttrs.reset();
     AttributeValue& a = _attrs[toLower(name)];
     a.type = ATTRTYPE_DOUBLEARRAY;
     a.value.doubleArrayValue = value;
@@ -315,6 +540,7 @@ Feature::set( const std::string& name, const std::vector<double>& value )
 void
 Feature::setSwap( const std::string& name, std::vector<double>& value )
 {
+    _allAttrs.reset();
     AttributeValue& a = _attrs[toLower(name)];
     a.type = ATTRTYPE_DOUBLEARRAY;
     a.value.doubleArrayValue.swap(value);
@@ -324,6 +550,7 @@ Feature::setSwap( const std::string& name, std::vector<double>& value )
 void
 Feature::setNull( const std::string& name)
 {
+    _allAttrs.reset();
     AttributeValue& a = _attrs[toLower(name)];
     a.value.set = false;
 }
@@ -331,6 +558,7 @@ Feature::setNull( const std::string& name)
 void
 Feature::setNull( const std::string& name, AttributeType type)
 {
+    _allAttrs.reset();
     AttributeValue& a = _attrs[toLower(name)];
     a.type = type;
     a.value.set = false;
@@ -339,55 +567,158 @@ Feature::setNull( const std::string& name, AttributeType type)
 void
 Feature::removeAttribute(const std::string& name)
 {
-    _attrs.erase(toLower(name));
+    std::string key = toLower(name);
+    if (_store.valid() && _store->has(_row, _store->column(key)))
+        detach();
+    _attrs.erase(key);
+    _allAttrs.reset();
 }
 
 bool
 Feature::hasAttr( const std::string& name ) const
 {
-    return _attrs.find(toLower(name)) != _attrs.end();
+    return indexOf(toLower(name)) >= 0;
 }
 
 std::string
 Feature::getString( const std::string& name ) const
 {
-    AttributeTable::const_iterator i = _attrs.find(toLower(name));
-    return i != _attrs.end()? i->second.getString() : EMPTY_STRING;
+    int i = indexOf(toLower(name));
+    return i >= 0 ? getString(i) : EMPTY_STRING;
 }
 
 double
 Feature::getDouble( const std::string& name, double defaultValue ) const
 {
-    AttributeTable::const_iterator i = _attrs.find(toLower(name));
-    return i != _attrs.end()? i->second.getDouble(defaultValue) : defaultValue;
+    std::string key = toLower(name);
+    AttributeTable::const_iterator i = _attrs.find(key);
+    if (i != _attrs.end())
+        return i->second.getDouble(defaultValue);
+    if (_store.valid())
+        return _store->getDouble(_row, _store->column(key), defaultValue);
+    return defaultValue;
 }
 
 long long
 Feature::getInt( const std::string& name, long long defaultValue ) const
 {
-    AttributeTable::const_iterator i = _attrs.find(toLower(name));
-    return i != _attrs.end()? i->second.getInt(defaultValue) : defaultValue;
+    std::string key = toLower(name);
+    AttributeTable::const_iterator i = _attrs.find(key);
+    if (i != _attrs.end())
+        return i->second.getInt(defaultValue);
+    if (_store.valid())
+        return _store->getInt(_row, _store->column(key), defaultValue);
+    return defaultValue;
 }
 
 const std::vector<double>*
 Feature::getDoubleArray( const std::string& name ) const
 {
-    AttributeTable::const_iterator i = _attrs.find(toLower(name));
-    return i != _attrs.end()? &i->second.getDoubleArrayValue() : 0L;
+    std::string key = toLower(name);
+    AttributeTable::const_iterator i = _attrs.find(key);
+    if (i != _attrs.end())
+        return &i->second.getDoubleArrayValue();
+    if (_store.valid())
+        return _store->getDoubleArray(_row, _store->column(key));
+    return 0L;
 }
 
 bool
 Feature::getBool( const std::string& name, bool defaultValue ) const
 {
-    AttributeTable::const_iterator i = _attrs.find(toLower(name));
-    return i != _attrs.end()? i->second.getBool(defaultValue) : defaultValue;
+    std::string key = toLower(name);
+    AttributeTable::const_iterator i = _attrs.find(key);
+    if (i != _attrs.end())
+        return i->second.getBool(defaultValue);
+    if (_store.valid())
+        return _store->getBool(_row, _store->column(key), defaultValue);
+    return defaultValue;
 }
 
 bool
 Feature::isSet( const std::string& name) const
 {
-    AttributeTable::const_iterator i = _attrs.find(toLower(name));
-    return i != _attrs.end()? i->second.value.set : false;
+    std::string key = toLower(name);
+    AttributeTable::const_iterator i = _attrs.find(key);
+    if (i != _attrs.end())
+        return i->second.value.set;
+    if (_store.valid())
+        return _store->isSet(_row, _store->column(key));
+    return false;
+}
+
+const AttributeTable&
+Feature::getAttrs() const
+{
+    if (!_store.valid())
+        return _attrs;
+
+    // const readers may race to build it; the first table published wins
+    auto all = std::atomic_load(&_allAttrs);
+    if (!all)
+    {
+        auto built = std::make_shared<const AttributeTable>(getAllAttrs());
+        if (std::atomic_compare_exchange_strong(&_allAttrs, &all, built))
+            all = built;
+    }
+    return *all;
+}
+
+AttributeTable
+Feature::getAllAttrs() const
+{
+    if (!_store.valid())
+        return _attrs;
+
+    AttributeTable result;
+    result._container.reserve(getNumAttrs());
+    forEachAttr([&](const std::string& name, const AttributeValue& value) {
+        result._container.push_back({ name, value });
+    });
+    return result;
+}
+
+unsigned
+Feature::getNumAttrs() const
+{
+    unsigned count = _attrs.size();
+    if (_store.valid())
+    {
+        for (int c = 0; c < _store->numColumns(); ++c)
+        {
+            if (_store->has(_row, c) && _attrs.indexOf(_store->name(c)) < 0)
+                ++count;
+        }
+    }
+    return count;
+}
+
+void
+Feature::setAttributeStore(const AttributeStore* store, unsigned row)
+{
+    _store = store;
+    _row = row;
+    _allAttrs.reset();
+}
+
+void
+Feature::detach()
+{
+    // copy the store row into the local table so we can modify it freely
+    if (_store.valid())
+    {
+        AttributeValue value;
+        for (int c = 0; c < _store->numColumns(); ++c)
+        {
+            if (_attrs.indexOf(_store->name(c)) < 0 && _store->get(_row, c, value))
+            {
+                _attrs[_store->name(c)] = value;
+            }
+        }
+        _store = nullptr;
+        _row = 0u;
+        _allAttrs.reset();
+    }
 }
 
 double
@@ -404,10 +735,10 @@ Feature::eval( NumericExpression& expr, FilterContext const* context ) const
     for (NumericExpression::Variables::const_iterator i = vars.begin(); i != vars.end(); ++i)
     {
         double val = 0.0;
-        AttributeTable::const_iterator ai = _attrs.find(toLower(i->first));
-        if (ai != _attrs.end())
+        int index = indexOf(toLower(i->first));
+        if (index >= 0)
         {
-            val = ai->second.getDouble(0.0);
+            val = getDouble(index);
         }
         else if (context && context->getSession())
         {
@@ -444,10 +775,10 @@ Feature::eval(NumericExpression& expr, Session* session) const
     for( NumericExpression::Variables::const_iterator i = vars.begin(); i != vars.end(); ++i )
     {
         double val = 0.0;
-        AttributeTable::const_iterator ai = _attrs.find(toLower(i->first));
-        if (ai != _attrs.end())
+        int index = indexOf(toLower(i->first));
+        if (index >= 0)
         {
-            val = ai->second.getDouble(0.0);
+            val = getDouble(index);
         }
         else if (session)
         {
@@ -487,10 +818,10 @@ Feature::eval(StringExpression& expr, FilterContext const* context) const
     for (StringExpression::Variables::const_iterator i = vars.begin(); i != vars.end(); ++i)
     {
         std::string val = "";
-        AttributeTable::const_iterator ai = _attrs.find(toLower(i->first));
-        if (ai != _attrs.end())
+        int index = indexOf(toLower(i->first));
+        if (index >= 0)
         {
-            val = ai->second.getString();
+            val = getString(index);
         }
         else if (context && context->getSession())
         {
@@ -530,10 +861,10 @@ Feature::eval(StringExpression& expr, Session* session) const
     for( StringExpression::Variables::const_iterator i = vars.begin(); i != vars.end(); ++i )
     {
         std::string val = "";
-        AttributeTable::const_iterator ai = _attrs.find(toLower(i->first));
-        if (ai != _attrs.end())
+        int index = indexOf(toLower(i->first));
+        if (index >= 0)
         {
-            val = ai->second.getString();
+            val = getString(index);
         }
         else if (session)
         {
@@ -684,9 +1015,10 @@ Feature::getGeoJSON() const
 
     //Write out all the properties
     Json::Value props(Json::objectValue);
-    if (getAttrs().size() > 0)
+    AttributeTable attrs = getAllAttrs();
+    if (attrs.size() > 0)
     {
-        for (AttributeTable::const_iterator itr = getAttrs().begin(); itr != getAttrs().end(); ++itr)
+        for (AttributeTable::const_iterator itr = attrs.begin(); itr != attrs.end(); ++itr)
         {
             if (itr->second.type == ATTRTYPE_INT)
             {
@@ -764,6 +1096,80 @@ std::string Feature::featuresToGeoJSON(const FeatureList& features)
 
 }
 
+bool
+Feature::readGeoJSON(const std::string& path, const std::function<bool(Feature*)>& callback)
+{
+    Json::Document doc;
+    if (!doc.open(path) || !doc.root().isObject())
+        return false;
+
+    // GeoJSON is always WGS84 according to spec
+    osg::ref_ptr<const SpatialReference> srs = SpatialReference::get("wgs84");
+
+    // features share a columnar store, in batches
+    const unsigned batchSize = 1024u;
+    osg::ref_ptr<AttributeStore> store;
+
+    auto emit = [&](const Json::View& value)
+    {
+        if (value["type"].asString() != "Feature")
+            return true;
+
+        // a feature with no geometry is valid GeoJSON; keep it
+        osg::ref_ptr<Geometry> geometry;
+        Json::View geom = value["geometry"];
+        if (geom.isObject())
+        {
+            geometry = GeometryUtils::geometryFromGeoJSON(geom.text());
+            if (!geometry.valid())
+                return true;
+        }
+
+        osg::ref_ptr<Feature> feature = new Feature(geometry.get(), srs.get());
+
+        Json::View id = value["id"];
+        if (id.isNumeric())
+            feature->setFID(id.asInt());
+
+        if (!store.valid() || store->numRows() >= batchSize)
+        {
+            store = new AttributeStore();
+            store->reserve(batchSize);
+        }
+        unsigned row = store->addRow();
+        feature->setAttributeStore(store.get(), row);
+
+        value["properties"].forEachMember([&](const std::string& name, const Json::View& prop)
+        {
+            switch (prop.type())
+            {
+            case Json::stringValue:  store->set(row, store->addColumn(name), prop.asString()); break;
+            case Json::intValue:     store->set(row, store->addColumn(name), prop.asInt()); break;
+            case Json::realValue:    store->set(row, store->addColumn(name), prop.asDouble()); break;
+            case Json::booleanValue: store->set(row, store->addColumn(name), prop.asBool()); break;
+            case Json::nullValue:    break;
+            default:                 store->set(row, store->addColumn(name), prop.text()); break; // nested JSON
+            }
+            return true;
+        });
+
+        return callback(feature.get());
+    };
+
+    const Json::View& root = doc.root();
+    std::string type = root["type"].asString();
+    if (type == "FeatureCollection")
+    {
+        return root["features"].forEach(emit);
+    }
+    else if (type == "Feature")
+    {
+        emit(root);
+        return true;
+    }
+    return false;
+}
+
 void Feature::transform( const SpatialReference* srs )
 {
     if (!getGeometry())
@@ -173,84 +173,102 @@ FeatureElevationLayer::createHeightFieldImplementation(const TileKey& key, Progr
     //Only allocate the heightfield if we actually intersect any features.
     osg::ref_ptr<osg::HeightField> hf = new osg::HeightField;
     hf->allocate(tileSize, tileSize);
-    for (unsigned int i = 0; i < hf->getHeightList().size(); ++i) hf->getHeightList()[i] = NO_DATA_VALUE;
 
     // Iterate over the output heightfield and sample the data that was read into it.
     double dx = (xmax - xmin) / (tileSize - 1);
     double dy = (ymax - ymin) / (tileSize - 1);
 
-    for (int c = 0; c < tileSize; ++c)
+    // Fill each feature's polygon into the grid with a scanline pass.
+    // Where features overlap, the first one in the list wins.
+    std::vector<float> heights(tileSize * tileSize, NO_DATA_VALUE);
+    std::vector<bool> filled(tileSize * tileSize, false);
+
+    for (auto& feature : featureList)
     {
-        double geoX = xmin + (dx * (double)c);
-        for (int r = 0; r < tileSize; ++r)
+        if (progress && progress->isCanceled())
+            return GeoHeightField::INVALID;
+
+        osgEarth::Polygon* boundary = dynamic_cast<osgEarth::Polygon*>(feature->getGeometry());
+
+        if (!boundary)
         {
-            double geoY = ymin + (dy * (double)r);
+            OE_WARN << LC << "NOT A POLYGON" << std::endl;
+            continue;
+        }
+
+        float h = feature->getDouble(options().attr().get());
 
-            float h = NO_DATA_VALUE;
+        // For transforming between ECEF and the local tangent plane at the feature's center:
+        osg::Matrix localToWorld, worldToLocal;
+        if (keySRS->isGeographic())
+        {
+            Bounds bounds = boundary->getBounds();
+            GeoPoint anchor(featureSRS, bounds.center().x(), bounds.center().y(), h, ALTMODE_ABSOLUTE);
+            if (transformRequired)
+                anchor = anchor.transform(keySRS);
+
+            anchor.createLocalToWorld(localToWorld);
+            worldToLocal.invert(localToWorld);
+        }
+
+        // The grid is in the key's SRS, so fill the polygon there.
+        osg::ref_ptr<osgEarth::Polygon> keyBoundary = boundary;
+        if (transformRequired)
+        {
+            keyBoundary = static_cast<osgEarth::Polygon*>(boundary->clone());
+            featureSRS->transform(keyBoundary->asVector(), keySRS);
+            for (auto& hole : keyBoundary->getHoles())
+                featureSRS->transform(hole->asVector(), keySRS);
+        }
 
-            for (FeatureList::iterator f = featureList.begin(); f != featureList.end(); ++f)
+        keyBoundary->rasterize2D(xmin, ymin, dx, dy, tileSize, tileSize, [&](unsigned c, unsigned r)
             {
-                if (progress && progress->isCanceled())
-                    return GeoHeightField::INVALID;
+                unsigned i = r * tileSize + c;
+                if (filled[i])
+                    return;
 
-                osgEarth::Polygon* boundary = dynamic_cast<osgEarth::Polygon*>((*f)->getGeometry());
+                filled[i] = true;
+                heights[i] = h;
 
-                if (!boundary)
+                if (keySRS->isGeographic())
                 {
-                    OE_WARN << LC << "NOT A POLYGON" << std::endl;
-                }
-                else
-                {
-                    GeoPoint geo(keySRS, geoX, geoY, 0.0, ALTMODE_ABSOLUTE);
+                    // for a round earth, must adjust the final elevation accounting for the
+                    // curvature of the earth; so we have to adjust it in the feature boundary's
+                    // local tangent plane.
+                    GeoPoint geo(keySRS, xmin + (dx * (double)c), ymin + (dy * (double)r), 0.0, ALTMODE_ABSOLUTE);
 
                     if (transformRequired)
                         geo = geo.transform(featureSRS);
 
-                    if (boundary->contains2D(geo.x(), geo.y()))
-                    {
-                        h = (*f)->getDouble(options().attr().get());
-
-                        if (keySRS->isGeographic())
-                        {
-                            // for a round earth, must adjust the final elevation accounting for the
-                            // curvature of the earth; so we have to adjust it in the feature boundary's
-                            // local tangent plane.
-                            Bounds bounds = boundary->getBounds();
-                            GeoPoint anchor(featureSRS, bounds.center().x(), bounds.center().y(), h, ALTMODE_ABSOLUTE);
-                            if (transformRequired)
-                                anchor = anchor.transform(keySRS);
-
-                            // For transforming between ECEF and local tangent plane:
-                            osg::Matrix localToWorld, worldToLocal;
-                            anchor.createLocalToWorld(localToWorld);
-                            worldToLocal.invert(localToWorld);
-
-                            // Get the ECEF location of the anchor point:
-                            osg::Vec3d ecef;
-                            geo.toWorld(ecef);
-
-                            // Move it into Local Tangent Plane coordinates:
-                            osg::Vec3d local = ecef * worldToLocal;
-
-                            // Reset the Z to zero, since the LTP is centered on the "h" elevation:
-                            local.z() = 0.0;
-
-                            // Back into ECEF:
-                            ecef = local * localToWorld;
-
-                            // And back into lat/long/alt:
-                            geo.fromWorld(geo.getSRS(), ecef);
-
-                            h = geo.z();
-                        }
-                        break;
-                    }
+                    // Get the ECEF location of the point:
+                    osg::Vec3d ecef;
+                    geo.toWorld(ecef);
+
+                    // Move it into Local Tangent Plane coordinates:
+                    osg::Vec3d local = ecef * worldToLocal;
+
+                    // Reset the Z to zero, since the LTP is centered on the "h" elevation:
+                    local.z() = 0.0;
+
+                    // Back into ECEF:
+                    ecef = local * localToWorld;
+
+                    // And back into lat/long/alt:
+                    geo.fromWorld(geo.getSRS(), ecef);
+
+                    heights[i] = geo.z();
                 }
-            }
+            });
+    }
 
-            hf->setHeight(c, r, h + options().offset().get());
+    for (int r = 0; r < tileSize; ++r)
+    {
+        for (int c = 0; c < tileSize; ++c)
+        {
+            hf->setHeight(c, r, heights[r * tileSize + c] + options().offset().get());
         }
     }
+
     return GeoHeightField(hf.release(), key.getExtent());
 }
 
@@ -0,0 +1,433 @@
+/* osgEarth
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include <osgEarth/FeatureExpression>
+#include <osgEarth/FilterContext>
+#include <osgEarth/Session>
+#include <osgEarth/ScriptEngine>
+#include <osgEarth/StringUtils>
+#include <osgEarth/Notify>
+#include <algorithm>
+#include <cmath>
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+#define LC "[FeatureExpression] "
+
+namespace
+{
+    // Features evaluated together in one pass of the bytecode. Small enough
+    // that the columns and the stack stay in L1.
+    constexpr unsigned CHUNK_SIZE = 256u;
+
+    // Finds an attribute, trying the location where we found it last time
+    // before falling back on the name search. Sets either "local" or "column".
+    inline bool lookup(
+        const Feature* feature, const std::string& name, AttributeHint& hint,
+        const AttributeValue*& local, int& column)
+    {
+        const AttributeTable& attrs = feature->getLocalAttrs();
+        if (!attrs.empty())
+        {
+            if (hint.local < 0 || hint.local >= attrs.size() || (attrs.begin() + hint.local)->first != name)
+                hint.local = attrs.indexOf(name);
+
+            if (hint.local >= 0)
+            {
+                local = &attrs.at(hint.local);
+                return true;
+            }
+        }
+
+        const AttributeStore* store = feature->getAttributeStore();
+        if (store)
+        {
+            if (store != hint.store)
+            {
+                hint.store = store;
+                hint.column = store->column(name);
+            }
+
+            if (store->has(feature->getAttributeRow(), hint.column))
+            {
+                local = nullptr;
+                column = hint.column;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline ScriptEngine* getScriptEngine(const FilterContext* context)
+    {
+        return context && context->getSession() ? context->getSession()->getScriptEngine() : nullptr;
+    }
+
+    // same semantics as the std::stack evaluator in NumericExpression::eval
+    inline double apply(std::uint8_t op, double a, double b)
+    {
+        switch (op)
+        {
+        case 1: return a + b;
+        case 2: return a - b;
+        case 3: return a * b;
+        case 4: return a / b;
+        case 5: return fmod(a, b);
+        case 6: return osg::minimum(a, b);
+        default: return osg::maximum(a, b);
+        }
+    }
+
+    // Runs one operator over a chunk; "bstep" is 0 for a constant operand.
+    template<typename FUNC>
+    inline void lanes(double* a, const double* b, unsigned bstep, unsigned count, FUNC&& func)
+    {
+        for (unsigned k = 0; k < count; ++k)
+            a[k] = func(a[k], b[k * bstep]);
+    }
+}
+
+//........................................................................
+
+CompiledNumericExpression::CompiledNumericExpression(const NumericExpression& expr) :
+    _src(expr._src)
+{
+    unsigned depth = 0u;
+
+    for (auto& atom : expr._rpn)
+    {
+        if (atom.first == NumericExpression::OPERAND)
+        {
+            _constants.push_back(atom.second);
+            _code.push_back(Instruction{ PUSH, CONSTANT, (unsigned)_constants.size() - 1u });
+            ++depth;
+        }
+        else if (atom.first == NumericExpression::VARIABLE)
+        {
+            // find the variable's name by its RPN position
+            std::string script;
+            for (auto& var : expr._vars)
+            {
+                if (&expr._rpn[var.second] == &atom)
+                {
+                    script = var.first;
+                    break;
+                }
+            }
+
+            std::string name = toLower(script);
+            unsigned slot = 0u;
+            while (slot < _slots.size() && _slots[slot].name != name)
+                ++slot;
+            if (slot == _slots.size())
+                _slots.push_back(Slot{ name, script });
+
+            _code.push_back(Instruction{ PUSH, COLUMN, slot });
+            ++depth;
+        }
+        else
+        {
+            Op op;
+            switch (atom.first)
+            {
+            case NumericExpression::ADD:  op = ADD; break;
+            case NumericExpression::SUB:  op = SUB; break;
+            case NumericExpression::MULT: op = MULT; break;
+            case NumericExpression::DIV:  op = DIV; break;
+            case NumericExpression::MOD:  op = MOD; break;
+            case NumericExpression::MIN:  op = MIN; break;
+            case NumericExpression::MAX:  op = MAX; break;
+            default: continue;
+            }
+
+            // The interpreter ignores operators that are short an operand;
+            // the stack depth is static, so drop them now.
+            if (depth < 2u)
+                continue;
+
+            --depth;
+
+            // The top of the stack always comes from the last instruction.
+            Instruction b = _code.back();
+            if (b.op == PUSH)
+            {
+                Instruction& a = _code[_code.size() - 2];
+                if (b.source == CONSTANT && a.op == PUSH && a.source == CONSTANT)
+                {
+                    // constant folding
+                    _constants[a.arg] = apply(op, _constants[a.arg], _constants[b.arg]);
+                    _code.pop_back();
+                }
+                else
+                {
+                    // operator takes the pushed value as an immediate operand
+                    _code.back() = Instruction{ op, b.source, b.arg };
+                }
+            }
+            else
+            {
+                _code.push_back(Instruction{ op, STACK, 0u });
+            }
+        }
+    }
+
+    // runtime stack depth
+    unsigned sp = 0u;
+    for (auto& i : _code)
+    {
+        if (i.op == PUSH) ++sp;
+        else if (i.source == STACK) --sp;
+        _depth = std::max(_depth, sp);
+    }
+}
+
+double
+CompiledNumericExpression::fetch(const Slot& slot, const Feature* feature, const FilterContext* context, AttributeHint& hint) const
+{
+    const AttributeValue* local;
+    int column;
+    if (lookup(feature, slot.name, hint, local, column))
+    {
+        return local ?
+            local->getDouble(0.0) :
+            feature->getAttributeStore()->getDouble(feature->getAttributeRow(), column, 0.0);
+    }
+
+    //No attr found, look for script
+    ScriptEngine* engine = getScriptEngine(context);
+    if (engine)
+    {
+        ScriptResult result = engine->run(slot.script, feature, context);
+        if (result.success())
+            return result.asDouble();
+
+        OE_WARN << LC << "Feature Script error on '" << _src << "': " << result.message() << std::endl;
+    }
+    return 0.0;
+}
+
+void
+CompiledNumericExpression::run(
+    const double* columns, unsigned stride, unsigned count,
+    double* stack, double* output) const
+{
+    unsigned sp = 0u;
+
+    for (auto& i : _code)
+    {
+        if (i.op == PUSH)
+        {
+            double* top = stack + sp * stride;
+            if (i.source == CONSTANT)
+                std::fill(top, top + count, _constants[i.arg]);
+            else
+                std::copy(columns + i.arg * stride, columns + i.arg * stride + count, top);
+            ++sp;
+            continue;
+        }
+
+        const double* b;
+        unsigned bstep = 1u;
+        if (i.source == STACK)
+        {
+            b = stack + (--sp) * stride;
+        }
+        else if (i.source == CONSTANT)
+        {
+            b = &_constants[i.arg];
+            bstep = 0u;
+        }
+        else
+        {
+            b = columns + i.arg * stride;
+        }
+
+        double* a = stack + (sp - 1u) * stride;
+
+        switch (i.op)
+        {
+        case ADD:  lanes(a, b, bstep, count, [](double x, double y) { return x + y; }); break;
+        case SUB:  lanes(a, b, bstep, count, [](double x, double y) { return x - y; }); break;
+        case MULT: lanes(a, b, bstep, count, [](double x, double y) { return x * y; }); break;
+        case DIV:  lanes(a, b, bstep, count, [](double x, double y) { return x / y; }); break;
+        case MOD:  lanes(a, b, bstep, count, [](double x, double y) { return fmod(x, y); }); break;
+        case MIN:  lanes(a, b, bstep, count, [](double x, double y) { return osg::minimum(x, y); }); break;
+        default:   lanes(a, b, bstep, count, [](double x, double y) { return osg::maximum(x, y); }); break;
+        }
+    }
+
+    for (unsigned k = 0; k < count; ++k)
+    {
+        double value = sp > 0u ? stack[(sp - 1u) * stride + k] : 0.0;
+        output[k] = !osg::isNaN(value) ? value : 0.0;
+    }
+}
+
+double
+CompiledNumericExpression::eval(const Feature* feature, const FilterContext* context) const
+{
+    std::vector<double> columns(_slots.size());
+    std::vector<double> stack(_depth);
+
+    if (feature)
+    {
+        for (unsigned s = 0; s < _slots.size(); ++s)
+        {
+            AttributeHint hint;
+            columns[s] = fetch(_slots[s], feature, context, hint);
+        }
+    }
+
+    double result;
+    run(columns.data(), 1u, 1u, stack.data(), &result);
+    return result;
+}
+
+void
+CompiledNumericExpression::eval(
+    const FeatureList& features,
+    const FilterContext* context,
+    std::vector<double>& output) const
+{
+    output.resize(features.size());
+
+    if (features.empty())
+        return;
+
+    if (isConstant())
+    {
+        std::fill(output.begin(), output.end(), eval(nullptr, context));
+        return;
+    }
+
+    std::vector<double> columns(_slots.size() * CHUNK_SIZE);
+    std::vector<double> stack(_depth * CHUNK_SIZE);
+    std::vector<AttributeHint> hints(_slots.size());
+
+    for (std::size_t first = 0; first < features.size(); first += CHUNK_SIZE)
+    {
+        unsigned count = (unsigned)std::min((std::size_t)CHUNK_SIZE, features.size() - first);
+
+        // gather one column per variable
+        for (unsigned s = 0; s < _slots.size(); ++s)
+        {
+            double* column = &columns[s * CHUNK_SIZE];
+            for (unsigned k = 0; k < count; ++k)
+            {
+                const Feature* feature = features[first + k].get();
+                column[k] = feature ? fetch(_slots[s], feature, context, hints[s]) : 0.0;
+            }
+        }
+
+        run(columns.data(), CHUNK_SIZE, count, stack.data(), &output[first]);
+    }
+}
+
+//........................................................................
+
+CompiledStringExpression::CompiledStringExpression(const StringExpression& expr) :
+    _src(expr._src)
+{
+    for (unsigned i = 0; i < expr._infix.size(); ++i)
+    {
+        auto& atom = expr._infix[i];
+
+        if (atom.first == StringExpression::OPERAND)
+        {
+            if (_parts.empty() || _parts.back().slot >= 0)
+                _parts.push_back(Part{ atom.second, -1 });
+            else
+                _parts.back().literal += atom.second;
+        }
+        else
+        {
+            // the variable name; the atom itself holds the last value set
+            std::string script;
+            for (auto& var : expr._vars)
+            {
+                if (var.second == i)
+                {
+                    script = var.first;
+                    break;
+                }
+            }
+
+            std::string name = toLower(script);
+            int slot = 0;
+            while (slot < (int)_slots.size() && _slots[slot].name != name)
+                ++slot;
+            if (slot == (int)_slots.size())
+                _slots.push_back(Slot{ name, script });
+
+            _parts.push_back(Part{ {}, slot });
+        }
+    }
+}
+
+void
+CompiledStringExpression::append(
+    const Feature* feature, const FilterContext* context,
+    std::vector<AttributeHint>& hints, std::string& output) const
+{
+    for (auto& part : _parts)
+    {
+        if (part.slot < 0)
+        {
+            output += part.literal;
+            continue;
+        }
+
+        const Slot& slot = _slots[part.slot];
+
+        const AttributeValue* local;
+        int column;
+        if (feature && lookup(feature, slot.name, hints[part.slot], local, column))
+        {
+            output += local ?
+                local->getString() :
+                feature->getAttributeStore()->getString(feature->getAttributeRow(), column);
+        }
+        else if (feature)
+        {
+            //No attr found, look for script
+            ScriptEngine* engine = getScriptEngine(context);
+            if (engine)
+            {
+                ScriptResult result = engine->run(slot.script, feature, context);
+                if (result.success())
+                    output += result.asString();
+                else
+                    // Couldn't execute it as code, just take it as a string literal.
+                    output += slot.script;
+            }
+        }
+    }
+}
+
+std::string
+CompiledStringExpression::eval(const Feature* feature, const FilterContext* context) const
+{
+    std::string result;
+    std::vector<AttributeHint> hints(_slots.size());
+    append(feature, context, hints, result);
+    return result;
+}
+
+void
+CompiledStringExpression::eval(
+    const FeatureList& features,
+    const FilterContext* context,
+    std::vector<std::string>& output) const
+{
+    output.resize(features.size());
+
+    std::vector<AttributeHint> hints(_slots.size());
+
+    for (std::size_t i = 0; i < features.size(); ++i)
+    {
+        output[i].clear();
+        append(features[i].get(), context, hints, output[i]);
+    }
+}
@@ -8,6 +8,8 @@
 #include <osgEarth/CropFilter>
 #include <osgEarth/FeatureSourceIndexNode>
 #include <osgEarth/FilterContext>
+#include <osgEarth/FileUtils>
+#include <osgEarth/StyleSheet>
 
 #include <osgEarth/CullingUtils>
 #include <osgEarth/ElevationLOD>
@@ -26,6 +28,7 @@
 #include <osg/PolygonOffset>
 #include <osg/Depth>
 #include <osg/ShapeDrawable>
+#include <osgDB/FileUtils>
 
 #include <iterator>
 
@@ -470,6 +473,15 @@ FeatureModelGraph::open()
         _usableFeatureExtent.expand(-0.001, -0.001);
     }
 
+    // Compiled tiles are only valid for the current data and styles
+    if (_options.nodeCaching() == true)
+    {
+        _cacheRevision = makeCacheRevision(
+            _session->getFeatureSource(),
+            _session->styles(),
+            _options);
+    }
+
     // Create a filter chain if necessary
     _filterChain = FeatureFilterChain::create(_options.filters(), NULL);
 
@@ -694,6 +706,13 @@ void
 FeatureModelGraph::shutdown()
 {
     _isActive = false;
+
+    if (_cacheReads > 0)
+    {
+        OE_INFO << LC << "Compiled-tile cache hit "
+            << _cacheHits << " of " << _cacheReads << " reads ("
+            << (100 * _cacheHits / _cacheReads) << "%)" << std::endl;
+    }
 }
 
 FeatureModelGraph::~FeatureModelGraph()
@@ -1140,19 +1159,50 @@ FeatureModelGraph::buildSubTilePagedLODs(
     }
 }
 
+// Changing any input makes the old cached tiles unreachable instead of
+// serving them stale.
+std::string
+FeatureModelGraph::makeCacheRevision(
+    const FeatureSource* source,
+    const StyleSheet* styles,
+    const FeatureModelOptions& options)
+{
+    std::stringstream buf;
+
+    // the layer revision changes when the source is dirtied at runtime;
+    // for local files, the time stamp catches edits between sessions.
+    if (source)
+    {
+        Config sourceConf = source->getConfig();
+        buf << sourceConf.toJSON() << ";" << source->getRevision();
+
+        std::string url = sourceConf.value("url");
+        if (!url.empty() && osgDB::fileExists(url))
+            buf << ";" << getLastModifiedTime(url);
+    }
+
+    if (styles)
+        buf << ";" << styles->getConfig().toJSON() << ";" << styles->getRevision();
+
+    buf << ";" << options.getConfig().toJSON();
+
+    return hashToString(buf.str());
+}
+
 namespace
 {
     std::string makeCacheKey(const FeatureLevel& level,
         const GeoExtent& extent,
-        const TileKey* key)
+        const TileKey* key,
+        const std::string& revision)
     {
         if (key)
         {
-            return Cache::makeCacheKey(key->str(), "fmg");
+            return Cache::makeCacheKey(revision + "/" + key->str(), "fmg");
         }
         else
         {
-            std::string b = Stringify() << extent.toString() << level.styleName().get();
+            std::string b = Stringify() << revision << "/" << extent.toString() << level.styleName().get();
             return Cache::makeCacheKey(b, "fmg");
         }
     }
@@ -1192,6 +1242,7 @@ FeatureModelGraph::readTileFromCache(const std::string&    cacheKey,
             // loaded from cache.
             group = dynamic_cast<osg::Group*>(rr.getNode());
             ++_cacheHits;
+            OE_PROFILING_PLOT("FMG cache hit %", (int64_t)(100 * _cacheHits / std::max(1, (int)_cacheReads)));
 
             // remap the feature index.
             if (group.valid() && _featureIndex.valid())
@@ -1215,8 +1266,6 @@ FeatureModelGraph::readTileFromCache(const std::string&    cacheKey,
             // some other error.
             OE_WARN << LC << "Cache read error (cacheKey=" << cacheKey << ") " << rr.getResultCodeString() << "; " << rr.errorDetail() << "\n";
         }
-
-        //OE_DEBUG << "cache hit ratio = " << float(_cacheHits) / float(_cacheReads) << "\n";
     }
 
     return group.release();
@@ -1264,7 +1313,7 @@ FeatureModelGraph::buildTile(
     osg::ref_ptr<osg::Group> group;
 
     // Try to read it from a cache:
-    std::string cacheKey = makeCacheKey(level, extent, key);
+    std::string cacheKey = makeCacheKey(level, extent, key, _cacheRevision);
 
     if (_options.nodeCaching() == true)
     {
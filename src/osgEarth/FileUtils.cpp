@@ -96,6 +96,8 @@
 
     #include <stdlib.h>
     #include <unistd.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
     #include <sys/types.h>
     #include <sys/stat.h>
 #endif
@@ -590,3 +592,59 @@ void CollectFilesVisitor::handleFile( const std::string& filename )
 	filenames.push_back( filename );
 }
 
+/**************************************************/
+bool
+MappedFile::open(const std::string& path)
+{
+    close();
+#if defined(WIN32) && !defined(__CYGWIN__)
+    HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    _file = file;
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file, &size))
+        return false;
+    if (size.QuadPart == 0)
+        return true;
+    _mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mapping == nullptr)
+        return false;
+    _data = static_cast<const char*>(::MapViewOfFile(static_cast<HANDLE>(_mapping), FILE_MAP_READ, 0, 0, 0));
+    _size = (std::size_t)size.QuadPart;
+#else
+    _fd = ::open(path.c_str(), O_RDONLY);
+    if (_fd < 0)
+        return false;
+    struct stat sb;
+    if (::fstat(_fd, &sb) != 0)
+        return false;
+    if (sb.st_size == 0)
+        return true;
+    void* ptr = ::mmap(nullptr, (std::size_t)sb.st_size, PROT_READ, MAP_SHARED, _fd, 0);
+    if (ptr == MAP_FAILED)
+        return false;
+    _data = static_cast<const char*>(ptr);
+    _size = (std::size_t)sb.st_size;
+#endif
+    return _data != nullptr;
+}
+
+void
+MappedFile::close()
+{
+#if defined(WIN32) && !defined(__CYGWIN__)
+    if (_data) ::UnmapViewOfFile(_data);
+    if (_mapping) ::CloseHandle(static_cast<HANDLE>(_mapping));
+    if (_file) ::CloseHandle(static_cast<HANDLE>(_file));
+    _mapping = nullptr;
+    _file = nullptr;
+#else
+    if (_data) ::munmap(const_cast<char*>(_data), _size);
+    if (_fd >= 0) ::close(_fd);
+    _fd = -1;
+#endif
+    _data = nullptr;
+    _size = 0u;
+}
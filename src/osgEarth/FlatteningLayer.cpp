@@ -139,25 +139,6 @@ namespace
         return p->getBounds().center();
     }
 
-    double getDistanceSquaredToClosestEdge(const osg::Vec3d& P, const Polygon* poly)
-    {
-        double Dmin = DBL_MAX;
-        ConstSegmentIterator seg_iter(poly, true);
-        while (seg_iter.hasMore())
-        {
-            auto& segment = seg_iter.next();
-            const POINT& A = segment.first;
-            const POINT& B = segment.second;
-            const VECTOR AP = P - A, AB = B - A;
-            double t = clamp((AP*AB) / AB.length2(), 0.0, 1.0);
-            VECTOR PROJ = A + AB * t;
-            double D = (P - PROJ).length2();
-            if (D < Dmin) Dmin = D;
-        }
-        return Dmin;
-    }
-
-
     struct Widths {
         Widths(const Widths& rhs) {
             bufferWidth = rhs.bufferWidth;
@@ -175,6 +156,24 @@ namespace
 
     typedef std::vector<Widths> WidthsList;
 
+    // A polygon participating in flattening, with its flattening height.
+    struct FlatPolygon
+    {
+        const Polygon* polygon;
+        double bufferWidth;
+        osg::Vec3d internalPoint; // z = sampled elevation
+    };
+
+    // An outer-ring edge of a FlatPolygon.
+    struct PolygonEdge
+    {
+        osg::Vec3d A;
+        osg::Vec3d B;
+        unsigned polygonIndex;
+    };
+
+    using PolygonIndex = RTree<unsigned, double, 2>;
+
     // Creates a heightfield that flattens an area intersecting the input polygon geometry.
     // The height of the area is found by sampling a point internal to the polygon.
     // bufferWidth = width of transition from flat area to natural terrain.
@@ -189,81 +188,169 @@ namespace
         double col_interval = ex.width() / (double)(hf->getNumColumns() - 1);
         double row_interval = ex.height() / (double)(hf->getNumRows() - 1);
 
-        POINT Pex, P, internalP;
-        GeoPoint EP(geomSRS, 0, 0, 0);
+        // Collect the polygons, index their bounds and their edges so each cell
+        // only visits the polygons that contain it and the edges within reach.
+        std::vector<FlatPolygon> polygons;
+        std::vector<PolygonEdge> edges;
+        PolygonIndex polygonIndex;
+        PolygonIndex edgeIndex;
+        double maxBufferWidth = 0.0;
 
-        bool needsTransform = ex.getSRS() != geomSRS;
-        
         ConstGeometryIterator giter;
 
-        for (unsigned col = 0; col < hf->getNumColumns(); ++col)
+        for (unsigned int geomIndex = 0; geomIndex < geom->getNumComponents(); geomIndex++)
         {
-            Pex.x() = ex.xMin() + (double)col * col_interval;
+            Geometry* component = geom->getComponents()[geomIndex].get();
+            const Widths& width = widths[geomIndex];
 
-            for (unsigned row = 0; row < hf->getNumRows(); ++row)
+            giter.reset(component, false);
+            while (giter.hasMore())
             {
-                // check for cancelation periodically
-                //if (progress && progress->isCanceled())
-                //    return false;
+                auto part = giter.next();
+                if (part->getType() == Geometry::TYPE_POLYGON)
+                {
+                    auto polygon = static_cast<const Polygon*>(part);
+                    unsigned p = polygons.size();
+                    polygons.push_back(FlatPolygon{ polygon, width.bufferWidth, getInternalPoint(polygon) });
+                    maxBufferWidth = osg::maximum(maxBufferWidth, width.bufferWidth);
+
+                    Bounds b = polygon->getBounds();
+                    double min[2] = { b.xMin(), b.yMin() };
+                    double max[2] = { b.xMax(), b.yMax() };
+                    polygonIndex.Insert(min, max, p);
+
+                    ConstSegmentIterator seg_iter(polygon, true);
+                    while (seg_iter.hasMore())
+                    {
+                        auto& segment = seg_iter.next();
+                        double emin[2] = { osg::minimum(segment.first.x(), segment.second.x()), osg::minimum(segment.first.y(), segment.second.y()) };
+                        double emax[2] = { osg::maximum(segment.first.x(), segment.second.x()), osg::maximum(segment.first.y(), segment.second.y()) };
+                        edgeIndex.Insert(emin, emax, (unsigned)edges.size());
+                        edges.push_back(PolygonEdge{ segment.first, segment.second, p });
+                    }
+                }
+            }
+        }
 
-                Pex.y() = ex.yMin() + (double)row * row_interval;
+        if (polygons.empty() && !fillAllPixels)
+            return false;
 
-                if (needsTransform)
-                    ex.getSRS()->transform(Pex, geomSRS, P);
-                else
-                    P = Pex;
+        Distance samplingResolution = Distance(0.0, Units::METERS);
+
+        // Sample the flattening height of every polygon in one batch:
+        if (!polygons.empty())
+        {
+            std::vector<osg::Vec3d> internalPoints;
+            internalPoints.reserve(polygons.size());
+            for (auto& polygon : polygons)
+                internalPoints.emplace_back(polygon.internalPoint.x(), polygon.internalPoint.y(), 0.0);
+
+            geomSRS->transform(internalPoints, pool->getMapSRS());
+            pool->sampleMapCoords(internalPoints.begin(), internalPoints.end(), samplingResolution, workingSet, nullptr);
+
+            for (unsigned i = 0; i < polygons.size(); ++i)
+                polygons[i].internalPoint.z() = internalPoints[i].z();
+        }
+
+        // Cell locations in the feature SRS, and their natural elevations in one batch:
+        unsigned numCols = hf->getNumColumns();
+        unsigned numRows = hf->getNumRows();
+
+        std::vector<osg::Vec3d> cellPoints;
+        cellPoints.reserve(numCols * numRows);
+        for (unsigned row = 0; row < numRows; ++row)
+        {
+            double y = ex.yMin() + (double)row * row_interval;
+            for (unsigned col = 0; col < numCols; ++col)
+            {
+                cellPoints.emplace_back(ex.xMin() + (double)col * col_interval, y, 0.0);
+            }
+        }
+
+        std::vector<osg::Vec3d> naturalPoints(cellPoints);
+        ex.getSRS()->transform(naturalPoints, pool->getMapSRS());
+        pool->sampleMapCoords(naturalPoints.begin(), naturalPoints.end(), samplingResolution, workingSet, nullptr);
+
+        if (ex.getSRS() != geomSRS)
+            ex.getSRS()->transform(cellPoints, geomSRS);
+
+        std::vector<unsigned> hits;
+
+        for (unsigned row = 0; row < numRows; ++row)
+        {
+            for (unsigned col = 0; col < numCols; ++col)
+            {
+                const osg::Vec3d& P = cellPoints[row * numCols + col];
+                float elevNatural = naturalPoints[row * numCols + col].z();
 
-                bool done = false;
-                double minD2 = DBL_MAX;//bufferWidth * bufferWidth; // minimum distance(squared) to closest polygon edge
-                double bufferWidth = 0.0;
+                double minD2 = DBL_MAX; // minimum distance(squared) to closest polygon edge
+                const FlatPolygon* best = nullptr;
 
-                const Polygon* bestPoly = 0L;
+                // Does the point P fall within a polygon? The first one in feature order wins.
+                double point[2] = { P.x(), P.y() };
+                hits.clear();
+                polygonIndex.Search(point, point, [&hits](const unsigned& hit)
+                    {
+                        hits.push_back(hit);
+                        return RTREE_KEEP_SEARCHING;
+                    });
+                std::sort(hits.begin(), hits.end());
 
-                for (unsigned int geomIndex = 0; geomIndex < geom->getNumComponents(); geomIndex++)
+                for (auto hit : hits)
                 {
-                    Geometry* component = geom->getComponents()[geomIndex].get();
-                    Widths width = widths[geomIndex];
-                    giter.reset(component, false);
-                    //ConstGeometryIterator giter(component, false);
-                    while (giter.hasMore() && !done)
+                    if (polygons[hit].polygon->contains2D(P.x(), P.y()))
                     {
-                        auto part = giter.next();
-                        if (part->getType() == Geometry::TYPE_POLYGON)
+                        best = &polygons[hit];
+                        minD2 = -1.0;
+                        break;
+                    }
+                }
+
+                // If not in a polygon, how far to the closest edge? Edges beyond every
+                // buffer width leave the natural elevation in place anyway.
+                if (!best && !polygons.empty())
+                {
+                    double searchMin[2] = { P.x() - maxBufferWidth, P.y() - maxBufferWidth };
+                    double searchMax[2] = { P.x() + maxBufferWidth, P.y() + maxBufferWidth };
+                    hits.clear();
+                    edgeIndex.Search(searchMin, searchMax, [&hits](const unsigned& hit)
                         {
-                            auto polygon = static_cast<const Polygon*>(part);
-
-                            // Does the point P fall within the polygon?
-                            if (polygon->contains2D(P.x(), P.y()))
-                            {
-                                // yes, flatten it to the polygon's centroid elevation;
-                                // and we're dont with this point.
-                                done = true;
-                                bestPoly = polygon;
-                                minD2 = -1.0;
-                                bufferWidth = width.bufferWidth;
-                            }
-
-                            // If not in the polygon, how far to the closest edge?
-                            else
-                            {
-                                double D2 = getDistanceSquaredToClosestEdge(P, polygon);
-                                if (D2 < minD2)
-                                {
-                                    minD2 = D2;
-                                    bestPoly = polygon;
-                                    bufferWidth = width.bufferWidth;
-                                }
-                            }
+                            hits.push_back(hit);
+                            return RTREE_KEEP_SEARCHING;
+                        });
+
+                    unsigned bestPolygon = ~0u;
+                    for (auto hit : hits)
+                    {
+                        const PolygonEdge& edge = edges[hit];
+                        const VECTOR AP = P - edge.A, AB = edge.B - edge.A;
+                        double t = clamp((AP*AB) / AB.length2(), 0.0, 1.0);
+                        VECTOR PROJ = edge.A + AB * t;
+                        double D2 = (P - PROJ).length2();
+                        if (D2 < minD2 || (D2 == minD2 && edge.polygonIndex < bestPolygon))
+                        {
+                            minD2 = D2;
+                            bestPolygon = edge.polygonIndex;
                         }
                     }
+
+                    if (bestPolygon != ~0u)
+                    {
+                        best = &polygons[bestPolygon];
+                    }
+                    else
+                    {
+                        // out of reach of every buffer: natural terrain.
+                        hf->setHeight(col, row, elevNatural);
+                        wroteChanges = true;
+                        continue;
+                    }
                 }
 
-                if (bestPoly && minD2 != 0.0)
+                if (best && minD2 != 0.0)
                 {
                     float h;
-                    POINT internalP = getInternalPoint(bestPoly);
-                    EP.x() = internalP.x(), EP.y() = internalP.y();
-                    float elevInternal = pool->getSample(EP, workingSet).elevation().as(Units::METERS);
+                    float elevInternal = best->internalPoint.z();
 
                     if (minD2 < 0.0)
                     {
@@ -271,9 +358,7 @@ namespace
                     }
                     else
                     {
-                        EP.x() = P.x(), EP.y() = P.y();
-                        float elevNatural = pool->getSample(EP, workingSet).elevation().as(Units::METERS);
-                        double blend = clamp(sqrt(minD2) / bufferWidth, 0.0, 1.0); // [0..1] 0=internal, 1=natural
+                        double blend = clamp(sqrt(minD2) / best->bufferWidth, 0.0, 1.0); // [0..1] 0=internal, 1=natural
                         h = smootherstep(elevInternal, elevNatural, blend);
                     }
 
@@ -283,9 +368,7 @@ namespace
 
                 else if (fillAllPixels)
                 {
-                    EP.x() = P.x(), EP.y() = P.y();
-                    float h = pool->getSample(EP, workingSet).elevation().as(Units::METERS);
-                    hf->setHeight(col, row, h);
+                    hf->setHeight(col, row, elevNatural);
                     // do not set wroteChanges
                 }
             }
@@ -462,7 +545,7 @@ namespace
 
         // Sample heights for the line segments
         std::vector< osg::Vec3d > segmentPoints;        
-        segments.reserve(segments.size() * 2);
+        segmentPoints.reserve(segments.size() * 2);
         for (auto itr = segments.begin(); itr != segments.end(); ++itr)
         {
             segmentPoints.push_back(itr->A);
@@ -511,11 +594,18 @@ namespace
        
         osg::Vec3d P, PROJ;
 
+        unsigned numCols = hf->getNumColumns();
+        std::vector<unsigned> hits;
+        std::vector<unsigned> columnStart(numCols + 1);
+        std::vector<unsigned> columnHits;
+        std::vector<unsigned> cursor;
+        std::vector<std::pair<unsigned, unsigned>> hitColumns;
+
         for (unsigned row = 0; row < hf->getNumRows(); ++row)
         {
             P.y() = ex.yMin() + (double)row * row_interval;
 
-            std::vector<unsigned> hits;
+            hits.clear();
 
             double searchMin[2] = { ex.xMin() - maxBufferDistance, P.y() - maxBufferDistance };
             double searchMax[2] = { ex.xMax() + maxBufferDistance, P.y() + maxBufferDistance };
@@ -532,6 +622,35 @@ namespace
                 continue;
             }
 
+            // Bucket the hits by the columns their buffered extents span, so each
+            // cell only measures the segments that can reach it. The buckets keep
+            // the hits in search order.
+            hitColumns.resize(hits.size());
+            std::fill(columnStart.begin(), columnStart.end(), 0u);
+            for (unsigned h = 0; h < hits.size(); ++h)
+            {
+                const LineSegment& segment = segments[hits[h]];
+                const Widths& w = widths[segment.geomIndex];
+                double reach = w.lineWidth * 0.5 + w.bufferWidth;
+                double x0 = (osg::minimum(segment.A.x(), segment.B.x()) - reach - ex.xMin()) / col_interval;
+                double x1 = (osg::maximum(segment.A.x(), segment.B.x()) + reach - ex.xMin()) / col_interval;
+                int c0 = (int)clamp(floor(x0), 0.0, (double)numCols);
+                int c1 = (int)clamp(ceil(x1), -1.0, (double)numCols - 1.0);
+                hitColumns[h] = std::make_pair((unsigned)c0, (unsigned)osg::maximum(c0 - 1, c1) + 1u);
+                for (int c = c0; c <= c1; ++c)
+                    columnStart[c + 1]++;
+            }
+            for (unsigned c = 0; c < numCols; ++c)
+                columnStart[c + 1] += columnStart[c];
+
+            columnHits.resize(columnStart[numCols]);
+            cursor.assign(columnStart.begin(), columnStart.end() - 1);
+            for (unsigned h = 0; h < hits.size(); ++h)
+            {
+                for (unsigned c = hitColumns[h].first; c < hitColumns[h].second; ++c)
+                    columnHits[cursor[c]++] = hits[h];
+            }
+
             static const unsigned Maxsamples = 4;
             Samples samples;
 
@@ -545,11 +664,9 @@ namespace
                 // radius; we will collect up to MaxSamples of these for each heightfield point.
                 samples.clear();
 
-                unsigned int hitIndex = 0;
-                // What is the maximum number of hits we see in this area?
-                for (auto hit : hits)
+                for (unsigned k = columnStart[col]; k < columnStart[col + 1]; ++k)
                 {
-                    LineSegment& segment = segments[hit];
+                    LineSegment& segment = segments[columnHits[k]];
 
                     const Widths& w = widths[segment.geomIndex];
 
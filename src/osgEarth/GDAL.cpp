@@ -335,6 +335,215 @@ namespace osgEarth
             }
         }
 
+        // Radius, in source pixels, of the kernel GDAL uses for a resampling
+        // algorithm at 1:1 scale.
+        int getResamplingRadius(GDALRIOResampleAlg alg)
+        {
+            switch (alg)
+            {
+            case GRIORA_NearestNeighbour: return 0;
+            case GRIORA_Bilinear: return 1;
+            case GRIORA_Cubic:
+            case GRIORA_CubicSpline: return 2;
+            case GRIORA_Lanczos: return 3;
+            default: return 2; // average, mode, gauss: grow with the scale factor
+            }
+        }
+
+        // Copies the cached blocks of a band covering the block-aligned region
+        // (ax0, ay0, aw, ah) into "region", decoding any that are missing.
+        // keyBand distinguishes the band's mask from its data in the cache.
+        bool assembleRegion(
+            BlockCache* cache,
+            GDALRasterBand* band,
+            int keyBand,
+            GDALDataType type,
+            int bx0, int by0, int bx1, int by1,
+            int ax0, int ay0, int aw,
+            std::vector<unsigned char>& region)
+        {
+            int blockWidth = 0, blockHeight = 0;
+            band->GetBlockSize(&blockWidth, &blockHeight);
+
+            const int rasterWidth = band->GetXSize();
+            const int rasterHeight = band->GetYSize();
+            const std::size_t typeSize = GDALGetDataTypeSizeBytes(type);
+
+            for (int by = by0; by <= by1; ++by)
+            {
+                for (int bx = bx0; bx <= bx1; ++bx)
+                {
+                    const int cx = bx * blockWidth, cy = by * blockHeight;
+                    const int cw = std::min(blockWidth, rasterWidth - cx);
+                    const int ch = std::min(blockHeight, rasterHeight - cy);
+
+                    BlockCache::Key key{ keyBand, (int)type, bx, by };
+
+                    auto block = cache->get(key, [&]() -> BlockCache::Data
+                        {
+                            auto data = std::make_shared<std::vector<unsigned char>>((std::size_t)cw * (std::size_t)ch * typeSize);
+                            if (band->RasterIO(GF_Read, cx, cy, cw, ch, data->data(), cw, ch, type, 0, 0) != CE_None)
+                                return nullptr;
+                            return data;
+                        });
+
+                    if (!block)
+                        return false;
+
+                    const std::size_t rowBytes = (std::size_t)cw * typeSize;
+                    for (int row = 0; row < ch; ++row)
+                    {
+                        ::memcpy(
+                            region.data() + ((std::size_t)(cy - ay0 + row) * (std::size_t)aw + (std::size_t)(cx - ax0)) * typeSize,
+                            block->data() + (std::size_t)row * rowBytes,
+                            rowBytes);
+                    }
+                }
+            }
+            return true;
+        }
+
+        // Reads a window of a band through a shared block cache. The source blocks
+        // under the window are fetched from the cache (decoding any that are missing),
+        // assembled into an in-memory dataset, and the original request is run against
+        // that so resampling behaves just like a direct read. Returns false if the
+        // request is not a good fit for the cache and the caller should read directly.
+        bool readThroughBlockCache(
+            BlockCache* cache,
+            GDALRasterBand* band,
+            double dXOff,
+            double dYOff,
+            double dXSize,
+            double dYSize,
+            void* pData,
+            int nBufXSize,
+            int nBufYSize,
+            GDALDataType eBufType,
+            GSpacing nPixelSpace,
+            GSpacing nLineSpace,
+            const GDALRasterIOExtraArg* psExtraArg,
+            CPLErr& out_err)
+        {
+            // Strongly downsampled reads are better served by the dataset's
+            // overviews, which GDAL only uses when reading directly.
+            if (dXSize >= 2.0 * (double)nBufXSize || dYSize >= 2.0 * (double)nBufYSize)
+                return false;
+
+            int blockWidth = 0, blockHeight = 0;
+            band->GetBlockSize(&blockWidth, &blockHeight);
+            if (blockWidth <= 0 || blockHeight <= 0)
+                return false;
+
+            const int rasterWidth = band->GetXSize();
+            const int rasterHeight = band->GetYSize();
+
+            // Pad the window so the resampling kernel sees the same neighbors
+            // it would see in the full raster. GDAL widens the kernel by the
+            // scale factor when downsampling.
+            const GDALRIOResampleAlg alg = psExtraArg ? psExtraArg->eResampleAlg : GRIORA_NearestNeighbour;
+            const double scale = std::max(1.0, std::max(dXSize / (double)nBufXSize, dYSize / (double)nBufYSize));
+            const int margin = (int)ceil((double)getResamplingRadius(alg) * scale) + 1;
+            int x0 = std::max((int)floor(dXOff) - margin, 0);
+            int y0 = std::max((int)floor(dYOff) - margin, 0);
+            int x1 = std::min((int)ceil(dXOff + dXSize) + margin, rasterWidth);
+            int y1 = std::min((int)ceil(dYOff + dYSize) + margin, rasterHeight);
+            if (x1 <= x0 || y1 <= y0)
+                return false;
+
+            // Block-aligned region covering the window:
+            int bx0 = x0 / blockWidth, bx1 = (x1 - 1) / blockWidth;
+            int by0 = y0 / blockHeight, by1 = (y1 - 1) / blockHeight;
+            int ax0 = bx0 * blockWidth, ay0 = by0 * blockHeight;
+            int aw = std::min((bx1 + 1) * blockWidth, rasterWidth) - ax0;
+            int ah = std::min((by1 + 1) * blockHeight, rasterHeight) - ay0;
+
+            const std::size_t typeSize = GDALGetDataTypeSizeBytes(eBufType);
+            if (typeSize == 0u || (std::size_t)aw * (std::size_t)ah * typeSize > cache->getMaxBytes())
+                return false;
+
+            // A mask that is not just "all valid" or derived from nodata (e.g. an
+            // alpha band or a .msk file) has to travel with the data, since
+            // GDAL's resampler uses it to weight the samples.
+            GDALRasterBand* maskBand = nullptr;
+            if ((band->GetMaskFlags() & (GMF_ALL_VALID | GMF_NODATA)) == 0)
+            {
+                maskBand = band->GetMaskBand();
+                if (!maskBand)
+                    return false;
+            }
+
+            OE_THREAD_LOCAL std::vector<unsigned char> region;
+            region.resize((std::size_t)aw * (std::size_t)ah * typeSize);
+
+            if (!assembleRegion(cache, band, band->GetBand(), eBufType, bx0, by0, bx1, by1, ax0, ay0, aw, region))
+                return false;
+
+            // mask blocks share the data band's block layout; keyed by the negated band number
+            OE_THREAD_LOCAL std::vector<unsigned char> maskRegion;
+            if (maskBand)
+            {
+                int maskBlockWidth = 0, maskBlockHeight = 0;
+                maskBand->GetBlockSize(&maskBlockWidth, &maskBlockHeight);
+                if (maskBlockWidth != blockWidth || maskBlockHeight != blockHeight)
+                    return false;
+
+                maskRegion.resize((std::size_t)aw * (std::size_t)ah);
+                if (!assembleRegion(cache, maskBand, -band->GetBand(), GDT_Byte, bx0, by0, bx1, by1, ax0, ay0, aw, maskRegion))
+                    return false;
+            }
+
+            GDALDriver* memDriver = GetGDALDriverManager()->GetDriverByName("MEM");
+            if (!memDriver)
+                return false;
+
+            GDALDataset* mem = memDriver->Create("", aw, ah, 0, eBufType, nullptr);
+            if (!mem)
+                return false;
+
+            char pointer[64];
+            int len = CPLPrintPointer(pointer, region.data(), sizeof(pointer) - 1);
+            pointer[len] = 0;
+            char** bandOptions = CSLSetNameValue(nullptr, "DATAPOINTER", pointer);
+            mem->AddBand(eBufType, bandOptions);
+            CSLDestroy(bandOptions);
+
+            GDALRasterBand* memBand = mem->GetRasterBand(1);
+
+            int hasNoData = 0;
+            double noData = band->GetNoDataValue(&hasNoData);
+            if (hasNoData)
+                memBand->SetNoDataValue(noData);
+
+            if (maskBand)
+            {
+                if (memBand->CreateMaskBand(0) != CE_None ||
+                    memBand->GetMaskBand()->RasterIO(GF_Write, 0, 0, aw, ah, maskRegion.data(), aw, ah, GDT_Byte, 0, 0) != CE_None)
+                {
+                    GDALClose(mem);
+                    return false;
+                }
+            }
+
+            GDALRasterIOExtraArg extraArg;
+            if (psExtraArg)
+            {
+                extraArg = *psExtraArg;
+            }
+            else
+            {
+                INIT_RASTERIO_EXTRA_ARG(extraArg);
+            }
+            extraArg.dfXOff -= (double)ax0;
+            extraArg.dfYOff -= (double)ay0;
+
+            out_err = memBand->RasterIO(GF_Read,
+                (int)floor(dXOff) - ax0, (int)floor(dYOff) - ay0, (int)ceil(dXSize), (int)ceil(dYSize),
+                pData, nBufXSize, nBufYSize, eBufType, nPixelSpace, nLineSpace, &extraArg);
+
+            GDALClose(mem);
+            return true;
+        }
+
         // GDALRasterBand::RasterIO helper method
         bool rasterIO(
             GDALRasterBand* band,
@@ -349,7 +558,8 @@ namespace osgEarth
             GDALDataType eBufType,
             GSpacing nPixelSpace,
             GSpacing nLineSpace,
-            RasterInterpolation interpolation = INTERP_NEAREST
+            RasterInterpolation interpolation = INTERP_NEAREST,
+            BlockCache* cache = nullptr
         )
         {
             GDALRasterIOExtraArg psExtraArg;
@@ -383,7 +593,16 @@ namespace osgEarth
             psExtraArg.dfXSize = dXSize;
             psExtraArg.dfYSize = dYSize;
 
-            CPLErr err = band->RasterIO(eRWFlag, floor(dXOff), floor(dYOff), ceil(dXSize), ceil(dYSize), pData, nBufXSize, nBufYSize, eBufType, nPixelSpace, nLineSpace, &psExtraArg);
+            CPLErr err = CE_None;
+
+            bool cached = cache && eRWFlag == GF_Read && readThroughBlockCache(
+                cache, band, dXOff, dYOff, dXSize, dYSize, pData, nBufXSize, nBufYSize,
+                eBufType, nPixelSpace, nLineSpace, &psExtraArg, err);
+
+            if (!cached)
+            {
+                err = band->RasterIO(eRWFlag, floor(dXOff), floor(dYOff), ceil(dXSize), ceil(dYSize), pData, nBufXSize, nBufYSize, eBufType, nPixelSpace, nLineSpace, &psExtraArg);
+            }
 
             if (err != CE_None)
             {
@@ -401,6 +620,105 @@ namespace osgEarth
 
 //...................................................................
 
+GDAL::BlockCache::BlockCache(std::size_t maxBytes) :
+    _maxBytes(maxBytes)
+{
+    //nop
+}
+
+std::size_t
+GDAL::BlockCache::getBytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _bytes;
+}
+
+GDAL::BlockCache::Data
+GDAL::BlockCache::get(const Key& key, const std::function<Data()>& load)
+{
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto i = _entries.find(key);
+        if (i != _entries.end())
+        {
+            entry = i->second;
+            _lru.splice(_lru.begin(), _lru, entry->lru);
+        }
+        else
+        {
+            entry = std::make_shared<Entry>();
+            _lru.push_front(key);
+            entry->lru = _lru.begin();
+            _entries[key] = entry;
+        }
+    }
+
+    // Only one thread decodes a given block; the others wait for it here.
+    Data data;
+    bool loadedHere = false;
+    {
+        std::lock_guard<std::mutex> lock(entry->loadMutex);
+        if (!entry->loaded)
+        {
+            entry->data = load();
+            entry->loaded = true;
+            loadedHere = true;
+        }
+        data = entry->data;
+    }
+
+    if (loadedHere)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // the entry may have been evicted or cleared while loading
+        auto i = _entries.find(key);
+        if (i != _entries.end() && i->second == entry)
+        {
+            if (data == nullptr)
+            {
+                // don't cache failures
+                _lru.erase(entry->lru);
+                _entries.erase(i);
+            }
+            else
+            {
+                entry->bytes = data->size();
+                _bytes += entry->bytes;
+
+                while (_bytes > _maxBytes && _lru.size() > 1)
+                {
+                    auto victim = std::prev(_lru.end());
+                    if (victim == entry->lru)
+                    {
+                        // keep the block we just loaded
+                        _lru.splice(_lru.begin(), _lru, victim);
+                        continue;
+                    }
+                    auto v = _entries.find(*victim);
+                    _bytes -= v->second->bytes;
+                    _entries.erase(v);
+                    _lru.erase(victim);
+                }
+            }
+        }
+    }
+
+    return data;
+}
+
+void
+GDAL::BlockCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _lru.clear();
+    _bytes = 0u;
+}
+
+//...................................................................
+
 
 GDAL::Driver::~Driver()
 {
@@ -1263,13 +1581,13 @@ GDAL::Driver::createImage(const TileKey& key,
         image->allocateImage(tileSize, tileSize, 1, pixelFormat, GL_UNSIGNED_BYTE);
         memset(image->data(), 0, image->getImageSizeInBytes());
 
-        rasterIO(bandRed, GF_Read, src_min_x, src_min_y, src_width, src_height, red.data(), target_width, target_height, GDT_Byte, 0, 0, gdalOptions().interpolation().get());
-        rasterIO(bandGreen, GF_Read, src_min_x, src_min_y, src_width, src_height, green.data(), target_width, target_height, GDT_Byte, 0, 0, gdalOptions().interpolation().get());
-        rasterIO(bandBlue, GF_Read, src_min_x, src_min_y, src_width, src_height, blue.data(), target_width, target_height, GDT_Byte, 0, 0, gdalOptions().interpolation().get());
+        rasterIO(bandRed, GF_Read, src_min_x, src_min_y, src_width, src_height, red.data(), target_width, target_height, GDT_Byte, 0, 0, gdalOptions().interpolation().get(), _blockCache.get());
+        rasterIO(bandGreen, GF_Read, src_min_x, src_min_y, src_width, src_height, green.data(), target_width, target_height, GDT_Byte, 0, 0, gdalOptions().interpolation().get(), _blockCache.get());
+        rasterIO(bandBlue, GF_Read, src_min_x, src_min_y, src_width, src_height, blue.data(), target_width, target_height, GDT_Byte, 0, 0, gdalOptions().interpolation().get(), _blockCache.get());
 
         if (bandAlpha)
         {
-            rasterIO(bandAlpha, GF_Read, src_min_x, src_min_y, src_width, src_height, alpha.data(), target_width, target_height, GDT_Byte, 0, 0, gdalOptions().interpolation().get());
+            rasterIO(bandAlpha, GF_Read, src_min_x, src_min_y, src_width, src_height, alpha.data(), target_width, target_height, GDT_Byte, 0, 0, gdalOptions().interpolation().get(), _blockCache.get());
         }
 
         for (int src_row = 0, dst_row = tile_offset_top;
@@ -1332,7 +1650,7 @@ GDAL::Driver::createImage(const TileKey& key,
             if (!success)
                 nodata = NO_DATA_VALUE;
 
-            if (rasterIO(bandGray, GF_Read, src_min_x, src_min_y, src_width, src_height, data.data(), target_width, target_height, gdalDataType, 0, 0, INTERP_NEAREST))
+            if (rasterIO(bandGray, GF_Read, src_min_x, src_min_y, src_width, src_height, data.data(), target_width, target_height, gdalDataType, 0, 0, INTERP_NEAREST, _blockCache.get()))
             {
                 // copy from data to image.
                 for (int src_row = 0, dst_row = tile_offset_top; src_row < target_height; src_row++, dst_row++)
@@ -1379,11 +1697,11 @@ GDAL::Driver::createImage(const TileKey& key,
             memset(image->data(), 0, image->getImageSizeInBytes());
 
 
-            rasterIO(bandGray, GF_Read, src_min_x, src_min_y, src_width, src_height, gray.data(), target_width, target_height, GDT_Byte, 0, 0, gdalOptions().interpolation().get());
+            rasterIO(bandGray, GF_Read, src_min_x, src_min_y, src_width, src_height, gray.data(), target_width, target_height, GDT_Byte, 0, 0, gdalOptions().interpolation().get(), _blockCache.get());
 
             if (bandAlpha)
             {
-                rasterIO(bandAlpha, GF_Read, src_min_x, src_min_y, src_width, src_height, alpha.data(), target_width, target_height, GDT_Byte, 0, 0, gdalOptions().interpolation().get());
+                rasterIO(bandAlpha, GF_Read, src_min_x, src_min_y, src_width, src_height, alpha.data(), target_width, target_height, GDT_Byte, 0, 0, gdalOptions().interpolation().get(), _blockCache.get());
             }
 
             for (int src_row = 0, dst_row = tile_offset_top;
@@ -1435,7 +1753,7 @@ GDAL::Driver::createImage(const TileKey& key,
             memset(image->data(), 0, image->getImageSizeInBytes());
         }
 
-        rasterIO(bandPalette, GF_Read, src_min_x, src_min_y, src_width, src_height, palette.data(), target_width, target_height, GDT_Byte, 0, 0, INTERP_NEAREST);
+        rasterIO(bandPalette, GF_Read, src_min_x, src_min_y, src_width, src_height, palette.data(), target_width, target_height, GDT_Byte, 0, 0, INTERP_NEAREST, _blockCache.get());
 
         ImageUtils::PixelWriter write(image.get());
 
@@ -1574,11 +1892,23 @@ GDAL::Driver::createHeightField(const TileKey& key, unsigned tileSize, ProgressC
             workspace.assign(workspace_width * workspace_height, NO_DATA_VALUE);
 
             // Read the data, filling the workspace vector from north to south:
-            auto read_error = band->RasterIO(GF_Read,
-                (int)col_min, (int)row_min,
-                (int)col_max - (int)col_min + 1, (int)row_max - (int)row_min + 1,
+            CPLErr read_error = CE_None;
+
+            bool cached = _blockCache && readThroughBlockCache(
+                _blockCache.get(), band,
+                col_min, row_min,
+                col_max - col_min + 1, row_max - row_min + 1,
                 &workspace[0], workspace_width, workspace_height,
-                GDT_Float32, 0, 0);
+                GDT_Float32, 0, 0, nullptr, read_error);
+
+            if (!cached)
+            {
+                read_error = band->RasterIO(GF_Read,
+                    (int)col_min, (int)row_min,
+                    (int)col_max - (int)col_min + 1, (int)row_max - (int)row_min + 1,
+                    &workspace[0], workspace_width, workspace_height,
+                    GDT_Float32, 0, 0);
+            }
 
             if (read_error != CE_None)
             {
@@ -1766,6 +2096,7 @@ GDAL::Options::readFrom(const Config& conf)
     conf.get("single_threaded", singleThreaded());
     conf.get("use_vrt", useVRT());
     conf.get("fallback_profile", fallbackProfile());
+    conf.get("block_cache_size_mb", blockCacheSize());
 
     // report on deprecated usage
     const std::string deprecated_keys[] = {
@@ -1791,6 +2122,7 @@ GDAL::Options::writeTo(Config& conf) const
     conf.set("coverage_uses_palette_index", coverageUsesPaletteIndex());
     conf.set("single_threaded", singleThreaded());
     conf.set("fallback_profile", fallbackProfile());
+    conf.set("block_cache_size_mb", blockCacheSize());
 }
 
 //......................................................................
@@ -1804,6 +2136,7 @@ namespace
     Status openOnThisThread(
         const T* layer,
         GDAL::Driver::Ptr& driver,
+        std::shared_ptr<GDAL::BlockCache> blockCache,
         osg::ref_ptr<const Profile>* in_out_profile,
         DataExtentList* out_dataExtents,
         bool verbose)
@@ -1819,6 +2152,8 @@ namespace
         if (layer->options().maxDataLevel().isSet())
             driver->setMaxDataLevel(layer->options().maxDataLevel().get());
 
+        driver->setBlockCache(blockCache);
+
         Status status = driver->open(
             layer->getName(),
             layer->options(),
@@ -1907,11 +2242,17 @@ GDALImageLayer::openImplementation()
     // and open is single-threaded by definition.
     GDAL::Driver::Ptr& driver = getSingleThreaded() ? _driverSingleThreaded : _driverPerThread.get();
 
+    // One block cache shared by all the per-thread drivers
+    _blockCache = nullptr;
+    if (options().blockCacheSize().get() > 0u)
+        _blockCache = std::make_shared<GDAL::BlockCache>((std::size_t)options().blockCacheSize().get() * 1024u * 1024u);
+
     DataExtentList dataExtents;
 
     Status s = openOnThisThread(
         this,
         driver,
+        _blockCache,
         &profile,
         &dataExtents,
         true);              //verbose
@@ -1937,6 +2278,7 @@ GDALImageLayer::closeImplementation()
     Util::ScopedWriteLock unique_lock(_createCloseMutex);
     _driverPerThread.clear();
     _driverSingleThreaded = nullptr;
+    _blockCache = nullptr;
 
     return ImageLayer::closeImplementation();
 }
@@ -1960,7 +2302,7 @@ GDALImageLayer::createImageImplementation(const TileKey& key, ProgressCallback*
         // calling openImpl with NULL params limits the setup
         // since we already called this during openImplementation
         osg::ref_ptr<const Profile> profile = getProfile();
-        openOnThisThread(this, driver, &profile, nullptr, false);
+        openOnThisThread(this, driver, _blockCache, &profile, nullptr, false);
     }
 
     if (driver != nullptr)
@@ -2040,11 +2382,17 @@ GDALElevationLayer::openImplementation()
     // Open the dataset temporarily to query the profile and extents.
     GDAL::Driver::Ptr& driver = getSingleThreaded() ? _driverSingleThreaded :  _driverPerThread.get();
 
+    // One block cache shared by all the per-thread drivers
+    _blockCache = nullptr;
+    if (options().blockCacheSize().get() > 0u)
+        _blockCache = std::make_shared<GDAL::BlockCache>((std::size_t)options().blockCacheSize().get() * 1024u * 1024u);
+
     DataExtentList dataExtents;
 
     Status s = openOnThisThread(
         this,
         driver,
+        _blockCache,
         &profile,
         &dataExtents,
         true);              //verbose
@@ -2070,6 +2418,7 @@ GDALElevationLayer::closeImplementation()
         Util::ScopedWriteLock unique_lock(_createCloseMutex);
         _driverPerThread.clear();
         _driverSingleThreaded = nullptr;
+        _blockCache = nullptr;
     }
 
     return ElevationLayer::closeImplementation();
@@ -2094,7 +2443,7 @@ GDALElevationLayer::createHeightFieldImplementation(const TileKey& key, Progress
         // calling openImpl with NULL params limits the setup
         // since we already called this during openImplementation
         osg::ref_ptr<const Profile> profile = getProfile();
-        openOnThisThread(this, driver, &profile, nullptr, false);
+        openOnThisThread(this, driver, _blockCache, &profile, nullptr, false);
     }
 
     if (driver != nullptr)
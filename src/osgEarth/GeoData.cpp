@@ -10,6 +10,7 @@
 #include "GDAL"
 #include "Metrics"
 #include "Math"
+#include "ReprojectionGrid"
 
 #include <osg/BoundingBox>
 #include <osg/Polytope>
@@ -2003,19 +2004,20 @@ namespace
         // (This is especially useful in the UnifiedCubeProfile since it nullifes the chances for
         // edge ambiguity.)
 
-        unsigned int numPixels = width * height;
-
         // Start by creating a sample grid over the destination
         // extent. These will be the source coordinates. Then, reproject
         // the sample grid into the source coordinate system.
-        double *srcPointsX = new double[numPixels * 2];
-        double *srcPointsY = srcPointsX + numPixels;
+        std::vector<osg::Vec3d> srcPoints;
 
-        dest_extent.getSRS()->transformGrid(
-            src_extent.getSRS(),
+        ReprojectionGrid::transform(
+            dest_extent.getSRS(), src_extent.getSRS(),
             dest_extent.xMin() + .5 * dx, dest_extent.yMin() + .5 * dy,
             dest_extent.xMax() - .5 * dx, dest_extent.yMax() - .5 * dy,
-            srcPointsX, srcPointsY, width, height);
+            width, height,
+            srcPoints);
+
+        if (srcPoints.size() != width * height)
+            return result;
 
         ImageUtils::PixelReader ia(image);
         osg::Vec4 color;
@@ -2031,21 +2033,20 @@ namespace
         {
            // Next, go through the source-SRS sample grid, read the color at each point from the source image,
            // and write it to the corresponding pixel in the destination image.
-           int pixel = 0;
            double xfac = (image->s() - 1) / src_extent.width();
            double yfac = (image->t() - 1) / src_extent.height();
            for (unsigned int c = 0; c < width; ++c)
            {
               for (unsigned int r = 0; r < height; ++r)
               {
-                 double src_x = srcPointsX[pixel];
-                 double src_y = srcPointsY[pixel];
+                 unsigned pixel = r * width + c;
+                 double src_x = srcPoints[pixel].x();
+                 double src_y = srcPoints[pixel].y();
 
                  if (src_x < src_extent.xMin() || src_x > src_extent.xMax() || src_y < src_extent.yMin() || src_y > src_extent.yMax())
                  {
                     //If the sample point is outside of the bound of the source extent, increment the pixel and keep looping through.
                     //OE_WARN << LC << "ERROR: sample point out of bounds: " << src_x << ", " << src_y << std::endl;
-                    pixel++;
                     continue;
                  }
 
@@ -2121,13 +2122,10 @@ namespace
                  }
 
                  writer(color, c, r, depth);
-                 pixel++;
               }
            }
         }
 
-        delete[] srcPointsX;
-
         return result;
     }
 }
@@ -5,6 +5,8 @@
 #include "Geometry"
 #include "GEOS"
 #include "Math"
+#include <algorithm>
+#include <cmath>
 #include <iterator>
 #include <cstdarg> // for va_start et al
 
@@ -1264,6 +1266,94 @@ Polygon::contains2D(double x, double y) const
     return true;
 }
 
+namespace
+{
+    // Collects the x positions at which the horizontal line through y crosses
+    // a ring, using the same edge rule and arithmetic as Ring::contains2D.
+    // A point (x,y) is inside the ring when an odd number of crossings lie
+    // beyond x.
+    void getCrossings(const Ring& poly, double y, std::vector<double>& output)
+    {
+        output.clear();
+        bool is_open = poly.isOpen();
+        unsigned i = is_open ? 0 : 1;
+        unsigned j = is_open ? poly.size() - 1 : 0;
+        for (; i < poly.size(); j = i++)
+        {
+            if (((poly[i].y() <= y) && (y < poly[j].y())) ||
+                ((poly[j].y() <= y) && (y < poly[i].y())))
+            {
+                output.push_back((poly[j].x() - poly[i].x()) * (y - poly[i].y()) / (poly[j].y() - poly[i].y()) + poly[i].x());
+            }
+        }
+        std::sort(output.begin(), output.end());
+    }
+
+    // First grid column whose x is not less than "a".
+    inline unsigned firstColumnAtOrAfter(double a, double x0, double dx, unsigned numCols)
+    {
+        double estimate = std::ceil((a - x0) / dx);
+        unsigned c = estimate <= 0.0 ? 0u : estimate >= (double)numCols ? numCols : (unsigned)estimate;
+        while (c > 0 && x0 + dx * (double)(c - 1) >= a) --c;
+        while (c < numCols && x0 + dx * (double)c < a) ++c;
+        return c;
+    }
+}
+
+void
+Polygon::rasterize2D(
+    double x0, double y0, double dx, double dy,
+    unsigned numCols, unsigned numRows,
+    const std::function<void(unsigned, unsigned)>& func) const
+{
+    if (size() < 3 || numCols == 0 || numRows == 0 || !(dx > 0.0) || !(dy > 0.0))
+        return;
+
+    Bounds bounds = getBounds();
+
+    // rows whose y could fall within the outer ring:
+    unsigned r0 = firstColumnAtOrAfter(bounds.yMin(), y0, dy, numRows);
+    unsigned r1 = firstColumnAtOrAfter(bounds.yMax(), y0, dy, numRows);
+
+    std::vector<double> crossings;
+    std::vector<std::vector<double>> holeCrossings(_holes.size());
+
+    for (unsigned row = r0; row <= r1 && row < numRows; ++row)
+    {
+        double y = y0 + dy * (double)row;
+
+        getCrossings(*this, y, crossings);
+        if (crossings.empty())
+            continue;
+
+        for (unsigned h = 0; h < _holes.size(); ++h)
+            getCrossings(*_holes[h].get(), y, holeCrossings[h]);
+
+        // inside the outer ring on [crossing 2k, crossing 2k+1):
+        for (unsigned k = 0; k + 1 < crossings.size(); k += 2)
+        {
+            unsigned c0 = firstColumnAtOrAfter(crossings[k], x0, dx, numCols);
+            unsigned c1 = firstColumnAtOrAfter(crossings[k + 1], x0, dx, numCols);
+
+            for (unsigned col = c0; col < c1; ++col)
+            {
+                double x = x0 + dx * (double)col;
+
+                bool inHole = false;
+                for (unsigned h = 0; h < holeCrossings.size() && !inHole; ++h)
+                {
+                    auto& hc = holeCrossings[h];
+                    auto beyond = hc.end() - std::upper_bound(hc.begin(), hc.end(), x);
+                    inHole = (beyond & 1) != 0;
+                }
+
+                if (!inHole)
+                    func(col, row);
+            }
+        }
+    }
+}
+
 void
 Polygon::open()
 {
@@ -15,6 +15,9 @@
 #include <osgDB/ReadFile>
 #include <osgDB/FileNameUtils>
 #include <curl/curl.h>
+#include <deque>
+#include <unordered_set>
+#include <thread>
 
 // Whether to use WinInet instead of cURL - CMAKE option
 #ifdef OSGEARTH_USE_WININET_FOR_HTTP
@@ -474,6 +477,111 @@ namespace
 
 //.........................................................................
 
+namespace
+{
+    void readProxyOptions(const osgDB::Options* options, std::string& proxy_host, std::string& proxy_port)
+    {
+        // try to set proxy host/port by reading the CURL proxy options
+        if ( options )
+        {
+            std::istringstream iss( options->getOptionString() );
+            std::string opt;
+            while( iss >> opt )
+            {
+                int index = opt.find('=');
+                if( opt.substr( 0, index ) == "OSG_CURL_PROXY" )
+                {
+                    proxy_host = opt.substr( index+1 );
+                }
+                else if ( opt.substr( 0, index ) == "OSG_CURL_PROXYPORT" )
+                {
+                    proxy_port = opt.substr( index+1 );
+                }
+            }
+        }
+    }
+
+    // Resolves the proxy address (host:port) and credentials for a request.
+    // Sources in increasing order of precedence: global settings, read options,
+    // environment. proxy_addr is empty if no proxy is configured.
+    void resolveProxy(const osgDB::Options* options, std::string& proxy_addr, std::string& proxy_auth)
+    {
+        std::string proxy_host;
+        std::string proxy_port = "8080";
+
+        //TODO: don't do all this proxy setup on every GET. Just do it once per client, or only when
+        // the proxy information changes.
+
+        //Try to get the proxy settings from the global settings
+        if (s_proxySettings.isSet())
+        {
+            proxy_host = s_proxySettings.get().hostName();
+            std::stringstream buf;
+            buf << s_proxySettings.get().port();
+            proxy_port = buf.str();
+
+            std::string proxy_username = s_proxySettings.get().userName();
+            std::string proxy_password = s_proxySettings.get().password();
+            if (!proxy_username.empty() && !proxy_password.empty())
+            {
+                proxy_auth = proxy_username + std::string(":") + proxy_password;
+            }
+        }
+
+        //Try to get the proxy settings from the local options that are passed in.
+        readProxyOptions( options, proxy_host, proxy_port );
+
+        optional< ProxySettings > proxySettings;
+        ProxySettings::fromOptions( options, proxySettings );
+        if (proxySettings.isSet())
+        {
+            proxy_host = proxySettings.get().hostName();
+            proxy_port = toString<int>(proxySettings.get().port());
+            OE_TEST << LC << "Read proxy settings from options " << proxy_host << " " << proxy_port << std::endl;
+        }
+
+        //Try to get the proxy settings from the environment variable
+        const char* proxyEnvAddress = getenv("OSG_CURL_PROXY");
+        if (proxyEnvAddress) //Env Proxy Settings
+        {
+            proxy_host = std::string(proxyEnvAddress);
+
+            const char* proxyEnvPort = getenv("OSG_CURL_PROXYPORT"); //Searching Proxy Port on Env
+            if (proxyEnvPort)
+            {
+                proxy_port = std::string( proxyEnvPort );
+            }
+        }
+
+        const char* proxyEnvAuth = getenv("OSGEARTH_CURL_PROXYAUTH");
+        if (proxyEnvAuth)
+        {
+            proxy_auth = std::string(proxyEnvAuth);
+        }
+
+        if ( !proxy_host.empty() )
+        {
+            proxy_addr = proxy_host + ":" + proxy_port;
+
+            if ( s_HTTP_DEBUG )
+            {
+                OE_NOTICE << LC << "Using proxy: " << proxy_addr << std::endl;
+
+                if (!proxy_auth.empty())
+                {
+                    OE_NOTICE << LC << "Using proxy authentication " << proxy_auth << std::endl;
+                }
+            }
+        }
+        else
+        {
+            proxy_addr.clear();
+        }
+    }
+}
+
+//.........................................................................
+
 namespace
 {
     class CURLImplementation : public HTTPClient::Implementation
@@ -529,86 +637,18 @@ namespace
                 options->getAuthenticationMap() :
                 osgDB::Registry::instance()->getAuthenticationMap();
 
-            std::string proxy_host;
-            std::string proxy_port = "8080";
-            std::string proxy_auth;
-
-            //TODO: don't do all this proxy setup on every GET. Just do it once per client, or only when
-            // the proxy information changes.
-
-            //Try to get the proxy settings from the global settings
-            if (s_proxySettings.isSet())
-            {
-                proxy_host = s_proxySettings.get().hostName();
-                std::stringstream buf;
-                buf << s_proxySettings.get().port();
-                proxy_port = buf.str();
-
-                std::string proxy_username = s_proxySettings.get().userName();
-                std::string proxy_password = s_proxySettings.get().password();
-                if (!proxy_username.empty() && !proxy_password.empty())
-                {
-                    proxy_auth = proxy_username + std::string(":") + proxy_password;
-                }
-            }
-
-            //Try to get the proxy settings from the local options that are passed in.
-            readOptions( options, proxy_host, proxy_port );
-
-            optional< ProxySettings > proxySettings;
-            ProxySettings::fromOptions( options, proxySettings );
-            if (proxySettings.isSet())
-            {
-                proxy_host = proxySettings.get().hostName();
-                proxy_port = toString<int>(proxySettings.get().port());
-                OE_TEST << LC << "Read proxy settings from options " << proxy_host << " " << proxy_port << std::endl;
-            }
-
-            //Try to get the proxy settings from the environment variable
-            const char* proxyEnvAddress = getenv("OSG_CURL_PROXY");
-            if (proxyEnvAddress) //Env Proxy Settings
-            {
-                proxy_host = std::string(proxyEnvAddress);
-
-                const char* proxyEnvPort = getenv("OSG_CURL_PROXYPORT"); //Searching Proxy Port on Env
-                if (proxyEnvPort)
-                {
-                    proxy_port = std::string( proxyEnvPort );
-                }
-            }
-
-            const char* proxyEnvAuth = getenv("OSGEARTH_CURL_PROXYAUTH");
-            if (proxyEnvAuth)
-            {
-                proxy_auth = std::string(proxyEnvAuth);
-            }
+            std::string proxy_addr, proxy_auth;
+            resolveProxy(options, proxy_addr, proxy_auth);
 
             // Set up proxy server:
-            std::string proxy_addr;
-            if ( !proxy_host.empty() )
+            if ( !proxy_addr.empty() )
             {
-                std::stringstream buf;
-                buf << proxy_host << ":" << proxy_port;
-                std::string bufStr;
-                bufStr = buf.str();
-                proxy_addr = bufStr;
-
-                if ( s_HTTP_DEBUG )
-                {
-                    OE_NOTICE << LC << "Using proxy: " << proxy_addr << std::endl;
-                }
-
                 //curl_easy_setopt( _curl_handle, CURLOPT_HTTPPROXYTUNNEL, 1 );
                 curl_easy_setopt( _curl_handle, CURLOPT_PROXY, proxy_addr.c_str() );
 
                 //Setup the proxy authentication if setup
                 if (!proxy_auth.empty())
                 {
-                    if ( s_HTTP_DEBUG )
-                    {
-                        OE_NOTICE << LC << "Using proxy authentication " << proxy_auth << std::endl;
-                    }
-
                     curl_easy_setopt( _curl_handle, CURLOPT_PROXYUSERPWD, proxy_auth.c_str());
                 }
             }
@@ -902,39 +942,500 @@ namespace
             curl_easy_setopt( _curl_handle, CURLOPT_CONNECTTIMEOUT, value );
         }
 
-        void readOptions(const osgDB::Options* options, std::string& proxy_host, std::string& proxy_port) const
+    private:
+        void* _curl_handle;
+        mutable std::string _previousPassword;
+        mutable long _previousHttpAuthentication;
+    };
+}
+
+HTTPClient::Implementation*
+CURLHTTPImplementationFactory::create() const
+{
+    return new CURLImplementation();
+}
+
+//.........................................................................
+
+namespace
+{
+    // Completion handler for one asynchronous transfer. canceled() reports
+    // whether anyone is still waiting on the result; abandon() resolves it
+    // as canceled when the transfer will never run (shutdown).
+    struct AsyncHandler
+    {
+        virtual ~AsyncHandler() { }
+        virtual bool canceled() const = 0;
+        virtual void complete(const HTTPResponse& response) = 0;
+        virtual void abandon() = 0;
+    };
+
+    template<typename T, typename F>
+    struct AsyncHandlerT : public AsyncHandler
+    {
+        AsyncHandlerT(const jobs::future<T>& promise, F func, const T& canceledValue) :
+            _promise(promise), _func(func), _canceledValue(canceledValue) { }
+        bool canceled() const override { return _promise.canceled(); }
+        void complete(const HTTPResponse& response) override { _func(response, _promise); }
+        void abandon() override { if (!_promise.canceled()) _promise.resolve(_canceledValue); }
+        jobs::future<T> _promise;
+        F _func;
+        T _canceledValue;
+    };
+
+    template<typename F>
+    AsyncHandler* makeAsyncHandler(const jobs::future<HTTPResponse>& promise, F func)
+    {
+        HTTPResponse canceled;
+        canceled.setCanceled(true);
+        canceled.setMessage("HTTP client shut down");
+        return new AsyncHandlerT<HTTPResponse, F>(promise, func, canceled);
+    }
+
+    template<typename F>
+    AsyncHandler* makeAsyncHandler(const jobs::future<ReadResult>& promise, F func)
+    {
+        return new AsyncHandlerT<ReadResult, F>(promise, func, ReadResult(ReadResult::RESULT_CANCELED));
+    }
+
+    // One in-flight (or queued) asynchronous GET.
+    struct AsyncTransfer
+    {
+        AsyncTransfer() : _part(new HTTPResponse::Part()), _sp(&_part->_stream)
+        {
+            _errorBuf[0] = 0;
+        }
+
+        ~AsyncTransfer()
+        {
+            if (_handle)
+                curl_easy_cleanup(_handle);
+            if (_headers)
+                curl_slist_free_all(_headers);
+        }
+
+        CURL* _handle = nullptr;
+        curl_slist* _headers = nullptr;
+        std::string _url;
+        std::string _proxy_addr;
+        osg::ref_ptr<HTTPResponse::Part> _part;
+        StreamObject _sp;
+        osg::ref_ptr<ProgressCallback> _progress;
+        std::unique_ptr<AsyncHandler> _handler;
+        osg::Timer_t _start = 0;
+        char _errorBuf[CURL_ERROR_SIZE];
+    };
+
+    static int AsyncTransferProgressCallback(void* clientp, double dltotal, double dlnow, double, double)
+    {
+        AsyncTransfer* t = (AsyncTransfer*)clientp;
+
+        // abandoned by the caller?
+        if (t->_handler->canceled())
+            return 1;
+
+        if (t->_progress.valid())
+            return t->_progress->isCanceled() || t->_progress->reportProgress(dlnow, dltotal);
+
+        return 0;
+    }
+
+    /**
+     * Runs all asynchronous GETs through a single curl multi handle serviced
+     * by one background thread. Transfers to the same host share connections
+     * and, with HTTP/2, are multiplexed over a single socket, so hundreds of
+     * tile requests no longer tie up hundreds of blocking threads.
+     */
+    class AsyncCURLEngine
+    {
+    public:
+        static AsyncCURLEngine& instance()
+        {
+            s_created = true;
+            static AsyncCURLEngine s_instance;
+            return s_instance;
+        }
+
+        //! Shuts down the engine if it was ever started.
+        static void shutdownInstance()
+        {
+            if (s_created)
+                instance().shutdown();
+        }
+
+        //! Queues a transfer; the engine takes ownership.
+        void submit(AsyncTransfer* t)
         {
-            // try to set proxy host/port by reading the CURL proxy options
-            if ( options )
             {
-                std::istringstream iss( options->getOptionString() );
-                std::string opt;
-                while( iss >> opt )
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_stopped)
                 {
-                    int index = opt.find('=');
-                    if( opt.substr( 0, index ) == "OSG_CURL_PROXY" )
+                    _queue.push_back(t);
+                    t = nullptr;
+                }
+            }
+
+            if (t)
+            {
+                // too late; nothing will ever service it
+                t->_handler->abandon();
+                delete t;
+                return;
+            }
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+            curl_multi_wakeup(_multi);
+#endif
+        }
+
+        //! Stops the transfer thread and resolves every pending request
+        //! as canceled, so no one waits forever on a future. Idempotent.
+        void shutdown()
+        {
+            _done = true;
+#if LIBCURL_VERSION_NUM >= 0x074400
+            curl_multi_wakeup(_multi);
+#endif
+            if (_thread.joinable())
+                _thread.join();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopped = true;
+
+            for (auto t : _running)
+            {
+                curl_multi_remove_handle(_multi, t->_handle);
+                t->_handler->abandon();
+                delete t;
+            }
+            _running.clear();
+            _active = 0u;
+
+            for (auto t : _queue)
+            {
+                t->_handler->abandon();
+                delete t;
+            }
+            _queue.clear();
+        }
+
+        std::atomic<unsigned> _maxTransfers;
+
+    private:
+        AsyncCURLEngine() :
+            _maxTransfers(64u),
+            _done(false),
+            _active(0u)
+        {
+            const char* maxEnv = ::getenv("OSGEARTH_HTTP_MAX_ASYNC_TRANSFERS");
+            if (maxEnv)
+                _maxTransfers = std::max(1u, osgEarth::as<unsigned>(std::string(maxEnv), 64u));
+
+            _multi = curl_multi_init();
+
+#if LIBCURL_VERSION_NUM >= 0x072B00
+            curl_multi_setopt(_multi, CURLMOPT_PIPELINING, (long)CURLPIPE_MULTIPLEX);
+#endif
+#if LIBCURL_VERSION_NUM >= 0x071E00
+            curl_multi_setopt(_multi, CURLMOPT_MAX_HOST_CONNECTIONS, 8L);
+            curl_multi_setopt(_multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, 64L);
+#endif
+
+            _thread = std::thread([this]() { run(); });
+        }
+
+        ~AsyncCURLEngine()
+        {
+            shutdown();
+            curl_multi_cleanup(_multi);
+        }
+
+        void run()
+        {
+            osgEarth::setThreadName("oe.http.async");
+
+            while (!_done)
+            {
+                // admit queued transfers up to the concurrency limit
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    while (!_queue.empty() && _active < _maxTransfers)
                     {
-                        proxy_host = opt.substr( index+1 );
+                        AsyncTransfer* t = _queue.front();
+                        _queue.pop_front();
+
+                        if (t->_handler->canceled())
+                        {
+                            delete t;
+                            continue;
+                        }
+
+                        t->_start = osg::Timer::instance()->tick();
+                        curl_multi_add_handle(_multi, t->_handle);
+                        _running.insert(t);
+                        ++_active;
                     }
-                    else if ( opt.substr( 0, index ) == "OSG_CURL_PROXYPORT" )
+                }
+
+                int running = 0;
+                curl_multi_perform(_multi, &running);
+
+                int remaining = 0;
+                CURLMsg* msg;
+                while ((msg = curl_multi_info_read(_multi, &remaining)) != nullptr)
+                {
+                    if (msg->msg == CURLMSG_DONE)
                     {
-                        proxy_port = opt.substr( index+1 );
+                        CURL* handle = msg->easy_handle;
+                        CURLcode res = msg->data.result;
+
+                        char* priv = nullptr;
+                        curl_easy_getinfo(handle, CURLINFO_PRIVATE, &priv);
+                        AsyncTransfer* t = (AsyncTransfer*)priv;
+
+                        curl_multi_remove_handle(_multi, handle);
+                        _running.erase(t);
+                        --_active;
+
+                        if (!t->_handler->canceled())
+                        {
+                            t->_handler->complete(makeResponse(t, res));
+                        }
+                        delete t;
                     }
                 }
+
+                // sleep until there's socket activity or a new submission
+#if LIBCURL_VERSION_NUM >= 0x074400
+                curl_multi_poll(_multi, nullptr, 0, 1000, nullptr);
+#else
+                curl_multi_wait(_multi, nullptr, 0, 10, nullptr);
+#endif
             }
         }
 
-    private:
-        void* _curl_handle;
-        mutable std::string _previousPassword;
-        mutable long _previousHttpAuthentication;
+        // Same response mapping as CURLImplementation::doGet
+        HTTPResponse makeResponse(AsyncTransfer* t, CURLcode res)
+        {
+            if (res == CURLE_ABORTED_BY_CALLBACK || res == CURLE_OPERATION_TIMEDOUT)
+            {
+                HTTPResponse response;
+                response.setCanceled(true);
+                response.setMessage(std::string(curl_easy_strerror(res)));
+                return response;
+            }
+
+            if (!t->_proxy_addr.empty())
+            {
+                long connect_code = 0L;
+                CURLcode r = curl_easy_getinfo(t->_handle, CURLINFO_HTTP_CONNECTCODE, &connect_code);
+                if (r != CURLE_OK)
+                {
+                    std::string msg = "Proxy connect error   " + std::string(curl_easy_strerror(r));
+                    OE_WARN << LC << msg << std::endl;
+                    HTTPResponse response(0);
+                    response.setMessage(msg);
+                    return response;
+                }
+            }
+
+            long response_code = 0L;
+            curl_easy_getinfo(t->_handle, CURLINFO_RESPONSE_CODE, &response_code);
+
+            if (s_simResponseCode > 0)
+            {
+                unsigned hash = std::hash<double>()(osg::Timer::instance()->tick()) % 10;
+                if (hash == 0)
+                    response_code = s_simResponseCode;
+            }
+
+            HTTPResponse response(response_code);
+
+            char* content_type_cp = nullptr;
+            curl_easy_getinfo(t->_handle, CURLINFO_CONTENT_TYPE, &content_type_cp);
+            if (content_type_cp != nullptr)
+            {
+                response.setMimeType(content_type_cp);
+            }
+
+            response.setLastModified(getCurlFileTime(t->_handle));
+
+            if (res == CURLE_OK)
+            {
+                if (response.getMimeType().length() > 9 &&
+                    ::strstr(response.getMimeType().c_str(), "multipart") == response.getMimeType().c_str())
+                {
+                    decodeMultipartStream("wcs", t->_part.get(), response.getParts());
+                }
+                else
+                {
+                    for (auto& header : t->_sp._headers)
+                    {
+                        t->_part->_headers[Strings::trim(header.first)] = Strings::trim(header.second);
+                    }
+                    response.getParts().push_back(t->_part.get());
+                }
+            }
+            else
+            {
+                response.setMessage(curl_easy_strerror(res));
+            }
+
+            response.setDuration(osg::Timer::instance()->delta_s(t->_start, osg::Timer::instance()->tick()));
+
+            if (s_HTTP_DEBUG)
+            {
+                OE_NOTICE << LC
+                    << "GET(" << response_code << ", async) " << response.getMimeType() << ": \""
+                    << t->_url << "\" t=" << std::setprecision(4) << response.getDuration() << "s" << std::endl;
+            }
+
+            return response;
+        }
+
+        CURLM* _multi;
+        std::mutex _mutex;
+        std::deque<AsyncTransfer*> _queue;
+        std::unordered_set<AsyncTransfer*> _running;
+        std::thread _thread;
+        std::atomic<bool> _done;
+        bool _stopped = false;
+        unsigned _active;
+        static std::atomic<bool> s_created;
     };
-}
 
-HTTPClient::Implementation*
-CURLHTTPImplementationFactory::create() const
-{
-    return new CURLImplementation();
+    std::atomic<bool> AsyncCURLEngine::s_created(false);
+
+    // Creates a fully configured transfer for a request. Mirrors the
+    // per-request setup of CURLImplementation::doGet.
+    AsyncTransfer* createAsyncTransfer(
+        const HTTPRequest& request,
+        const osgDB::Options* options,
+        ProgressCallback* progress,
+        AsyncHandler* handler)
+    {
+        AsyncTransfer* t = new AsyncTransfer();
+        t->_handler.reset(handler);
+        t->_progress = progress;
+        t->_handle = curl_easy_init();
+
+        CURL* handle = t->_handle;
+
+        t->_url = request.getURL();
+        osg::ref_ptr<URLRewriter> rewriter = HTTPClient::getURLRewriter();
+        if (rewriter.valid())
+        {
+            t->_url = rewriter->rewrite(t->_url);
+        }
+
+        curl_easy_setopt(handle, CURLOPT_URL, t->_url.c_str());
+        curl_easy_setopt(handle, CURLOPT_PRIVATE, (void*)t);
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, StreamObjectReadCallback);
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, (void*)&t->_sp);
+        curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, StreamObjectHeaderCallback);
+        curl_easy_setopt(handle, CURLOPT_HEADERDATA, (void*)&t->_sp);
+        curl_easy_setopt(handle, CURLOPT_PROGRESSFUNCTION, &AsyncTransferProgressCallback);
+        curl_easy_setopt(handle, CURLOPT_PROGRESSDATA, (void*)t);
+        curl_easy_setopt(handle, CURLOPT_NOPROGRESS, (void*)0);
+        curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, (void*)t->_errorBuf);
+        curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, (void*)1);
+        curl_easy_setopt(handle, CURLOPT_MAXREDIRS, (void*)5);
+        curl_easy_setopt(handle, CURLOPT_FILETIME, true);
+        curl_easy_setopt(handle, CURLOPT_ENCODING, "");
+        curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, (void*)0);
+
+#ifdef OE_CURL_SHARE
+        // same DNS, cookie, TLS session and connection cache as the sync path
+        curl_easy_setopt(handle, CURLOPT_SHARE, CURL_SHARE);
+#endif
+
+#if LIBCURL_VERSION_NUM >= 0x072F00
+        // prefer HTTP/2 over TLS so requests to one host share a connection
+        curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#endif
+#if LIBCURL_VERSION_NUM >= 0x072B00
+        // wait for a multiplexable connection rather than opening a new one
+        curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+#endif
+
+        const char* userAgentEnv = ::getenv("OSGEARTH_USERAGENT");
+        curl_easy_setopt(handle, CURLOPT_USERAGENT, userAgentEnv ? userAgentEnv : s_userAgent.c_str());
+
+        long timeout = s_timeout;
+        const char* timeoutEnv = ::getenv("OSGEARTH_HTTP_TIMEOUT");
+        if (timeoutEnv)
+            timeout = osgEarth::as<long>(std::string(timeoutEnv), 0);
+        curl_easy_setopt(handle, CURLOPT_TIMEOUT, timeout);
+
+        long connectTimeout = s_connectTimeout;
+        const char* connectTimeoutEnv = ::getenv("OSGEARTH_HTTP_CONNECTTIMEOUT");
+        if (connectTimeoutEnv)
+            connectTimeout = osgEarth::as<long>(std::string(connectTimeoutEnv), 0);
+        curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, connectTimeout);
+
+        std::string proxy_auth;
+        resolveProxy(options, t->_proxy_addr, proxy_auth);
+        if (!t->_proxy_addr.empty())
+        {
+            curl_easy_setopt(handle, CURLOPT_PROXY, t->_proxy_addr.c_str());
+            if (!proxy_auth.empty())
+                curl_easy_setopt(handle, CURLOPT_PROXYUSERPWD, proxy_auth.c_str());
+        }
+
+        const osgDB::AuthenticationMap* authenticationMap = (options && options->getAuthenticationMap()) ?
+            options->getAuthenticationMap() :
+            osgDB::Registry::instance()->getAuthenticationMap();
+
+        const osgDB::AuthenticationDetails* details = authenticationMap ?
+            authenticationMap->getAuthenticationDetails(t->_url) :
+            0;
+
+        if (details)
+        {
+            std::string password(details->username + ":" + details->password);
+            curl_easy_setopt(handle, CURLOPT_USERPWD, password.c_str());
+#if LIBCURL_VERSION_NUM >= 0x070a07
+            curl_easy_setopt(handle, CURLOPT_HTTPAUTH, details->httpAuthentication);
+#endif
+        }
+
+        for (auto& header : request.getHeaders())
+        {
+            std::string line = osgEarth::toLower(header.first) + ": " + header.second;
+            t->_headers = curl_slist_append(t->_headers, line.c_str());
+        }
+
+        // Disable the default Pragma: no-cache that curl adds by default.
+        t->_headers = curl_slist_append(t->_headers, "pragma: ");
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, t->_headers);
+
+        osg::ref_ptr<ConfigHandler> configHandler = HTTPClient::getConfigHandler();
+        if (configHandler.valid())
+        {
+            configHandler->onInitialize(handle);
+            configHandler->onGet(handle);
+        }
+
+        return t;
+    }
+
+    CacheBin* getURLCacheBin(const osgDB::Options* options, optional<CachePolicy>& cachePolicy)
+    {
+        CacheBin* bin = nullptr;
+        CacheSettings* cacheSettings = CacheSettings::get(options);
+        if (cacheSettings)
+        {
+            cachePolicy = cacheSettings->cachePolicy();
+            if (cacheSettings->isCacheEnabled())
+            {
+                // Use the global bin instead of the defined cache bin so all URLs are cached to the same place
+                bin = cacheSettings->getCache()->getOrCreateDefaultBin();
+            }
+        }
+        return bin;
+    }
+
+    const char* ASYNC_HTTP_POOL = "oe.http";
 }
 
 #ifdef OSGEARTH_USE_WININET_FOR_HTTP
@@ -1454,6 +1955,14 @@ HTTPClient::globalInit()
 #endif
 }
 
+void
+HTTPClient::globalShutdown()
+{
+#ifndef OSGEARTH_USE_WININET_FOR_HTTP
+    AsyncCURLEngine::shutdownInstance();
+#endif
+}
+
 void
 HTTPClient::readOptions(const osgDB::Options* options, std::string& proxy_host, std::string& proxy_port) const
 {
@@ -1493,6 +2002,152 @@ HTTPClient::get( const std::string&    url,
     return getClient().doGet( url, options, progress);
 }
 
+jobs::future<HTTPResponse>
+HTTPClient::getAsync(const HTTPRequest&    request,
+                     const osgDB::Options* options,
+                     ProgressCallback*     progress)
+{
+    OE_PROFILING_ZONE;
+
+#ifdef OSGEARTH_USE_WININET_FOR_HTTP
+    // WinInet has no multiplexed interface, so run the blocking GET in a job.
+    osg::ref_ptr<const osgDB::Options> options_ref(options);
+    osg::ref_ptr<ProgressCallback> progress_ref(progress);
+    return jobs::dispatch(
+        [request, options_ref, progress_ref](Cancelable&) {
+            return HTTPClient::get(request, options_ref.get(), progress_ref.get());
+        },
+        jobs::context{ ASYNC_HTTP_POOL, jobs::get_pool(ASYNC_HTTP_POOL) });
+#else
+    jobs::future<HTTPResponse> promise;
+
+    URI uri(request.getURL());
+
+    // URL cache lookups happen right here; only misses go to the network.
+    osgEarth::optional<CachePolicy> cachePolicy;
+    osg::ref_ptr<CacheBin> bin = getURLCacheBin(options, cachePolicy);
+
+    HTTPResponse cachedResponse;
+    bool expired = false;
+    bool gotFromCache = bin.valid() && readCachedResponse(bin.get(), uri.cacheKey(), cachePolicy.get(), options, cachedResponse, expired);
+
+    if ((gotFromCache && !expired) || cachePolicy->usage() == CachePolicy::USAGE_CACHE_ONLY)
+    {
+        promise.resolve(cachedResponse);
+        return promise;
+    }
+
+    osg::ref_ptr<const osgDB::Options> options_ref(options);
+    std::string cacheKey = uri.cacheKey();
+
+    auto onComplete = [bin, cacheKey, options_ref, cachedResponse](const HTTPResponse& remoteResponse, jobs::future<HTTPResponse>& promise)
+    {
+        if (bin.valid())
+        {
+            // keep cache I/O off the transfer thread
+            jobs::future<HTTPResponse> p = promise;
+            jobs::dispatch(
+                [bin, cacheKey, options_ref, cachedResponse, remoteResponse, p]() mutable {
+                    p.resolve(mergeRemoteResponse(bin.get(), cacheKey, options_ref.get(), cachedResponse, remoteResponse));
+                },
+                jobs::context{ ASYNC_HTTP_POOL, jobs::get_pool(ASYNC_HTTP_POOL) });
+        }
+        else
+        {
+            promise.resolve(remoteResponse);
+        }
+    };
+
+    AsyncCURLEngine::instance().submit(
+        createAsyncTransfer(request, options, progress, makeAsyncHandler(promise, onComplete)));
+
+    return promise;
+#endif
+}
+
+jobs::future<ReadResult>
+HTTPClient::readImageAsync(const HTTPRequest&    request,
+                           const osgDB::Options* options,
+                           ProgressCallback*     progress)
+{
+    OE_PROFILING_ZONE;
+
+    osg::ref_ptr<const osgDB::Options> options_ref(options);
+    osg::ref_ptr<ProgressCallback> progress_ref(progress);
+    jobs::context context{ ASYNC_HTTP_POOL, jobs::get_pool(ASYNC_HTTP_POOL) };
+
+#ifdef OSGEARTH_USE_WININET_FOR_HTTP
+    return jobs::dispatch(
+        [request, options_ref, progress_ref](Cancelable&) {
+            return HTTPClient::readImage(request, options_ref.get(), progress_ref.get());
+        },
+        context);
+#else
+    jobs::future<ReadResult> promise;
+
+    URI uri(request.getURL());
+
+    osgEarth::optional<CachePolicy> cachePolicy;
+    osg::ref_ptr<CacheBin> bin = getURLCacheBin(options, cachePolicy);
+
+    HTTPResponse cachedResponse;
+    bool expired = false;
+    bool gotFromCache = bin.valid() && readCachedResponse(bin.get(), uri.cacheKey(), cachePolicy.get(), options, cachedResponse, expired);
+
+    if ((gotFromCache && !expired) || cachePolicy->usage() == CachePolicy::USAGE_CACHE_ONLY)
+    {
+        // decode the cached data in a job
+        jobs::dispatch(
+            [request, cachedResponse, options_ref, progress_ref, promise]() mutable {
+                if (!promise.canceled())
+                    promise.resolve(makeImageResult(request, cachedResponse, options_ref.get(), progress_ref.get()));
+            },
+            context);
+        return promise;
+    }
+
+    std::string cacheKey = uri.cacheKey();
+
+    auto onComplete = [request, bin, cacheKey, options_ref, progress_ref, cachedResponse, context](const HTTPResponse& remoteResponse, jobs::future<ReadResult>& promise)
+    {
+        // update the cache and decode in a job, not on the transfer thread
+        jobs::future<ReadResult> p = promise;
+        jobs::dispatch(
+            [request, bin, cacheKey, options_ref, progress_ref, cachedResponse, remoteResponse, p]() mutable {
+                HTTPResponse response = mergeRemoteResponse(bin.get(), cacheKey, options_ref.get(), cachedResponse, remoteResponse);
+                if (!p.canceled())
+                    p.resolve(makeImageResult(request, response, options_ref.get(), progress_ref.get()));
+            },
+            context);
+    };
+
+    AsyncCURLEngine::instance().submit(
+        createAsyncTransfer(request, options, progress, makeAsyncHandler(promise, onComplete)));
+
+    return promise;
+#endif
+}
+
+void
+HTTPClient::setMaxAsyncTransfers(unsigned value)
+{
+#ifndef OSGEARTH_USE_WININET_FOR_HTTP
+    AsyncCURLEngine::instance()._maxTransfers = std::max(1u, value);
+#else
+    jobs::get_pool(ASYNC_HTTP_POOL)->set_concurrency(std::max(1u, value));
+#endif
+}
+
+unsigned
+HTTPClient::getMaxAsyncTransfers()
+{
+#ifndef OSGEARTH_USE_WININET_FOR_HTTP
+    return AsyncCURLEngine::instance()._maxTransfers;
+#else
+    return jobs::get_pool(ASYNC_HTTP_POOL)->concurrency();
+#endif
+}
+
 ReadResult
 HTTPClient::readImage(const HTTPRequest&    request,
                       const osgDB::Options* options,
@@ -1545,81 +2200,21 @@ HTTPClient::doGet(const HTTPRequest&    request,
     URI uri(request.getURL());
 
     // URL caching
-    CacheBin* bin = nullptr;
-    CacheSettings* cacheSettings = CacheSettings::get(options);
     osgEarth::optional<CachePolicy> cachePolicy;
-    if (cacheSettings)
-    {
-        cachePolicy = cacheSettings->cachePolicy();
-        if (cacheSettings->isCacheEnabled())
-        {
-            // Use the global bin instead of the defined cache bin so all URLs are cached to the same place
-            bin = cacheSettings->getCache()->getOrCreateDefaultBin();
-            //bin = cacheSettings->getCacheBin();
-        }
-    }
+    CacheBin* bin = getURLCacheBin(options, cachePolicy);
 
     bool expired = false;
 
     HTTPResponse response;
 
-    bool gotFromCache = false;
-
     //Try to read result from the cache.
-    if (bin)
-    {
-        ReadResult result = bin->readString(uri.cacheKey(), options);
-        if (result.succeeded())
-        {            
-            gotFromCache = true;
-
-            // If the cache-control header contains no-cache that means that it's ok to store the result in the cache, but it must be requested
-            // from the server each time it is it requested.
-            bool noCache = false;
-            std::string cacheControl = result.metadata().value("cache-control");
-            if (cacheControl.find("no-cache") != std::string::npos)
-            {
-                noCache = true;
-            }
-
-            expired = noCache || cachePolicy->isExpired(result.lastModifiedTime());
-            result.setIsFromCache(true);            
-
-            HTTPResponse cacheResponse(HTTPResponse::CATEGORY_SUCCESS);
-            osg::ref_ptr<HTTPResponse::Part> part = new HTTPResponse::Part();
-            part->_stream << result.getString();
-            std::string contentType = result.metadata().value("content-type");
-            cacheResponse.setMimeType(contentType);
-            cacheResponse.getParts().push_back(part);
-            cacheResponse.setHeadersFromConfig(result.metadata());
-            cacheResponse.setFromCache(true);
-            response = cacheResponse;
-        }
-    }
+    bool gotFromCache = bin && readCachedResponse(bin, uri.cacheKey(), cachePolicy.get(), options, response, expired);
 
     if ((expired || !gotFromCache) && cachePolicy->usage() != CachePolicy::USAGE_CACHE_ONLY)
     {
         HTTPResponse remoteResponse = _impl->doGet(request, options, progress);
 
-        if (remoteResponse.getCode() == ReadResult::RESULT_NOT_MODIFIED)
-        {
-            // Touch the cached item to update it's last modified timestamp so it doesn't expire again immediately.
-            if (bin)
-                bin->touch(uri.cacheKey());
-        }
-        else
-        {
-            response = remoteResponse;
-
-            if (response.isOK())
-            {
-                if (bin != nullptr)
-                {
-                    osg::ref_ptr< StringObject> stringObject = new StringObject(response.getPartAsString(0));
-                    bin->write(uri.cacheKey(), stringObject, response.getHeadersAsConfig(), options);
-                }
-            }
-        }
+        response = mergeRemoteResponse(bin, uri.cacheKey(), options, response, remoteResponse);
 
         OE_PROFILING_ZONE_TEXT(Stringify() << "response_code " << response.getCode());
         if (response.isCanceled())
@@ -1630,6 +2225,66 @@ HTTPClient::doGet(const HTTPRequest&    request,
     return response;
 }
 
+bool
+HTTPClient::readCachedResponse(CacheBin*             bin,
+                               const std::string&    cacheKey,
+                               const CachePolicy&    policy,
+                               const osgDB::Options* options,
+                               HTTPResponse&         out_response,
+                               bool&                 out_expired)
+{
+    ReadResult result = bin->readString(cacheKey, options);
+    if (!result.succeeded())
+        return false;
+
+    // If the cache-control header contains no-cache that means that it's ok to store the result in the cache, but it must be requested
+    // from the server each time it is it requested.
+    bool noCache = false;
+    std::string cacheControl = result.metadata().value("cache-control");
+    if (cacheControl.find("no-cache") != std::string::npos)
+    {
+        noCache = true;
+    }
+
+    out_expired = noCache || policy.isExpired(result.lastModifiedTime());
+
+    HTTPResponse cacheResponse(HTTPResponse::CATEGORY_SUCCESS);
+    osg::ref_ptr<HTTPResponse::Part> part = new HTTPResponse::Part();
+    part->_stream << result.getString();
+    std::string contentType = result.metadata().value("content-type");
+    cacheResponse.setMimeType(contentType);
+    cacheResponse.getParts().push_back(part);
+    cacheResponse.setHeadersFromConfig(result.metadata());
+    cacheResponse.setFromCache(true);
+    out_response = cacheResponse;
+    return true;
+}
+
+HTTPResponse
+HTTPClient::mergeRemoteResponse(CacheBin*             bin,
+                                const std::string&    cacheKey,
+                                const osgDB::Options* options,
+                                const HTTPResponse&   cachedResponse,
+                                const HTTPResponse&   remoteResponse)
+{
+    if (remoteResponse.getCode() == ReadResult::RESULT_NOT_MODIFIED)
+    {
+        // Touch the cached item to update it's last modified timestamp so it doesn't expire again immediately.
+        if (bin)
+            bin->touch(cacheKey);
+
+        return cachedResponse;
+    }
+
+    if (remoteResponse.isOK() && bin != nullptr)
+    {
+        osg::ref_ptr< StringObject> stringObject = new StringObject(remoteResponse.getPartAsString(0));
+        bin->write(cacheKey, stringObject, remoteResponse.getHeadersAsConfig(), options);
+    }
+
+    return remoteResponse;
+}
+
 bool
 HTTPClient::doDownload(const std::string& url, const std::string& filename)
 {
@@ -1728,10 +2383,19 @@ HTTPClient::doReadImage(const HTTPRequest&    request,
 {
     initialize();
 
-    ReadResult result;
-
     HTTPResponse response = this->doGet(request, options, callback);
 
+    return makeImageResult(request, response, options, callback);
+}
+
+ReadResult
+HTTPClient::makeImageResult(const HTTPRequest&    request,
+                            const HTTPResponse&   response,
+                            const osgDB::Options* options,
+                            ProgressCallback*     callback)
+{
+    ReadResult result;
+
     if (response.isOK())
     {
         osgDB::ReaderWriter* reader = getReader(request.getURL(), response);
@@ -9,6 +9,7 @@
 #include <osgEarth/Random>
 #include <osgEarth/Math>
 #include <osgEarth/MetaTile>
+#include <osgEarth/ReprojectionGrid>
 
 using namespace osgEarth;
 
@@ -652,9 +653,8 @@ ImageLayer::assembleImage(const TileKey& key, ProgressCallback* progress)
             auto mosaic = new osg::Image();
             mosaic->allocateImage(cols, rows, layers, GL_RGBA, GL_UNSIGNED_BYTE);
 
-            // Working set of points. it's much faster to xform an entire vector all at once.
+            // Working set of points, one per output pixel center.
             std::vector<osg::Vec3d> points;
-            points.resize(cols * rows);
 
             double minx, miny, maxx, maxy;
             key.getExtent().getBounds(minx, miny, maxx, maxy);
@@ -679,21 +679,16 @@ ImageLayer::assembleImage(const TileKey& key, ProgressCallback* progress)
                 //sourceBounds.yMax() -= 0.5 * dy;
             }
 
-            // build a grid of sample points:
-            for (unsigned t = 0; t < rows; ++t)
-            {
-                double y = miny + (0.5 * dy) + (dy * (double)t);
-                for (unsigned s = 0; s < cols; ++s)
-                {
-                    double x = minx + (0.5 * dx) + (dx * (double)s);
-                    points[t * cols + s] = { x, y, 0.0 };
-                }
-            }
-
-            // transform the sample points to the SRS of our source data tiles:
+            // transform the sample points to the SRS of our source data tiles.
+            // ReprojectionGrid interpolates from a sparse lattice when it can.
             if (source_srs && key_srs)
             {
-                key_srs->transform(points, source_srs);
+                ReprojectionGrid::transform(
+                    key_srs, source_srs,
+                    minx + 0.5 * dx, miny + 0.5 * dy,
+                    maxx - 0.5 * dx, maxy - 0.5 * dy,
+                    cols, rows,
+                    points);
 
                 if (sourceBounds.valid())
                 {
@@ -705,6 +700,9 @@ ImageLayer::assembleImage(const TileKey& key, ProgressCallback* progress)
                 }
             }
 
+            if (points.size() != cols * rows)
+                return output;
+
             // Mosaic our sources into a single output image.
             std::vector<GeoImagePixelReader> readers;
             for (unsigned i = 0; i < sources.size(); ++i)
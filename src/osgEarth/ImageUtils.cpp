@@ -13,9 +13,21 @@
 #include <osgDB/Registry>
 
 #include <osg/ValueObject>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 
 #define LC "[ImageUtils] "
 
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT 0x140B
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OE_IMAGEUTILS_SSE2
+#include <emmintrin.h>
+#endif
+
 
 #if defined(OSG_GLES1_AVAILABLE) || defined(OSG_GLES2_AVAILABLE) || defined(OSG_GLES3_AVAILABLE)
 #    define GL_RGB8_INTERNAL  GL_RGB8_OES
@@ -205,83 +217,123 @@ ImageUtils::resizeImage(const osg::Image* input,
         PixelReader read( input );
         PixelWriter write( output.get() );
 
-        osg::Vec4 color;
+        // The source columns and weights are the same for every output row,
+        // so compute them once. Each output pixel is a blend of two columns
+        // (the second weight is zero for nearest neighbor or exact hits).
+        std::vector<int> col0(out_s), col1(out_s);
+        std::vector<float> colw0(out_s), colw1(out_s);
 
-        for( unsigned int output_row=0; output_row < out_t; output_row++ )
+        for( unsigned int output_col = 0; output_col < out_s; output_col++ )
         {
-            // get an appropriate input row
-            float output_row_ratio = (float)output_row/(float)out_t;
-            float input_row = output_row_ratio * (float)in_t;
-            if ( input_row >= input->t() ) input_row = in_t-1;
-            else if ( input_row < 0 ) input_row = 0;
+            float output_col_ratio = (float)output_col/(float)out_s;
+            float input_col =  output_col_ratio * (float)in_s;
+            if ( input_col >= (int)in_s ) input_col = in_s-1;
+            else if ( input_col < 0 ) input_col = 0.0f;
 
-            for( unsigned int output_col = 0; output_col < out_s; output_col++ )
+            if (bilinear)
             {
-                float output_col_ratio = (float)output_col/(float)out_s;
-                float input_col =  output_col_ratio * (float)in_s;
-                if ( input_col >= (int)in_s ) input_col = in_s-1;
-                else if ( input_col < 0 ) input_col = 0.0f;
+                int colMin = osg::maximum((int)floor(input_col), 0);
+                int colMax = osg::maximum(osg::minimum((int)ceil(input_col), (int)(input->s()-1)), 0);
+                if (colMin > colMax) colMin = colMax;
+
+                col0[output_col] = colMin;
+                col1[output_col] = colMax;
+                colw0[output_col] = colMax == colMin ? 1.0f : (float)((double)colMax - input_col);
+                colw1[output_col] = colMax == colMin ? 0.0f : (float)(input_col - (double)colMin);
+            }
+            else
+            {
+                // nearest neighbor:
+                int col = (input_col-(int)input_col) <= (ceil(input_col)-input_col) ?
+                    (int)input_col :
+                    osg::minimum( 1+(int)input_col, (int)in_s-1 );
+
+                col0[output_col] = col1[output_col] = col;
+                colw0[output_col] = 1.0f;
+                colw1[output_col] = 0.0f;
+            }
+        }
+
+        // Source rows are read in bulk and reused while consecutive output
+        // rows map onto them.
+        PixelRow row0, row1, out;
+        out.resize(out_s);
+
+        for(int layer=0; layer<input->r(); ++layer)
+        {
+            int cached0 = -1, cached1 = -1;
+
+            for( unsigned int output_row=0; output_row < out_t; output_row++ )
+            {
+                // get an appropriate input row
+                float output_row_ratio = (float)output_row/(float)out_t;
+                float input_row = output_row_ratio * (float)in_t;
+                if ( input_row >= input->t() ) input_row = in_t-1;
+                else if ( input_row < 0 ) input_row = 0;
+
+                int rowMin, rowMax;
+                float roww0 = 1.0f, roww1 = 0.0f;
 
-                for(int layer=0; layer<input->r(); ++layer)
+                if (bilinear)
                 {
-                    if (bilinear)
+                    rowMin = osg::maximum((int)floor(input_row), 0);
+                    rowMax = osg::maximum(osg::minimum((int)ceil(input_row), (int)(input->t()-1)), 0);
+                    if (rowMin > rowMax) rowMin = rowMax;
+
+                    if (rowMax != rowMin)
                     {
-                        // Do a bilinear interpolation for the image
-                        int rowMin = osg::maximum((int)floor(input_row), 0);
-                        int rowMax = osg::maximum(osg::minimum((int)ceil(input_row), (int)(input->t()-1)), 0);
-                        int colMin = osg::maximum((int)floor(input_col), 0);
-                        int colMax = osg::maximum(osg::minimum((int)ceil(input_col), (int)(input->s()-1)), 0);
-
-                        if (rowMin > rowMax) rowMin = rowMax;
-                        if (colMin > colMax) colMin = colMax;
-
-                        osg::Vec4 urColor = read(colMax, rowMax, layer);
-                        osg::Vec4 llColor = read(colMin, rowMin, layer);
-                        osg::Vec4 ulColor = read(colMin, rowMax, layer);
-                        osg::Vec4 lrColor = read(colMax, rowMin, layer);
-
-                        if ((colMax == colMin) && (rowMax == rowMin))
-                        {
-                            // Exact value
-                            color = urColor;
-                        }
-                        else if (colMax == colMin)
-                        {
-                            // Linear interpolate vertically
-                            color = llColor * ((double)rowMax - input_row) + ulColor * (input_row - (double)rowMin);
-                        }
-                        else if (rowMax == rowMin)
-                        {
-                            // Linear interpolate horizontally
-                            color = llColor * ((double)colMax - input_col) + lrColor * (input_col - (double)colMin);
-                        }
-                        else
-                        {
-                            // Bilinear interpolate
-                            osg::Vec4 r1 = llColor * ((double)colMax - input_col) + lrColor * (input_col - (double)colMin);
-                            osg::Vec4 r2 = ulColor * ((double)colMax - input_col) + urColor * (input_col - (double)colMin);
-                            color = r1 * ((double)rowMax - input_row) + r2 * (input_row - (double)rowMin);
-                        }
+                        roww0 = (float)((double)rowMax - input_row);
+                        roww1 = (float)(input_row - (double)rowMin);
                     }
-                    else
-                    {
-                        // nearest neighbor:
-                        int col = (input_col-(int)input_col) <= (ceil(input_col)-input_col) ?
-                            (int)input_col :
-                            osg::minimum( 1+(int)input_col, (int)in_s-1 );
+                }
+                else
+                {
+                    // nearest neighbor:
+                    rowMin = rowMax = (input_row-(int)input_row) <= (ceil(input_row)-input_row) ?
+                        (int)input_row :
+                        osg::minimum( 1+(int)input_row, (int)in_t-1 );
+                }
+
+                if (rowMin == cached1 && rowMin != cached0)
+                {
+                    std::swap(row0, row1);
+                    std::swap(cached0, cached1);
+                }
+                if (rowMin != cached0)
+                {
+                    read.readRow(row0, rowMin, layer); // read from mip level 0
+                    cached0 = rowMin;
+                }
+                if (rowMax != rowMin && rowMax != cached1)
+                {
+                    read.readRow(row1, rowMax, layer);
+                    cached1 = rowMax;
+                }
+
+                const bool vertical = rowMax != rowMin;
 
-                        int row = (input_row-(int)input_row) <= (ceil(input_row)-input_row) ?
-                            (int)input_row :
-                            osg::minimum( 1+(int)input_row, (int)in_t-1 );
+                for( unsigned int output_col = 0; output_col < out_s; output_col++ )
+                {
+                    const int c0 = col0[output_col], c1 = col1[output_col];
+                    const float w0 = colw0[output_col], w1 = colw1[output_col];
 
-                        read(color, col, row, layer); // read pixel from mip level 0.
+                    float r = row0.r[c0] * w0 + row0.r[c1] * w1;
+                    float g = row0.g[c0] * w0 + row0.g[c1] * w1;
+                    float b = row0.b[c0] * w0 + row0.b[c1] * w1;
+                    float a = row0.a[c0] * w0 + row0.a[c1] * w1;
 
-                        // old code
-                        //color = read( (int)input_col, (int)input_row, layer ); // read pixel from mip level 0
+                    if (vertical)
+                    {
+                        r = r * roww0 + (row1.r[c0] * w0 + row1.r[c1] * w1) * roww1;
+                        g = g * roww0 + (row1.g[c0] * w0 + row1.g[c1] * w1) * roww1;
+                        b = b * roww0 + (row1.b[c0] * w0 + row1.b[c1] * w1) * roww1;
+                        a = a * roww0 + (row1.a[c0] * w0 + row1.a[c1] * w1) * roww1;
                     }
 
-                    write( color, output_col, output_row, layer, mipmapLevel ); // write to target mip level
+                    out.r[output_col] = r, out.g[output_col] = g, out.b[output_col] = b, out.a[output_col] = a;
                 }
+
+                write.writeRow(out, output_row, layer, 0, out_s, mipmapLevel); // write to target mip level
             }
         }
     }
@@ -948,23 +1000,31 @@ ImageUtils::mix(osg::Image* dest, const osg::Image* src, float a)
     bool srcHasAlpha = hasAlphaChannel(src);
     bool destHasAlpha = hasAlphaChannel(dest);
 
-    osg::Vec4 src_value, dest_value;
     PixelReader read_src(src), read_dest(dest);
     PixelWriter write_dest(dest);
+    PixelRow src_row, dest_row;
+    const unsigned width = dest->s();
 
-    read_src.forEachPixel([&](auto& i)
-        {
-            read_src(src_value, i);
-            read_dest(dest_value, i);
-            float sa = srcHasAlpha ? a * src_value.a() : a;
-            float da = destHasAlpha ? dest_value.a() : 1.0f;
-            dest_value.set(
-                dest_value.r() * (1.0f - sa) + src_value.r() * sa,
-                dest_value.g() * (1.0f - sa) + src_value.g() * sa,
-                dest_value.b() * (1.0f - sa) + src_value.b() * sa,
-                osg::maximum(sa, da));
-            write_dest(dest_value, i);
-        });
+    for (int r = 0; r < dest->r(); ++r)
+    {
+        for (int t = 0; t < dest->t(); ++t)
+        {
+            read_src.readRow(src_row, t, r);
+            read_dest.readRow(dest_row, t, r);
+
+            for (unsigned i = 0; i < width; ++i)
+            {
+                float sa = srcHasAlpha ? a * src_row.a[i] : a;
+                float da = destHasAlpha ? dest_row.a[i] : 1.0f;
+                dest_row.r[i] = dest_row.r[i] * (1.0f - sa) + src_row.r[i] * sa;
+                dest_row.g[i] = dest_row.g[i] * (1.0f - sa) + src_row.g[i] * sa;
+                dest_row.b[i] = dest_row.b[i] * (1.0f - sa) + src_row.b[i] * sa;
+                dest_row.a[i] = osg::maximum(sa, da);
+            }
+
+            write_dest.writeRow(dest_row, t, r);
+        }
+    }
 
     return true;
 }
@@ -1409,15 +1469,19 @@ ImageUtils::convert(const osg::Image* image, GLenum pixelFormat, GLenum dataType
     else
         result->setInternalTextureFormat( pixelFormat );
 
-    // copy image to result
+    // copy image to result, a row at a time
     PixelReader read(image);
     PixelWriter write(result);
+    PixelRow row;
 
-    osg::Vec4 value;
-    read.forEachPixel([&](auto& i) {
-        read(value, i);
-        write(value, i);
-    });
+    for (int r = 0; r < image->r(); ++r)
+    {
+        for (int t = 0; t < image->t(); ++t)
+        {
+            read.readRow(row, t, r);
+            write.writeRow(row, t, r);
+        }
+    }
 
     return result;
 }
@@ -1661,6 +1725,116 @@ namespace
         static double scale(bool norm) { return 1.0; }
     };
 
+    // IEEE 754 half <-> single precision conversions (GL_HALF_FLOAT).
+    inline float halfToFloat(GLushort h)
+    {
+        std::uint32_t sign = (std::uint32_t)(h & 0x8000u) << 16;
+        std::uint32_t exponent = (h >> 10) & 0x1fu;
+        std::uint32_t mantissa = h & 0x3ffu;
+        std::uint32_t bits;
+
+        if (exponent == 0u)
+        {
+            if (mantissa == 0u)
+            {
+                bits = sign;
+            }
+            else
+            {
+                // subnormal half -> normalized float
+                exponent = 113u;
+                while ((mantissa & 0x400u) == 0u)
+                {
+                    mantissa <<= 1;
+                    --exponent;
+                }
+                bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+            }
+        }
+        else if (exponent == 31u)
+        {
+            bits = sign | 0x7f800000u | (mantissa << 13); // inf/nan
+        }
+        else
+        {
+            bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+        }
+
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    inline GLushort floatToHalf(float f)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+
+        std::uint32_t sign = (bits >> 16) & 0x8000u;
+        std::uint32_t mantissa = bits & 0x7fffffu;
+        int exponent = (int)((bits >> 23) & 0xffu);
+
+        if (exponent == 0xff)
+            return (GLushort)(sign | 0x7c00u | (mantissa ? 0x200u : 0u)); // inf/nan
+
+        exponent = exponent - 127 + 15;
+
+        if (exponent >= 31)
+            return (GLushort)(sign | 0x7c00u); // overflow -> inf
+
+        if (exponent <= 0)
+        {
+            if (exponent < -10)
+                return (GLushort)sign; // underflow -> 0
+
+            // subnormal half, round to nearest
+            mantissa |= 0x800000u;
+            unsigned shift = (unsigned)(14 - exponent);
+            std::uint32_t half = mantissa >> shift;
+            if ((mantissa >> (shift - 1u)) & 1u)
+                ++half;
+            return (GLushort)(sign | half);
+        }
+
+        // round to nearest; a carry into the exponent is still correct
+        std::uint32_t half = sign | ((std::uint32_t)exponent << 10) | (mantissa >> 13);
+        if (mantissa & 0x1000u)
+            ++half;
+        return (GLushort)half;
+    }
+
+    struct HalfFloat
+    {
+        GLushort bits;
+        HalfFloat(float f) : bits(floatToHalf(f)) { }
+        operator float() const { return halfToFloat(bits); }
+    };
+
+    template<> struct GLTypeTraits<HalfFloat>
+    {
+        static double scale(bool norm) { return 1.0; }
+    };
+
+    // Converts a float channel to 8 bits, clamping and rounding to nearest.
+    // Shared by the per-pixel and row writers so both produce the same bytes.
+    inline GLubyte toUByte(float v, float scale)
+    {
+        return (GLubyte)clamp(v * scale + 0.5f, 0.0f, 255.0f);
+    }
+
+    // Converts a float channel to the storage type T, given the read scale
+    template<typename T>
+    inline T encodeChannel(float v, double scale)
+    {
+        return (T)(v / scale);
+    }
+
+    template<>
+    inline GLubyte encodeChannel<GLubyte>(float v, double scale)
+    {
+        return toUByte(v, (float)(1.0 / scale));
+    }
+
     // The Reader function that performs the read.
     template<int Format, typename T> struct ColorReader;
     template<int Format, typename T> struct ColorWriter;
@@ -1682,7 +1856,7 @@ namespace
         static void write(const ImageUtils::PixelWriter* iw, const osg::Vec4f& c, int s, int t, int r, int m)
         {
             T* ptr = (T*)iw->data(s, t, r, m);
-            (*ptr) = (T)(c.r() / GLTypeTraits<T>::scale(iw->_normalized));
+            (*ptr) = encodeChannel<T>(c.r(), GLTypeTraits<T>::scale(iw->_normalized));
         }
     };
 
@@ -1703,7 +1877,7 @@ namespace
         static void write(const ImageUtils::PixelWriter* iw, const osg::Vec4f& c, int s, int t, int r, int m)
         {
             T* ptr = (T*)iw->data(s, t, r, m);
-            (*ptr) = (T)(c.r() / GLTypeTraits<T>::scale(iw->_normalized));
+            (*ptr) = encodeChannel<T>(c.r(), GLTypeTraits<T>::scale(iw->_normalized));
         }
     };
 
@@ -1724,7 +1898,7 @@ namespace
         static void write(const ImageUtils::PixelWriter* iw, const osg::Vec4f& c, int s, int t, int r, int m)
         {
             T* ptr = (T*)iw->data(s, t, r, m);
-            (*ptr) = (T)(c.r() / GLTypeTraits<T>::scale(iw->_normalized));
+            (*ptr) = encodeChannel<T>(c.r(), GLTypeTraits<T>::scale(iw->_normalized));
         }
     };
 
@@ -1745,7 +1919,7 @@ namespace
         static void write(const ImageUtils::PixelWriter* iw, const osg::Vec4f& c, int s, int t, int r, int m)
         {
             T* ptr = (T*)iw->data(s, t, r, m);
-            (*ptr) = (T)(c.a() / GLTypeTraits<T>::scale(iw->_normalized));
+            (*ptr) = encodeChannel<T>(c.a(), GLTypeTraits<T>::scale(iw->_normalized));
         }
     };
 
@@ -1769,8 +1943,8 @@ namespace
         {
             double scale = GLTypeTraits<T>::scale(iw->_normalized);
             T* ptr = (T*)iw->data(s, t, r, m);
-            *ptr++ = (T)( c.r() / scale );
-            *ptr   = (T)( c.a() / scale );
+            *ptr++ = encodeChannel<T>(c.r(), scale);
+            *ptr   = encodeChannel<T>(c.a(), scale);
         }
     };
 
@@ -1794,8 +1968,8 @@ namespace
         {
             double scale = GLTypeTraits<T>::scale(iw->_normalized);
             T* ptr = (T*)iw->data(s, t, r, m);
-            *ptr++ = (T)( c.r() / scale );
-            *ptr++ = (T)( c.g() / scale );
+            *ptr++ = encodeChannel<T>(c.r(), scale);
+            *ptr++ = encodeChannel<T>(c.g(), scale);
         }
     };
 
@@ -1820,9 +1994,9 @@ namespace
         {
             double scale = GLTypeTraits<T>::scale(iw->_normalized);
             T* ptr = (T*)iw->data(s, t, r, m);
-            *ptr++ = (T)( c.r() / scale );
-            *ptr++ = (T)( c.g() / scale );
-            *ptr++ = (T)( c.b() / scale );
+            *ptr++ = encodeChannel<T>(c.r(), scale);
+            *ptr++ = encodeChannel<T>(c.g(), scale);
+            *ptr++ = encodeChannel<T>(c.b(), scale);
         }
     };
 
@@ -1848,10 +2022,10 @@ namespace
         {
             double scale = GLTypeTraits<T>::scale(iw->_normalized);
             T* ptr = (T*)iw->data(s, t, r, m);
-            *ptr++ = (T)( c.r() / scale );
-            *ptr++ = (T)( c.g() / scale );
-            *ptr++ = (T)( c.b() / scale );
-            *ptr++ = (T)( c.a() / scale );
+            *ptr++ = encodeChannel<T>(c.r(), scale);
+            *ptr++ = encodeChannel<T>(c.g(), scale);
+            *ptr++ = encodeChannel<T>(c.b(), scale);
+            *ptr++ = encodeChannel<T>(c.a(), scale);
         }
     };
 
@@ -1876,9 +2050,9 @@ namespace
         {
             double scale = GLTypeTraits<T>::scale(iw->_normalized);
             T* ptr = (T*)iw->data(s, t, r, m);
-            *ptr++ = (T)( c.b() / scale );
-            *ptr++ = (T)( c.g() / scale );
-            *ptr++ = (T)( c.r() / scale );
+            *ptr++ = encodeChannel<T>(c.b(), scale);
+            *ptr++ = encodeChannel<T>(c.g(), scale);
+            *ptr++ = encodeChannel<T>(c.r(), scale);
         }
     };
 
@@ -1904,10 +2078,10 @@ namespace
         {
             double scale = GLTypeTraits<T>::scale(iw->_normalized);
             T* ptr = (T*)iw->data(s, t, r, m);
-            *ptr++ = (T)( c.b() / scale );
-            *ptr++ = (T)( c.g() / scale );
-            *ptr++ = (T)( c.r() / scale );
-            *ptr++ = (T)( c.a() / scale );
+            *ptr++ = encodeChannel<T>(c.b(), scale);
+            *ptr++ = encodeChannel<T>(c.g(), scale);
+            *ptr++ = encodeChannel<T>(c.r(), scale);
+            *ptr++ = encodeChannel<T>(c.a(), scale);
         }
     };
 
@@ -2221,6 +2395,8 @@ namespace
             //return &ColorReader<GLFormat, GLuint>::read;
         case GL_FLOAT:
             return &ColorReader<GLFormat, GLfloat>::read;
+        case GL_HALF_FLOAT:
+            return &ColorReader<GLFormat, HalfFloat>::read;
         case GL_UNSIGNED_SHORT_5_5_5_1:
             return &ColorReader<GL_UNSIGNED_SHORT_5_5_5_1, GLushort>::read;
         case GL_UNSIGNED_BYTE_3_3_2:
@@ -2284,12 +2460,188 @@ namespace
     }
 }
 
+namespace
+{
+    // Row readers. Each one reads "count" pixels starting at (s,t,r,m) into
+    // the channel arrays of a PixelRow. The specialized versions only handle
+    // m == 0; readRow falls back on the generic reader for mipmap levels.
+
+    void readRowGeneric(const ImageUtils::PixelReader* ia, ImageUtils::PixelRow& out, int s, int t, int r, int m, unsigned count)
+    {
+        osg::Vec4f c;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            ia->_read(ia, c, s + (int)i, t, r, m);
+            out.r[i] = c.r(), out.g[i] = c.g(), out.b[i] = c.b(), out.a[i] = c.a();
+        }
+    }
+
+    void readRowRGBA8(const ImageUtils::PixelReader* ia, ImageUtils::PixelRow& out, int s, int t, int r, int m, unsigned count)
+    {
+        const GLubyte* ptr = ia->data(s, t, r, 0);
+        const float scale = ia->_normalized ? 1.0f / 255.0f : 1.0f;
+        float* R = out.r.data(), * G = out.g.data(), * B = out.b.data(), * A = out.a.data();
+        unsigned i = 0;
+
+#ifdef OE_IMAGEUTILS_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 vscale = _mm_set1_ps(scale);
+        for (; i + 4 <= count; i += 4)
+        {
+            // four RGBA pixels -> four float vectors, then transpose to SoA
+            __m128i px = _mm_loadu_si128((const __m128i*)(ptr + i * 4));
+            __m128i lo = _mm_unpacklo_epi8(px, zero);
+            __m128i hi = _mm_unpackhi_epi8(px, zero);
+            __m128 p0 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), vscale);
+            __m128 p1 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), vscale);
+            __m128 p2 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), vscale);
+            __m128 p3 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), vscale);
+            _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+            _mm_storeu_ps(R + i, p0);
+            _mm_storeu_ps(G + i, p1);
+            _mm_storeu_ps(B + i, p2);
+            _mm_storeu_ps(A + i, p3);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const GLubyte* p = ptr + i * 4;
+            R[i] = (float)p[0] * scale;
+            G[i] = (float)p[1] * scale;
+            B[i] = (float)p[2] * scale;
+            A[i] = (float)p[3] * scale;
+        }
+    }
+
+    void readRowRGB8(const ImageUtils::PixelReader* ia, ImageUtils::PixelRow& out, int s, int t, int r, int m, unsigned count)
+    {
+        // no cheap SSE2 deinterleave for 3-byte pixels; keep the loop
+        // branch-free so the compiler can vectorize it
+        const GLubyte* ptr = ia->data(s, t, r, 0);
+        const float scale = ia->_normalized ? 1.0f / 255.0f : 1.0f;
+        float* R = out.r.data(), * G = out.g.data(), * B = out.b.data(), * A = out.a.data();
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const GLubyte* p = ptr + i * 3;
+            R[i] = (float)p[0] * scale;
+            G[i] = (float)p[1] * scale;
+            B[i] = (float)p[2] * scale;
+            A[i] = 1.0f;
+        }
+    }
+
+    // GL_LUMINANCE or GL_RED, 8 bits (red is replicated like ColorReader does)
+    void readRowR8(const ImageUtils::PixelReader* ia, ImageUtils::PixelRow& out, int s, int t, int r, int m, unsigned count)
+    {
+        const GLubyte* ptr = ia->data(s, t, r, 0);
+        const float scale = ia->_normalized ? 1.0f / 255.0f : 1.0f;
+        float* R = out.r.data();
+        unsigned i = 0;
+
+#ifdef OE_IMAGEUTILS_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 vscale = _mm_set1_ps(scale);
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i px = _mm_loadu_si128((const __m128i*)(ptr + i));
+            __m128i lo = _mm_unpacklo_epi8(px, zero);
+            __m128i hi = _mm_unpackhi_epi8(px, zero);
+            _mm_storeu_ps(R + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), vscale));
+            _mm_storeu_ps(R + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), vscale));
+            _mm_storeu_ps(R + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), vscale));
+            _mm_storeu_ps(R + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), vscale));
+        }
+#endif
+        for (; i < count; ++i)
+            R[i] = (float)ptr[i] * scale;
+
+        std::memcpy(out.g.data(), R, count * sizeof(float));
+        std::memcpy(out.b.data(), R, count * sizeof(float));
+        std::fill(out.a.begin(), out.a.begin() + count, 1.0f);
+    }
+
+    // GL_LUMINANCE or GL_RED, 32-bit float
+    void readRowR32F(const ImageUtils::PixelReader* ia, ImageUtils::PixelRow& out, int s, int t, int r, int m, unsigned count)
+    {
+        const GLfloat* ptr = (const GLfloat*)ia->data(s, t, r, 0);
+        std::memcpy(out.r.data(), ptr, count * sizeof(float));
+        std::memcpy(out.g.data(), ptr, count * sizeof(float));
+        std::memcpy(out.b.data(), ptr, count * sizeof(float));
+        std::fill(out.a.begin(), out.a.begin() + count, 1.0f);
+    }
+
+    // GL_LUMINANCE or GL_RED, 16-bit float
+    void readRowR16F(const ImageUtils::PixelReader* ia, ImageUtils::PixelRow& out, int s, int t, int r, int m, unsigned count)
+    {
+        const GLushort* ptr = (const GLushort*)ia->data(s, t, r, 0);
+        float* R = out.r.data();
+        for (unsigned i = 0; i < count; ++i)
+            R[i] = halfToFloat(ptr[i]);
+
+        std::memcpy(out.g.data(), R, count * sizeof(float));
+        std::memcpy(out.b.data(), R, count * sizeof(float));
+        std::fill(out.a.begin(), out.a.begin() + count, 1.0f);
+    }
+
+    void readRowRGBA32F(const ImageUtils::PixelReader* ia, ImageUtils::PixelRow& out, int s, int t, int r, int m, unsigned count)
+    {
+        const GLfloat* ptr = (const GLfloat*)ia->data(s, t, r, 0);
+        float* R = out.r.data(), * G = out.g.data(), * B = out.b.data(), * A = out.a.data();
+        unsigned i = 0;
+
+#ifdef OE_IMAGEUTILS_SSE2
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 p0 = _mm_loadu_ps(ptr + i * 4);
+            __m128 p1 = _mm_loadu_ps(ptr + i * 4 + 4);
+            __m128 p2 = _mm_loadu_ps(ptr + i * 4 + 8);
+            __m128 p3 = _mm_loadu_ps(ptr + i * 4 + 12);
+            _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+            _mm_storeu_ps(R + i, p0);
+            _mm_storeu_ps(G + i, p1);
+            _mm_storeu_ps(B + i, p2);
+            _mm_storeu_ps(A + i, p3);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const GLfloat* p = ptr + i * 4;
+            R[i] = p[0], G[i] = p[1], B[i] = p[2], A[i] = p[3];
+        }
+    }
+
+    //! Selects a row reader based on the input pixel format and type.
+    inline ImageUtils::PixelReader::RowReaderFunc
+    getRowReader(GLenum pixelFormat, GLenum dataType)
+    {
+        const bool single = pixelFormat == GL_LUMINANCE || pixelFormat == GL_RED;
+
+        switch (dataType)
+        {
+        case GL_UNSIGNED_BYTE:
+            if (pixelFormat == GL_RGBA) return &readRowRGBA8;
+            if (pixelFormat == GL_RGB) return &readRowRGB8;
+            if (single) return &readRowR8;
+            break;
+        case GL_FLOAT:
+            if (pixelFormat == GL_RGBA) return &readRowRGBA32F;
+            if (single) return &readRowR32F;
+            break;
+        case GL_HALF_FLOAT:
+            if (single) return &readRowR16F;
+            break;
+        }
+        return &readRowGeneric;
+    }
+}
+
 ImageUtils::PixelReader::PixelReader() :
     _bilinear(false),
     _sampleAsTexture(false),
     _sampleAsRepeatingTexture(false),
     _image(nullptr),
-    _read(nullptr)
+    _read(nullptr),
+    _readRow(nullptr)
 {
     //nop
 }
@@ -2299,7 +2651,8 @@ ImageUtils::PixelReader::PixelReader(const osg::Image* image) :
     _sampleAsTexture(false),
     _sampleAsRepeatingTexture(false),
     _image(nullptr),
-    _read(nullptr)
+    _read(nullptr),
+    _readRow(nullptr)
 {
     setImage(image);
 }
@@ -2322,6 +2675,7 @@ ImageUtils::PixelReader::setImage(const osg::Image* image)
             OE_WARN << "[PixelReader] No reader found for pixel format " << std::hex << _image->getPixelFormat() << std::endl;
             _read = &ColorReader<0,GLbyte>::read;
         }
+        _readRow = getRowReader(_image->getPixelFormat(), dataType);
     }
 }
 
@@ -2660,6 +3014,26 @@ ImageUtils::PixelReader::operator()(double u, double v, int r, int m) const
     return temp;
 }
 
+void
+ImageUtils::PixelReader::readRow(PixelRow& out, int t, int r, int s, unsigned count, int m) const
+{
+    if (!_image)
+        return;
+
+    if (count == 0)
+    {
+        int width = m == 0 ? _image->s() : osg::maximum(_image->s() >> m, 1);
+        count = width > s ? (unsigned)(width - s) : 0u;
+    }
+
+    if (out.size() < count)
+        out.resize(count);
+
+    // formats without a specialized row reader use the per-pixel one
+    if (count > 0)
+        (m == 0 && _readRow ? _readRow : &readRowGeneric)(this, out, s, t, r, m, count);
+}
+
 bool
 ImageUtils::PixelReader::supports( GLenum pixelFormat, GLenum dataType )
 {
@@ -2689,6 +3063,8 @@ namespace
             return &ColorWriter<GLFormat, GLuint>::write;
         case GL_FLOAT:
             return &ColorWriter<GLFormat, GLfloat>::write;
+        case GL_HALF_FLOAT:
+            return &ColorWriter<GLFormat, HalfFloat>::write;
         case GL_UNSIGNED_SHORT_5_5_5_1:
             return &ColorWriter<GL_UNSIGNED_SHORT_5_5_5_1, GLushort>::write;
         case GL_UNSIGNED_BYTE_3_3_2:
@@ -2739,8 +3115,168 @@ namespace
     }
 }
 
+namespace
+{
+    // Row writers. Each one writes "count" pixels from the channel arrays of
+    // a PixelRow starting at (s,t,r,m). The specialized versions only handle
+    // m == 0; writeRow falls back on the generic writer for mipmap levels.
+    // The 8-bit writers clamp and round to nearest, like the per-pixel writer.
+
+    void writeRowGeneric(const ImageUtils::PixelWriter* iw, const ImageUtils::PixelRow& in, int s, int t, int r, int m, unsigned count)
+    {
+        for (unsigned i = 0; i < count; ++i)
+        {
+            iw->_writer(iw, osg::Vec4f(in.r[i], in.g[i], in.b[i], in.a[i]), s + (int)i, t, r, m);
+        }
+    }
+
+    void writeRowRGBA8(const ImageUtils::PixelWriter* iw, const ImageUtils::PixelRow& in, int s, int t, int r, int m, unsigned count)
+    {
+        GLubyte* ptr = iw->data(s, t, r, 0);
+        const float scale = iw->_normalized ? 255.0f : 1.0f;
+        const float* R = in.r.data(), * G = in.g.data(), * B = in.b.data(), * A = in.a.data();
+        unsigned i = 0;
+
+#ifdef OE_IMAGEUTILS_SSE2
+        const __m128 vscale = _mm_set1_ps(scale);
+        const __m128 vhalf = _mm_set1_ps(0.5f);
+        const __m128 vmin = _mm_setzero_ps();
+        const __m128 vmax = _mm_set1_ps(255.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 p0 = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(R + i), vscale), vhalf), vmin), vmax);
+            __m128 p1 = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(G + i), vscale), vhalf), vmin), vmax);
+            __m128 p2 = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(B + i), vscale), vhalf), vmin), vmax);
+            __m128 p3 = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(A + i), vscale), vhalf), vmin), vmax);
+            _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+            // truncating after +0.5 matches toUByte; saturating packs interleave back to RGBA
+            __m128i lo = _mm_packs_epi32(_mm_cvttps_epi32(p0), _mm_cvttps_epi32(p1));
+            __m128i hi = _mm_packs_epi32(_mm_cvttps_epi32(p2), _mm_cvttps_epi32(p3));
+            _mm_storeu_si128((__m128i*)(ptr + i * 4), _mm_packus_epi16(lo, hi));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            GLubyte* p = ptr + i * 4;
+            p[0] = toUByte(R[i], scale);
+            p[1] = toUByte(G[i], scale);
+            p[2] = toUByte(B[i], scale);
+            p[3] = toUByte(A[i], scale);
+        }
+    }
+
+    void writeRowRGB8(const ImageUtils::PixelWriter* iw, const ImageUtils::PixelRow& in, int s, int t, int r, int m, unsigned count)
+    {
+        GLubyte* ptr = iw->data(s, t, r, 0);
+        const float scale = iw->_normalized ? 255.0f : 1.0f;
+        const float* R = in.r.data(), * G = in.g.data(), * B = in.b.data();
+        for (unsigned i = 0; i < count; ++i)
+        {
+            GLubyte* p = ptr + i * 3;
+            p[0] = toUByte(R[i], scale);
+            p[1] = toUByte(G[i], scale);
+            p[2] = toUByte(B[i], scale);
+        }
+    }
+
+    // GL_LUMINANCE or GL_RED, 8 bits
+    void writeRowR8(const ImageUtils::PixelWriter* iw, const ImageUtils::PixelRow& in, int s, int t, int r, int m, unsigned count)
+    {
+        GLubyte* ptr = iw->data(s, t, r, 0);
+        const float scale = iw->_normalized ? 255.0f : 1.0f;
+        const float* R = in.r.data();
+        unsigned i = 0;
+
+#ifdef OE_IMAGEUTILS_SSE2
+        const __m128 vscale = _mm_set1_ps(scale);
+        const __m128 vhalf = _mm_set1_ps(0.5f);
+        const __m128 vmin = _mm_setzero_ps();
+        const __m128 vmax = _mm_set1_ps(255.0f);
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i v0 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(R + i), vscale), vhalf), vmin), vmax));
+            __m128i v1 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(R + i + 4), vscale), vhalf), vmin), vmax));
+            __m128i v2 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(R + i + 8), vscale), vhalf), vmin), vmax));
+            __m128i v3 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(R + i + 12), vscale), vhalf), vmin), vmax));
+            __m128i lo = _mm_packs_epi32(v0, v1);
+            __m128i hi = _mm_packs_epi32(v2, v3);
+            _mm_storeu_si128((__m128i*)(ptr + i), _mm_packus_epi16(lo, hi));
+        }
+#endif
+        for (; i < count; ++i)
+            ptr[i] = toUByte(R[i], scale);
+    }
+
+    // GL_LUMINANCE or GL_RED, 32-bit float
+    void writeRowR32F(const ImageUtils::PixelWriter* iw, const ImageUtils::PixelRow& in, int s, int t, int r, int m, unsigned count)
+    {
+        std::memcpy(iw->data(s, t, r, 0), in.r.data(), count * sizeof(float));
+    }
+
+    // GL_LUMINANCE or GL_RED, 16-bit float
+    void writeRowR16F(const ImageUtils::PixelWriter* iw, const ImageUtils::PixelRow& in, int s, int t, int r, int m, unsigned count)
+    {
+        GLushort* ptr = (GLushort*)iw->data(s, t, r, 0);
+        const float* R = in.r.data();
+        for (unsigned i = 0; i < count; ++i)
+            ptr[i] = floatToHalf(R[i]);
+    }
+
+    void writeRowRGBA32F(const ImageUtils::PixelWriter* iw, const ImageUtils::PixelRow& in, int s, int t, int r, int m, unsigned count)
+    {
+        GLfloat* ptr = (GLfloat*)iw->data(s, t, r, 0);
+        const float* R = in.r.data(), * G = in.g.data(), * B = in.b.data(), * A = in.a.data();
+        unsigned i = 0;
+
+#ifdef OE_IMAGEUTILS_SSE2
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 p0 = _mm_loadu_ps(R + i);
+            __m128 p1 = _mm_loadu_ps(G + i);
+            __m128 p2 = _mm_loadu_ps(B + i);
+            __m128 p3 = _mm_loadu_ps(A + i);
+            _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+            _mm_storeu_ps(ptr + i * 4, p0);
+            _mm_storeu_ps(ptr + i * 4 + 4, p1);
+            _mm_storeu_ps(ptr + i * 4 + 8, p2);
+            _mm_storeu_ps(ptr + i * 4 + 12, p3);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            GLfloat* p = ptr + i * 4;
+            p[0] = R[i], p[1] = G[i], p[2] = B[i], p[3] = A[i];
+        }
+    }
+
+    //! Selects a row writer based on the output pixel format and type.
+    inline ImageUtils::PixelWriter::RowWriterFunc
+    getRowWriter(GLenum pixelFormat, GLenum dataType)
+    {
+        const bool single = pixelFormat == GL_LUMINANCE || pixelFormat == GL_RED;
+
+        switch (dataType)
+        {
+        case GL_UNSIGNED_BYTE:
+            if (pixelFormat == GL_RGBA) return &writeRowRGBA8;
+            if (pixelFormat == GL_RGB) return &writeRowRGB8;
+            if (single) return &writeRowR8;
+            break;
+        case GL_FLOAT:
+            if (pixelFormat == GL_RGBA) return &writeRowRGBA32F;
+            if (single) return &writeRowR32F;
+            break;
+        case GL_HALF_FLOAT:
+            if (single) return &writeRowR16F;
+            break;
+        }
+        return &writeRowGeneric;
+    }
+}
+
 ImageUtils::PixelWriter::PixelWriter(osg::Image* image) :
-_image(image)
+_image(image),
+_writeRow(&writeRowGeneric)
 {
     if (image)
     {
@@ -2755,6 +3291,7 @@ _image(image)
             OE_WARN << "[PixelWriter] No writer found for pixel format " << std::hex << _image->getPixelFormat() << std::endl;
             _writer = &ColorWriter<0, GLbyte>::write;
         }
+        _writeRow = getRowWriter(_image->getPixelFormat(), dataType);
     }
 }
 
@@ -2764,15 +3301,31 @@ ImageUtils::PixelWriter::supports( GLenum pixelFormat, GLenum dataType )
     return getWriter(pixelFormat, dataType) != 0L;
 }
 
+void
+ImageUtils::PixelWriter::writeRow(const PixelRow& in, int t, int r, int s, unsigned count, int m)
+{
+    if (!_image)
+        return;
+
+    if (count == 0)
+    {
+        int width = m == 0 ? _image->s() : osg::maximum(_image->s() >> m, 1);
+        count = width > s ? (unsigned)(width - s) : 0u;
+    }
+
+    count = osg::minimum(count, in.size());
+
+    if (count > 0)
+        (m == 0 && _writeRow ? _writeRow : &writeRowGeneric)(this, in, s, t, r, m, count);
+}
+
 void
 ImageUtils::PixelWriter::assign(const osg::Vec4& c)
 {
     if (_image->valid())
     {
         for(int r=0; r<_image->r(); ++r)
-            for(int t=0; t<_image->t(); ++t)
-                for(int s=0; s<_image->s(); ++s)
-                    (*this)(c, s, t, r);
+            assign(c, r);
     }
 }
 
@@ -2781,9 +3334,13 @@ ImageUtils::PixelWriter::assign(const osg::Vec4& c, int layer)
 {
     if (_image->valid())
     {
+        PixelRow row;
+        row.resize(_image->s());
+        for (int s = 0; s < _image->s(); ++s)
+            row.set(s, c);
+
         for(int t=0; t<_image->t(); ++t)
-            for(int s=0; s<_image->s(); ++s)
-                (*this)(c, s, t, layer);
+            writeRow(row, t, layer);
     }
 }
 
@@ -11,7 +11,11 @@
  */
 
 #include <osgEarth/JsonUtils>
+#include <osgEarth/FileUtils>
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 
 #if _MSC_VER >= 1400 // VC++ 8.0
@@ -3510,3 +3514,424 @@ std::ostream& operator<<( std::ostream &sout, const Value &root )
    return sout;
 }
 
+//........................................................................
+
+namespace
+{
+   // Characters that can open or close a nested value
+   struct Structural
+   {
+      bool is[256];
+      Structural()
+      {
+         std::memset(is, 0, sizeof(is));
+         is[(unsigned char)'"'] = is[(unsigned char)'{'] = is[(unsigned char)'}'] = true;
+         is[(unsigned char)'['] = is[(unsigned char)']'] = true;
+      }
+   };
+   const Structural structural;
+
+   inline const char* skipSpaces( const char *p, const char *end )
+   {
+      while ( p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') )
+         ++p;
+      return p;
+   }
+
+   // Position just past the closing quote of the string that starts at p,
+   // or null if it's unterminated.
+   const char* skipString( const char *p, const char *end )
+   {
+      ++p;
+      for ( ;; )
+      {
+         const char *quote = static_cast<const char*>( std::memchr(p, '"', end - p) );
+         if ( !quote )
+            return 0;
+
+         // an odd number of backslashes before it means the quote is escaped
+         const char *b = quote;
+         while ( b > p && b[-1] == '\\' )
+            --b;
+         if ( ((quote - b) & 1) == 0 )
+            return quote + 1;
+
+         p = quote + 1;
+      }
+   }
+
+   // Position just past the value that starts at p, or null if it's malformed.
+   const char* skipValue( const char *p, const char *end )
+   {
+      if ( p >= end )
+         return 0;
+
+      if ( *p == '"' )
+         return skipString( p, end );
+
+      if ( *p == '{' || *p == '[' )
+      {
+         int depth = 0;
+         while ( p < end )
+         {
+            while ( p < end && !structural.is[(unsigned char)*p] )
+               ++p;
+            if ( p == end )
+               break;
+
+            char c = *p;
+            if ( c == '"' )
+            {
+               p = skipString( p, end );
+               if ( !p )
+                  return 0;
+               continue;
+            }
+
+            if ( c == '{' || c == '[' )
+               ++depth;
+            else if ( --depth == 0 )
+               return p + 1;
+            ++p;
+         }
+         return 0;
+      }
+
+      // number, true, false or null
+      const char *start = p;
+      while ( p < end && *p != ',' && *p != '}' && *p != ']' &&
+              *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r' )
+         ++p;
+      return p > start ? p : 0;
+   }
+
+   void appendUTF8( std::string &out, unsigned int cp )
+   {
+      if ( cp < 0x80 )
+         out += (char)cp;
+      else if ( cp < 0x800 )
+      {
+         out += (char)(0xC0 | (cp >> 6));
+         out += (char)(0x80 | (cp & 0x3F));
+      }
+      else if ( cp < 0x10000 )
+      {
+         out += (char)(0xE0 | (cp >> 12));
+         out += (char)(0x80 | ((cp >> 6) & 0x3F));
+         out += (char)(0x80 | (cp & 0x3F));
+      }
+      else
+      {
+         out += (char)(0xF0 | (cp >> 18));
+         out += (char)(0x80 | ((cp >> 12) & 0x3F));
+         out += (char)(0x80 | ((cp >> 6) & 0x3F));
+         out += (char)(0x80 | (cp & 0x3F));
+      }
+   }
+
+   bool readHex4( const char *&p, const char *end, unsigned int &value )
+   {
+      if ( end - p < 4 )
+         return false;
+      value = 0;
+      for ( int i = 0; i < 4; ++i, ++p )
+      {
+         char c = *p;
+         value <<= 4;
+         if ( c >= '0' && c <= '9' ) value += c - '0';
+         else if ( c >= 'a' && c <= 'f' ) value += c - 'a' + 10;
+         else if ( c >= 'A' && c <= 'F' ) value += c - 'A' + 10;
+         else return false;
+      }
+      return true;
+   }
+
+   // Decodes the body of a string (between the quotes)
+   std::string unescape( const char *p, const char *end )
+   {
+      std::string out;
+      out.reserve( end - p );
+      while ( p < end )
+      {
+         const char *slash = static_cast<const char*>( std::memchr(p, '\\', end - p) );
+         if ( !slash )
+         {
+            out.append( p, end );
+            break;
+         }
+         out.append( p, slash );
+         p = slash + 1;
+         if ( p == end )
+            break;
+
+         char c = *p++;
+         switch ( c )
+         {
+         case 'b': out += '\b'; break;
+         case 'f': out += '\f'; break;
+         case 'n': out += '\n'; break;
+         case 'r': out += '\r'; break;
+         case 't': out += '\t'; break;
+         case 'u':
+         {
+            unsigned int cp;
+            if ( !readHex4(p, end, cp) )
+               return out;
+            if ( cp >= 0xD800 && cp <= 0xDBFF && end - p >= 6 && p[0] == '\\' && p[1] == 'u' )
+            {
+               // surrogate pair
+               const char *q = p + 2;
+               unsigned int low;
+               if ( readHex4(q, end, low) && low >= 0xDC00 && low <= 0xDFFF )
+               {
+                  cp = 0x10000 + ((cp & 0x3FF) << 10) + (low & 0x3FF);
+                  p = q;
+               }
+            }
+            appendUTF8( out, cp );
+            break;
+         }
+         default: out += c; break; // quote, backslash, slash
+         }
+      }
+      return out;
+   }
+
+   // Walks the elements of an array or the members of an object. "key" is
+   // the raw key text (without quotes) for object members.
+   template<typename FUNC>
+   bool walk( const char *begin, const char *end, char open, FUNC &&func )
+   {
+      if ( !begin || begin == end || *begin != open )
+         return false;
+
+      const char close = open == '{' ? '}' : ']';
+      const char *p = skipSpaces( begin + 1, end );
+
+      if ( p < end && *p == close )
+         return true;
+
+      while ( p < end )
+      {
+         const char *keyBegin = 0, *keyEnd = 0;
+         if ( open == '{' )
+         {
+            if ( *p != '"' )
+               return false;
+            const char *afterKey = skipString( p, end );
+            if ( !afterKey )
+               return false;
+            keyBegin = p + 1;
+            keyEnd = afterKey - 1;
+            p = skipSpaces( afterKey, end );
+            if ( p == end || *p != ':' )
+               return false;
+            p = skipSpaces( p + 1, end );
+         }
+
+         const char *valueEnd = skipValue( p, end );
+         if ( !valueEnd )
+            return false;
+
+         if ( !func(keyBegin, keyEnd, View(p, valueEnd)) )
+            return true;
+
+         p = skipSpaces( valueEnd, end );
+         if ( p < end && *p == ',' )
+            p = skipSpaces( p + 1, end );
+         else
+            return p < end && *p == close;
+      }
+      return false;
+   }
+}
+
+namespace osgEarth { namespace Util { namespace Json
+{
+   ValueType
+   View::type() const
+   {
+      if ( !valid() )
+         return nullValue;
+
+      switch ( *begin_ )
+      {
+      case '{': return objectValue;
+      case '[': return arrayValue;
+      case '"': return stringValue;
+      case 't':
+      case 'f': return booleanValue;
+      case 'n': return nullValue;
+      default:
+         for ( const char *p = begin_; p < end_; ++p )
+            if ( *p == '.' || *p == 'e' || *p == 'E' )
+               return realValue;
+         return intValue;
+      }
+   }
+
+   View
+   View::operator[]( const char *key ) const
+   {
+      View result;
+      const std::size_t length = std::strlen( key );
+
+      walk( begin_, end_, '{', [&]( const char *keyBegin, const char *keyEnd, const View &value )
+      {
+         bool match;
+         if ( std::memchr(keyBegin, '\\', keyEnd - keyBegin) )
+            match = unescape( keyBegin, keyEnd ) == key;
+         else
+            match = (std::size_t)(keyEnd - keyBegin) == length && std::memcmp( keyBegin, key, length ) == 0;
+
+         if ( match )
+            result = value;
+         return !match;
+      });
+
+      return result;
+   }
+
+   unsigned
+   View::size() const
+   {
+      unsigned count = 0u;
+      if ( isArray() )
+         walk( begin_, end_, '[', [&]( const char*, const char*, const View& ) { ++count; return true; } );
+      else if ( isObject() )
+         walk( begin_, end_, '{', [&]( const char*, const char*, const View& ) { ++count; return true; } );
+      return count;
+   }
+
+   bool
+   View::forEach( const std::function<bool(const View&)> &func ) const
+   {
+      return walk( begin_, end_, '[', [&]( const char*, const char*, const View &value )
+      {
+         return func( value );
+      });
+   }
+
+   bool
+   View::forEachMember( const std::function<bool(const std::string&, const View&)> &func ) const
+   {
+      return walk( begin_, end_, '{', [&]( const char *keyBegin, const char *keyEnd, const View &value )
+      {
+         return func( unescape(keyBegin, keyEnd), value );
+      });
+   }
+
+   std::string
+   View::asString() const
+   {
+      if ( !isString() || end_ - begin_ < 2 )
+         return std::string();
+      return unescape( begin_ + 1, end_ - 1 );
+   }
+
+   double
+   View::asDouble( double fallback ) const
+   {
+      if ( !isNumeric() )
+         return fallback;
+
+      // numbers are short; copy one out so strtod stops at the end of the view
+      char buf[64];
+      std::size_t length = std::min( (std::size_t)(end_ - begin_), sizeof(buf) - 1 );
+      std::memcpy( buf, begin_, length );
+      buf[length] = 0;
+
+      char *stop;
+      double value = std::strtod( buf, &stop );
+      return stop != buf ? value : fallback;
+   }
+
+   long long
+   View::asInt( long long fallback ) const
+   {
+      if ( type() == intValue )
+      {
+         char buf[32];
+         std::size_t length = std::min( (std::size_t)(end_ - begin_), sizeof(buf) - 1 );
+         std::memcpy( buf, begin_, length );
+         buf[length] = 0;
+
+         char *stop;
+         long long value = std::strtoll( buf, &stop, 10 );
+         return stop != buf ? value : fallback;
+      }
+      return isNumeric() ? (long long)asDouble( (double)fallback ) : fallback;
+   }
+
+   bool
+   View::asBool( bool fallback ) const
+   {
+      if ( isBool() )
+         return *begin_ == 't';
+      if ( isNumeric() )
+         return asDouble() != 0.0;
+      return fallback;
+   }
+
+   bool
+   View::materialize( Value &value ) const
+   {
+      if ( !valid() )
+         return false;
+      Reader reader;
+      return reader.parse( begin_, end_, value, false );
+   }
+
+   //........................................................................
+
+   Document::Document() :
+      mapping_( 0 )
+   {
+      //nop
+   }
+
+   Document::~Document()
+   {
+      delete static_cast<MappedFile*>( mapping_ );
+   }
+
+   bool
+   Document::open( const std::string &path )
+   {
+      text_.clear();
+      delete static_cast<MappedFile*>( mapping_ );
+
+      MappedFile *file = new MappedFile();
+      mapping_ = file;
+
+      if ( !file->open(path) || !file->data() )
+      {
+         root_ = View();
+         return false;
+      }
+
+      return setText( file->data(), file->data() + file->size() );
+   }
+
+   bool
+   Document::load( std::string text )
+   {
+      delete static_cast<MappedFile*>( mapping_ );
+      mapping_ = 0;
+      text_ = std::move( text );
+      return setText( text_.data(), text_.data() + text_.size() );
+   }
+
+   bool
+   Document::setText( const char *begin, const char *end )
+   {
+      // skip a UTF-8 byte order mark
+      if ( end - begin >= 3 && std::memcmp(begin, "\xEF\xBB\xBF", 3) == 0 )
+         begin += 3;
+
+      begin = skipSpaces( begin, end );
+      const char *valueEnd = skipValue( begin, end );
+      root_ = valueEnd ? View( begin, valueEnd ) : View();
+      return root_.valid();
+   }
+} } }
@@ -9,6 +9,7 @@
 #include <osgDB/FileUtils>
 #include <osgEarth/GDAL>
 #include <sstream>
+#include <thread>
 #include <sqlite3.h>
 
 using namespace osgEarth;
@@ -48,6 +49,10 @@ MBTiles::Options::writeTo(Config& conf) const
     conf.set("filename", _url);
     conf.set("format", _format);
     conf.set("compress", _compress);
+    conf.set("read_connections", _readConnections);
+    conf.set("mmap_size_mb", _mmapSize);
+    conf.set("immutable", _immutable);
+    conf.set("write_batch_size", _writeBatchSize);
 }
 
 void
@@ -55,11 +60,19 @@ MBTiles::Options::readFrom(const Config& conf)
 {
     format().init("png");
     compress().init(false);
+    readConnections().init(0u);
+    mmapSize().init(0u);
+    immutable().init(false);
+    writeBatchSize().init(1u);
 
     conf.get("filename", _url);
     conf.get("url", _url); // compat for consistency with other drivers
     conf.get("format", _format);
     conf.get("compress", _compress);
+    conf.get("read_connections", _readConnections);
+    conf.get("mmap_size_mb", _mmapSize);
+    conf.get("immutable", _immutable);
+    conf.get("write_batch_size", _writeBatchSize);
 }
 
 //...................................................................
@@ -316,11 +329,57 @@ bool MBTilesElevationLayer::putMetaData(const std::string& name, const std::stri
 #undef LC
 #define LC "[MBTiles] \"" << _name << "\" "
 
+// A read-only database connection with its own prepared tile query.
+struct MBTiles::Driver::ReadConnection
+{
+    sqlite3* database = nullptr;
+    sqlite3_stmt* selectTile = nullptr;
+
+    ~ReadConnection()
+    {
+        if (selectTile)
+            sqlite3_finalize(selectTile);
+        if (database)
+            sqlite3_close_v2(database);
+    }
+};
+
+namespace
+{
+    const char* SELECT_TILE_SQL = "SELECT tile_data from tiles where zoom_level = ? AND tile_column = ? AND tile_row = ?";
+    const char* INSERT_TILE_SQL = "INSERT OR REPLACE INTO tiles (zoom_level, tile_column, tile_row, tile_data) VALUES (?, ?, ?, ?)";
+
+    // SQLite URI filename for a local path (needed for the immutable flag)
+    std::string toSQLiteURI(const std::string& path)
+    {
+        std::string uri = "file:";
+        for (char c : path)
+        {
+            if (c == '\\') uri += '/';
+            else if (c == '%') uri += "%25";
+            else if (c == '?') uri += "%3f";
+            else if (c == '#') uri += "%23";
+            else uri += c;
+        }
+        return uri;
+    }
+}
+
 MBTiles::Driver::Driver() :
     _minLevel(0),
     _maxLevel(19),
     _forceRGB(false),
-    _database(nullptr)
+    _database(nullptr),
+    _selectTileStmt(nullptr),
+    _insertTileStmt(nullptr),
+    _writeBatchSize(1u),
+    _pendingWrites(0u),
+    _readOnly(false),
+    _immutable(false),
+    _mmapSizeMB(0u),
+    _maxReadConnections(1u),
+    _numReadConnections(0u),
+    _closingReadConnections(false)
 {
     //nop
 }
@@ -333,6 +392,40 @@ Driver::~Driver()
 void
 MBTiles::Driver::closeDatabase()
 {
+    // commit anything left in the current write batch
+    flush();
+
+    {
+        std::unique_lock<std::mutex> lock(_readConnectionsMutex);
+
+        // refuse new checkouts, and wait for readers to return the
+        // connections they hold before closing them.
+        _closingReadConnections = true;
+        _readConnectionAvailable.notify_all();
+        while (_idleReadConnections.size() < _numReadConnections)
+        {
+            _readConnectionAvailable.wait(lock);
+        }
+
+        for (auto conn : _idleReadConnections)
+            delete conn;
+        _idleReadConnections.clear();
+        _numReadConnections = 0u;
+        _closingReadConnections = false;
+    }
+
+    if (_selectTileStmt != nullptr)
+    {
+        sqlite3_finalize((sqlite3_stmt*)_selectTileStmt);
+        _selectTileStmt = nullptr;
+    }
+
+    if (_insertTileStmt != nullptr)
+    {
+        sqlite3_finalize((sqlite3_stmt*)_insertTileStmt);
+        _insertTileStmt = nullptr;
+    }
+
     if (_database != nullptr)
     {
         sqlite3* database = (sqlite3*)_database;
@@ -341,6 +434,123 @@ MBTiles::Driver::closeDatabase()
     }
 }
 
+Status
+MBTiles::Driver::flush()
+{
+    std::lock_guard<std::mutex> exclusiveLock(_mutex);
+
+    if (_pendingWrites > 0u && _database != nullptr)
+    {
+        _pendingWrites = 0u;
+
+        return commitWriteBatch();
+    }
+    return Status::NoError;
+}
+
+Status
+MBTiles::Driver::commitWriteBatch()
+{
+    sqlite3* database = (sqlite3*)_database;
+
+    char* errorMsg = nullptr;
+    if (SQLITE_OK != sqlite3_exec(database, "COMMIT", 0L, 0L, &errorMsg))
+    {
+        Status status(Status::GeneralError, Stringify()
+            << "Failed to commit write batch; the batch was discarded: " << (errorMsg ? errorMsg : ""));
+        sqlite3_free(errorMsg);
+
+        // a failed COMMIT leaves the transaction open; end it so later
+        // batches start clean.
+        if (!sqlite3_get_autocommit(database))
+        {
+            sqlite3_exec(database, "ROLLBACK", 0L, 0L, 0L);
+        }
+
+        OE_WARN << LC << status.message() << std::endl;
+        return status;
+    }
+    return Status::NoError;
+}
+
+MBTiles::Driver::ReadConnection*
+MBTiles::Driver::acquireReadConnection() const
+{
+    std::unique_lock<std::mutex> lock(_readConnectionsMutex);
+
+    while (!_closingReadConnections && _idleReadConnections.empty() && _numReadConnections >= _maxReadConnections)
+    {
+        _readConnectionAvailable.wait(lock);
+    }
+
+    if (_closingReadConnections)
+    {
+        return nullptr;
+    }
+
+    if (!_idleReadConnections.empty())
+    {
+        ReadConnection* conn = _idleReadConnections.back();
+        _idleReadConnections.pop_back();
+        return conn;
+    }
+
+    // open a new connection; reserve the slot first so we can drop the lock
+    ++_numReadConnections;
+    lock.unlock();
+
+    ReadConnection* conn = new ReadConnection();
+
+    int rc;
+    if (_immutable)
+    {
+        rc = sqlite3_open_v2(
+            (toSQLiteURI(_filename) + "?immutable=1").c_str(), &conn->database,
+            SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_URI, 0L);
+    }
+    else
+    {
+        rc = sqlite3_open_v2(
+            _filename.c_str(), &conn->database,
+            SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, 0L);
+    }
+
+    if (rc == SQLITE_OK && _mmapSizeMB > 0u)
+    {
+        std::string pragma = Stringify() << "PRAGMA mmap_size=" << ((sqlite3_int64)_mmapSizeMB * 1048576);
+        sqlite3_exec(conn->database, pragma.c_str(), 0L, 0L, 0L);
+    }
+
+    if (rc == SQLITE_OK)
+    {
+        rc = sqlite3_prepare_v2(conn->database, SELECT_TILE_SQL, -1, &conn->selectTile, 0L);
+    }
+
+    if (rc != SQLITE_OK)
+    {
+        OE_WARN << LC << "Failed to open read connection: " << sqlite3_errmsg(conn->database) << std::endl;
+        delete conn;
+
+        lock.lock();
+        --_numReadConnections;
+        _readConnectionAvailable.notify_all();
+        return nullptr;
+    }
+
+    return conn;
+}
+
+void
+MBTiles::Driver::releaseReadConnection(ReadConnection* conn) const
+{
+    {
+        std::lock_guard<std::mutex> lock(_readConnectionsMutex);
+        _idleReadConnections.push_back(conn);
+    }
+    // notify all, since closeDatabase() may be waiting along with readers
+    _readConnectionAvailable.notify_all();
+}
+
 Status
 MBTiles::Driver::open(
     const std::string& name,
@@ -407,6 +617,19 @@ MBTiles::Driver::open(
             << "Database \"" << fullFilename << "\": " << sqlite3_errmsg(database));
     }
 
+    _filename = fullFilename;
+    _readOnly = !readWrite;
+    _immutable = options.immutable().get();
+    _mmapSizeMB = options.mmapSize().get();
+    _writeBatchSize = std::max(1u, options.writeBatchSize().get());
+    _pendingWrites = 0u;
+
+    // In read-only mode, tile reads go through a pool of connections so
+    // concurrent loads don't serialize on the primary connection.
+    _maxReadConnections = options.readConnections().get();
+    if (_maxReadConnections == 0u)
+        _maxReadConnections = std::max(1u, std::thread::hardware_concurrency());
+
     // New database setup:
     if (isNewDatabase)
     {
@@ -634,14 +857,43 @@ MBTiles::Driver::readMaxLevel()
     return result;
 }
 
+bool
+MBTiles::Driver::readTileData(void* database_, void* stmt, int z, int x, int y, std::string& out) const
+{
+    sqlite3* database = (sqlite3*)database_;
+    sqlite3_stmt* select = (sqlite3_stmt*)stmt;
+
+    sqlite3_bind_int( select, 1, z );
+    sqlite3_bind_int( select, 2, x );
+    sqlite3_bind_int( select, 3, y );
+
+    bool found = false;
+    int rc = sqlite3_step( select );
+    if ( rc == SQLITE_ROW)
+    {
+        // the pointer returned from _blob gets freed internally by sqlite, supposedly
+        const char* data = (const char*)sqlite3_column_blob( select, 0 );
+        int dataLen = sqlite3_column_bytes( select, 0 );
+        out.assign( data, dataLen );
+        found = true;
+    }
+    else if (rc != SQLITE_DONE)
+    {
+        OE_DEBUG << LC << "SQL QUERY failed for " << SELECT_TILE_SQL << ": " << sqlite3_errmsg(database) << std::endl;
+    }
+
+    // keep the statement for the next read
+    sqlite3_reset( select );
+
+    return found;
+}
+
 ReadResult
 MBTiles::Driver::read(
     const TileKey& key,
     ProgressCallback* progress,
     const osgDB::Options* readOptions) const
 {
-    std::lock_guard<std::mutex> exclusiveLock(_mutex);
-
     int z = key.getLevelOfDetail();
     int x = key.getTileX();
     int y = key.getTileY();
@@ -661,73 +913,146 @@ MBTiles::Driver::read(
     key.getProfile()->getNumTiles(key.getLevelOfDetail(), numCols, numRows);
     y  = numRows - y - 1;
 
-    sqlite3* database = (sqlite3*)_database;
+    std::string dataBuffer;
+    bool valid = false;
 
-    //Get the image
-    sqlite3_stmt* select = NULL;
-    std::string query = "SELECT tile_data from tiles where zoom_level = ? AND tile_column = ? AND tile_row = ?";
-    int rc = sqlite3_prepare_v2( database, query.c_str(), -1, &select, 0L );
-    if ( rc != SQLITE_OK )
+    if (_readOnly)
     {
-        OE_WARN << LC << "Failed to prepare SQL: " << query << "; " << sqlite3_errmsg(database) << std::endl;
-        return ReadResult::RESULT_READER_ERROR;
-    }
-
-    bool valid = true;
+        ReadConnection* conn = acquireReadConnection();
+        if (!conn)
+        {
+            return ReadResult::RESULT_READER_ERROR;
+        }
 
-    sqlite3_bind_int( select, 1, z );
-    sqlite3_bind_int( select, 2, x );
-    sqlite3_bind_int( select, 3, y );
+        valid = readTileData(conn->database, conn->selectTile, z, x, y, dataBuffer);
 
-    osg::Image* result = NULL;
-    rc = sqlite3_step( select );
-    if ( rc == SQLITE_ROW)
+        releaseReadConnection(conn);
+    }
+    else
     {
-        // the pointer returned from _blob gets freed internally by sqlite, supposedly
-        const char* data = (const char*)sqlite3_column_blob( select, 0 );
-        int dataLen = sqlite3_column_bytes( select, 0 );
+        std::lock_guard<std::mutex> exclusiveLock(_mutex);
 
-        std::string dataBuffer( data, dataLen );
+        sqlite3* database = (sqlite3*)_database;
 
-        // decompress if necessary:
-        if ( _compressor.valid() )
+        if (_selectTileStmt == nullptr)
         {
-            std::istringstream inputStream(dataBuffer);
-            std::string value;
-            if ( !_compressor->decompress(inputStream, value) )
-            {
-                OE_WARN << LC << "Decompression failed" << std::endl;
-                valid = false;
-            }
-            else
+            sqlite3_stmt* select = NULL;
+            int rc = sqlite3_prepare_v2( database, SELECT_TILE_SQL, -1, &select, 0L );
+            if ( rc != SQLITE_OK )
             {
-                dataBuffer = value;
+                OE_WARN << LC << "Failed to prepare SQL: " << SELECT_TILE_SQL << "; " << sqlite3_errmsg(database) << std::endl;
+                return ReadResult::RESULT_READER_ERROR;
             }
+            _selectTileStmt = select;
         }
 
-        // decode the raw image data:
-        if ( valid )
+        valid = readTileData(database, _selectTileStmt, z, x, y, dataBuffer);
+    }
+
+    // decompress and decode outside of any lock:
+    osg::Image* result = NULL;
+
+    // decompress if necessary:
+    if ( valid && _compressor.valid() )
+    {
+        std::istringstream inputStream(dataBuffer);
+        std::string value;
+        if ( !_compressor->decompress(inputStream, value) )
         {
-            std::istringstream inputStream(dataBuffer);
-            result = ImageUtils::readStream(inputStream, _dbOptions.get());
-            // If we couldn't load the image automatically try the reader instead.
-            if (!result && _rw.valid())
-            {
-                result = _rw->readImage(inputStream, _dbOptions.get()).takeImage();
-            }
+            OE_WARN << LC << "Decompression failed" << std::endl;
+            valid = false;
+        }
+        else
+        {
+            dataBuffer = value;
         }
     }
-    else
+
+    // decode the raw image data:
+    if ( valid )
     {
-        OE_DEBUG << LC << "SQL QUERY failed for " << query << ": " << std::endl;
-        valid = false;
+        std::istringstream inputStream(dataBuffer);
+        result = ImageUtils::readStream(inputStream, _dbOptions.get());
+        // If we couldn't load the image automatically try the reader instead.
+        if (!result && _rw.valid())
+        {
+            result = _rw->readImage(inputStream, _dbOptions.get()).takeImage();
+        }
     }
 
-    sqlite3_finalize( select );
-
     return ReadResult(result);
 }
 
+Status
+MBTiles::Driver::insertTile(int z, int x, int y, const void* data, unsigned data_size)
+{
+    sqlite3* database = (sqlite3*)_database;
+
+    // Prep the insert statement once and reuse it:
+    if (_insertTileStmt == nullptr)
+    {
+        sqlite3_stmt* insert = NULL;
+        int rc = sqlite3_prepare_v2(database, INSERT_TILE_SQL, -1, &insert, 0L);
+        if (rc != SQLITE_OK)
+        {
+            return Status(Status::GeneralError, Stringify()
+                << "Failed to prepare SQL: " << INSERT_TILE_SQL << "; " << sqlite3_errmsg(database));
+        }
+        _insertTileStmt = insert;
+    }
+
+    sqlite3_stmt* insert = (sqlite3_stmt*)_insertTileStmt;
+
+    // open a new transaction at the start of each write batch
+    if (_writeBatchSize > 1u && _pendingWrites == 0u)
+    {
+        char* errorMsg = nullptr;
+        if (SQLITE_OK != sqlite3_exec(database, "BEGIN", 0L, 0L, &errorMsg))
+        {
+            Status status(Status::GeneralError, Stringify() << "Failed to begin write batch: " << (errorMsg ? errorMsg : ""));
+            sqlite3_free(errorMsg);
+            return status;
+        }
+    }
+
+    // bind parameters:
+    sqlite3_bind_int(insert, 1, z);
+    sqlite3_bind_int(insert, 2, x);
+    sqlite3_bind_int(insert, 3, y);
+
+    // bind the data blob:
+    sqlite3_bind_blob(insert, 4, data, data_size, SQLITE_STATIC);
+
+    // run the sql.
+    int rc;
+    int tries = 0;
+    do {
+        rc = sqlite3_step(insert);
+    } while (++tries < 100 && (rc == SQLITE_BUSY || rc == SQLITE_LOCKED));
+
+    Status status = Status::NoError;
+    if (SQLITE_OK != rc && SQLITE_DONE != rc)
+    {
+#if SQLITE_VERSION_NUMBER >= 3007015
+        status = Status(Status::GeneralError, Stringify()<<"Failed query: " << INSERT_TILE_SQL << "(" << rc << ")" << sqlite3_errstr(rc) << "; " << sqlite3_errmsg(database));
+#else
+        status = Status(Status::GeneralError, Stringify()<< "Failed query: " << INSERT_TILE_SQL << "(" << rc << ")" << rc << "; " << sqlite3_errmsg(database));
+#endif
+    }
+
+    sqlite3_reset(insert);
+    sqlite3_clear_bindings(insert);
+
+    if (_writeBatchSize > 1u && ++_pendingWrites >= _writeBatchSize)
+    {
+        _pendingWrites = 0u;
+        Status commitStatus = commitWriteBatch();
+        if (commitStatus.isError())
+            return commitStatus;
+    }
+
+    return status;
+}
 
 Status
 MBTiles::Driver::write(const TileKey& key, const osg::Image* image, ProgressCallback* progress)
@@ -795,45 +1120,12 @@ MBTiles::Driver::write(const TileKey& key, const osg::Image* image, ProgressCall
     key.getProfile()->getNumTiles(key.getLevelOfDetail(), numCols, numRows);
     y = numRows - y - 1;
 
-    sqlite3* database = (sqlite3*)_database;
-
-    // Prep the insert statement:
-    sqlite3_stmt* insert = NULL;
-    std::string query = "INSERT OR REPLACE INTO tiles (zoom_level, tile_column, tile_row, tile_data) VALUES (?, ?, ?, ?)";
-    int rc = sqlite3_prepare_v2(database, query.c_str(), -1, &insert, 0L);
-    if (rc != SQLITE_OK)
-    {
-        return Status(Status::GeneralError, Stringify()
-            << "Failed to prepare SQL: " << query << "; " << sqlite3_errmsg(database));
-    }
-
-    // bind parameters:
-    sqlite3_bind_int(insert, 1, z);
-    sqlite3_bind_int(insert, 2, x);
-    sqlite3_bind_int(insert, 3, y);
-
-    // bind the data blob:
-    sqlite3_bind_blob(insert, 4, data, data_size, SQLITE_STATIC);
-
-    // run the sql.
-    bool ok = true;
-    int tries = 0;
-    do {
-        rc = sqlite3_step(insert);
-    } while (++tries < 100 && (rc == SQLITE_BUSY || rc == SQLITE_LOCKED));
-
-    if (SQLITE_OK != rc && SQLITE_DONE != rc)
+    Status status = insertTile(z, x, y, data, data_size);
+    if (status.isError())
     {
-#if SQLITE_VERSION_NUMBER >= 3007015
-        return Status(Status::GeneralError, Stringify()<<"Failed query: " << query << "(" << rc << ")" << sqlite3_errstr(rc) << "; " << sqlite3_errmsg(database));
-#else
-        return Status(Status::GeneralError, Stringify()<< "Failed query: " << query << "(" << rc << ")" << rc << "; " << sqlite3_errmsg(database));
-#endif
-        ok = false;
+        return status;
     }
 
-    sqlite3_finalize(insert);
-
     // adjust the max level if necessary
     if (key.getLOD() > _maxLevel)
     {
@@ -853,8 +1145,6 @@ MBTiles::Driver::write(const TileKey& key, const osg::HeightField* hf, ProgressC
     if (!key.valid() || !hf)
         return Status::AssertionFailure;
 
-    std::lock_guard<std::mutex> exclusiveLock(_mutex);
-
     std::string value = GDAL::heightFieldToTiff(hf);
 
     // compress if necessary:
@@ -868,6 +1158,8 @@ MBTiles::Driver::write(const TileKey& key, const osg::HeightField* hf, ProgressC
         value = output.str();
     }
 
+    std::lock_guard<std::mutex> exclusiveLock(_mutex);
+
     int z = key.getLOD();
     int x = key.getTileX();
     int y = key.getTileY();
@@ -877,45 +1169,12 @@ MBTiles::Driver::write(const TileKey& key, const osg::HeightField* hf, ProgressC
     key.getProfile()->getNumTiles(key.getLevelOfDetail(), numCols, numRows);
     y = numRows - y - 1;
 
-    sqlite3* database = (sqlite3*)_database;
-
-    // Prep the insert statement:
-    sqlite3_stmt* insert = NULL;
-    std::string query = "INSERT OR REPLACE INTO tiles (zoom_level, tile_column, tile_row, tile_data) VALUES (?, ?, ?, ?)";
-    int rc = sqlite3_prepare_v2(database, query.c_str(), -1, &insert, 0L);
-    if (rc != SQLITE_OK)
-    {
-        return Status(Status::GeneralError, Stringify()
-            << "Failed to prepare SQL: " << query << "; " << sqlite3_errmsg(database));
-    }
-
-    // bind parameters:
-    sqlite3_bind_int(insert, 1, z);
-    sqlite3_bind_int(insert, 2, x);
-    sqlite3_bind_int(insert, 3, y);
-
-    // bind the data blob:
-    sqlite3_bind_blob(insert, 4, value.c_str(), value.length(), SQLITE_STATIC);
-
-    // run the sql.
-    bool ok = true;
-    int tries = 0;
-    do {
-        rc = sqlite3_step(insert);
-    } while (++tries < 100 && (rc == SQLITE_BUSY || rc == SQLITE_LOCKED));
-
-    if (SQLITE_OK != rc && SQLITE_DONE != rc)
+    Status status = insertTile(z, x, y, value.c_str(), value.length());
+    if (status.isError())
     {
-#if SQLITE_VERSION_NUMBER >= 3007015
-        return Status(Status::GeneralError, Stringify() << "Failed query: " << query << "(" << rc << ")" << sqlite3_errstr(rc) << "; " << sqlite3_errmsg(database));
-#else
-        return Status(Status::GeneralError, Stringify() << "Failed query: " << query << "(" << rc << ")" << rc << "; " << sqlite3_errmsg(database));
-#endif
-        ok = false;
+        return status;
     }
 
-    sqlite3_finalize(insert);
-
     // adjust the max level if necessary
     if (key.getLOD() > _maxLevel)
     {
@@ -10,9 +10,11 @@
 #include <osgEarth/GeoData>
 #include <osgEarth/FeatureSource>
 #include <osgDB/Registry>
-#include "vector_tile.pb.h"
 
 #include <sqlite3.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 
 using namespace osgEarth;
 using namespace osgEarth::MVT;
@@ -26,14 +28,7 @@ using namespace osgEarth::MVT;
 
 namespace osgEarth { namespace MVT
 {
-    // https://github.com/mapbox/mapnik-vector-tile/blob/master/examples/c%2B%2B/tileinfo.cpp
-    enum CommandType {
-        SEG_END    = 0,
-        SEG_MOVETO = 1,
-        SEG_LINETO = 2,
-        SEG_CLOSE = (0x40 | 0x0f)
-    };
-
+    // https://github.com/mapbox/vector-tile-spec/tree/master/2.1
     enum eGeomType {
         Unknown = 0,
         Point = 1,
@@ -41,137 +36,338 @@ namespace osgEarth { namespace MVT
         Polygon = 3
     };
 
-    int zig_zag_decode(int n)
-    {
-        return (n >> 1) ^ (-(n & 1));
-    }
+    // Field numbers from the vector tile schema (vector_tile.proto)
+    enum {
+        TILE_LAYERS = 3,
+        LAYER_NAME = 1, LAYER_FEATURES = 2, LAYER_KEYS = 3, LAYER_VALUES = 4, LAYER_EXTENT = 5,
+        FEATURE_ID = 1, FEATURE_TAGS = 2, FEATURE_TYPE = 3, FEATURE_GEOMETRY = 4,
+        VALUE_STRING = 1, VALUE_FLOAT = 2, VALUE_DOUBLE = 3, VALUE_INT = 4, VALUE_UINT = 5, VALUE_SINT = 6, VALUE_BOOL = 7
+    };
 
-    Geometry* decodeLine(const mapnik::vector::tile_feature& feature, const TileKey& key, unsigned int tileres)
+    /**
+     * Minimal protobuf wire format reader that walks a buffer in place.
+     * Length-delimited fields come back as readers over the same bytes,
+     * so nothing is copied or allocated until a value is actually used.
+     * Malformed input puts the reader in an error state and ends it.
+     */
+    class PbfReader
     {
-        unsigned int length = 0;
-        int cmd = -1;
-        const int cmd_bits = 3;
+    public:
+        enum WireType { WIRE_VARINT = 0, WIRE_FIXED64 = 1, WIRE_LENGTH = 2, WIRE_FIXED32 = 5 };
 
-        int x = 0;
-        int y = 0;
+        PbfReader() = default;
+        PbfReader(const char* data, std::size_t size) : _p(data), _end(data + size) { }
 
-        std::vector< osg::ref_ptr< osgEarth::LineString > > lines;
-        osg::ref_ptr< osgEarth::LineString > currentLine;
+        //! Advance to the next field. False at the end of the buffer or on error.
+        bool next()
+        {
+            if (_p >= _end || _error)
+                return false;
+
+            std::uint64_t key = varint();
+            _field = (std::uint32_t)(key >> 3);
+            _wire = (std::uint32_t)(key & 0x7);
+            if (_field == 0u)
+                fail();
+            return !_error;
+        }
 
-        GeoExtent extent = key.getExtent();
+        std::uint32_t field() const { return _field; }
+        std::uint32_t wire() const { return _wire; }
+        bool ok() const { return !_error; }
+        bool eof() const { return _p >= _end; }
+        const char* data() const { return _p; }
+        std::size_t size() const { return (std::size_t)(_end - _p); }
 
-        for (int k = 0; k < feature.geometry_size();)
+        std::uint64_t varint()
         {
-            if (!length)
+            std::uint64_t result = 0u;
+            for (unsigned shift = 0u; shift < 64u && _p < _end; shift += 7u)
             {
-                unsigned int cmd_length = feature.geometry(k++);
-                cmd = cmd_length & ((1 << cmd_bits) - 1);
-                length = cmd_length >> cmd_bits;
+                std::uint8_t b = (std::uint8_t)*_p++;
+                result |= (std::uint64_t)(b & 0x7f) << shift;
+                if ((b & 0x80) == 0)
+                    return result;
             }
-            if (length > 0)
+            fail();
+            return 0u;
+        }
+
+        std::int64_t svarint()
+        {
+            std::uint64_t n = varint();
+            return (std::int64_t)((n >> 1) ^ (0u - (n & 1u)));
+        }
+
+        template<typename T>
+        T fixed()
+        {
+            T value = T();
+            if (size() < sizeof(T))
             {
-                length--;
+                fail();
+                return value;
+            }
+            std::memcpy(&value, _p, sizeof(T)); // wire format is little-endian
+            _p += sizeof(T);
+            return value;
+        }
 
-                if (cmd == SEG_MOVETO || cmd == SEG_LINETO)
-                {
-                    if (cmd == SEG_MOVETO)
-                    {
-                        currentLine = new osgEarth::LineString;
-                        lines.push_back( currentLine.get() );
-                    }
-                    int px = feature.geometry(k++);
-                    int py = feature.geometry(k++);
-                    px = zig_zag_decode(px);
-                    py = zig_zag_decode(py);
+        //! Reader over a length-delimited field (message, string, or packed array)
+        PbfReader message()
+        {
+            std::uint64_t length = varint();
+            if (_error || length > size())
+            {
+                fail();
+                return PbfReader();
+            }
+            PbfReader sub(_p, (std::size_t)length);
+            _p += length;
+            return sub;
+        }
+
+        //! Skip the value of the current field
+        void skip()
+        {
+            switch (_wire)
+            {
+            case WIRE_VARINT:  varint(); break;
+            case WIRE_FIXED64: fixed<std::uint64_t>(); break;
+            case WIRE_LENGTH:  message(); break;
+            case WIRE_FIXED32: fixed<std::uint32_t>(); break;
+            default:           fail(); break;
+            }
+        }
 
-                    x += px;
-                    y += py;
+    private:
+        const char* _p = nullptr;
+        const char* _end = nullptr;
+        std::uint32_t _field = 0u;
+        std::uint32_t _wire = 0u;
+        bool _error = false;
 
-                    double width = extent.width();
-                    double height = extent.height();
+        void fail()
+        {
+            _error = true;
+            _p = _end;
+        }
+    };
 
-                    double geoX = extent.xMin() + (width/(double)tileres) * (double)x;
-                    double geoY = extent.yMax() - (height/(double)tileres) * (double)y;
+    inline int zig_zag_decode(std::uint32_t n)
+    {
+        return (int)((n >> 1) ^ (0u - (n & 1u)));
+    }
 
-                    if (currentLine.valid())
-                    {
-                        currentLine->push_back(geoX, geoY, 0);
-                    }
-                }
+    // A tag value. Strings point into the tile buffer.
+    struct Value
+    {
+        enum Type { NONE, STRING, DOUBLE, INTEGER, BOOL } type = NONE;
+        const char* str = nullptr;
+        std::size_t length = 0u;
+        double d = 0.0;
+        long long i = 0;
+        bool b = false;
+    };
+
+    Value decodeValue(PbfReader reader)
+    {
+        Value value;
+        while (reader.next())
+        {
+            switch (reader.field())
+            {
+            case VALUE_STRING: {
+                PbfReader s = reader.message();
+                value.type = Value::STRING, value.str = s.data(), value.length = s.size();
+                break; }
+            case VALUE_FLOAT:
+                value.type = Value::DOUBLE, value.d = (double)reader.fixed<float>();
+                break;
+            case VALUE_DOUBLE:
+                value.type = Value::DOUBLE, value.d = reader.fixed<double>();
+                break;
+            case VALUE_INT:
+            case VALUE_UINT:
+                value.type = Value::INTEGER, value.i = (long long)reader.varint();
+                break;
+            case VALUE_SINT:
+                value.type = Value::INTEGER, value.i = (long long)reader.svarint();
+                break;
+            case VALUE_BOOL:
+                value.type = Value::BOOL, value.b = reader.varint() != 0u;
+                break;
+            default:
+                reader.skip();
             }
         }
+        return value;
+    }
 
-        currentLine = 0;
+    // The parts of a layer we need, as views into the tile buffer. The
+    // encoder may write the features before the keys and values, so we
+    // scan the whole layer before decoding any feature.
+    struct LayerView
+    {
+        std::string name;
+        unsigned extent = 4096u;
+        std::vector<PbfReader> features;
+        std::vector<PbfReader> keys;
+        std::vector<PbfReader> values;
+    };
 
-        if (lines.size() == 0)
+    bool scanLayer(PbfReader reader, const std::vector<std::string>& layers_to_include, LayerView& layer)
+    {
+        layer.features.clear();
+        layer.keys.clear();
+        layer.values.clear();
+        layer.extent = 4096u;
+
+        // Find the name first, so layers we don't want are never indexed
+        PbfReader nameScan = reader;
+        while (nameScan.next())
         {
-            return 0;
+            if (nameScan.field() == LAYER_NAME)
+            {
+                PbfReader s = nameScan.message();
+                layer.name.assign(s.data(), s.size());
+                break;
+            }
+            nameScan.skip();
         }
-        else if (lines.size() == 1)
+
+        if (!layers_to_include.empty() &&
+            std::find(layers_to_include.begin(), layers_to_include.end(), layer.name) == layers_to_include.end())
         {
-            // Just return a simple LineString
-            return lines[0].release();
+            return false;
         }
-        else
+
+        while (reader.next())
         {
-            // Return a multilinestring
-            MultiGeometry* multi = new MultiGeometry;
-            for (unsigned int i = 0; i < lines.size(); i++)
+            switch (reader.field())
             {
-                multi->add(lines[i].get());
+            case LAYER_FEATURES: layer.features.push_back(reader.message()); break;
+            case LAYER_KEYS:     layer.keys.push_back(reader.message()); break;
+            case LAYER_VALUES:   layer.values.push_back(reader.message()); break;
+            case LAYER_EXTENT:   layer.extent = (unsigned)reader.varint(); break;
+            default:             reader.skip();
             }
-            return multi;
         }
+
+        return reader.ok() && layer.extent > 0u;
     }
 
-    Geometry* decodePoint(const mapnik::vector::tile_feature& feature, const TileKey& key, unsigned int tileres)
+    // Command stream decoded into tile-wide scratch buffers. Every path
+    // is a run of points in "points" that begins with a MoveTo.
+    struct Path
     {
-        unsigned int length = 0;
-        int cmd = -1;
-        const int cmd_bits = 3;
+        unsigned first;
+        unsigned count;
+        bool closed;
+    };
 
-        int x = 0;
-        int y = 0;
+    struct GeometryBuffer
+    {
+        std::vector<osg::Vec3d> points;
+        std::vector<Path> paths;
+    };
 
-        osgEarth::PointSet *geometry = new osgEarth::PointSet();
+    bool decodeCommands(
+        PbfReader commands, const GeoExtent& extent, unsigned tileres, GeometryBuffer& buffer)
+    {
+        buffer.points.clear();
+        buffer.paths.clear();
+
+        // a coordinate takes at least two bytes:
+        buffer.points.reserve(commands.size() / 2u);
 
-        GeoExtent extent = key.getExtent();
+        const double sx = extent.width() / (double)tileres;
+        const double sy = extent.height() / (double)tileres;
+        int x = 0, y = 0;
 
-        for (int k = 0; k < feature.geometry_size();)
+        while (!commands.eof())
         {
-            if (!length)
-            {
-                unsigned int cmd_length = feature.geometry(k++);
-                cmd = cmd_length & ((1 << cmd_bits) - 1);
-                length = cmd_length >> cmd_bits;
-            }
-            if (length > 0)
+            std::uint32_t header = (std::uint32_t)commands.varint();
+            std::uint32_t cmd = header & ((1u << CMD_BITS) - 1u);
+            std::uint32_t length = header >> CMD_BITS;
+
+            if (cmd == CMD_MOVETO || cmd == CMD_LINETO)
             {
-                length--;
-                if (cmd == SEG_MOVETO || cmd == SEG_LINETO)
+                for (; length > 0u && !commands.eof(); --length)
                 {
-                    int px = feature.geometry(k++);
-                    int py = feature.geometry(k++);
-                    px = zig_zag_decode(px);
-                    py = zig_zag_decode(py);
+                    x += zig_zag_decode((std::uint32_t)commands.varint());
+                    y += zig_zag_decode((std::uint32_t)commands.varint());
 
-                    x += px;
-                    y += py;
+                    if (cmd == CMD_MOVETO || buffer.paths.empty() || buffer.paths.back().closed)
+                        buffer.paths.push_back(Path{ (unsigned)buffer.points.size(), 0u, false });
 
-                    double width = extent.width();
-                    double height = extent.height();
+                    buffer.points.emplace_back(
+                        extent.xMin() + sx * (double)x,
+                        extent.yMax() - sy * (double)y,
+                        0.0);
 
-                    double geoX = extent.xMin() + (width/(double)tileres) * (double)x;
-                    double geoY = extent.yMax() - (height/(double)tileres) * (double)y;
-                    geometry->push_back(geoX, geoY, 0);
+                    ++buffer.paths.back().count;
                 }
             }
+            else if (cmd == CMD_CLOSEPATH)
+            {
+                if (!buffer.paths.empty())
+                    buffer.paths.back().closed = true;
+            }
+            else
+            {
+                return false;
+            }
         }
 
-        return geometry;
+        return commands.ok();
+    }
+
+    template<typename T>
+    T* makePart(const GeometryBuffer& buffer, const Path& path, unsigned extra = 0u)
+    {
+        T* part = new T(path.count + extra);
+        for (unsigned i = path.first; i < path.first + path.count; ++i)
+            part->push_back(buffer.points[i]);
+        return part;
     }
 
-    Geometry* decodePolygon(const mapnik::vector::tile_feature& feature, const  TileKey& key, unsigned int tileres)
+    Geometry* collect(std::vector<osg::ref_ptr<Geometry>>& parts)
+    {
+        if (parts.empty())
+        {
+            return nullptr;
+        }
+        else if (parts.size() == 1)
+        {
+            return parts.front().release();
+        }
+        else
+        {
+            MultiGeometry* multi = new MultiGeometry;
+            for (auto& part : parts)
+                multi->add(part.get());
+            return multi;
+        }
+    }
+
+    Geometry* decodeLine(const GeometryBuffer& buffer)
+    {
+        std::vector<osg::ref_ptr<Geometry>> lines;
+        lines.reserve(buffer.paths.size());
+
+        for (auto& path : buffer.paths)
+            lines.push_back(makePart<osgEarth::LineString>(buffer, path));
+
+        return collect(lines);
+    }
+
+    Geometry* decodePoint(const GeometryBuffer& buffer)
+    {
+        return new osgEarth::PointSet(&buffer.points);
+    }
+
+    Geometry* decodePolygon(const GeometryBuffer& buffer)
     {
         /*
          https://github.com/mapbox/vector-tile-spec/tree/master/2.1
@@ -181,278 +377,285 @@ namespace osgEarth { namespace MVT
          interior ring (inner polygon of the current polygon).
          */
 
+        std::vector<osg::ref_ptr<Geometry>> polygons;
+        osgEarth::Polygon* currentPolygon = nullptr;
 
-        unsigned int length = 0;
-        int cmd = -1;
-        const int cmd_bits = 3;
-
-        int x = 0;
-        int y = 0;
-
-        // The list of polygons we've collected
-        std::vector< osg::ref_ptr< osgEarth::Polygon > > polygons;
-
-        osg::ref_ptr< osgEarth::Polygon > currentPolygon;
-
-        osg::ref_ptr< osgEarth::Ring > currentRing;
-
-        GeoExtent extent = key.getExtent();
-
-        for (int k = 0; k < feature.geometry_size();)
+        for (auto& path : buffer.paths)
         {
-            if (!length)
+            // rings end with ClosePath
+            if (!path.closed || path.count == 0u)
+                continue;
+
+            // same formula as Ring::getSignedArea2D, on the open ring
+            unsigned count = path.count;
+            const osg::Vec3d* p = &buffer.points[path.first];
+            if (count > 1u && p[0] == p[count - 1u])
+                --count;
+
+            double area = 0.0;
+            for (unsigned i = 0, j = count - 1u; i < count; j = i++)
+                area += (p[j].x() + p[i].x()) * (p[j].y() - p[i].y());
+
+            // New polygon
+            if (area > 0)
             {
-                unsigned int cmd_length = feature.geometry(k++);
-                cmd = cmd_length & ((1 << cmd_bits) - 1);
-                length = cmd_length >> cmd_bits;
+                currentPolygon = makePart<osgEarth::Polygon>(buffer, path, 1u);
+                currentPolygon->close();
+                currentPolygon->rewind(Geometry::ORIENTATION_CCW);
+                polygons.push_back(currentPolygon);
             }
-            if (length > 0)
+            // Hole
+            else if (area < 0)
             {
-                length--;
-                if (cmd == SEG_MOVETO || cmd == SEG_LINETO)
+                if (currentPolygon)
                 {
-                    if (!currentRing)
-                    {
-                        currentRing = new osgEarth::Ring();
-                    }
-
-                    int px = feature.geometry(k++);
-                    int py = feature.geometry(k++);
-                    px = zig_zag_decode(px);
-                    py = zig_zag_decode(py);
-
-                    x += px;
-                    y += py;
-
-                    double width = extent.width();
-                    double height = extent.height();
-
-                    double geoX = extent.xMin() + (width/(double)tileres) * (double)x;
-                    double geoY = extent.yMax() - (height/(double)tileres) * (double)y;
-                    currentRing->push_back(geoX, geoY, 0);
+                    osgEarth::Ring* hole = makePart<osgEarth::Ring>(buffer, path, 1u);
+                    hole->close();
+                    hole->rewind(Geometry::ORIENTATION_CW);
+                    currentPolygon->getHoles().push_back(hole);
                 }
-                else if (cmd == (SEG_CLOSE & ((1 << cmd_bits) - 1)))
-                {                    
-                    double area = currentRing->getSignedArea2D();
-
-                    // Close the ring.
-                    currentRing->close();
-                    
-                    // New polygon
-                    if (area > 0)
-                    {
-                        currentRing->rewind(Geometry::ORIENTATION_CCW);
-                        currentPolygon = new osgEarth::Polygon(&currentRing->asVector());
-                        polygons.push_back(currentPolygon.get());
-                    }
-                    // Hole
-                    else if (area < 0)
-                    {
-                        if (currentPolygon.valid())
-                        {
-                            currentRing->rewind(Geometry::ORIENTATION_CW);
-                            currentPolygon->getHoles().push_back( currentRing );
-                        }
-                        else
-                        {
-                            // this means we encountered a "hole" without a parent outer ring,
-                            // discard for now -gw
-                            OE_DEBUG << LC << "Discarding improperly wound polygon (hole without an outer ring)\n";
-                        }
-                    }
-
-                    // Start a new ring
-                    currentRing = 0;
+                else
+                {
+                    // this means we encountered a "hole" without a parent outer ring,
+                    // discard for now -gw
+                    OE_DEBUG << LC << "Discarding improperly wound polygon (hole without an outer ring)\n";
                 }
             }
         }
 
-        currentRing = 0;
-        currentPolygon = 0;
+        return collect(polygons);
+    }
 
-        if (polygons.size() == 0)
-        {
-            return 0;
-        }
-        else if (polygons.size() == 1)
-        {
-            // Just return a simple polygon
-            return polygons[0].release();
-        }
-        else
+    // Read-only istream over a memory buffer, for the decompressor
+    struct MemoryBuffer : public std::streambuf
+    {
+        MemoryBuffer(const char* data, std::size_t size)
         {
-            // Return a multipolygon
-            MultiGeometry* multi = new MultiGeometry;
-            for (unsigned int i = 0; i < polygons.size(); i++)
-            {
-                multi->add(polygons[i].get());
-            }
-            return multi;
+            char* p = const_cast<char*>(data);
+            setg(p, p, p + size);
         }
-    }
+    };
 
-    bool readTile(std::istream& in, const TileKey& key, FeatureList& features, const std::vector<std::string>& layers_to_include)
+    bool readTile(
+        const char* data, std::size_t size,
+        const TileKey& key,
+        FeatureList& features,
+        const std::vector<std::string>& layers_to_include,
+        const FeatureFilter& filter)
     {
         features.clear();
 
-        // Get the compressor
-        osg::ref_ptr< osgDB::BaseCompressor> compressor = osgDB::Registry::instance()->getObjectWrapperManager()->findCompressor("zlib");
-        if (!compressor.valid())
-        {
+        if (!data || size == 0u)
             return false;
-        }
 
-        // Decompress the tile
-        std::string original((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
-        in.seekg (0, std::ios::beg);
-        std::string value;
-        if (!compressor->decompress(in, value))
+        // Tiles may be gzip or zlib compressed; a raw tile starts with a layer field (0x1a)
+        // and is decoded in place.
+        std::string decompressed;
+        const unsigned char* magic = (const unsigned char*)data;
+        bool compressed =
+            (size >= 2u && magic[0] == 0x1f && magic[1] == 0x8b) ||
+            (magic[0] == 0x78);
+
+        if (compressed)
         {
-            value = original;
+            osg::ref_ptr< osgDB::BaseCompressor> compressor = osgDB::Registry::instance()->getObjectWrapperManager()->findCompressor("zlib");
+            if (!compressor.valid())
+            {
+                return false;
+            }
+
+            MemoryBuffer buf(data, size);
+            std::istream in(&buf);
+            if (compressor->decompress(in, decompressed))
+            {
+                data = decompressed.data();
+                size = decompressed.size();
+            }
         }
 
+        const GeoExtent& extent = key.getExtent();
+        const SpatialReference* srs = key.getProfile()->getSRS();
+
+        // all features in the tile share one columnar attribute store
+        osg::ref_ptr<AttributeStore> store = new AttributeStore();
+        const int layerColumn = store->addColumn("mvt_layer");
+        const int otherTagsColumn = store->addColumn("other_tags");
 
-        mapnik::vector::tile tile;
+        LayerView layer;
+        GeometryBuffer buffer;
+        std::vector<int> keyColumns;
+        std::vector<Value> values;
 
-        if (tile.ParseFromString(value))
+        PbfReader tile(data, size);
+        while (tile.next())
         {
-            for (int i = 0; i < tile.layers().size(); i++)
+            if (tile.field() != TILE_LAYERS || tile.wire() != PbfReader::WIRE_LENGTH)
             {
-                const mapnik::vector::tile_layer &layer = tile.layers().Get(i);
+                tile.skip();
+                continue;
+            }
 
-                // if we have specific layers, only load those.
-                if (!layers_to_include.empty())
+            // if we have specific layers, only load those.
+            if (!scanLayer(tile.message(), layers_to_include, layer))
+            {
+                continue;
+            }
+
+            // resolve each layer key to a store column on first use
+            keyColumns.assign(layer.keys.size(), -1);
+
+            values.clear();
+            values.reserve(layer.values.size());
+            for (auto& v : layer.values)
+                values.push_back(decodeValue(v));
+
+            for (auto& featureReader : layer.features)
+            {
+                // Index the feature fields without decoding them
+                PbfReader reader = featureReader;
+                std::uint64_t id = 0u;
+                int type = Unknown;
+                PbfReader tags, commands;
+
+                while (reader.next())
                 {
-                    if (std::find(layers_to_include.begin(), layers_to_include.end(), layer.name()) == layers_to_include.end())
+                    switch (reader.field())
                     {
-                        continue;
+                    case FEATURE_ID:       id = reader.varint(); break;
+                    case FEATURE_TYPE:     type = (int)reader.varint(); break;
+                    case FEATURE_TAGS:     if (reader.wire() == PbfReader::WIRE_LENGTH) tags = reader.message(); else reader.skip(); break;
+                    case FEATURE_GEOMETRY: if (reader.wire() == PbfReader::WIRE_LENGTH) commands = reader.message(); else reader.skip(); break;
+                    default:               reader.skip();
                     }
                 }
 
-                for (int j = 0; j < layer.features().size(); j++)
+                if (!reader.ok())
                 {
-                    const mapnik::vector::tile_feature &feature = layer.features().Get(j);
+                    OE_DEBUG << LC << "Skipping malformed feature in layer " << layer.name << " of " << key.str() << std::endl;
+                    continue;
+                }
 
-                    osg::ref_ptr< Feature > oeFeature = new Feature(0, key.getProfile()->getSRS());
+                if (filter && !filter(layer.name, type))
+                {
+                    continue;
+                }
 
-                    // Set the layer name as "mvt_layer" so we can filter it later
-                    oeFeature->set("mvt_layer", layer.name());
-                        
-                    // Read attributes
-                    for (int k = 0; k < feature.tags().size(); k+=2)
-                    {
-                        std::string key = layer.keys().Get(feature.tags().Get(k));
-                        mapnik::vector::tile_value value = layer.values().Get(feature.tags().Get(k+1));
+                if (type != Point && type != LineString && type != Polygon)
+                {
+                    OE_SOFT_ASSERT(false, "MVT: unsupported geometry type \"" << type << "\"");
+                }
 
-                        if (value.has_bool_value())
-                        {
-                            oeFeature->set(key, value.bool_value());
-                        }
-                        else if (value.has_double_value())
-                        {
-                            oeFeature->set(key, value.double_value());
-                        }
-                        else if (value.has_float_value())
-                        {
-                            oeFeature->set(key, value.float_value());
-                        }
-                        else if (value.has_int_value())
-                        {
-                            oeFeature->set(key, (long long)value.int_value());
-                        }
-                        else if (value.has_sint_value())
-                        {
-                            oeFeature->set(key, (long long)value.sint_value());
-                        }
-                        else if (value.has_string_value())
-                        {
-                            oeFeature->set(key, value.string_value());
-                        }
-                        else if (value.has_uint_value())
-                        {
-                            oeFeature->set(key, (long long)value.uint_value());
-                        }
+                if (!decodeCommands(commands, extent, layer.extent, buffer))
+                {
+                    OE_DEBUG << LC << "Skipping feature with a malformed geometry in layer " << layer.name << " of " << key.str() << std::endl;
+                    continue;
+                }
 
-                        // Special path for getting heights from our test dataset.
-                        if (key == "other_tags")
-                        {
-                            std::string other_tags = value.string_value();
+                osg::ref_ptr< osgEarth::Geometry > geometry;
 
-                            auto tized = StringTokenizer()
-                                .delim("=")
-                                .delim(">")
-                                .standardQuotes()
-                                .tokenize(other_tags);
+                if (type == Polygon)
+                {
+                    geometry = decodePolygon(buffer);
+                }
+                else if (type == Point)
+                {
+                    geometry = decodePoint(buffer);
 
-                            if (tized.size() == 3)
-                            {
-                                if (tized[0] == "height")
-                                {
-                                    std::string value = tized[2];
-                                    // Remove quotes from the height
-                                    float height = as<float>(value, FLT_MAX);
-                                    if (height != FLT_MAX)
-                                    {
-                                        oeFeature->set("height", height);
-                                    }
-                                }
-                            }
-                        }
+                    // This is a bit of a hack, but if a point is outside of the extents we remove it.
+                    // Lines and Polygons that extend outside of the tileset we keep though b/c we assume that they are just slightly going outside of the
+                    // extent.  Should probably make this an option somewhere.
+                    if (geometry && !extent.contains(geometry->getBounds().center()))
+                    {
+                        geometry = nullptr;
                     }
+                }
+                else
+                {
+                    geometry = decodeLine(buffer);
+                }
+
+                if (!geometry)
+                {
+                    continue;
+                }
 
+                osg::ref_ptr< Feature > oeFeature = new Feature(geometry.get(), srs);
+                oeFeature->setFID(id);
 
+                unsigned row = store->addRow();
+                oeFeature->setAttributeStore(store.get(), row);
 
-                    osg::ref_ptr< osgEarth::Geometry > geometry;
+                // Set the layer name as "mvt_layer" so we can filter it later
+                store->set(row, layerColumn, layer.name);
 
-                    eGeomType geomType = static_cast<eGeomType>(feature.type());
-                    if (geomType == MVT::Polygon)
+                // Read attributes
+                while (!tags.eof())
+                {
+                    std::uint64_t keyIndex = tags.varint();
+                    std::uint64_t valueIndex = tags.varint();
+                    if (!tags.ok() || keyIndex >= layer.keys.size() || valueIndex >= values.size())
+                        break;
+
+                    if (keyColumns[keyIndex] < 0)
                     {
-                        geometry = decodePolygon(feature, key, layer.extent());
+                        const PbfReader& k = layer.keys[keyIndex];
+                        keyColumns[keyIndex] = store->addColumn(std::string(k.data(), k.size()));
                     }
-                    else if (geomType == MVT::LineString)
+                    int column = keyColumns[keyIndex];
+
+                    const Value& value = values[valueIndex];
+                    switch (value.type)
                     {
-                        geometry = decodeLine(feature, key, layer.extent());
+                    case Value::STRING:  store->set(row, column, value.str, value.length); break;
+                    case Value::DOUBLE:  store->set(row, column, value.d); break;
+                    case Value::INTEGER: store->set(row, column, value.i); break;
+                    case Value::BOOL:    store->set(row, column, value.b); break;
+                    default: break;
                     }
-                    else if (geomType == MVT::Point)
+
+                    // Special path for getting heights from our test dataset.
+                    if (column == otherTagsColumn && value.type == Value::STRING)
                     {
-                        geometry = decodePoint(feature, key, layer.extent());
+                        auto tized = StringTokenizer()
+                            .delim("=")
+                            .delim(">")
+                            .standardQuotes()
+                            .tokenize(std::string(value.str, value.length));
 
-                        // This is a bit of a hack, but if a point is outside of the extents we remove it.
-                        // Lines and Polygons that extend outside of the tileset we keep though b/c we assume that they are just slightly going outside of the
-                        // extent.  Should probably make this an option somewhere.
-                        if (geometry)
+                        if (tized.size() == 3)
                         {
-                            if (!key.getExtent().contains(geometry->getBounds().center()))
+                            if (tized[0] == "height")
                             {
-                                geometry = NULL;
+                                // Remove quotes from the height
+                                float height = as<float>(tized[2], FLT_MAX);
+                                if (height != FLT_MAX)
+                                {
+                                    store->set(row, store->addColumn("height"), (double)height);
+                                }
                             }
                         }
                     }
-                    else
-                    {
-                        OE_SOFT_ASSERT(false, "MVT: unsupported geometry type \"" << feature.type() << "\"");
-                        geometry = decodeLine(feature, key, layer.extent());
-                    }
-
-                    if (geometry)
-                    {
-                        oeFeature->setFID(feature.id());
-                        oeFeature->setGeometry(geometry.get());
-                        features.push_back(oeFeature.get());
-                    }
-
                 }
+
+                features.push_back(oeFeature.get());
             }
         }
-        else
+
+        if (!tile.ok())
         {
             OE_WARN << "Failed to parse mvt" << key.str() << std::endl;
+            features.clear();
             return false;
         }
 
         return true;
     }
 
+    bool readTile(std::istream& in, const TileKey& key, FeatureList& features, const std::vector<std::string>& layers_to_include)
+    {
+        std::string buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        return readTile(buffer.data(), buffer.size(), key, features, layers_to_include, {});
+    }
 }} // namespace osgEarth::MVT
 
 //........................................................................
@@ -611,9 +814,7 @@ MVTFeatureSource::createFeatureCursorImplementation(const Query& query, Progress
         // the pointer returned from _blob gets freed internally by sqlite, supposedly
         const char* data = (const char*)sqlite3_column_blob(select, 0);
         int dataLen = sqlite3_column_bytes(select, 0);
-        std::string dataBuffer(data, dataLen);
-        std::stringstream in(dataBuffer);
-        MVT::readTile(in, key, features, options().layers());
+        MVT::readTile(data, dataLen, key, features, options().layers(), _featureFilter);
     }
     else
     {    
@@ -687,12 +888,10 @@ MVTFeatureSource::iterateTiles(int zoomLevel, int limit, int offset, const GeoEx
         // the pointer returned from _blob gets freed internally by sqlite, supposedly
         const char* data = (const char*)sqlite3_column_blob(select, 3);
         int dataLen = sqlite3_column_bytes(select, 3);
-        std::string dataBuffer(data, dataLen);
-        std::stringstream in(dataBuffer);
 
         FeatureList features;
 
-        MVT::readTile(in, key, features, options().layers());
+        MVT::readTile(data, dataLen, key, features, options().layers(), _featureFilter);
 
         // If we have any features and we have an fid attribute, override the fid of the features
         // NOTE: FeatureSource normally does this, but we're bypassing it here... consider a refactoring...
@@ -293,16 +293,15 @@ namespace osgEarth
                 for (unsigned int i = 0; i < g.getNumFeatures(); ++i)
                 {
                     const Feature* feature = g.getFeature(i);
-                    for (auto& attr : feature->getAttrs())
+                    feature->forEachAttr([&](const std::string& key, const AttributeValue&)
                     {
-                        std::string key = attr.first;
                         auto itr = keysToIndex.find(key);
                         if (itr == keysToIndex.end())
                         {
                             keysToIndex[key] = keys.size();                                                        
                             keys.push_back(key);
                         }
-                    }
+                    });
                 }
 
                 os << os.PROPERTY("Keys");
@@ -329,10 +328,13 @@ namespace osgEarth
 
                     os << g.getVisible(i) << std::endl;
 
+                    // includes any attribute store row; assemble it once
+                    AttributeTable attrs = feature->getAllAttrs();
+
                     os << os.PROPERTY("Attrs");
-                    os.writeSize(feature->getAttrs().size());
+                    os.writeSize(attrs.size());
                     os << os.BEGIN_BRACKET << std::endl;
-                    for (auto& attr : feature->getAttrs())
+                    for (auto& attr : attrs)
                     {
                         os << (unsigned int)keysToIndex[attr.first] << std::endl;
                         os << (unsigned int)attr.second.type << std::endl;
@@ -8,10 +8,16 @@
 #include <osgEarth/FeatureCursor>
 #include <osgEarth/Filter>
 #include <osgEarth/StringUtils>
+#include <osgEarth/Threading>
+#include <osgEarth/Metrics>
 
 #include <gdal.h>
+#include <osg/Timer>
+#include <algorithm>
 #include <queue>
 
+#include <osgEarth/rtree.h>
+
 #define LC "[OGRFeatureSource] "
 
 using namespace osgEarth;
@@ -30,6 +36,106 @@ namespace osgEarth { namespace OGR
         return h;
     }
 
+    // Feature extents in the layer's SRS, by FID
+    using MemoryIndex = RTree<FeatureID, double, 2>;
+
+    /**
+     * Read-only dataset/layer handles shared by the cursors of one source.
+     * A cursor checks out a pair for its lifetime and returns it when it's
+     * done, so tile queries don't reopen the data for every cursor. GDAL
+     * handles are not thread-safe, but the checkout guarantees that only
+     * one thread uses a pair at a time.
+     */
+    class DatasetPool
+    {
+    public:
+        DatasetPool(const std::string& source, const std::string& layer) :
+            _source(source),
+            _layer(layer),
+            _maxIdle(std::max(4u, std::thread::hardware_concurrency()))
+        {
+            //nop
+        }
+
+        ~DatasetPool()
+        {
+            close();
+        }
+
+        //! Takes an idle pair, or opens a new one
+        bool acquire(GDALDatasetH& ds, OGRLayerH& layer)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_idle.empty())
+                {
+                    ds = _idle.back().first;
+                    layer = _idle.back().second;
+                    _idle.pop_back();
+                    return true;
+                }
+            }
+
+            ds = GDALOpenEx(
+                _source.c_str(),
+                GDAL_OF_VECTOR | GDAL_OF_READONLY,
+                nullptr,
+                nullptr,
+                nullptr);
+
+            layer = ds ? openLayer(ds, _layer) : nullptr;
+
+            if (ds && !layer)
+            {
+                GDALClose(ds);
+                ds = nullptr;
+            }
+
+            return ds != nullptr;
+        }
+
+        //! Returns a pair to the pool, or closes it if the pool is full or closed
+        void release(GDALDatasetH ds, OGRLayerH layer)
+        {
+            // leave the layer the way we found it:
+            OGR_L_SetSpatialFilter(layer, nullptr);
+            OGR_L_ResetReading(layer);
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_closed && _idle.size() < _maxIdle)
+                {
+                    _idle.emplace_back(ds, layer);
+                    return;
+                }
+            }
+
+            GDALClose(ds);
+        }
+
+        //! Closes the idle handles; pairs released after this are closed as well
+        void close()
+        {
+            std::vector<std::pair<GDALDatasetH, OGRLayerH>> idle;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _closed = true;
+                idle.swap(_idle);
+            }
+
+            for (auto& handles : idle)
+                GDALClose(handles.first);
+        }
+
+    private:
+        std::string _source;
+        std::string _layer;
+        unsigned _maxIdle;
+        std::mutex _mutex;
+        std::vector<std::pair<GDALDatasetH, OGRLayerH>> _idle;
+        bool _closed = false;
+    };
+
     /**
      * Determine whether a point is valid or not.  Some shapefiles can have points that are ridiculously big, which are really invalid data
      * but shapefiles have no way of marking the data as invalid.  So instead we check for really large values that are indiciative of something being wrong.
@@ -76,7 +182,8 @@ OGR::OGRFeatureCursor::OGRFeatureCursor(
     const FeatureFilterChain& filters,
     bool rewindPolygons,
     unsigned chunkSize,
-    ProgressCallback* progress) :
+    ProgressCallback* progress,
+    std::shared_ptr<DatasetPool> pool) :
 
     FeatureCursor(progress),
     _source(source),
@@ -90,7 +197,10 @@ OGR::OGRFeatureCursor::OGRFeatureCursor(
     _resultSetEndReached(false),
     _profile(profile),
     _filters(filters),
-    _rewindPolygons(rewindPolygons)
+    _rewindPolygons(rewindPolygons),
+    _nextFid(0u),
+    _readByFid(false),
+    _pool(pool)
 {
     std::string expr;
     std::string from = OGR_FD_GetName(OGR_L_GetLayerDefn(static_cast<OGRLayerH>(_layerHandle)));
@@ -181,6 +291,40 @@ OGR::OGRFeatureCursor::OGRFeatureCursor(
     readChunk();
 }
 
+OGR::OGRFeatureCursor::OGRFeatureCursor(
+    void* dsHandle,
+    void* layerHandle,
+    std::vector<FeatureID>&& fids,
+    const FeatureSource* source,
+    const FeatureProfile* profile,
+    const Query& query,
+    const FeatureFilterChain& filters,
+    bool rewindPolygons,
+    unsigned chunkSize,
+    ProgressCallback* progress,
+    std::shared_ptr<DatasetPool> pool) :
+
+    FeatureCursor(progress),
+    _source(source),
+    _dsHandle(dsHandle),
+    _layerHandle(layerHandle),
+    _resultSetHandle(0L),
+    _spatialFilter(0L),
+    _query(query),
+    _chunkSize(chunkSize == 0u ? 500u : chunkSize),
+    _nextHandleToQueue(0L),
+    _resultSetEndReached(false),
+    _profile(profile),
+    _filters(filters),
+    _rewindPolygons(rewindPolygons),
+    _fids(std::move(fids)),
+    _nextFid(0u),
+    _readByFid(true),
+    _pool(pool)
+{
+    readChunk();
+}
+
 OGR::OGRFeatureCursor::OGRFeatureCursor(void* resultSetHandle, const FeatureProfile* profile) :
     FeatureCursor(NULL),
     _resultSetHandle(resultSetHandle),
@@ -190,7 +334,9 @@ OGR::OGRFeatureCursor::OGRFeatureCursor(void* resultSetHandle, const FeatureProf
     _spatialFilter(0L),
     _chunkSize(500),
     _nextHandleToQueue(0L),
-    _resultSetEndReached(false)
+    _resultSetEndReached(false),
+    _nextFid(0u),
+    _readByFid(false)
 {
     if (_resultSetHandle)
     {
@@ -211,14 +357,31 @@ OGR::OGRFeatureCursor::~OGRFeatureCursor()
     if ( _spatialFilter )
         OGR_G_DestroyGeometry( static_cast<OGRGeometryH>(_spatialFilter) );
 
-    if ( _dsHandle )
+    if ( _dsHandle && _pool )
+        _pool->release( static_cast<GDALDatasetH>(_dsHandle), static_cast<OGRLayerH>(_layerHandle) );
+    else if ( _dsHandle )
         GDALClose( static_cast<GDALDatasetH>(_dsHandle) );
 }
 
 bool
 OGR::OGRFeatureCursor::hasMore() const
 {
-    return _resultSetHandle && _queue.size() > 0;
+    return (_resultSetHandle || _readByFid) && _queue.size() > 0;
+}
+
+void*
+OGR::OGRFeatureCursor::nextHandle()
+{
+    if (!_readByFid)
+        return OGR_L_GetNextFeature( static_cast<OGRLayerH>(_resultSetHandle) );
+
+    while (_nextFid < _fids.size())
+    {
+        OGRFeatureH handle = OGR_L_GetFeature( static_cast<OGRLayerH>(_layerHandle), _fids[_nextFid++] );
+        if (handle)
+            return handle;
+    }
+    return nullptr;
 }
 
 Feature*
@@ -244,15 +407,21 @@ OGR::OGRFeatureCursor::nextFeature()
 void
 OGR::OGRFeatureCursor::readChunk()
 {
-    if ( !_resultSetHandle )
+    if ( !_resultSetHandle && !_readByFid )
         return;
     
     while( _queue.size() < _chunkSize && !_resultSetEndReached )
     {
         FeatureList filterList;
+
+        // the chunk's attributes share one columnar store
+        osg::ref_ptr<AttributeStore> store = new AttributeStore();
+        store->reserve(std::min(_chunkSize, 4096u));
+        std::vector<int> columns;
+
         while( filterList.size() < _chunkSize && !_resultSetEndReached )
         {
-            OGRFeatureH handle = OGR_L_GetNextFeature( static_cast<OGRLayerH>(_resultSetHandle) );
+            OGRFeatureH handle = static_cast<OGRFeatureH>(nextHandle());
             if ( handle )
             {
                 /*
@@ -265,7 +434,7 @@ OGR::OGRFeatureCursor::readChunk()
                 }
                 */
                 osg::ref_ptr<Feature> feature = OgrUtils::createFeature(
-                    handle, _profile->getSRS(), _rewindPolygons);
+                    handle, _profile->getSRS(), _rewindPolygons, store.get(), columns);
 
                 if (feature.valid())
                 {
@@ -322,7 +491,7 @@ OGR::OGRFeatureCursor::readChunk()
         }
     }
 
-    if (_chunkSize == ~0)
+    if (_chunkSize == ~0 && _resultSetHandle)
     {
         OGR_L_ResetReading(static_cast<OGRLayerH>(_resultSetHandle));
     }
@@ -339,6 +508,7 @@ OGRFeatureSource::Options::getConfig() const
     conf.set("ogr_driver", _ogrDriver);
     conf.set("build_spatial_index", _buildSpatialIndex);
     conf.set("force_rebuild_spatial_index", _forceRebuildSpatialIndex);
+    conf.set("memory_spatial_index", _memorySpatialIndex);
     conf.set("geometry", _geometryConfig);
     conf.set("geometry_url", _geometryUrl);
     conf.set("layer", _layer);
@@ -354,6 +524,7 @@ OGRFeatureSource::Options::fromConfig(const Config& conf)
     conf.get("ogr_driver", _ogrDriver);
     conf.get("build_spatial_index", _buildSpatialIndex);
     conf.get("force_rebuild_spatial_index", _forceRebuildSpatialIndex);
+    conf.get("memory_spatial_index", _memorySpatialIndex);
     conf.get("geometry", _geometryConfig);
     conf.get("geometry_url", _geometryUrl);
     conf.get("layer", _layer);
@@ -367,6 +538,7 @@ REGISTER_OSGEARTH_LAYER(ogrfeatures, OGRFeatureSource);
 OE_LAYER_PROPERTY_IMPL(OGRFeatureSource, URI, URL, url);
 OE_LAYER_PROPERTY_IMPL(OGRFeatureSource, std::string, Connection, connection);
 OE_LAYER_PROPERTY_IMPL(OGRFeatureSource, bool, BuildSpatialIndex, buildSpatialIndex);
+OE_LAYER_PROPERTY_IMPL(OGRFeatureSource, bool, MemorySpatialIndex, memorySpatialIndex);
 OE_LAYER_PROPERTY_IMPL(OGRFeatureSource, std::string, OGRDriver, ogrDriver);
 OE_LAYER_PROPERTY_IMPL(OGRFeatureSource, URI, GeometryURL, geometryUrl);
 OE_LAYER_PROPERTY_IMPL(OGRFeatureSource, std::string, Layer, layer);
@@ -383,11 +555,28 @@ OGRFeatureSource::init()
     _needsSync = false;
     _writable = false;
     _geometryType = Geometry::TYPE_UNKNOWN;
+    _memoryIndex = nullptr;
+    _memoryIndexBuilt = false;
+    _pool = nullptr;
 }
 
 Status
 OGRFeatureSource::closeImplementation()
 {
+    if (_pool)
+    {
+        // cursors still holding handles will close them when they finish
+        _pool->close();
+        _pool = nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_memoryIndexMutex);
+        delete static_cast<OGR::MemoryIndex*>(_memoryIndex);
+        _memoryIndex = nullptr;
+        _memoryIndexBuilt = false;
+    }
+
     if (_layerHandle)
     {
         if (_needsSync)
@@ -610,6 +799,12 @@ OGRFeatureSource::openImplementation()
         //Get the feature count
         _featureCount = OGR_L_GetFeatureCount(static_cast<OGRLayerH>(_layerHandle), 1);
 
+        if (!_writable)
+        {
+            // cursors share read-only handles instead of reopening the data:
+            _pool = std::make_shared<OGR::DatasetPool>(_source, options().layer().value());
+        }
+
         // establish the feature schema:
         initSchema();
 
@@ -814,6 +1009,63 @@ OGRFeatureSource::buildSpatialIndex()
    }
 }
 
+void*
+OGRFeatureSource::buildMemorySpatialIndex(void* layerHandle) const
+{
+    OGRLayerH layer = static_cast<OGRLayerH>(layerHandle);
+
+    // Only worth it when OGR would otherwise scan the whole layer, and only
+    // possible when we can fetch features by FID.
+    if (!layer ||
+        OGR_L_TestCapability(layer, OLCFastSpatialFilter) != 0 ||
+        OGR_L_TestCapability(layer, OLCRandomRead) == 0)
+    {
+        return nullptr;
+    }
+
+    OE_PROFILING_ZONE;
+    osg::Timer_t start = osg::Timer::instance()->tick();
+
+    // we only need the geometry, so skip decoding the attributes:
+    OGRFeatureDefnH layerDef = OGR_L_GetLayerDefn(layer);
+    std::vector<const char*> ignored;
+    for (int i = 0; i < OGR_FD_GetFieldCount(layerDef); ++i)
+        ignored.push_back(OGR_Fld_GetNameRef(OGR_FD_GetFieldDefn(layerDef, i)));
+    ignored.push_back("OGR_STYLE");
+    ignored.push_back(nullptr);
+    OGR_L_SetIgnoredFields(layer, ignored.data());
+
+    OGR::MemoryIndex* index = new OGR::MemoryIndex();
+    unsigned count = 0u;
+    double a_min[2], a_max[2];
+    OGREnvelope env;
+
+    OGR_L_ResetReading(layer);
+    OGRFeatureH handle;
+    while ((handle = OGR_L_GetNextFeature(layer)) != nullptr)
+    {
+        FeatureID fid = OGR_F_GetFID(handle);
+        OGRGeometryH geom = OGR_F_GetGeometryRef(handle);
+        if (fid >= 0 && geom && !OGR_G_IsEmpty(geom))
+        {
+            OGR_G_GetEnvelope(geom, &env);
+            a_min[0] = env.MinX, a_min[1] = env.MinY;
+            a_max[0] = env.MaxX, a_max[1] = env.MaxY;
+            index->Insert(a_min, a_max, fid);
+            ++count;
+        }
+        OGR_F_Destroy(handle);
+    }
+
+    OGR_L_SetIgnoredFields(layer, nullptr);
+    OGR_L_ResetReading(layer);
+
+    OE_INFO << LC << getName() << ": indexed " << count << " features in "
+        << osg::Timer::instance()->delta_m(start, osg::Timer::instance()->tick()) << " ms" << std::endl;
+
+    return index;
+}
+
 FeatureCursor*
 OGRFeatureSource::createFeatureCursorImplementation(const Query& query, ProgressCallback* progress) const
 {
@@ -829,25 +1081,27 @@ OGRFeatureSource::createFeatureCursorImplementation(const Query& query, Progress
         GDALDatasetH dsHandle = 0L;
         OGRLayerH layerHandle = 0L;
 
-        const char* openOptions[2] = {
-            "OGR_GPKG_INTEGRITY_CHECK=NO",
-            nullptr
-        };
-
-        dsHandle = GDALOpenEx(
-            _source.c_str(),
-            GDAL_OF_VECTOR | GDAL_OF_READONLY,
-            nullptr,
-            nullptr, //openOptions,
-            nullptr);
-
-        // open the handles safely:
         // Each cursor requires its own DS handle so that multi-threaded access will work.
-        // The cursor impl will dispose of the new DS handle.
-        //dsHandle = OGROpenShared(_source.c_str(), 0, &_ogrDriverHandle);
-        if (dsHandle)
+        // Take one from the pool if we have one; otherwise open a new one, and the
+        // cursor impl will dispose of it.
+        std::shared_ptr<OGR::DatasetPool> pool = _pool;
+        if (pool)
         {
-            layerHandle = OGR::openLayer(dsHandle, options().layer().get());
+            pool->acquire(dsHandle, layerHandle);
+        }
+        else
+        {
+            dsHandle = GDALOpenEx(
+                _source.c_str(),
+                GDAL_OF_VECTOR | GDAL_OF_READONLY,
+                nullptr,
+                nullptr,
+                nullptr);
+
+            if (dsHandle)
+            {
+                layerHandle = OGR::openLayer(dsHandle, options().layer().get());
+            }
         }
 
         if (dsHandle && layerHandle)
@@ -858,6 +1112,56 @@ OGRFeatureSource::createFeatureCursorImplementation(const Query& query, Progress
                 newQuery = options().query()->combineWith(query);
             }
 
+            // A plain spatial query can use the memory index to read just the
+            // features it touches. The first one builds the index, using the
+            // handles it just checked out.
+            const OGR::MemoryIndex* index = nullptr;
+            if (pool &&
+                options().memorySpatialIndex() == true &&
+                !newQuery.expression().isSet() &&
+                !newQuery.orderby().isSet() &&
+                (newQuery.bounds().isSet() || newQuery.tileKey().isSet()))
+            {
+                std::lock_guard<std::mutex> lock(_memoryIndexMutex);
+                if (!_memoryIndexBuilt)
+                {
+                    _memoryIndex = buildMemorySpatialIndex(layerHandle);
+                    _memoryIndexBuilt = true;
+                }
+                index = static_cast<const OGR::MemoryIndex*>(_memoryIndex);
+            }
+
+            if (index)
+            {
+                Bounds bounds;
+                if (newQuery.bounds().isSet())
+                    bounds = newQuery.bounds().get();
+                else
+                    bounds = newQuery.tileKey()->getExtent().transform(getFeatureProfile()->getSRS()).bounds();
+
+                std::vector<FeatureID> fids;
+                double a_min[2] = { bounds.xMin(), bounds.yMin() };
+                double a_max[2] = { bounds.xMax(), bounds.yMax() };
+                index->Search(a_min, a_max,
+                    [&fids](const FeatureID& fid) { fids.push_back(fid); return RTREE_KEEP_SEARCHING; });
+
+                // read in file order
+                std::sort(fids.begin(), fids.end());
+
+                return new OGR::OGRFeatureCursor(
+                    dsHandle,
+                    layerHandle,
+                    std::move(fids),
+                    this,
+                    getFeatureProfile(),
+                    newQuery,
+                    getFilters(),
+                    _options->rewindPolygons().get(),
+                    0, // default chunksize
+                    progress,
+                    pool);
+            }
+
             // cursor is responsible for the OGR handles.
             return new OGR::OGRFeatureCursor(
                 dsHandle,
@@ -868,12 +1172,17 @@ OGRFeatureSource::createFeatureCursorImplementation(const Query& query, Progress
                 getFilters(),
                 _options->rewindPolygons().get(),
                 0, // default chunksize
-                progress
+                progress,
+                pool
                 );
         }
         else
         {
-            if (dsHandle)
+            if (dsHandle && pool)
+            {
+                pool->release(dsHandle, layerHandle);
+            }
+            else if (dsHandle)
             {
                 GDALClose(dsHandle);
             }
@@ -949,7 +1258,7 @@ OGRFeatureSource::insertFeature(Feature* feature)
     OGRFeatureH feature_handle = OGR_F_Create(OGR_L_GetLayerDefn(static_cast<OGRLayerH>(_layerHandle)));
     if (feature_handle)
     {
-        const AttributeTable& attrs = feature->getAttrs();
+        AttributeTable attrs = feature->getAllAttrs();
 
         // assign the attributes:
         int num_fields = OGR_F_GetFieldCount(feature_handle);
@@ -3,6 +3,7 @@
 * MIT License
 */
 #include <osgEarth/OgrUtils>
+#include <cstring>
 
 #define LC "[FeatureSource] "
 
@@ -583,6 +584,72 @@ OgrUtils::createFeature( OGRFeatureH handle, const SpatialReference* srs, bool r
     return feature;
 }
 
+Feature*
+OgrUtils::createFeature(OGRFeatureH handle, const SpatialReference* srs, bool rewindPolygons, AttributeStore* store, std::vector<int>& columns)
+{
+    if (!store)
+        return createFeature(handle, srs, rewindPolygons);
+
+    FeatureID fid = OGR_F_GetFID( handle );
+
+    OGRGeometryH geomRef = OGR_F_GetGeometryRef( handle );
+
+    Geometry* geom = 0;
+
+    if ( geomRef )
+    {
+        geom = OgrUtils::createGeometry( geomRef, rewindPolygons);
+    }
+
+    Feature* feature = new Feature( geom, srs, Style(), fid );
+
+    int numAttrs = OGR_F_GetFieldCount(handle);
+
+    // resolve the field names to store columns once per layer
+    if (columns.size() != (unsigned)numAttrs)
+    {
+        columns.resize(numAttrs);
+        for (int i = 0; i < numAttrs; ++i)
+        {
+            OGRFieldDefnH field_handle_ref = OGR_F_GetFieldDefnRef( handle, i );
+            columns[i] = store->addColumn( OGR_Fld_GetNameRef( field_handle_ref ) );
+        }
+    }
+
+    unsigned row = store->addRow();
+    feature->setAttributeStore(store, row);
+
+    for (int i = 0; i < numAttrs; ++i)
+    {
+        if (!IsFieldSet( handle, i ))
+            continue;
+
+        OGRFieldDefnH field_handle_ref = OGR_F_GetFieldDefnRef( handle, i );
+        switch( OGR_Fld_GetType( field_handle_ref ) )
+        {
+        case OFTInteger:
+            store->set(row, columns[i], (long long)OGR_F_GetFieldAsInteger(handle, i));
+            break;
+
+        case OFTInteger64:
+            store->set(row, columns[i], (long long)OGR_F_GetFieldAsInteger64(handle, i));
+            break;
+
+        case OFTReal:
+            store->set(row, columns[i], OGR_F_GetFieldAsDouble(handle, i));
+            break;
+
+        default:
+            {
+                const char* value = OGR_F_GetFieldAsString(handle, i);
+                store->set(row, columns[i], value, strlen(value));
+            }
+        }
+    }
+
+    return feature;
+}
+
 AttributeType
 OgrUtils::getAttributeType( OGRFieldType type )
 {
@@ -225,6 +225,13 @@ Registry::Registry() :
         jobs::set_allow_work_stealing(true);
     }
 
+    // heap-based, batch-reprioritized job scheduling?
+    const char* scheduling = getenv("OSGEARTH_JOB_SCHEDULING");
+    if (scheduling && osgEarth::Util::ciEquals(scheduling, "batched"))
+    {
+        jobs::set_scheduling(jobs::scheduling::batched);
+    }
+
     // register the system stock Units.
     Units::registerAll( this );
 
@@ -256,6 +263,9 @@ Registry::~Registry()
     // Release any GL objects
     release();
 
+    // Cancel any outstanding asynchronous HTTP requests
+    HTTPClient::globalShutdown();
+
     OE_INFO << "Goodbye." << std::endl;
 }
 
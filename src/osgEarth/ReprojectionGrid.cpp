@@ -0,0 +1,339 @@
+/* osgEarth
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include <osgEarth/ReprojectionGrid>
+#include <osgEarth/SpatialReference>
+#include <osgEarth/Containers>
+#include <osgEarth/Metrics>
+#include <osgEarth/Math>
+#include <osgEarth/Notify>
+#include <osg/Vec2d>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
+using namespace osgEarth;
+
+namespace
+{
+    // Largest lattice we will try before giving up and transforming every
+    // point. Each refinement re-transforms the whole lattice, so this caps
+    // the wasted work on grids that don't interpolate well (e.g., ones that
+    // straddle a projection discontinuity).
+    constexpr unsigned MAX_LATTICE_SIZE = 65u;
+
+    // Maximum interpolation error in vertical datum offsets (meters)
+    constexpr double Z_TOLERANCE = 0.05;
+
+    // Number of validated lattices to keep around
+    constexpr unsigned CACHE_SIZE = 256u;
+
+    std::atomic<unsigned> s_latticeSize(17u);
+    std::atomic<double> s_tolerance(0.125);
+
+    struct LatticeKey
+    {
+        SpatialReference::Key from, to;
+        double xmin, ymin, xmax, ymax;
+        unsigned cols, rows;
+
+        bool operator == (const LatticeKey& rhs) const {
+            return
+                xmin == rhs.xmin && ymin == rhs.ymin &&
+                xmax == rhs.xmax && ymax == rhs.ymax &&
+                cols == rhs.cols && rows == rhs.rows &&
+                from == rhs.from && to == rhs.to;
+        }
+    };
+
+    // Transformed lattice points. An empty lattice means interpolation
+    // was not accurate enough and every point must be transformed.
+    struct Lattice
+    {
+        unsigned nx = 0u, ny = 0u;
+        std::vector<osg::Vec3d> points;
+    };
+    using LatticePtr = std::shared_ptr<const Lattice>;
+}
+
+namespace std
+{
+    template<> struct hash<LatticeKey>
+    {
+        std::size_t operator()(const LatticeKey& k) const
+        {
+            std::size_t seed = k.from.hash;
+            auto combine = [&seed](std::size_t h) {
+                seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            };
+            combine(k.to.hash);
+            combine(std::hash<double>()(k.xmin));
+            combine(std::hash<double>()(k.ymin));
+            combine(std::hash<double>()(k.xmax));
+            combine(std::hash<double>()(k.ymax));
+            combine(hash_value_unsigned(k.cols, k.rows));
+            return seed;
+        }
+    };
+}
+
+namespace
+{
+    using LatticeCache = LRUCache<LatticeKey, LatticePtr>;
+
+    LatticeCache& cache()
+    {
+        static LatticeCache s_cache(true, CACHE_SIZE);
+        return s_cache;
+    }
+
+    inline bool isFinite(const osg::Vec3d& p)
+    {
+        return std::isfinite(p.x()) && std::isfinite(p.y()) && std::isfinite(p.z());
+    }
+
+    // Fills "out" with an nx by ny grid spanning the bounds (inclusive).
+    void makeGrid(
+        double xmin, double ymin, double xmax, double ymax,
+        unsigned nx, unsigned ny,
+        std::vector<osg::Vec3d>& out)
+    {
+        out.resize(nx * ny);
+        double dx = nx > 1 ? (xmax - xmin) / (double)(nx - 1) : 0.0;
+        double dy = ny > 1 ? (ymax - ymin) / (double)(ny - 1) : 0.0;
+
+        for (unsigned t = 0; t < ny; ++t)
+        {
+            double y = ymin + dy * (double)t;
+            for (unsigned s = 0; s < nx; ++s)
+            {
+                out[t * nx + s].set(xmin + dx * (double)s, y, 0.0);
+            }
+        }
+    }
+
+    // Transforms the center of every lattice cell and compares it to the
+    // interpolated value. The allowable error scales with the local size
+    // of an output sample in the target SRS.
+    bool validate(
+        const Lattice& lattice,
+        const SpatialReference* from_srs,
+        const SpatialReference* to_srs,
+        double xmin, double ymin, double xmax, double ymax,
+        unsigned cols, unsigned rows,
+        double tolerance)
+    {
+        const unsigned nx = lattice.nx, ny = lattice.ny;
+        const unsigned mx = nx - 1, my = ny - 1;
+
+        std::vector<osg::Vec3d> centers(mx * my);
+        double cx = (xmax - xmin) / (double)mx;
+        double cy = (ymax - ymin) / (double)my;
+        for (unsigned j = 0; j < my; ++j)
+        {
+            for (unsigned i = 0; i < mx; ++i)
+            {
+                centers[j * mx + i].set(
+                    xmin + cx * ((double)i + 0.5),
+                    ymin + cy * ((double)j + 0.5),
+                    0.0);
+            }
+        }
+
+        if (!from_srs->transform(centers, to_srs))
+            return false;
+
+        // output samples per lattice cell
+        double spx = (double)(cols - 1) / (double)mx;
+        double spy = (double)(rows - 1) / (double)my;
+
+        const auto& L = lattice.points;
+
+        for (unsigned j = 0; j < my; ++j)
+        {
+            for (unsigned i = 0; i < mx; ++i)
+            {
+                const osg::Vec3d& p00 = L[j * nx + i];
+                const osg::Vec3d& p10 = L[j * nx + i + 1];
+                const osg::Vec3d& p01 = L[(j + 1) * nx + i];
+                const osg::Vec3d& p11 = L[(j + 1) * nx + i + 1];
+                const osg::Vec3d& exact = centers[j * mx + i];
+
+                if (!isFinite(p00) || !isFinite(p10) || !isFinite(p01) || !isFinite(p11) || !isFinite(exact))
+                    return false;
+
+                osg::Vec3d interp = (p00 + p10 + p01 + p11) * 0.25;
+
+                double spacing = std::min(
+                    osg::Vec2d(p10.x() - p00.x(), p10.y() - p00.y()).length() / spx,
+                    osg::Vec2d(p01.x() - p00.x(), p01.y() - p00.y()).length() / spy);
+
+                double error = osg::Vec2d(interp.x() - exact.x(), interp.y() - exact.y()).length();
+
+                if (error > tolerance * spacing)
+                    return false;
+
+                if (std::abs(interp.z() - exact.z()) > Z_TOLERANCE)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Finds the coarsest lattice that interpolates within tolerance,
+    // or returns an empty one if it's cheaper to transform every point.
+    LatticePtr buildLattice(
+        const SpatialReference* from_srs,
+        const SpatialReference* to_srs,
+        double xmin, double ymin, double xmax, double ymax,
+        unsigned cols, unsigned rows)
+    {
+        auto lattice = std::make_shared<Lattice>();
+        const double tolerance = s_tolerance;
+
+        for (unsigned n = s_latticeSize; n <= MAX_LATTICE_SIZE; n = 2 * n - 1)
+        {
+            unsigned nx = std::min(n, cols);
+            unsigned ny = std::min(n, rows);
+
+            // the lattice plus its validation costs about 2*nx*ny transforms;
+            // past that point the approximation buys nothing.
+            if (2u * nx * ny >= cols * rows)
+                break;
+
+            lattice->nx = nx, lattice->ny = ny;
+            makeGrid(xmin, ymin, xmax, ymax, nx, ny, lattice->points);
+
+            if (!from_srs->transform(lattice->points, to_srs))
+                break;
+
+            if (validate(*lattice, from_srs, to_srs, xmin, ymin, xmax, ymax, cols, rows, tolerance))
+                return lattice;
+        }
+
+        return std::make_shared<Lattice>();
+    }
+
+    void interpolate(
+        const Lattice& lattice,
+        unsigned cols, unsigned rows,
+        std::vector<osg::Vec3d>& output)
+    {
+        const unsigned nx = lattice.nx, ny = lattice.ny;
+        const auto& L = lattice.points;
+
+        output.resize(cols * rows);
+
+        double fx = (double)(nx - 1) / (double)(cols - 1);
+        double fy = (double)(ny - 1) / (double)(rows - 1);
+
+        // column lookups are the same for every row
+        std::vector<unsigned> i0(cols);
+        std::vector<double> wx(cols);
+        for (unsigned s = 0; s < cols; ++s)
+        {
+            double u = (double)s * fx;
+            i0[s] = std::min((unsigned)u, nx - 2);
+            wx[s] = u - (double)i0[s];
+        }
+
+        for (unsigned t = 0; t < rows; ++t)
+        {
+            double v = (double)t * fy;
+            unsigned j = std::min((unsigned)v, ny - 2);
+            double wy = v - (double)j;
+
+            const osg::Vec3d* row0 = &L[j * nx];
+            const osg::Vec3d* row1 = &L[(j + 1) * nx];
+            osg::Vec3d* out = &output[t * cols];
+
+            for (unsigned s = 0; s < cols; ++s)
+            {
+                unsigned i = i0[s];
+                osg::Vec3d a = row0[i] + (row0[i + 1] - row0[i]) * wx[s];
+                osg::Vec3d b = row1[i] + (row1[i + 1] - row1[i]) * wx[s];
+                out[s] = a + (b - a) * wy;
+            }
+        }
+    }
+}
+
+bool
+ReprojectionGrid::transform(
+    const SpatialReference* from_srs,
+    const SpatialReference* to_srs,
+    double xmin, double ymin,
+    double xmax, double ymax,
+    unsigned cols, unsigned rows,
+    std::vector<osg::Vec3d>& output)
+{
+    OE_SOFT_ASSERT_AND_RETURN(from_srs != nullptr && to_srs != nullptr, false);
+    OE_SOFT_ASSERT_AND_RETURN(cols > 0 && rows > 0, false);
+
+    OE_PROFILING_ZONE;
+
+    LatticePtr lattice;
+
+    if (s_latticeSize >= 2u && cols >= 2u && rows >= 2u && !from_srs->isEquivalentTo(to_srs))
+    {
+        LatticeKey key{
+            from_srs->getKey(), to_srs->getKey(),
+            xmin, ymin, xmax, ymax,
+            cols, rows };
+
+        LatticeCache::Record record;
+        if (cache().get(key, record))
+        {
+            lattice = record.value();
+        }
+        else
+        {
+            lattice = buildLattice(from_srs, to_srs, xmin, ymin, xmax, ymax, cols, rows);
+            cache().insert(key, lattice);
+        }
+    }
+
+    if (lattice && !lattice->points.empty())
+    {
+        interpolate(*lattice, cols, rows, output);
+        return true;
+    }
+
+    makeGrid(xmin, ymin, xmax, ymax, cols, rows, output);
+    return from_srs->transform(output, to_srs);
+}
+
+void
+ReprojectionGrid::setLatticeSize(unsigned value)
+{
+    s_latticeSize = value;
+    clearCache();
+}
+
+unsigned
+ReprojectionGrid::getLatticeSize()
+{
+    return s_latticeSize;
+}
+
+void
+ReprojectionGrid::setTolerance(double value)
+{
+    s_tolerance = value;
+    clearCache();
+}
+
+double
+ReprojectionGrid::getTolerance()
+{
+    return s_tolerance;
+}
+
+void
+ReprojectionGrid::clearCache()
+{
+    cache().clear();
+}
@@ -7,6 +7,15 @@
 #include "Metrics"
 #include "FeatureSource"
 #include "FeatureRasterizer"
+#include "Threading"
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OE_SDF_SSE2
+#include <emmintrin.h>
+#endif
 
 using namespace osgEarth;
 using namespace osgEarth::Util;
@@ -17,6 +26,20 @@ namespace
         return (x & (x - 1)) == 0;
     }
 
+    // marks an unset coordinate in a nearest-neighbor field
+    constexpr float NODATA = 32767.0f;
+
+    // don't split work into bands smaller than this many rows (or columns)
+    constexpr unsigned MIN_BAND_SIZE = 16u;
+
+    // Calls func(begin, end) on bands of [0, count) rows (or columns), in
+    // parallel when there are enough of them.
+    template<typename FUNC>
+    inline void forEachBand(unsigned count, FUNC&& func)
+    {
+        Threading::parallelFor("SDF band", count, MIN_BAND_SIZE, MIN_BAND_SIZE, func);
+    }
+
     // https://www.comp.nus.edu.sg/~tants/jfa/i3d06.pdf
     const char* jfa_cs = R"(
     #version 430
@@ -185,24 +208,30 @@ SDFGenerator::createNearestNeighborField(
     // actually need to write to the GeoImage, and that's OK.
     osg::Image* nnimage = const_cast<osg::Image*>(nnfield.getImage());
 
+    OE_SOFT_ASSERT_AND_RETURN(nnimage->getPixelFormat() == GL_RG && nnimage->getDataType() == GL_FLOAT, false);
+
     ImageUtils::PixelReader read_raster(inputRaster.getImage());
-    ImageUtils::PixelWriter write_nnf(nnimage);
 
-    constexpr float NODATA = 32767.0f;
-    osg::Vec4f nodata(NODATA, NODATA, NODATA, NODATA);
-    osg::Vec4f pixel, coord;
-    GeoImageIterator iter(inputRaster);
-    iter.forEachPixel([&]()
+    const unsigned width = inputRaster.getImage()->s();
+    const unsigned height = inputRaster.getImage()->t();
+
+    // Seed the field: pixels with data point to themselves.
+    forEachBand(height, [&](unsigned t0, unsigned t1)
         {
-            read_raster(pixel, iter.s(), iter.t());
-            if ((!inverted && pixel.a() >= 0.5f) || (inverted && pixel.a() <= 0.5f))
-                coord.set((float)iter.s(), (float)iter.t(), 0.0f, 0.0f);
-            else
-                coord = nodata;
-            
-            write_nnf(coord, iter.s(), iter.t());
-        }
-    );
+            ImageUtils::PixelRow row;
+            for (unsigned t = t0; t < t1; ++t)
+            {
+                read_raster.readRow(row, t);
+                float* out = (float*)nnimage->data(0, t);
+                for (unsigned s = 0; s < width; ++s)
+                {
+                    float a = row.a[s];
+                    bool set = inverted ? (a <= 0.5f) : (a >= 0.5f);
+                    out[s * 2 + 0] = set ? (float)s : NODATA;
+                    out[s * 2 + 1] = set ? (float)t : NODATA;
+                }
+            }
+        });
 
     //if (_useGPU)
     //{
@@ -237,11 +266,6 @@ SDFGenerator::createDistanceField(
 
     ImageUtils::PixelReader read_nnf(nnfield.getImage());
     read_nnf.setBilinear(false);
-    
-    GeoImageIterator i(sdf);
-
-    osg::Vec4f me, closest, pixel;
-    int c = 0; // clamp((int)(channel - GL_RED), 0, 3);
 
     osg::Vec2f bias(
         (sdf.getExtent().xMin() - nnfield.getExtent().xMin()) / nnfield.getExtent().width(),
@@ -251,49 +275,55 @@ SDFGenerator::createDistanceField(
         sdf.getExtent().width() / nnfield.getExtent().width(),
         sdf.getExtent().height() / nnfield.getExtent().height());
 
-    //int bias_s = (nnfield.getImage()->s() - sdf.getImage()->s()) / 2;
-    //int bias_t = (nnfield.getImage()->t() - sdf.getImage()->t()) / 2;
+    const int nnf_s = nnfield.getImage()->s();
+    const int nnf_t = nnfield.getImage()->t();
+    const float cellSize = 1.0f / (float)(nnf_s - 1);
 
-    float nnf_u, nnf_v;
+    const unsigned width = sdfimage->s();
+    const unsigned height = sdfimage->t();
 
-    float cellSize = 1.0f / (float)(nnfield.getImage()->s() - 1);
-
-    i.forEachPixel([&]()
+    // Rows are independent, so each band reads, updates and writes back
+    // its own rows of the SDF. Only the first channel is updated.
+    forEachBand(height, [&](unsigned t0, unsigned t1)
         {
-            read_sdf(pixel, i.s(), i.t());
+            ImageUtils::PixelRow row;
+            osg::Vec4f me, closest;
 
-#if 0
-            // this code path assumes perfect centering
+            for (unsigned t = t0; t < t1; ++t)
+            {
+                read_sdf.readRow(row, t);
+                bool dirty = false;
 
-            int nnfs = i.s() + bias_s;
-            int nnft = i.t() + bias_t;
+                // convert ndc coords to the NNF domain
+                double v = ((double)t + 0.5) / (double)height;
+                float nnf_v = clamp(v * scale.y() + bias.y(), 0.0, 1.0);
 
-            me.set(nnfs, nnft, 0, 0);
-            read_nnf(closest, nnfs, nnft);
-#else
-            // convert ndc coords to the NNF domain
-            nnf_u = clamp(i.u() * scale.x() + bias.x(), 0.0, 1.0);
-            nnf_v = clamp(i.v() * scale.y() + bias.y(), 0.0, 1.0);
+                for (unsigned s = 0; s < width; ++s)
+                {
+                    double u = ((double)s + 0.5) / (double)width;
+                    float nnf_u = clamp(u * scale.x() + bias.x(), 0.0, 1.0);
 
-            me.set(
-                floor(nnf_u * nnfield.getImage()->s()),
-                floor(nnf_v * nnfield.getImage()->t()),
-                0, 0);
+                    me.set(floor(nnf_u * nnf_s), floor(nnf_v * nnf_t), 0, 0);
 
-            read_nnf(closest, nnf_u, nnf_v);
-#endif
+                    read_nnf(closest, nnf_u, nnf_v);
 
-            float d = distance2D(me, closest);
-            d = unitremap(d * cellSize * span, lo, hi);
-            if (d < pixel[c])
-            {
-                pixel[c] = d;
-                write_sdf(pixel, i.s(), i.t());
+                    float d = distance2D(me, closest);
+                    d = unitremap(d * cellSize * span, lo, hi);
+                    if (d < row.r[s])
+                    {
+                        row.r[s] = d;
+                        dirty = true;
+                    }
+                }
+
+                if (dirty)
+                {
+                    write_sdf.writeRow(row, t);
+                }
             }
         });
 }
 
-
 #if 0
 void
 SDFGenerator::compute_nnf_on_gpu(osg::Image* image) const
@@ -324,34 +354,97 @@ SDFGenerator::NNFSession::renderImplementation(osg::State* state)
 }
 #endif
 
-/*
-inline void readRGFloatPixel(ImageUtils::PixelReader& reader, osg::Vec4& pixel, unsigned int s, unsigned int t, unsigned int r=0)
+namespace
 {
-    const float* data = (const float*)(reader.data(s, t, r));
-    pixel.x() = float(*data++);
-    pixel.y() = float(*data++);
-}
+    // For pixels (s, t) with s in [s0, s1), considers the seed stored at
+    // column s+dx of (CX, CY) and keeps it in (X, Y, D) if it's closer
+    // than the best seed found so far. D holds squared distances.
+    inline void relaxSpan(
+        const float* CX, const float* CY,
+        float* X, float* Y, float* D,
+        float t, int s0, int s1, int dx)
+    {
+        int s = s0;
 
-inline void writeRGFloatPixel(ImageUtils::PixelWriter& writer, osg::Vec4& pixel, unsigned int s, unsigned int t, unsigned int r = 0)
-{
-    float* data = (float*)(writer.data(s, t, r));
-    *data++ = pixel.x();
-    *data++ = pixel.y();
-}
-*/
+#ifdef OE_SDF_SSE2
+        const __m128 vt = _mm_set1_ps(t);
+        const __m128 vnodata = _mm_set1_ps(NODATA);
+        const __m128 vmax = _mm_set1_ps(FLT_MAX);
+        const __m128 vfour = _mm_set1_ps(4.0f);
+        __m128 vs = _mm_setr_ps((float)s, (float)(s + 1), (float)(s + 2), (float)(s + 3));
 
-inline void readRGFloatPixel(float* grid, unsigned int w, unsigned int h, osg::Vec4& pixel, unsigned int s, unsigned int t)
-{
-    float *data = &grid[(t * w + s) * 2];
-    pixel.x() = *data++;
-    pixel.y() = *data++;
-}
+        for (; s + 4 <= s1; s += 4, vs = _mm_add_ps(vs, vfour))
+        {
+            __m128 cx = _mm_loadu_ps(CX + s + dx);
+            __m128 cy = _mm_loadu_ps(CY + s + dx);
+            __m128 ex = _mm_sub_ps(cx, vs);
+            __m128 ey = _mm_sub_ps(cy, vt);
+            __m128 d = _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey));
+
+            // unset seeds never win
+            __m128 set = _mm_cmpneq_ps(cx, vnodata);
+            d = _mm_or_ps(_mm_and_ps(set, d), _mm_andnot_ps(set, vmax));
+
+            __m128 best = _mm_loadu_ps(D + s);
+            __m128 closer = _mm_cmplt_ps(d, best);
+            _mm_storeu_ps(D + s, _mm_or_ps(_mm_and_ps(closer, d), _mm_andnot_ps(closer, best)));
+            _mm_storeu_ps(X + s, _mm_or_ps(_mm_and_ps(closer, cx), _mm_andnot_ps(closer, _mm_loadu_ps(X + s))));
+            _mm_storeu_ps(Y + s, _mm_or_ps(_mm_and_ps(closer, cy), _mm_andnot_ps(closer, _mm_loadu_ps(Y + s))));
+        }
+#endif
 
-inline void writeRGFloatPixel(float* grid, unsigned int w, unsigned int h, osg::Vec4& pixel, unsigned int s, unsigned int t)
-{
-    float* data = &grid[(t * w + s) * 2];
-    *data++ = pixel.x();
-    *data++ = pixel.y();
+        for (; s < s1; ++s)
+        {
+            float cx = CX[s + dx], cy = CY[s + dx];
+            float ex = cx - (float)s, ey = cy - t;
+            float d = cx != NODATA ? ex * ex + ey * ey : FLT_MAX;
+            if (d < D[s])
+            {
+                D[s] = d, X[s] = cx, Y[s] = cy;
+            }
+        }
+    }
+
+    // One jump-flood step over rows [t0, t1). Each pixel looks at the seeds
+    // of its eight neighbors at distance L (and its own) and keeps the
+    // closest one. This "gather" form reads one buffer and writes the other,
+    // so bands of rows can run in parallel.
+    void jumpFloodRows(
+        const float* inX, const float* inY,
+        float* outX, float* outY,
+        int width, int height, int L,
+        unsigned t0, unsigned t1)
+    {
+        std::vector<float> D(width);
+
+        for (int t = (int)t0; t < (int)t1; ++t)
+        {
+            float* X = outX + t * width;
+            float* Y = outY + t * width;
+            std::fill(X, X + width, NODATA);
+            std::fill(Y, Y + width, NODATA);
+            std::fill(D.begin(), D.end(), FLT_MAX);
+
+            for (int rt = t - L; rt <= t + L; rt += L)
+            {
+                if (rt < 0 || rt >= height)
+                    continue;
+
+                const float* CX = inX + rt * width;
+                const float* CY = inY + rt * width;
+
+                for (int dx = -L; dx <= L; dx += L)
+                {
+                    int s0 = std::max(0, -dx);
+                    int s1 = std::min(width, width - dx);
+                    if (s0 < s1)
+                    {
+                        relaxSpan(CX, CY, X, Y, D.data(), (float)t, s0, s1, dx);
+                    }
+                }
+            }
+        }
+    }
 }
 
 void
@@ -361,72 +454,55 @@ SDFGenerator::compute_nnf_on_cpu(osg::Image* buf) const
 
     // Jump-Flood algorithm for computing discrete voronoi
     // https://www.comp.nus.edu.sg/~tants/jfa/i3d06.pdf
-    osg::Vec4f pixel_points_to;
-    osg::Vec4f remote;
-    osg::Vec4f remote_points_to;
+    // The buffer is GL_RG float. We split it into separate X and Y planes
+    // (ping-ponged between passes) so the inner loops vectorize.
+    const int n = buf->s();
+    const int width = buf->s();
+    const int height = buf->t();
+    const std::size_t size = (std::size_t)width * (std::size_t)height;
 
-    // There are many read/write accesses in a tight loop in this algorithm so it is much faster to access
-    // the raw image data directly by pointer using a known format (GL_RG float) rather than use the PixelReader functions.
-    
-    //ImageUtils::PixelReader readBuf(buf);
-    //ImageUtils::PixelWriter writeBuf(buf);
-    int n = buf->s();
-    constexpr float NODATA = 32767;
+    std::vector<float> ax(size), ay(size), bx(size), by(size);
 
-    unsigned int imageWidth = buf->s();
-    unsigned int imageHeight = buf->t();
-    float* imageData = (float*)(buf->data());
+    forEachBand(height, [&](unsigned t0, unsigned t1)
+        {
+            for (unsigned t = t0; t < t1; ++t)
+            {
+                const float* in = (const float*)buf->data(0, t);
+                float* X = &ax[t * width];
+                float* Y = &ay[t * width];
+                for (int s = 0; s < width; ++s)
+                {
+                    X[s] = in[s * 2 + 0];
+                    Y[s] = in[s * 2 + 1];
+                }
+            }
+        });
 
     for (int L = n / 2; L >= 1; L /= 2)
     {
-        for (int iterT = 0; iterT < buf->t(); ++iterT)
-        {
-            for (int iterS = 0; iterS < buf->s(); ++iterS)
+        forEachBand(height, [&](unsigned t0, unsigned t1)
             {
-                readRGFloatPixel(imageData, imageWidth, imageHeight, pixel_points_to, iterS, iterT);
+                jumpFloodRows(ax.data(), ay.data(), bx.data(), by.data(), width, height, L, t0, t1);
+            });
+
+        std::swap(ax, bx);
+        std::swap(ay, by);
+    }
 
-                // no data at this pixel yet? skip it; there is nothing to propagate.
-                if (pixel_points_to.x() != NODATA)
+    forEachBand(height, [&](unsigned t0, unsigned t1)
+        {
+            for (unsigned t = t0; t < t1; ++t)
+            {
+                float* out = (float*)buf->data(0, t);
+                const float* X = &ax[t * width];
+                const float* Y = &ay[t * width];
+                for (int s = 0; s < width; ++s)
                 {
-                    for (int s = iterS - L; s <= iterS + L; s += L)
-                    {
-                        if (s < 0 || s >= buf->s())
-                            continue;
-
-                        remote[0] = (float)s;
-
-                        for (int t = iterT - L; t <= iterT + L; t += L)
-                        {
-                            if (t < 0 || t >= buf->t())
-                                continue;
-                            if (s == iterS && t == iterT)
-                                continue;
-
-                            remote[1] = (float)t;
-
-                            readRGFloatPixel(imageData, imageWidth, imageHeight, remote_points_to, s, t);
-
-                            if (remote_points_to.x() == NODATA) // remote is unset? Just copy
-                            {
-                                writeRGFloatPixel(imageData, imageWidth, imageHeight, pixel_points_to, s, t);
-                            }
-                            else
-                            {
-                                // compare the distances and pick the closest.
-                                float d_existing = distanceSquared2D(remote, remote_points_to);
-                                float d_possible = distanceSquared2D(remote, pixel_points_to);
-
-                                if (d_possible < d_existing)
-                                {
-                                    writeRGFloatPixel(imageData, imageWidth, imageHeight, pixel_points_to, s, t);
-                                }
-                            }
-                        }
-                    }
+                    out[s * 2 + 0] = X[s];
+                    out[s * 2 + 1] = Y[s];
                 }
             }
-        }
-    }
+        });
 }
 
 #define INF 1E20
@@ -465,50 +541,89 @@ static void edt1d(const float* f, float* d, int* v, float* z, unsigned int n) {
 }
 
 //! https://www.theoryofcomputing.org/articles/v008a019/v008a019.pdf
-//! Compute the 2d distance transform of a grid of floats
+//! Compute the 2d distance transform of a grid of floats.
+//! Columns (then rows) are independent, so each pass is split into bands
+//! that run in parallel.
 //! @param grid A 2d grid of floats
 //! @param width The width of the grid
 //! @param height The height of the grid
 void edt2d(float* grid, unsigned int width, unsigned int height)
 {
-    unsigned int maxLength = std::max(width, height);
-    float* f = new float[maxLength];
-    float* d = new float[maxLength];
-    int* v = new int[maxLength];
-    float* z = new float[maxLength + 1u];
-
-    // process columns
-    for (unsigned x = 0; x < width; ++x) {
-        for (unsigned y = 0; y < height; ++y) {
-            f[y] = grid[width * y + x];
-        }
-        // Do the distance transform.
-        edt1d(f, d, v, z, height);
-        // Copy d back into the grid
-        for (unsigned y = 0; y < height; ++y) {
-            grid[width * y + x] = d[y];
-        }        
-    }
+    // process columns. Gathering one column at a time strides through the
+    // whole grid, so we gather a block of adjacent columns per row instead.
+    constexpr unsigned BLOCK = 16u;
+
+    forEachBand(width, [&](unsigned x0, unsigned x1)
+        {
+            std::vector<float> f(BLOCK * height), d(height), z(height + 1u);
+            std::vector<int> v(height);
+
+            for (unsigned xb = x0; xb < x1; xb += BLOCK)
+            {
+                unsigned count = std::min(BLOCK, x1 - xb);
+
+                for (unsigned y = 0; y < height; ++y) {
+                    const float* in = &grid[width * y + xb];
+                    for (unsigned k = 0; k < count; ++k)
+                        f[k * height + y] = in[k];
+                }
+
+                for (unsigned k = 0; k < count; ++k) {
+                    // Do the distance transform, and keep it in f
+                    edt1d(&f[k * height], d.data(), v.data(), z.data(), height);
+                    std::memcpy(&f[k * height], d.data(), height * sizeof(float));
+                }
+
+                // Copy the block back into the grid
+                for (unsigned y = 0; y < height; ++y) {
+                    float* out = &grid[width * y + xb];
+                    for (unsigned k = 0; k < count; ++k)
+                        out[k] = f[k * height + y];
+                }
+            }
+        });
 
     // process rows
-    for (unsigned y = 0; y < height; ++y) {
-        for (unsigned x = 0; x < width; ++x) {
-            f[x] = grid[width * y + x];
-        }
+    forEachBand(height, [&](unsigned y0, unsigned y1)
+        {
+            std::vector<float> d(width), z(width + 1u);
+            std::vector<int> v(width);
+
+            for (unsigned y = y0; y < y1; ++y) {
+                float* row = &grid[width * y];
+                // Do the distance transform and copy d back into the grid
+                edt1d(row, d.data(), v.data(), z.data(), width);
+                std::memcpy(row, d.data(), width * sizeof(float));
+            }
+        });
+}
 
-        // Do the distance transform
-        edt1d(f, d, v, z, width);
+namespace
+{
+    // Converts squared pixel distances to normalized [0..1] values
+    inline void remapDistances(const float* in, float* out, unsigned count, float lo, float hi)
+    {
+        const float scale = 1.0f / (hi - lo);
+        unsigned i = 0;
+
+#ifdef OE_SDF_SSE2
+        const __m128 vlo = _mm_set1_ps(lo);
+        const __m128 vscale = _mm_set1_ps(scale);
+        const __m128 vzero = _mm_setzero_ps();
+        const __m128 vone = _mm_set1_ps(1.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 d = _mm_sqrt_ps(_mm_loadu_ps(in + i));
+            d = _mm_mul_ps(_mm_sub_ps(d, vlo), vscale);
+            _mm_storeu_ps(out + i, _mm_min_ps(_mm_max_ps(d, vzero), vone));
+        }
+#endif
 
-        // Copy d back into the grid
-        for (unsigned x = 0; x < width; ++x) {
-            grid[width * y + x] = d[x];
+        for (; i < count; ++i)
+        {
+            out[i] = clamp((std::sqrt(in[i]) - lo) * scale, 0.0f, 1.0f);
         }
     }
-
-    delete[] f;
-    delete[] d;
-    delete[] v;
-    delete[] z;
 }
 
 osg::Image* SDFGenerator::createDistanceField(const osg::Image* image, float minPixels, float maxPixels) const
@@ -520,20 +635,19 @@ osg::Image* SDFGenerator::createDistanceField(const osg::Image* image, float min
     unsigned int width = image->s();
     unsigned int height = image->t();
 
-    // Initialize the grid to INF
-    std::vector<float> grid(width * height, INF);
-
-    // Mark pixels with alpha > 0 as having a distance of 0
-    for (unsigned int y = 0; y < height; ++y) {
-        for (unsigned int x = 0; x < width; ++x) {
-            osg::Vec4 pixel;
-            read(pixel, x, y);
-            float a = pixel.a();
-            if (a > 0.0f) {
-                grid[y * width + x] = 0;
+    // Mark pixels with alpha > 0 as having a distance of 0, and the rest INF
+    std::vector<float> grid(width * height);
+
+    forEachBand(height, [&](unsigned y0, unsigned y1)
+        {
+            ImageUtils::PixelRow row;
+            for (unsigned y = y0; y < y1; ++y) {
+                read.readRow(row, y);
+                float* out = &grid[width * y];
+                for (unsigned x = 0; x < width; ++x)
+                    out[x] = row.a[x] > 0.0f ? 0.0f : (float)INF;
             }
-        }
-    }
+        });
 
     // Compute the distance transform
     edt2d(grid.data(), width, height);
@@ -543,21 +657,21 @@ osg::Image* SDFGenerator::createDistanceField(const osg::Image* image, float min
     sdf->allocateImage(width, height, 1, GL_RED, GL_UNSIGNED_BYTE);
     sdf->setInternalTextureFormat(GL_R8);
 
-    osg::Vec4 p;
-
     ImageUtils::PixelWriter write(sdf.get());
-    write.assign(Color(1, 1, 1, 1));
-    for (unsigned y = 0; y < height; ++y)
-    {
-        for (unsigned x = 0; x < width; ++x)
+
+    forEachBand(height, [&](unsigned y0, unsigned y1)
         {
-            // The distance computed is the square distance, so take the square root here to get the actual distance
-            float d = sqrt(grid[width * y + x]);
-            // Remap the value between 0 and 1
-            float value = unitremap(d, minPixels, maxPixels);
-            p.set(value, 1.0, 1.0, 1.0);
-            write(p, x, y);
-        }
-    }
+            ImageUtils::PixelRow row;
+            row.resize(width);
+
+            for (unsigned y = y0; y < y1; ++y)
+            {
+                // The distance computed is the square distance, so take the square root
+                // to get the actual distance, and remap the value between 0 and 1
+                remapDistances(&grid[width * y], row.r.data(), width, minPixels, maxPixels);
+                write.writeRow(row, y);
+            }
+        });
+
     return sdf.release();
 }
\ No newline at end of file
@@ -304,6 +304,51 @@ Tile::fromJSON(const Json::Value& value, LoadContext& uc)
     }
 }
 
+void
+Tile::fromJSON(const Json::View& value, LoadContext& uc)
+{
+    // Walk the members once and decode only the small ones; the children
+    // are read straight from the text, so a large tileset is never built
+    // into a Json::Value tree.
+    value.forEachMember([&](const std::string& key, const Json::View& member)
+    {
+        Json::Value small;
+
+        if (key == "boundingVolume" && member.materialize(small))
+            boundingVolume() = small;
+        else if (key == "viewerRequestVolume" && member.materialize(small))
+            viewerRequestVolume() = small;
+        else if (key == "geometricError")
+            geometricError() = member.asDouble(0.0);
+        else if (key == "content" && member.materialize(small))
+            content() = TileContent(small, uc);
+        else if (key == "refine")
+            refine() = osgEarth::ciEquals(member.asString(), "ADD") ? REFINE_ADD : REFINE_REPLACE;
+        else if (key == "transform")
+        {
+            std::vector<double> c;
+            member.forEach([&](const Json::View& digit)
+            {
+                c.push_back(digit.asDouble());
+                return c.size() <= 16;
+            });
+            if (c.size() == 16)
+                transform() = osg::Matrix(c.data());
+        }
+        else if (key == "children")
+        {
+            member.forEach([&](const Json::View& child)
+            {
+                osg::ref_ptr<Tile> tile = new Tile(child, uc);
+                children().push_back(tile.get());
+                return true;
+            });
+        }
+
+        return true;
+    });
+}
+
 Json::Value
 Tile::getJSON() const
 {
@@ -398,6 +443,26 @@ Tileset::fromJSON(const Json::Value& value, LoadContext& uc)
         root() = new Tile(value["root"], uc);
 }
 
+void
+Tileset::fromJSON(const Json::View& value, LoadContext& uc)
+{
+    value.forEachMember([&](const std::string& key, const Json::View& member)
+    {
+        Json::Value small;
+
+        if (key == "asset" && member.materialize(small))
+            asset() = Asset(small);
+        else if (key == "boundingVolume" && member.materialize(small))
+            boundingVolume() = BoundingVolume(small);
+        else if (key == "geometricError")
+            geometricError() = member.asDouble(0.0);
+        else if (key == "root")
+            root() = new Tile(member, uc);
+
+        return true;
+    });
+}
+
 Json::Value
 Tileset::getJSON() const
 {
@@ -416,15 +481,14 @@ Tileset::getJSON() const
 Tileset*
 Tileset::create(const std::string& json, const URIContext& uc)
 {
-    Json::Reader reader;
-    Json::Value root(Json::objectValue);
-    if (!reader.parse(json, root, false))
+    Json::Document doc;
+    if (!doc.load(json) || !doc.root().isObject())
         return NULL;
 
     LoadContext lc;
     lc._uc = uc;
 
-    return new Tileset(root, lc);
+    return new Tileset(doc.root(), lc);
 }
 
 static VirtualProgram* getOrCreateDebugVirtualProgram()
@@ -39,6 +39,7 @@ TerrainOptions::getConfig() const
     conf.set( "min_expiry_frames", _minExpiryFrames);
     conf.set( "min_resident_tiles", minResidentTiles());
     conf.set( "max_tiles_to_unload_per_frame", _maxTilesToUnloadPerFrame);
+    conf.set( "memory_budget_mb", memoryBudget());
     conf.set( "cast_shadows", _castShadows);
     conf.set( "tile_pixel_size", _tilePixelSize);
     conf.set( "lod_method", "screen_space", _lodMethod, LODMethod::SCREEN_SPACE);
@@ -57,6 +58,8 @@ TerrainOptions::getConfig() const
     conf.set( "priority_scale", priorityScale() );
     conf.set( "texture_compression", textureCompression());
     conf.set( "concurrency", concurrency());
+    conf.set( "load_layers_in_parallel", loadLayersInParallel());
+    conf.set( "layer_load_timeout", layerLoadTimeout());
     conf.set( "use_land_cover", useLandCover() );
     //conf.set("screen_space_error", screenSpaceError()); // don't serialize me, i'm set by the MapNode
     conf.set("max_texture_size", maxTextureSize());
@@ -64,6 +67,8 @@ TerrainOptions::getConfig() const
     conf.set("create_tiles_async", createTilesAsync());
     conf.set("create_tiles_grouped", createTilesGrouped());
     conf.set("restrict_polar_subdivision", restrictPolarSubdivision());
+    conf.set("prefetch_frames", prefetchFrames());
+    conf.set("prefetches_per_frame", prefetchesPerFrame());
 
     conf.set("expiration_range", minExpiryRange()); // legacy
     conf.set("expiration_threshold", minResidentTiles()); // legacy
@@ -95,6 +100,7 @@ TerrainOptions::fromConfig(const Config& conf)
     conf.get( "min_expiry_frames", _minExpiryFrames);
     conf.get( "min_resident_tiles", minResidentTiles());
     conf.get( "max_tiles_to_unload_per_frame", _maxTilesToUnloadPerFrame);
+    conf.get( "memory_budget_mb", memoryBudget());
     conf.get( "cast_shadows", _castShadows);
     conf.get( "tile_pixel_size", _tilePixelSize);
     conf.get( "lod_method", "screen_space", _lodMethod, LODMethod::SCREEN_SPACE);
@@ -113,6 +119,8 @@ TerrainOptions::fromConfig(const Config& conf)
     conf.get( "priority_scale", priorityScale());
     conf.get( "texture_compression", textureCompression());
     conf.get( "concurrency", concurrency());
+    conf.get( "load_layers_in_parallel", loadLayersInParallel());
+    conf.get( "layer_load_timeout", layerLoadTimeout());
     conf.get( "use_land_cover", useLandCover());
     //conf.get("screen_space_error", screenSpaceError()); // don't serialize me, i'm set by the MapNode
     conf.get("max_texture_size", maxTextureSize());
@@ -121,6 +129,8 @@ TerrainOptions::fromConfig(const Config& conf)
     conf.get("create_tiles_async", createTilesAsync());
     conf.get("create_tiles_grouped", createTilesGrouped());
     conf.get("restrict_polar_subdivision", restrictPolarSubdivision());
+    conf.get("prefetch_frames", prefetchFrames());
+    conf.get("prefetches_per_frame", prefetchesPerFrame());
 
     conf.get("expiration_range", minExpiryRange()); // legacy
     conf.get("expiration_threshold", minResidentTiles()); // legacy
@@ -187,6 +197,7 @@ OE_OPTION_IMPL(TerrainOptionsAPI, double, MinExpiryTime, minExpiryTime);
 OE_OPTION_IMPL(TerrainOptionsAPI, float, MinExpiryRange, minExpiryRange);
 OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, MaxTilesToUnloadPerFrame, maxTilesToUnloadPerFrame);
 OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, MinResidentTiles, minResidentTiles);
+OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, MemoryBudget, memoryBudget);
 OE_OPTION_IMPL(TerrainOptionsAPI, float, HeightFieldSkirtRatio, heightFieldSkirtRatio);
 OE_OPTION_IMPL(TerrainOptionsAPI, Color, Color, color);
 OE_OPTION_IMPL(TerrainOptionsAPI, bool, Progressive, progressive);
@@ -199,12 +210,16 @@ OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, MergesPerFrame, mergesPerFrame);
 OE_OPTION_IMPL(TerrainOptionsAPI, float, PriorityScale, priorityScale);
 OE_OPTION_IMPL(TerrainOptionsAPI, std::string, TextureCompressionMethod, textureCompression);
 OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, Concurrency, concurrency);
+OE_OPTION_IMPL(TerrainOptionsAPI, bool, LoadLayersInParallel, loadLayersInParallel);
+OE_OPTION_IMPL(TerrainOptionsAPI, double, LayerLoadTimeout, layerLoadTimeout);
 OE_OPTION_IMPL(TerrainOptionsAPI, float, ScreenSpaceError, screenSpaceError);
 OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, MaxTextureSize, maxTextureSize);
 OE_OPTION_IMPL(TerrainOptionsAPI, bool, Visible, visible);
 OE_OPTION_IMPL(TerrainOptionsAPI, bool, CreateTilesAsync, createTilesAsync);
 OE_OPTION_IMPL(TerrainOptionsAPI, bool, CreateTilesGrouped, createTilesGrouped);
 OE_OPTION_IMPL(TerrainOptionsAPI, bool, RestrictPolarSubdivision, restrictPolarSubdivision);
+OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, PrefetchFrames, prefetchFrames);
+OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, PrefetchesPerFrame, prefetchesPerFrame);
 
 bool
 TerrainOptionsAPI::getGPUTessellation() const
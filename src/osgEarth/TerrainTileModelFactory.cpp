@@ -12,6 +12,9 @@
 
 #include <osg/Texture2D>
 #include <osg/Texture2DArray>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 
 #define LC "[TerrainTileModelFactory] "
 
@@ -143,6 +146,12 @@ TerrainTileModelFactory::createTileModel(
         key,
         map->getDataModelRevision() );
 
+    if (_options.loadLayersInParallel() == true)
+    {
+        addLayersInParallel(model.get(), map, key, manifest, require, progress);
+        return model.release();
+    }
+
     // assemble all the components:
     addColorLayers(model.get(), map, require, key, manifest, progress, false);
 
@@ -397,6 +406,290 @@ TerrainTileModelFactory::addColorLayers(
     }
 }
 
+namespace
+{
+    // Moves whatever a partial (per-layer) model produced into the final model.
+    void splice(TerrainTileModel* model, TerrainTileModel* part)
+    {
+        for (unsigned i = 0; i < part->colorLayers.size(); ++i)
+        {
+            auto& shared = part->sharedLayerIndices;
+            if (std::find(shared.begin(), shared.end(), i) != shared.end())
+            {
+                model->sharedLayerIndices.push_back(model->colorLayers.size());
+            }
+            model->colorLayers.push_back(std::move(part->colorLayers[i]));
+        }
+
+        if (part->elevation.texture)
+            model->elevation = std::move(part->elevation);
+
+        if (part->normalMap.texture)
+            model->normalMap = std::move(part->normalMap);
+
+        if (part->landCover.texture)
+            model->landCover = std::move(part->landCover);
+
+        if (part->mesh.verts.valid())
+            model->mesh = std::move(part->mesh);
+
+        model->requiresUpdateTraversal =
+            model->requiresUpdateTraversal || part->requiresUpdateTraversal;
+    }
+}
+
+void
+TerrainTileModelFactory::addLayersInParallel(
+    TerrainTileModel* model,
+    const Map* map,
+    const TileKey& key,
+    const CreateTileManifest& manifest,
+    const TerrainEngineRequirements& require,
+    ProgressCallback* progress)
+{
+    OE_PROFILING_ZONE;
+
+    // One task per data source. Each one writes into its own partial model so
+    // the tasks never touch shared state; we splice the parts together in map
+    // order once they all finish. No task outlives this call (see below), so
+    // the tasks can safely use this factory and the map directly.
+    using Clock = std::chrono::steady_clock;
+
+    // When a task ran, and whether it overran its deadline
+    struct Timing
+    {
+        std::atomic<Clock::rep> start{ 0 }; // 0 = not started yet
+        std::atomic_bool late{ false };
+        std::atomic_bool done{ false };
+    };
+
+    struct Task
+    {
+        std::string name;
+        std::function<void(TerrainTileModel*, ProgressCallback*)> run;
+        osg::ref_ptr<TerrainTileModel> part;
+        osg::ref_ptr<ProgressCallback> progress;
+        std::shared_ptr<Timing> timing;
+        std::function<bool()> expired;
+        Future<bool> result;
+    };
+    std::vector<Task> tasks;
+
+    LayerVector layers;
+    map->getLayers(layers);
+
+    for (auto& layer : layers)
+    {
+        if (!layer->isOpen() ||
+            layer->getRenderType() != layer->RENDERTYPE_TERRAIN_SURFACE ||
+            manifest.excludes(layer.get()))
+        {
+            continue;
+        }
+
+        Task task;
+        task.name = layer->getName();
+
+        ImageLayer* imageLayer = dynamic_cast<ImageLayer*>(layer.get());
+        if (imageLayer)
+        {
+            task.run = [this, imageLayer, &key, &require](TerrainTileModel* part, ProgressCallback* p) {
+                addImageLayer(part, imageLayer, key, require, p);
+            };
+        }
+        else // non-image kind of TILE layer (e.g., splatting); no I/O
+        {
+            task.part = new TerrainTileModel(key, model->revision);
+            TerrainTileModel::ColorLayer colorModel;
+            colorModel.layer = layer;
+            colorModel.revision = layer->getRevision();
+            task.part->colorLayers.push_back(std::move(colorModel));
+        }
+        tasks.emplace_back(std::move(task));
+    }
+
+    if (require.elevationTextures)
+    {
+        unsigned border = (require.elevationBorder) ? 1u : 0u;
+        Task task;
+        task.name = "elevation";
+        task.run = [this, map, &key, &manifest, border](TerrainTileModel* part, ProgressCallback* p) {
+            addElevation(part, map, key, manifest, border, p);
+        };
+        tasks.emplace_back(std::move(task));
+    }
+
+    if (require.landCoverTextures)
+    {
+        Task task;
+        task.name = "land cover";
+        task.run = [this, map, &key, &require, &manifest](TerrainTileModel* part, ProgressCallback* p) {
+            addLandCover(part, map, key, require, manifest, p);
+        };
+        tasks.emplace_back(std::move(task));
+    }
+
+    if (require.tileMesh && key.getLOD() <= _options.maxLOD().value())
+    {
+        Task task;
+        task.name = "mesh";
+        task.run = [this, map, &key, &require, &manifest](TerrainTileModel* part, ProgressCallback* p) {
+            addMesh(part, map, key, require, manifest, p);
+        };
+        tasks.emplace_back(std::move(task));
+    }
+
+    // Each layer gets its own deadline, counted from when its task starts
+    // running, so a layer queued behind others is not charged for the wait.
+    const double timeout = _options.layerLoadTimeout().value();
+    const Clock::rep timeoutTicks = timeout > 0.0 ?
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(timeout)).count() : 0;
+
+    // Set once we stop waiting; tells running tasks to quit and queued ones to skip.
+    auto abandoned = std::make_shared<std::atomic_bool>(false);
+
+    // Dispatch all but the last I/O task; run that one on this thread
+    // so the calling job does useful work instead of just waiting.
+    Task* inlineTask = nullptr;
+    for (auto& task : tasks)
+    {
+        if (!task.run)
+            continue;
+
+        auto timing = std::make_shared<Timing>();
+        task.timing = timing;
+        task.expired = [timing, timeoutTicks]() {
+            if (timing->done)
+                return timing->late.load();
+            Clock::rep t0 = timing->start;
+            return timeoutTicks > 0 && t0 != 0 && Clock::now().time_since_epoch().count() - t0 > timeoutTicks;
+        };
+
+        auto expired = task.expired;
+        task.part = new TerrainTileModel(key, model->revision);
+        task.progress = new ProgressCallback(progress, [abandoned, expired]() {
+            return abandoned->load() || expired();
+        });
+
+        if (inlineTask)
+        {
+            auto run = inlineTask->run;
+            auto part = inlineTask->part;
+            auto childProgress = inlineTask->progress;
+            auto childTiming = inlineTask->timing;
+            auto childExpired = inlineTask->expired;
+
+            jobs::context context;
+            context.name = inlineTask->name;
+            context.pool = jobs::get_pool(ARENA_TERRAIN_LAYERS);
+
+            inlineTask->result = jobs::dispatch([run, part, childProgress, childTiming, childExpired, abandoned](Cancelable& c)
+                {
+                    if (!c.canceled() && !abandoned->load())
+                    {
+                        childTiming->start = Clock::now().time_since_epoch().count();
+                        run(part.get(), childProgress.get());
+                        childTiming->late = childExpired();
+                        childTiming->done = true;
+                    }
+                    return true;
+                },
+                context);
+        }
+        inlineTask = &task;
+    }
+
+    if (inlineTask)
+    {
+        inlineTask->timing->start = Clock::now().time_since_epoch().count();
+        inlineTask->run(inlineTask->part.get(), inlineTask->progress.get());
+        inlineTask->timing->late = inlineTask->expired();
+        inlineTask->timing->done = true;
+        inlineTask->result.resolve(true);
+    }
+
+    // Wait for the rest, bailing out if the caller cancels or a layer runs
+    // out of time.
+    Task* timedOut = nullptr;
+    for (auto& task : tasks)
+    {
+        if (!task.run)
+            continue;
+
+        osg::ref_ptr<ProgressCallback> waiter = new ProgressCallback(progress, task.expired);
+        task.result.join(waiter.get());
+
+        // a task that ran out of time may still have finished, with partial data
+        if (task.expired())
+        {
+            timedOut = &task;
+            break;
+        }
+        if (!task.result.available())
+        {
+            break;
+        }
+    }
+
+    // Make sure no task is still using this factory or the map when we
+    // return. Queued tasks skip their work, and running ones see their
+    // progress canceled and return as soon as the layer checks it.
+    bool incomplete = std::any_of(tasks.begin(), tasks.end(), [](const Task& task) {
+        return task.run && !task.result.available(); });
+
+    if (incomplete || timedOut)
+    {
+        abandoned->store(true);
+        for (auto& task : tasks)
+        {
+            if (task.run)
+                task.result.join();
+        }
+    }
+
+    // A layer that timed out cancels the tile with a retry delay, so the
+    // engine requests it again later instead of keeping a tile without that
+    // layer. A task that canceled itself (e.g., a recoverable network
+    // error) does the same, just like the sequential path would.
+    if (progress && !progress->canceled())
+    {
+        float retryDelay = -1.0f;
+
+        if (timedOut)
+        {
+            OE_DEBUG << LC << "Layer \"" << timedOut->name << "\" timed out for "
+                << key.str() << "; will retry" << std::endl;
+            retryDelay = (float)timeout;
+        }
+        else
+        {
+            for (auto& task : tasks)
+            {
+                if (task.progress.valid() && task.progress->canceled())
+                    retryDelay = std::max(retryDelay, task.progress->getRetryDelay());
+            }
+        }
+
+        if (retryDelay >= 0.0f)
+        {
+            progress->setRetryDelay(std::max(progress->getRetryDelay(), retryDelay));
+            progress->cancel();
+        }
+    }
+
+    // no progress callback to cancel? keep whatever completed.
+    for (auto& task : tasks)
+    {
+        if (timedOut == &task)
+            continue;
+
+        if (task.progress.valid() && task.progress->canceled())
+            continue;
+
+        splice(model, task.part.get());
+    }
+}
+
 void
 TerrainTileModelFactory::addElevation(
     TerrainTileModel*            model,
@@ -3,6 +3,8 @@
  * MIT License
  */
 #include "Threading"
+#include <algorithm>
+#include <condition_variable>
 #include <cstdlib>
 #include <climits>
 #include <cstring>
@@ -49,3 +51,90 @@ void osgEarth::setThreadName(const std::string& name)
     }
 #endif
 }
+
+namespace
+{
+    struct ParallelFor
+    {
+        std::atomic<unsigned> next = { 0u };
+        unsigned count = 0u;
+        unsigned chunkSize = 1u;
+        unsigned chunks = 0u;
+        unsigned finished = 0u;
+        std::mutex mutex;
+        std::condition_variable done;
+        const std::function<void(unsigned, unsigned)>* func = nullptr;
+
+        // Runs chunks until none are left. A helper that starts after the
+        // last chunk is claimed leaves without touching func, which may be
+        // gone by then.
+        void run()
+        {
+            unsigned ran = 0u;
+            for (unsigned begin = next.fetch_add(chunkSize); begin < count; begin = next.fetch_add(chunkSize))
+            {
+                (*func)(begin, std::min(begin + chunkSize, count));
+                ++ran;
+            }
+
+            if (ran > 0u)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished += ran;
+                if (finished == chunks)
+                    done.notify_all();
+            }
+        }
+    };
+
+    jobs::jobpool* parallelForPool()
+    {
+        static jobs::jobpool* pool = []()
+        {
+            auto* p = jobs::get_pool(ARENA_PARALLEL_FOR);
+            p->set_concurrency(std::max(2u, std::thread::hardware_concurrency()));
+            p->set_can_steal_work(false);
+            return p;
+        }();
+        return pool;
+    }
+}
+
+void
+Threading::parallelFor(const char* name, unsigned count, unsigned minPerThread, unsigned chunkSize,
+    const std::function<void(unsigned, unsigned)>& func)
+{
+    if (count == 0u)
+        return;
+
+    chunkSize = std::max(1u, chunkSize);
+    unsigned chunks = (count + chunkSize - 1u) / chunkSize;
+
+    auto* pool = parallelForPool();
+    unsigned threads = std::min(pool->concurrency() + 1u, count / std::max(1u, minPerThread));
+    threads = std::min(threads, chunks);
+    if (threads <= 1u)
+    {
+        func(0u, count);
+        return;
+    }
+
+    // shared with the helpers, which may outlive this call
+    auto state = std::make_shared<ParallelFor>();
+    state->count = count;
+    state->chunkSize = chunkSize;
+    state->chunks = chunks;
+    state->func = &func;
+
+    jobs::context job;
+    job.name = name;
+    job.pool = pool;
+
+    for (unsigned t = 1u; t < threads; ++t)
+        jobs::dispatch([state]() { state->run(); }, job);
+
+    state->run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&]() { return state->finished == state->chunks; });
+}
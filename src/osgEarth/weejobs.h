@@ -10,7 +10,9 @@
 #include <chrono>
 #include <condition_variable>
 #include <cstdlib>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <type_traits>
@@ -273,6 +275,23 @@ namespace WEEJOBS_NAMESPACE
         bool can_cancel = true; // if true, the job will cancel if its future goes out of scope
     };
 
+    /**
+    * How a jobpool chooses the next job to run.
+    */
+    enum class scheduling
+    {
+        //! Evaluate the priority of every queued job on every take and run the
+        //! highest. Always current, but each take costs one priority call per
+        //! queued job while holding the queue lock.
+        exact,
+
+        //! Keep the queue in a heap of cached priorities that are re-evaluated
+        //! in batches (see jobpool::set_reprioritize_interval). Workers pull small
+        //! batches into their own deques, which idle siblings can steal from.
+        //! Each take costs O(log n).
+        batched
+    };
+
     /**
      * Future holds the future result of an asynchronous operation.
      *
@@ -490,6 +509,7 @@ namespace WEEJOBS_NAMESPACE
         {
             context ctx;
             std::function<bool()> _delegate;
+            float _priority = 0.0f; // cached priority for batched scheduling
 
             bool operator < (const job& rhs) const
             {
@@ -497,6 +517,24 @@ namespace WEEJOBS_NAMESPACE
                 float rp = rhs.ctx.priority ? rhs.ctx.priority() : -FLT_MAX;
                 return lp < rp;
             }
+
+            inline float evaluate_priority() const
+            {
+                return ctx.priority ? ctx.priority() : 0.0f;
+            }
+
+            static bool by_cached_priority(const job& lhs, const job& rhs)
+            {
+                return lhs._priority < rhs._priority;
+            }
+        };
+
+        // Jobs a worker thread pulled from its pool in one batch.
+        // The owner takes from the front; idle siblings steal from the back.
+        struct worker_queue
+        {
+            std::mutex _mutex;
+            std::deque<job> _jobs;
         };
 
         inline bool steal_job(class jobpool* thief, detail::job& stolen);
@@ -565,11 +603,46 @@ namespace WEEJOBS_NAMESPACE
             _can_steal_work = value;
         }
 
+        //! How this pool chooses the next job to run. Default = scheduling::exact.
+        void set_scheduling(scheduling value)
+        {
+            std::lock_guard<std::mutex> lock(_queue_mutex);
+            if (_scheduling != value)
+            {
+                _scheduling = value;
+                if (value == scheduling::batched)
+                    _reprioritize(std::chrono::steady_clock::now());
+            }
+        }
+
+        //! How this pool chooses the next job to run.
+        scheduling get_scheduling() const
+        {
+            return _scheduling;
+        }
+
+        //! How often batched scheduling re-evaluates the priority of every
+        //! queued job. Between refreshes only the job at the top of the heap
+        //! is re-checked before it runs. Default = 50ms.
+        void set_reprioritize_interval(std::chrono::milliseconds value)
+        {
+            std::lock_guard<std::mutex> lock(_queue_mutex);
+            _reprioritize_interval = value;
+        }
+
         //! Discard all queued jobs
         void cancel_all()
         {
             std::lock_guard<std::mutex> lock(_queue_mutex);
             _queue.clear();
+            {
+                std::lock_guard<std::mutex> locals_lock(_locals_mutex);
+                for (auto& local : _locals)
+                {
+                    std::lock_guard<std::mutex> local_lock(local->_mutex);
+                    local->_jobs.clear();
+                }
+            }
             _metrics.canceled += _metrics.pending;
             _metrics.pending = 0;
         }
@@ -590,9 +663,18 @@ namespace WEEJOBS_NAMESPACE
 
                 if (_target_concurrency > 0)
                 {
+                    detail::job job{ context, delegate };
+
+                    // evaluate the priority outside the lock:
+                    if (_scheduling == scheduling::batched)
+                        job._priority = job.evaluate_priority();
+
                     std::lock_guard<std::mutex> lock(_queue_mutex);
 
-                    _queue.emplace_back(detail::job{ context, delegate });
+                    _queue.emplace_back(std::move(job));
+
+                    if (_scheduling == scheduling::batched)
+                        std::push_heap(_queue.begin(), _queue.end(), detail::job::by_cached_priority);
 
                     _metrics.pending++;
                     _metrics.total++;
@@ -621,6 +703,12 @@ namespace WEEJOBS_NAMESPACE
                 std::lock_guard<std::mutex> lock(_queue_mutex);
                 return _take_job(output, false);
             }
+            else if (!_done && !_queue.empty() && _scheduling == scheduling::batched)
+            {
+                _pop_heap(output);
+                _metrics.pending--;
+                return true;
+            }
             else if (!_done && !_queue.empty())
             {
                 auto ptr = _queue.end();
@@ -652,6 +740,145 @@ namespace WEEJOBS_NAMESPACE
             return false;
         }
 
+        //! Batched scheduling: takes the best job from the queue, and moves a
+        //! few more into the worker's local deque so its next takes skip the
+        //! queue lock. Batches stay small enough to keep every thread busy.
+        inline bool _take_jobs(detail::job& output, detail::worker_queue& local)
+        {
+            std::lock_guard<std::mutex> lock(_queue_mutex);
+
+            if (_done || _queue.empty() || _scheduling != scheduling::batched)
+                return false;
+
+            _pop_heap(output);
+            _metrics.pending--;
+
+            std::size_t share = _queue.size() / (2u * std::max(_target_concurrency.load(), 1u));
+            std::size_t count = std::min(share, _batch_size);
+            if (count > 0)
+            {
+                std::lock_guard<std::mutex> local_lock(local._mutex);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    local._jobs.emplace_back();
+                    _pop_heap(local._jobs.back());
+                }
+
+                // siblings woken for these jobs will find the queue empty;
+                // make sure they look in the local deques instead of waiting
+                _block.notify_all();
+            }
+            return true;
+        }
+
+        //! Takes the next job from a worker's local deque.
+        inline bool _take_local(detail::job& output, detail::worker_queue& local)
+        {
+            std::lock_guard<std::mutex> lock(local._mutex);
+            if (local._jobs.empty())
+                return false;
+
+            output = std::move(local._jobs.front());
+            local._jobs.pop_front();
+            _metrics.pending--;
+            return true;
+        }
+
+        //! Steals a job from the back of a sibling worker's local deque.
+        inline bool _steal_local(detail::job& output, detail::worker_queue& thief)
+        {
+            std::lock_guard<std::mutex> lock(_locals_mutex);
+            for (auto& local : _locals)
+            {
+                if (local.get() != &thief)
+                {
+                    std::lock_guard<std::mutex> local_lock(local->_mutex);
+                    if (!local->_jobs.empty())
+                    {
+                        output = std::move(local->_jobs.back());
+                        local->_jobs.pop_back();
+                        _metrics.pending--;
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        //! Pops the top of the priority heap into output. Call with the queue locked.
+        inline void _pop_heap(detail::job& output)
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (now - _last_reprioritize >= _reprioritize_interval)
+            {
+                _reprioritize(now);
+            }
+
+            std::pop_heap(_queue.begin(), _queue.end(), detail::job::by_cached_priority);
+
+            // Re-check the candidate: if its priority fell below the next best
+            // cached priority since the last refresh, sink it and try again.
+            for (int tries = 0; tries < 8 && _queue.size() > 1; ++tries)
+            {
+                auto& candidate = _queue.back();
+                float priority = candidate.evaluate_priority();
+                if (priority >= _queue.front()._priority)
+                    break;
+
+                candidate._priority = priority;
+                std::push_heap(_queue.begin(), _queue.end(), detail::job::by_cached_priority);
+                std::pop_heap(_queue.begin(), _queue.end(), detail::job::by_cached_priority);
+            }
+
+            output = std::move(_queue.back());
+            _queue.pop_back();
+        }
+
+        //! Re-evaluates every queued priority and rebuilds the heap. Call with the queue locked.
+        inline void _reprioritize(std::chrono::steady_clock::time_point now)
+        {
+            for (auto& job : _queue)
+                job._priority = job.evaluate_priority();
+
+            std::make_heap(_queue.begin(), _queue.end(), detail::job::by_cached_priority);
+            _last_reprioritize = now;
+        }
+
+        //! Returns a departing worker's local jobs to the queue.
+        inline void _retire(detail::worker_queue& local)
+        {
+            bool requeued = false;
+            {
+                std::lock_guard<std::mutex> lock(_queue_mutex);
+                {
+                    std::lock_guard<std::mutex> locals_lock(_locals_mutex);
+                    _locals.erase(
+                        std::remove_if(_locals.begin(), _locals.end(),
+                            [&](const std::shared_ptr<detail::worker_queue>& q) { return q.get() == &local; }),
+                        _locals.end());
+                }
+
+                std::lock_guard<std::mutex> local_lock(local._mutex);
+                if (!_done)
+                {
+                    for (auto& job : local._jobs)
+                    {
+                        _queue.emplace_back(std::move(job));
+                        if (_scheduling == scheduling::batched)
+                            std::push_heap(_queue.begin(), _queue.end(), detail::job::by_cached_priority);
+                        requeued = true;
+                    }
+                }
+                local._jobs.clear();
+            }
+
+            // the remaining threads may all be asleep
+            if (requeued)
+            {
+                _block.notify_all();
+            }
+        }
+
         //! Construct a new job pool.
         //! Do not call this directly - call getPool(name) instead.
         jobpool(const std::string& name, unsigned concurrency) :
@@ -664,7 +891,7 @@ namespace WEEJOBS_NAMESPACE
 
         //! Pulls queued jobs and runs them in whatever thread run() is called from.
         //! Runs in a loop until _done is set.
-        inline void run();
+        inline void run(detail::worker_queue& local);
 
         //! Spawn all threads in this scheduler
         inline void start_threads();
@@ -678,6 +905,12 @@ namespace WEEJOBS_NAMESPACE
         bool _can_steal_work = true;
         std::vector<detail::job> _queue;
         mutable std::mutex _queue_mutex; // protect access to the queue
+        std::atomic<scheduling> _scheduling = { scheduling::exact }; // how to choose the next job
+        std::chrono::steady_clock::duration _reprioritize_interval = std::chrono::milliseconds(50); // batched: full priority refresh period
+        std::chrono::steady_clock::time_point _last_reprioritize; // batched: time of the last full refresh
+        std::size_t _batch_size = 8u; // batched: most jobs a worker pulls into its local deque at once
+        std::vector<std::shared_ptr<detail::worker_queue>> _locals; // per-thread local deques
+        std::mutex _locals_mutex; // protects _locals
         mutable std::mutex _quit_mutex; // protects access to _done
         std::atomic<unsigned> _target_concurrency; // target number of concurrent threads in the pool
         std::condition_variable_any _block; // thread waiter block
@@ -727,6 +960,7 @@ namespace WEEJOBS_NAMESPACE
 
             bool _alive = true;
             bool _stealing_allowed = false;
+            scheduling _scheduling = scheduling::exact;
             std::mutex _pools_mutex;
             std::vector<jobpool*> _pools;
             metrics _metrics;
@@ -752,6 +986,7 @@ namespace WEEJOBS_NAMESPACE
                 return pool;
         }
         auto new_pool = new jobpool(name, pool_size);
+        new_pool->set_scheduling(instance()._scheduling);
         instance()._pools.push_back(new_pool);
         instance()._metrics._pools.push_back(&new_pool->_metrics);
         new_pool->start_threads();
@@ -879,6 +1114,19 @@ namespace WEEJOBS_NAMESPACE
         instance()._stealing_allowed = value;
     }
 
+    //! Sets the scheduling mode of every existing job pool and of any pool created later.
+    inline void set_scheduling(scheduling value)
+    {
+        std::vector<jobpool*> pools;
+        {
+            std::lock_guard<std::mutex> lock(instance()._pools_mutex);
+            instance()._scheduling = value;
+            pools = instance()._pools;
+        }
+        for (auto pool : pools)
+            pool->set_scheduling(value);
+    }
+
     inline detail::runtime::runtime()
     {
         //nop
@@ -904,12 +1152,29 @@ namespace WEEJOBS_NAMESPACE
                 pool->join_threads();
     }
 
-    inline void jobpool::run()
+    inline void jobpool::run(detail::worker_queue& local)
     {
         while (!_done)
         {
             detail::job next;
-            bool have_next = false;
+
+            // Jobs this worker already pulled in a batch come first; then (in batched
+            // mode) a new batch from the queue, then a job stolen from a sibling.
+            // Stealing runs in either mode, since jobs batched before a switch to
+            // exact scheduling still count as pending.
+            bool have_next = _take_local(next, local);
+
+            if (!have_next && _scheduling == scheduling::batched)
+            {
+                have_next = _take_jobs(next, local);
+            }
+
+            if (!have_next)
+            {
+                have_next = _steal_local(next, local);
+            }
+
+            if (!have_next)
             {
                 if (_can_steal_work && instance()._stealing_allowed)
                 {
@@ -934,8 +1199,9 @@ namespace WEEJOBS_NAMESPACE
                 {
                     std::unique_lock<std::mutex> lock(_queue_mutex);
 
-                    // wait until just our local queue is non-empty
-                    _block.wait(lock, [this] { return !_queue.empty() || _done; });
+                    // wait until just our local queue is non-empty. Pending includes
+                    // the jobs batched into worker deques, which we can steal.
+                    _block.wait(lock, [this] { return _metrics.pending > 0 || _done; });
 
                     if (!_done && !_queue.empty())
                     {
@@ -978,6 +1244,8 @@ namespace WEEJOBS_NAMESPACE
                 break;
             }
         }
+
+        _retire(local);
     }
 
     inline void jobpool::start_threads()
@@ -989,13 +1257,19 @@ namespace WEEJOBS_NAMESPACE
         {
             _metrics.concurrency++;
 
-            _threads.push_back(std::thread([this]
+            auto local = std::make_shared<detail::worker_queue>();
+            {
+                std::lock_guard<std::mutex> lock(_locals_mutex);
+                _locals.push_back(local);
+            }
+
+            _threads.push_back(std::thread([this, local]
                 {
                     if (instance()._set_thread_name)
                     {
                         instance()._set_thread_name(_metrics.name.c_str());
                     }
-                    run();
+                    run(*local);
                 }
             ));
         }
@@ -1019,6 +1293,23 @@ namespace WEEJOBS_NAMESPACE
         }
         _queue.clear();
 
+        // ...and the jobs waiting in worker deques.
+        {
+            std::lock_guard<std::mutex> locals_lock(_locals_mutex);
+            for (auto& local : _locals)
+            {
+                std::lock_guard<std::mutex> local_lock(local->_mutex);
+                for (auto& queuedjob : local->_jobs)
+                {
+                    if (queuedjob.ctx.group != nullptr)
+                    {
+                        queuedjob.ctx.group->release();
+                    }
+                }
+                local->_jobs.clear();
+            }
+        }
+
         // wake up all threads so they can exit
         _block.notify_all();
     }
@@ -0,0 +1,1226 @@
+/* osgEarth
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include "PackCache"
+#include <osgEarth/Cache>
+#include <osgEarth/StringUtils>
+#include <osgEarth/Threading>
+#include <osgEarth/URI>
+#include <osgEarth/FileUtils>
+#include <osgEarth/Registry>
+#include <osgEarth/Metrics>
+#include <osgEarth/DateTime>
+#include <osgDB/FileUtils>
+#include <osgDB/FileNameUtils>
+#include <osgDB/Registry>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <streambuf>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#   endif
+#   include <windows.h>
+#   include <io.h>
+#   include <fcntl.h>
+#else
+#   include <unistd.h>
+#   include <fcntl.h>
+#   include <sys/file.h>
+#endif
+
+using namespace osgEarth;
+using namespace osgEarth::Drivers;
+
+#undef  LC
+#define LC "[PackCache] "
+
+#define PACK_FILE_NAME  "data.pack"
+#define INDEX_FILE_NAME "index.idx"
+#define LOCK_FILE_NAME  "data.lock"
+#define TEMP_SUFFIX     ".tmp"
+
+#define PACK_FILE_MAGIC   0x4b504f45u // "OEPK"
+#define PACK_RECORD_MAGIC 0x434f4552u // "REOC"
+#define PACK_INDEX_MAGIC  0x58494f45u // "EOIX"
+#define PACK_VERSION      1u
+
+namespace
+{
+    // On-disk layouts. Pack file:
+    //   PackFileHeader, then a sequence of records:
+    //   RecordHeader | key bytes | metadata JSON bytes | data bytes
+    // Index file:
+    //   IndexFileHeader, then for each live record:
+    //   IndexRecord | key bytes
+    // The index is only an accelerator; the pack can always be rescanned.
+
+    struct PackFileHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t generation;
+    };
+
+    enum RecordType : std::uint8_t
+    {
+        RECORD_DATA = 1,
+        RECORD_TOMBSTONE = 2
+    };
+
+    struct RecordHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t checksum;
+        std::uint8_t  type;
+        std::uint8_t  reserved[3];
+        std::uint32_t keySize;
+        std::uint32_t metaSize;
+        std::uint32_t dataSize;
+        std::int64_t  timestamp;
+    };
+    static_assert(sizeof(RecordHeader) == 32, "RecordHeader must be packed to 32 bytes");
+
+    struct IndexFileHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t generation;
+        std::uint64_t packSize;
+        std::uint64_t count;
+    };
+
+    struct IndexRecord
+    {
+        std::uint64_t offset;
+        std::uint32_t recordSize;
+        std::uint32_t keySize;
+        std::int64_t  timestamp;
+    };
+
+    // FNV-1a, used to detect torn or corrupt records
+    inline std::uint32_t checksum(std::uint32_t h, const void* ptr, std::size_t len)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(ptr);
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            h ^= p[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    std::uint32_t checksum(const RecordHeader& header, const char* payload)
+    {
+        RecordHeader temp = header;
+        temp.checksum = 0u;
+        std::uint32_t h = checksum(2166136261u, &temp, sizeof(temp));
+        return checksum(h, payload, (std::size_t)header.keySize + header.metaSize + header.dataSize);
+    }
+
+    bool replaceFile(const std::string& from, const std::string& to)
+    {
+#ifdef _WIN32
+        return ::MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        return ::rename(from.c_str(), to.c_str()) == 0;
+#endif
+    }
+
+    bool truncateFile(const std::string& path, std::uint64_t size)
+    {
+#ifdef _WIN32
+        int fd = ::_open(path.c_str(), _O_RDWR | _O_BINARY);
+        if (fd < 0) return false;
+        bool ok = ::_chsize_s(fd, (__int64)size) == 0;
+        ::_close(fd);
+        return ok;
+#else
+        return ::truncate(path.c_str(), (off_t)size) == 0;
+#endif
+    }
+
+    /**
+     * Exclusive lock on a file in the bin folder. Only one process (and one
+     * cache instance) may append to a pack; the OS drops the lock if the
+     * holder dies.
+     */
+    class LockFile
+    {
+    public:
+        ~LockFile()
+        {
+            release();
+        }
+
+        bool acquire(const std::string& path)
+        {
+            release();
+#ifdef _WIN32
+            // no sharing = exclusive while the handle is open
+            _handle = ::CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0,
+                nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            return _handle != INVALID_HANDLE_VALUE;
+#else
+            _fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            if (_fd < 0)
+                return false;
+            if (::flock(_fd, LOCK_EX | LOCK_NB) != 0)
+            {
+                ::close(_fd);
+                _fd = -1;
+                return false;
+            }
+            return true;
+#endif
+        }
+
+        void release()
+        {
+#ifdef _WIN32
+            if (_handle != INVALID_HANDLE_VALUE)
+                ::CloseHandle(_handle);
+            _handle = INVALID_HANDLE_VALUE;
+#else
+            if (_fd >= 0)
+                ::close(_fd);
+            _fd = -1;
+#endif
+        }
+
+    private:
+#ifdef _WIN32
+        HANDLE _handle = INVALID_HANDLE_VALUE;
+#else
+        int _fd = -1;
+#endif
+    };
+
+    /**
+     * Input stream buffer over a block of memory, so the OSG readers can
+     * decode straight out of the mapped pack file without an extra copy.
+     */
+    class MemoryStreamBuf : public std::streambuf
+    {
+    public:
+        MemoryStreamBuf(const char* data, std::size_t size)
+        {
+            char* p = const_cast<char*>(data);
+            setg(p, p, p + size);
+        }
+
+    protected:
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode) override
+        {
+            char* target =
+                dir == std::ios_base::beg ? eback() + off :
+                dir == std::ios_base::cur ? gptr() + off :
+                egptr() + off;
+            if (target < eback() || target > egptr())
+                return pos_type(off_type(-1));
+            setg(eback(), target, egptr());
+            return pos_type(target - eback());
+        }
+
+        pos_type seekpos(pos_type pos, std::ios_base::openmode mode) override
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, mode);
+        }
+    };
+
+    /**
+     * One append-only pack file with an in-memory index.
+     *
+     * Writes append a checksummed record and flush before the index is
+     * updated, so a crash can at worst leave a torn record at the tail;
+     * open() detects it and truncates it away. Superseded and removed
+     * records are reclaimed by compact(), which rewrites the live records
+     * into a new pack file and swaps it in atomically.
+     *
+     * A pack has a single writer: open() fails if another process already
+     * holds the bin's lock file.
+     */
+    class PackFile
+    {
+    public:
+        struct Entry
+        {
+            std::uint64_t offset = 0u;
+            std::uint32_t recordSize = 0u;
+            std::int64_t timestamp = 0;
+        };
+
+        ~PackFile()
+        {
+            close();
+        }
+
+        bool open(const std::string& folder)
+        {
+            std::lock_guard<std::mutex> writeLock(_writeMutex);
+            ScopedWriteLock lock(_mutex);
+
+            _packPath = osgDB::concatPaths(folder, PACK_FILE_NAME);
+            _indexPath = osgDB::concatPaths(folder, INDEX_FILE_NAME);
+
+            std::string lockPath = osgDB::concatPaths(folder, LOCK_FILE_NAME);
+            if (!_lock.acquire(lockPath))
+            {
+                OE_WARN << LC << "Pack " << _packPath << " is in use by another process "
+                    "(a pack cache folder supports one process at a time)" << std::endl;
+                return false;
+            }
+
+            // leftovers from an interrupted compaction or index save
+            ::remove((_packPath + TEMP_SUFFIX).c_str());
+            ::remove((_indexPath + TEMP_SUFFIX).c_str());
+
+            if (!osgDB::fileExists(_packPath))
+            {
+                if (!createPack(_packPath, 0u))
+                    return false;
+            }
+
+            if (!_map.open(_packPath) || _map.size() < sizeof(PackFileHeader))
+                return false;
+
+            PackFileHeader header;
+            ::memcpy(&header, _map.data(), sizeof(header));
+            if (header.magic != PACK_FILE_MAGIC || header.version != PACK_VERSION)
+            {
+                OE_WARN << LC << "Unrecognized pack file " << _packPath << std::endl;
+                return false;
+            }
+            _generation = header.generation;
+
+            // Load the index snapshot, then recover anything appended after it.
+            std::uint64_t scanFrom = loadIndex();
+            std::uint64_t validSize = scan(scanFrom);
+
+            if (validSize < _map.size())
+            {
+                OE_WARN << LC << "Discarding " << (_map.size() - validSize)
+                    << " bytes of incomplete data at the end of " << _packPath << std::endl;
+                _map.close();
+                if (!truncateFile(_packPath, validSize) || !_map.open(_packPath))
+                    return false;
+            }
+
+            _packSize = validSize;
+
+            _out = ::fopen(_packPath.c_str(), "ab");
+            return _out != nullptr;
+        }
+
+        void close()
+        {
+            std::lock_guard<std::mutex> writeLock(_writeMutex);
+            ScopedWriteLock lock(_mutex);
+            if (_out)
+            {
+                saveIndex();
+                ::fclose(_out);
+                _out = nullptr;
+            }
+            _map.close();
+            _lock.release();
+        }
+
+        bool append(const std::string& key, const std::string& meta, const std::string& data, std::int64_t timestamp)
+        {
+            return append(RECORD_DATA, key, meta, data, timestamp);
+        }
+
+        bool remove(const std::string& key)
+        {
+            {
+                ScopedReadLock lock(_mutex);
+                if (_index.find(key) == _index.end())
+                    return false;
+            }
+            return append(RECORD_TOMBSTONE, key, std::string(), std::string(), 0);
+        }
+
+        bool touch(const std::string& key, std::int64_t timestamp)
+        {
+            // in memory only; persisted with the next index snapshot.
+            ScopedWriteLock lock(_mutex);
+            auto i = _index.find(key);
+            if (i == _index.end())
+                return false;
+            i->second.timestamp = timestamp;
+            return true;
+        }
+
+        bool contains(const std::string& key) const
+        {
+            ScopedReadLock lock(_mutex);
+            return _index.find(key) != _index.end();
+        }
+
+        //! Invokes func(meta, metaSize, data, dataSize, timestamp) with pointers
+        //! directly into the mapped pack file. The pointers are only valid
+        //! for the duration of the call.
+        template<typename FUNC>
+        bool read(const std::string& key, FUNC&& func)
+        {
+            for (int pass = 0; pass < 2; ++pass)
+            {
+                Entry bad;
+                {
+                    ScopedReadLock lock(_mutex);
+                    auto i = _index.find(key);
+                    if (i == _index.end())
+                        return false;
+
+                    const Entry& entry = i->second;
+                    if (entry.offset + entry.recordSize <= _map.size())
+                    {
+                        RecordHeader header;
+                        const char* record = _map.data() + entry.offset;
+                        if (verify(record, entry, key, header))
+                        {
+                            const char* meta = record + sizeof(header) + header.keySize;
+                            func(meta, header.metaSize, meta + header.metaSize, header.dataSize, entry.timestamp);
+                            return true;
+                        }
+                        bad = entry;
+                    }
+                }
+
+                if (bad.recordSize > 0u)
+                {
+                    // The index points at something other than this key's
+                    // record; drop the entry so we stop reading it.
+                    OE_WARN << LC << "Corrupt record for \"" << key << "\" in " << _packPath << "; discarding" << std::endl;
+                    ScopedWriteLock lock(_mutex);
+                    auto i = _index.find(key);
+                    if (i != _index.end() && i->second.offset == bad.offset)
+                    {
+                        _deadBytes += i->second.recordSize;
+                        _index.erase(i);
+                    }
+                    return false;
+                }
+
+                // The pack has grown since we mapped it.
+                ScopedWriteLock lock(_mutex);
+                if (_map.size() < _packSize)
+                {
+                    _map.open(_packPath);
+                }
+            }
+            return false;
+        }
+
+        //! Rewrites the live records into a fresh pack file. Writers are only
+        //! blocked while taking a snapshot and while swapping the files in.
+        bool compact()
+        {
+            OE_PROFILING_ZONE;
+
+            std::lock_guard<std::mutex> compactLock(_compactMutex);
+
+            if (_clearPending)
+                return false;
+
+            // snapshot the live records
+            std::vector<std::pair<std::string, Entry>> live;
+            std::uint64_t snapshotSize, generation;
+            {
+                std::lock_guard<std::mutex> writeLock(_writeMutex);
+                ScopedReadLock lock(_mutex);
+
+                if (_out == nullptr)
+                    return false;
+
+                snapshotSize = _packSize;
+                generation = _generation;
+                live.assign(_index.begin(), _index.end());
+            }
+
+            // copy in pack order so the source is read sequentially
+            std::sort(live.begin(), live.end(),
+                [](const std::pair<std::string, Entry>& a, const std::pair<std::string, Entry>& b) {
+                    return a.second.offset < b.second.offset;
+                });
+
+            std::string tempPath = _packPath + TEMP_SUFFIX;
+            if (!createPack(tempPath, generation + 1))
+                return false;
+
+            // a private mapping, so readers and appends are not affected
+            Util::MappedFile source;
+            FILE* out = ::fopen(tempPath.c_str(), "ab");
+            bool ok = out != nullptr && source.open(_packPath) && source.size() >= snapshotSize;
+
+            std::unordered_map<std::string, std::uint64_t> newOffsets;
+            newOffsets.reserve(live.size());
+            std::uint64_t newSize = sizeof(PackFileHeader);
+
+            for (auto i = live.begin(); ok && i != live.end(); ++i)
+            {
+                // a clear() is waiting to truncate the source
+                if (_clearPending)
+                {
+                    ok = false;
+                    break;
+                }
+
+                const Entry& entry = i->second;
+                ok =
+                    entry.offset + entry.recordSize <= snapshotSize &&
+                    ::fwrite(source.data() + entry.offset, 1, entry.recordSize, out) == entry.recordSize;
+
+                newOffsets[i->first] = newSize;
+                newSize += entry.recordSize;
+            }
+
+            std::lock_guard<std::mutex> writeLock(_writeMutex);
+
+            // give up if the pack was cleared or closed in the meantime
+            ok = ok && _out != nullptr && _generation == generation;
+
+            // carry over whatever was appended during the copy, as is
+            std::uint64_t tailSize = ok ? _packSize - snapshotSize : 0u;
+            if (ok && tailSize > 0u)
+            {
+                ok =
+                    source.open(_packPath) &&
+                    source.size() >= _packSize &&
+                    ::fwrite(source.data() + snapshotSize, 1, tailSize, out) == tailSize;
+            }
+            source.close();
+
+            if (out)
+            {
+                ok = (::fflush(out) == 0) && ok;
+                ::fclose(out);
+            }
+
+            if (!ok)
+            {
+                ::remove(tempPath.c_str());
+                return false;
+            }
+
+            ScopedWriteLock lock(_mutex);
+
+            ::fclose(_out);
+            _out = nullptr;
+            _map.close();
+
+            bool swapped = replaceFile(tempPath, _packPath);
+            if (swapped)
+            {
+                std::uint64_t liveBytes = 0u;
+                for (auto i = _index.begin(); i != _index.end(); )
+                {
+                    Entry& entry = i->second;
+                    if (entry.offset >= snapshotSize)
+                    {
+                        // appended during the copy
+                        entry.offset = newSize + (entry.offset - snapshotSize);
+                    }
+                    else
+                    {
+                        auto n = newOffsets.find(i->first);
+                        if (n == newOffsets.end())
+                        {
+                            i = _index.erase(i);
+                            continue;
+                        }
+                        entry.offset = n->second;
+                    }
+                    liveBytes += entry.recordSize;
+                    ++i;
+                }
+
+                _packSize = newSize + tailSize;
+                _deadBytes = _packSize - sizeof(PackFileHeader) - liveBytes;
+                ++_generation;
+                saveIndex();
+            }
+            else
+            {
+                ::remove(tempPath.c_str());
+            }
+
+            _map.open(_packPath);
+            _out = ::fopen(_packPath.c_str(), "ab");
+            return swapped && _out != nullptr;
+        }
+
+        //! Discards every record. A compaction in progress is abandoned first,
+        //! since it reads the pack file that clear() truncates.
+        bool clear()
+        {
+            ++_clearPending;
+            std::lock_guard<std::mutex> compactLock(_compactMutex);
+            --_clearPending;
+
+            std::lock_guard<std::mutex> writeLock(_writeMutex);
+            ScopedWriteLock lock(_mutex);
+
+            if (_out)
+                ::fclose(_out);
+            _out = nullptr;
+            _map.close();
+            _index.clear();
+            _deadBytes = 0u;
+
+            ::remove(_indexPath.c_str());
+            if (!createPack(_packPath, ++_generation))
+                return false;
+
+            _packSize = sizeof(PackFileHeader);
+            _map.open(_packPath);
+            _out = ::fopen(_packPath.c_str(), "ab");
+            return _out != nullptr;
+        }
+
+        bool needsCompaction(float ratio, std::uint64_t minSize) const
+        {
+            ScopedReadLock lock(_mutex);
+            return
+                _packSize >= minSize &&
+                (double)_deadBytes >= (double)ratio * (double)_packSize;
+        }
+
+        std::uint64_t size() const
+        {
+            ScopedReadLock lock(_mutex);
+            return _packSize;
+        }
+
+    private:
+        std::string _packPath;
+        std::string _indexPath;
+        Util::MappedFile _map;
+        FILE* _out = nullptr;
+        std::unordered_map<std::string, Entry> _index;
+        std::uint64_t _packSize = 0u;
+        std::uint64_t _deadBytes = 0u;
+        std::uint64_t _generation = 0u;
+        LockFile _lock;
+        mutable ReadWriteMutex _mutex;  // protects the index and the mapping
+        std::mutex _writeMutex;         // serializes appends
+        std::mutex _compactMutex;       // serializes compactions and clears
+        std::atomic_int _clearPending = { 0 }; // clears waiting on a compaction
+
+        // Checks that a record is intact and is the data record for "key"
+        static bool verify(const char* record, const Entry& entry, const std::string& key, RecordHeader& header)
+        {
+            if (entry.recordSize < sizeof(RecordHeader))
+                return false;
+
+            ::memcpy(&header, record, sizeof(header));
+            const char* payload = record + sizeof(header);
+
+            return
+                header.magic == PACK_RECORD_MAGIC &&
+                header.type == RECORD_DATA &&
+                (std::uint64_t)sizeof(header) + header.keySize + header.metaSize + header.dataSize == entry.recordSize &&
+                header.keySize == key.size() &&
+                ::memcmp(payload, key.data(), key.size()) == 0 &&
+                checksum(header, payload) == header.checksum;
+        }
+
+        bool append(RecordType type, const std::string& key, const std::string& meta, const std::string& data, std::int64_t timestamp)
+        {
+            RecordHeader header;
+            ::memset(&header, 0, sizeof(header));
+            header.magic = PACK_RECORD_MAGIC;
+            header.type = type;
+            header.keySize = (std::uint32_t)key.size();
+            header.metaSize = (std::uint32_t)meta.size();
+            header.dataSize = (std::uint32_t)data.size();
+            header.timestamp = timestamp;
+
+            std::string payload;
+            payload.reserve(key.size() + meta.size() + data.size());
+            payload.append(key).append(meta).append(data);
+            header.checksum = checksum(header, payload.data());
+
+            std::lock_guard<std::mutex> writeLock(_writeMutex);
+
+            if (_out == nullptr)
+                return false;
+
+            std::uint64_t offset = _packSize;
+            std::uint32_t recordSize = (std::uint32_t)(sizeof(header) + payload.size());
+
+            bool ok =
+                ::fwrite(&header, sizeof(header), 1, _out) == 1 &&
+                ::fwrite(payload.data(), 1, payload.size(), _out) == payload.size() &&
+                ::fflush(_out) == 0;
+
+            if (!ok)
+                return false;
+
+            ScopedWriteLock lock(_mutex);
+            _packSize += recordSize;
+            apply(type, key, Entry{ offset, recordSize, timestamp });
+            return true;
+        }
+
+        // update the index for a record; call with _mutex held
+        void apply(RecordType type, const std::string& key, const Entry& entry)
+        {
+            auto i = _index.find(key);
+            if (i != _index.end())
+            {
+                _deadBytes += i->second.recordSize;
+                if (type == RECORD_TOMBSTONE)
+                    _index.erase(i);
+                else
+                    i->second = entry;
+            }
+            else if (type == RECORD_DATA)
+            {
+                _index[key] = entry;
+            }
+
+            if (type == RECORD_TOMBSTONE)
+                _deadBytes += entry.recordSize;
+        }
+
+        // Scans records from "offset" to the end of the mapped file, applying them
+        // to the index. Returns the end of the last valid record.
+        std::uint64_t scan(std::uint64_t offset)
+        {
+            const char* base = _map.data();
+            const std::uint64_t end = _map.size();
+
+            while (offset + sizeof(RecordHeader) <= end)
+            {
+                RecordHeader header;
+                ::memcpy(&header, base + offset, sizeof(header));
+                if (header.magic != PACK_RECORD_MAGIC)
+                    break;
+
+                std::uint64_t payloadSize = (std::uint64_t)header.keySize + header.metaSize + header.dataSize;
+                if (offset + sizeof(header) + payloadSize > end)
+                    break;
+
+                const char* payload = base + offset + sizeof(header);
+                if (checksum(header, payload) != header.checksum)
+                    break;
+
+                std::uint32_t recordSize = (std::uint32_t)(sizeof(header) + payloadSize);
+                apply(
+                    (RecordType)header.type,
+                    std::string(payload, header.keySize),
+                    Entry{ offset, recordSize, header.timestamp });
+
+                offset += recordSize;
+            }
+
+            return offset;
+        }
+
+        // Loads the index snapshot. Returns the pack offset it covers,
+        // from which the pack must be scanned.
+        std::uint64_t loadIndex()
+        {
+            _index.clear();
+            _deadBytes = 0u;
+
+            Util::MappedFile idx;
+            if (idx.open(_indexPath) && idx.size() >= sizeof(IndexFileHeader))
+            {
+                IndexFileHeader header;
+                ::memcpy(&header, idx.data(), sizeof(header));
+
+                if (header.magic == PACK_INDEX_MAGIC &&
+                    header.version == PACK_VERSION &&
+                    header.generation == _generation &&
+                    header.packSize <= _map.size())
+                {
+                    const char* ptr = idx.data() + sizeof(header);
+                    const char* end = idx.data() + idx.size();
+                    std::uint64_t liveBytes = 0u;
+
+                    _index.reserve(header.count);
+                    for (std::uint64_t n = 0; n < header.count; ++n)
+                    {
+                        IndexRecord rec;
+                        if (ptr + sizeof(rec) > end)
+                            break;
+                        ::memcpy(&rec, ptr, sizeof(rec));
+                        ptr += sizeof(rec);
+                        if (ptr + rec.keySize > end)
+                            break;
+                        _index[std::string(ptr, rec.keySize)] = Entry{ rec.offset, rec.recordSize, rec.timestamp };
+                        ptr += rec.keySize;
+                        liveBytes += rec.recordSize;
+                    }
+
+                    if (_index.size() == header.count)
+                    {
+                        _deadBytes = header.packSize - sizeof(PackFileHeader) - liveBytes;
+                        return header.packSize;
+                    }
+                }
+
+                OE_INFO << LC << "Index " << _indexPath << " is stale; rebuilding" << std::endl;
+                _index.clear();
+            }
+
+            return sizeof(PackFileHeader);
+        }
+
+        // Writes an index snapshot; call with both locks held
+        void saveIndex()
+        {
+            std::string tempPath = _indexPath + TEMP_SUFFIX;
+            FILE* out = ::fopen(tempPath.c_str(), "wb");
+            if (out == nullptr)
+                return;
+
+            IndexFileHeader header;
+            header.magic = PACK_INDEX_MAGIC;
+            header.version = PACK_VERSION;
+            header.generation = _generation;
+            header.packSize = _packSize;
+            header.count = _index.size();
+
+            bool ok = ::fwrite(&header, sizeof(header), 1, out) == 1;
+            for (auto i = _index.begin(); ok && i != _index.end(); ++i)
+            {
+                IndexRecord rec;
+                rec.offset = i->second.offset;
+                rec.recordSize = i->second.recordSize;
+                rec.keySize = (std::uint32_t)i->first.size();
+                rec.timestamp = i->second.timestamp;
+                ok =
+                    ::fwrite(&rec, sizeof(rec), 1, out) == 1 &&
+                    ::fwrite(i->first.data(), 1, i->first.size(), out) == i->first.size();
+            }
+
+            ok = (::fflush(out) == 0) && ok;
+            ::fclose(out);
+
+            if (!ok || !replaceFile(tempPath, _indexPath))
+            {
+                ::remove(tempPath.c_str());
+            }
+        }
+
+        static bool createPack(const std::string& path, std::uint64_t generation)
+        {
+            FILE* out = ::fopen(path.c_str(), "wb");
+            if (out == nullptr)
+                return false;
+            PackFileHeader header;
+            header.magic = PACK_FILE_MAGIC;
+            header.version = PACK_VERSION;
+            header.generation = generation;
+            bool ok = ::fwrite(&header, sizeof(header), 1, out) == 1;
+            ok = (::fflush(out) == 0) && ok;
+            ::fclose(out);
+            return ok;
+        }
+    };
+
+    //------------------------------------------------------------------------
+
+    /**
+     * Cache that stores each bin in a single pack file.
+     */
+    class PackCache : public Cache
+    {
+    public:
+        PackCache() { } // unused
+        PackCache( const PackCache& rhs, const osg::CopyOp& op ) { } // unused
+        META_Object( osgEarth, PackCache );
+
+        PackCache( const CacheOptions& options );
+
+    public: // Cache interface
+
+        CacheBin* addBin( const std::string& binID ) override;
+
+        CacheBin* getOrCreateDefaultBin() override;
+
+    protected:
+        std::string _rootPath;
+        PackCacheOptions _options;
+    };
+
+    /**
+     * Cache bin implementation for a PackCache.
+     */
+    class PackCacheBin : public CacheBin
+    {
+    public:
+        PackCacheBin(
+            const std::string& name,
+            const std::string& rootPath,
+            const PackCacheOptions& options);
+
+        virtual ~PackCacheBin();
+
+    public: // CacheBin interface
+
+        ReadResult readObject(const std::string& key, const osgDB::Options* dbo) override;
+
+        ReadResult readImage(const std::string& key, const osgDB::Options* dbo) override;
+
+        ReadResult readString(const std::string& key, const osgDB::Options* dbo) override;
+
+        bool write(const std::string& key, const osg::Object* object, const Config& meta, const osgDB::Options* dbo) override;
+
+        bool remove(const std::string& key) override;
+
+        bool touch(const std::string& key) override;
+
+        RecordStatus getRecordStatus(const std::string& key) override;
+
+        bool clear() override;
+
+        bool compact() override;
+
+        unsigned getStorageSize() override;
+
+    protected:
+        using ReadFunc = std::function<osgDB::ReaderWriter::ReadResult(std::istream&)>;
+
+        ReadResult read(const std::string& key, const ReadFunc& reader);
+
+        void postWrite();
+
+        bool _ok;
+        std::string _binPath;
+        PackCacheOptions _options;
+        PackFile _pack;
+        std::atomic_bool _compacting;
+        osg::ref_ptr<osgDB::ReaderWriter> _rw;
+        osg::ref_ptr<osgDB::Options> _rwOptions;
+        bool _debug;
+    };
+}
+
+//------------------------------------------------------------------------
+
+namespace
+{
+    PackCache::PackCache(const CacheOptions& options) :
+        Cache(options),
+        _options(options)
+    {
+        // read the root path from ENV is necessary:
+        if ( !_options.rootPath().isSet())
+        {
+            const char* cachePath = ::getenv(OSGEARTH_ENV_CACHE_PATH);
+            if ( cachePath )
+                _options.rootPath() = cachePath;
+        }
+
+        _rootPath = URI( *_options.rootPath(), options.referrer() ).full();
+
+        if (osgDB::makeDirectory(_rootPath) == false)
+        {
+            _status.set(Status::ResourceUnavailable, Stringify()
+                << "Failed to create or access folder \"" << _rootPath << "\"");
+            return;
+        }
+        OE_INFO << LC << "Opened a pack cache at \"" << _rootPath << "\"" << std::endl;
+    }
+
+    CacheBin*
+    PackCache::addBin( const std::string& name )
+    {
+        if (getStatus().isError())
+            return NULL;
+
+        return _bins.getOrCreate(name, new PackCacheBin(name, _rootPath, _options));
+    }
+
+    CacheBin*
+    PackCache::getOrCreateDefaultBin()
+    {
+        if (getStatus().isError())
+            return NULL;
+
+        static Mutex s_defaultBinMutex;
+        if ( !_defaultBin.valid() )
+        {
+            std::lock_guard<std::mutex> lock( s_defaultBinMutex );
+            if ( !_defaultBin.valid() ) // double-check
+            {
+                _defaultBin = new PackCacheBin("__default", _rootPath, _options);
+            }
+        }
+        return _defaultBin.get();
+    }
+
+    //------------------------------------------------------------------------
+
+    PackCacheBin::PackCacheBin(
+        const std::string& binID,
+        const std::string& rootPath,
+        const PackCacheOptions& options) :
+
+        CacheBin(binID, options.enableNodeCaching().get()),
+        _options(options),
+        _compacting(false),
+        _debug(::getenv("OSGEARTH_CACHE_DEBUG") != 0L)
+    {
+        _binPath = osgDB::concatPaths(rootPath, binID);
+
+        _rw = osgDB::Registry::instance()->getReaderWriterForExtension("osgb");
+        _rwOptions = Registry::instance()->cloneOrCreateOptions();
+
+        _ok =
+            _rw.valid() &&
+            osgDB::makeDirectory(_binPath) &&
+            _pack.open(_binPath);
+
+        if (!_ok)
+        {
+            OE_WARN << LC << "Failed to open cache bin at [" << _binPath << "]" << std::endl;
+        }
+    }
+
+    PackCacheBin::~PackCacheBin()
+    {
+        // background compaction holds a reference, so it's finished by now
+        _pack.close();
+    }
+
+    ReadResult
+    PackCacheBin::read(const std::string& key, const ReadFunc& reader)
+    {
+        OE_PROFILING_ZONE;
+
+        if (!_ok)
+            return ReadResult(ReadResult::RESULT_NOT_FOUND);
+
+        osgDB::ReaderWriter::ReadResult r;
+        Config meta;
+        TimeStamp timestamp = 0;
+
+        bool found = _pack.read(key, [&](
+            const char* metaPtr, std::uint32_t metaSize,
+            const char* dataPtr, std::uint32_t dataSize,
+            std::int64_t recordTime)
+            {
+                if (metaSize > 0)
+                    meta.fromJSON(std::string(metaPtr, metaSize));
+
+                // decode directly from the mapped bytes
+                MemoryStreamBuf buf(dataPtr, dataSize);
+                std::istream in(&buf);
+                r = reader(in);
+                timestamp = (TimeStamp)recordTime;
+            });
+
+        if (!found)
+            return ReadResult(ReadResult::RESULT_NOT_FOUND);
+
+        if (!r.success())
+            return ReadResult(r.message());
+
+        if (_debug)
+            OE_NOTICE << LC << "Read \"" << key << "\" from cache bin [" << getID() << "]" << std::endl;
+
+        ReadResult rr(r.getObject(), meta);
+        rr.setLastModifiedTime(timestamp);
+        return rr;
+    }
+
+    ReadResult
+    PackCacheBin::readImage(const std::string& key, const osgDB::Options* readOptions)
+    {
+        osg::ref_ptr<osgDB::ReaderWriter> rw = _rw;
+        osg::ref_ptr<const osgDB::Options> dbo = readOptions ? readOptions : _rwOptions.get();
+
+        ReadResult rr = read(key, [&](std::istream& in) { return rw->readImage(in, dbo.get()); });
+
+        // compressed cache data means there was an internal error
+        OE_SOFT_ASSERT_AND_RETURN(
+            rr.getImage() == nullptr || rr.getImage()->isCompressed() == false,
+            ReadResult());
+
+        return rr;
+    }
+
+    ReadResult
+    PackCacheBin::readObject(const std::string& key, const osgDB::Options* readOptions)
+    {
+        osg::ref_ptr<osgDB::ReaderWriter> rw = _rw;
+        osg::ref_ptr<const osgDB::Options> dbo = readOptions ? readOptions : _rwOptions.get();
+
+        return read(key, [&](std::istream& in) { return rw->readObject(in, dbo.get()); });
+    }
+
+    ReadResult
+    PackCacheBin::readString(const std::string& key, const osgDB::Options* readOptions)
+    {
+        ReadResult r = readObject(key, readOptions);
+        if ( r.succeeded() )
+        {
+            if ( r.get<StringObject>() )
+                return r;
+            else
+                return ReadResult("Empty string");
+        }
+        else
+        {
+            return r;
+        }
+    }
+
+    bool
+    PackCacheBin::write(
+        const std::string& key,
+        const osg::Object* object,
+        const Config& meta,
+        const osgDB::Options* writeOptions)
+    {
+        OE_PROFILING_ZONE;
+
+        if (!_ok || !object)
+            return false;
+
+        bool isNode = dynamic_cast<const osg::Node*>(object) != nullptr;
+        if (isNode && _options.enableNodeCaching() == false)
+            return true;
+
+        const osgDB::Options* dbo = writeOptions ? writeOptions : _rwOptions.get();
+
+        std::stringstream datastream;
+        osgDB::ReaderWriter::WriteResult r;
+
+        if (dynamic_cast<const osg::Image*>(object))
+        {
+            const osg::Image* image = static_cast<const osg::Image*>(object);
+            OE_SOFT_ASSERT_AND_RETURN(image->isCompressed() == false, false);
+            r = _rw->writeImage(*image, datastream, dbo);
+        }
+        else if (isNode)
+        {
+            r = _rw->writeNode(*static_cast<const osg::Node*>(object), datastream, dbo);
+        }
+        else
+        {
+            r = _rw->writeObject(*object, datastream, dbo);
+        }
+
+        bool ok =
+            r.success() &&
+            _pack.append(key, meta.empty() ? std::string() : meta.toJSON(false), datastream.str(), DateTime().asTimeStamp());
+
+        if (!ok)
+        {
+            OE_WARN << LC << "FAILED to write \"" << key << "\" to cache bin \"" <<
+                getID() << "\"; msg = \"" << r.message() << "\"" << std::endl;
+        }
+        else
+        {
+            if (_debug)
+                OE_NOTICE << LC << "Wrote \"" << key << "\" to cache bin [" << getID() << "]" << std::endl;
+
+            postWrite();
+        }
+
+        return ok;
+    }
+
+    void
+    PackCacheBin::postWrite()
+    {
+        std::uint64_t minSize = (std::uint64_t)_options.minCompactionSizeMB().get() * 1048576u;
+
+        if (_pack.needsCompaction(_options.compactionRatio().get(), minSize) &&
+            _compacting.exchange(true) == false)
+        {
+            // keep the bin alive until the job completes
+            osg::ref_ptr<PackCacheBin> bin(this);
+
+            jobs::dispatch([bin]() {
+                    bin->_pack.compact();
+                    bin->_compacting = false;
+                },
+                jobs::context{ "oe.packcache.compact", jobs::get_pool("oe.packcache") });
+        }
+    }
+
+    CacheBin::RecordStatus
+    PackCacheBin::getRecordStatus(const std::string& key)
+    {
+        return _ok && _pack.contains(key) ? STATUS_OK : STATUS_NOT_FOUND;
+    }
+
+    bool
+    PackCacheBin::remove(const std::string& key)
+    {
+        return _ok && _pack.remove(key);
+    }
+
+    bool
+    PackCacheBin::touch(const std::string& key)
+    {
+        return _ok && _pack.touch(key, DateTime().asTimeStamp());
+    }
+
+    bool
+    PackCacheBin::clear()
+    {
+        return _ok && _pack.clear();
+    }
+
+    bool
+    PackCacheBin::compact()
+    {
+        if (!_ok || _compacting.exchange(true))
+            return false;
+
+        bool ok = _pack.compact();
+        _compacting = false;
+        return ok;
+    }
+
+    unsigned
+    PackCacheBin::getStorageSize()
+    {
+        return _ok ? (unsigned)std::min(_pack.size(), (std::uint64_t)UINT_MAX) : 0u;
+    }
+}
+
+//------------------------------------------------------------------------
+
+/**
+ * Cache driver that appends records to large pack files rather than
+ * writing one file per record.
+ */
+class PackCacheDriver : public CacheDriver
+{
+public:
+    PackCacheDriver()
+    {
+        supportsExtension( "osgearth_cache_pack", "Pack file cache for osgEarth" );
+    }
+
+    virtual const char* className() const
+    {
+        return "Pack file cache for osgEarth";
+    }
+
+    virtual ReadResult readObject(const std::string& file_name, const Options* options) const
+    {
+        if ( !acceptsExtension(osgDB::getLowerCaseFileExtension( file_name )))
+            return ReadResult::FILE_NOT_HANDLED;
+
+        return ReadResult( new PackCache( getCacheOptions(options) ) );
+    }
+};
+
+REGISTER_OSGPLUGIN(osgearth_cache_pack, PackCacheDriver)
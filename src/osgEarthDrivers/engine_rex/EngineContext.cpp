@@ -18,6 +18,7 @@ EngineContext::EngineContext(
     TerrainEngineNode* terrainEngine,
     GeometryPool* geometryPool,
     Merger* merger,
+    Prefetcher* prefetcher,
     TileNodeRegistry::Ptr          tiles,
     const RenderBindings& renderBindings,
     const SelectionInfo& selectionInfo,
@@ -27,6 +28,7 @@ EngineContext::EngineContext(
     _terrainEngine(terrainEngine),
     _geometryPool(geometryPool),
     _merger(merger),
+    _prefetcher(prefetcher),
     _tiles(tiles),
     _renderBindings(renderBindings),
     _options(terrainEngine->getOptions()),
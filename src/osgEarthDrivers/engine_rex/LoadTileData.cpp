@@ -6,6 +6,7 @@
 #include "SurfaceNode"
 #include "TileNode"
 #include "EngineContext"
+#include "Prefetcher"
 
 #include <osgEarth/TerrainEngineNode>
 #include <osgEarth/Terrain>
@@ -27,6 +28,7 @@ LoadTileDataOperation::LoadTileDataOperation(
     _merged(false)
 {
     _engine = context->getEngine();
+    _prefetcher = context->getPrefetcher();
     _name = tilenode->getKey().str();
 }
 
@@ -42,6 +44,7 @@ LoadTileDataOperation::LoadTileDataOperation(
     _merged(false)
 {
     _engine = context->getEngine();
+    _prefetcher = context->getPrefetcher();
     _name = tilenode->getKey().str();
 }
 
@@ -72,6 +75,27 @@ LoadTileDataOperation::dispatch(bool async)
 
     TileKey key(_tilenode->getKey());
 
+    // Priority function. This return the maximum priority if the tile
+    // has disappeared so that it will be immediately rejected from the job queue.
+    // You can change it to -FLT_MAX to let it fester on the end of the queue,
+    // but that may slow down the job queue's sorting algorithm.
+    osg::observer_ptr<TileNode> tile_obs(_tilenode);
+    auto priority_func = [tile_obs]() -> float
+    {
+        if (tile_obs.valid() == false) return FLT_MAX; // quick trivial reject
+        osg::ref_ptr<TileNode> tilenode;
+        return tile_obs.lock(tilenode) ? tilenode->getLoadPriority() : FLT_MAX;
+    };
+
+    // A full-tile load may already be in flight (or done) courtesy of
+    // the prefetcher; if so, adopt that result instead of starting over.
+    osg::ref_ptr<Prefetcher> prefetcher;
+    if (async && _manifest.empty() && _prefetcher.lock(prefetcher) && prefetcher->isEnabled())
+    {
+        if (prefetcher->claim(key, priority_func, _result))
+            return true;
+    }
+
     auto load = [engine, map, key, manifest, enableCancel] (Cancelable& progress)
     {
         osg::ref_ptr<ProgressCallback> wrapper =
@@ -86,18 +110,6 @@ LoadTileDataOperation::dispatch(bool async)
         return result;
     };
 
-    // Priority function. This return the maximum priority if the tile
-    // has disappeared so that it will be immediately rejected from the job queue.
-    // You can change it to -FLT_MAX to let it fester on the end of the queue,
-    // but that may slow down the job queue's sorting algorithm.
-    osg::observer_ptr<TileNode> tile_obs(_tilenode);
-    auto priority_func = [tile_obs]() -> float
-    {
-        if (tile_obs.valid() == false) return FLT_MAX; // quick trivial reject
-        osg::ref_ptr<TileNode> tilenode;
-        return tile_obs.lock(tilenode) ? tilenode->getLoadPriority() : FLT_MAX;
-    };
-
 
     if (async)
     {
@@ -0,0 +1,187 @@
+/* osgEarth
+ * Copyright 2008-2014 Pelican Mapping
+ * MIT License
+ */
+#include "PrefetchQueue"
+#include <iterator>
+
+using namespace osgEarth;
+using namespace osgEarth::REX;
+
+namespace
+{
+    // most claimed keys to remember; the oldest are forgotten first
+    constexpr unsigned MAX_CLAIMED = 4096u;
+}
+
+void
+PrefetchQueue::remember(const TileKey& key)
+{
+    // assumes lock held
+    if (_claimed.count(key) == 0)
+    {
+        _claimedOrder.push_back(key);
+        _claimed[key] = std::prev(_claimedOrder.end());
+        if (_claimedOrder.size() > MAX_CLAIMED)
+        {
+            _claimed.erase(_claimedOrder.front());
+            _claimedOrder.pop_front();
+        }
+    }
+}
+
+void
+PrefetchQueue::forget(const TileKey& key)
+{
+    std::lock_guard<Threading::Mutex> lock(_mutex);
+    auto i = _claimed.find(key);
+    if (i != _claimed.end())
+    {
+        _claimedOrder.erase(i->second);
+        _claimed.erase(i);
+    }
+}
+
+bool
+PrefetchQueue::issue(
+    const TileKey& key,
+    const Loader& load,
+    unsigned frame,
+    jobs::jobpool* pool)
+{
+    std::lock_guard<Threading::Mutex> lock(_mutex);
+
+    if (_entries.count(key) > 0 || _claimed.count(key) > 0)
+        return false;
+
+    auto priority = std::make_shared<Priority>();
+
+    jobs::context job;
+    job.name = "prefetch " + key.str();
+    job.pool = pool;
+    job.priority = [priority]() { return (*priority)(); };
+
+    Entry& entry = _entries[key];
+    entry._result = jobs::dispatch(load, job);
+    entry._priority = priority;
+    entry._lastPredictedFrame = frame;
+
+    ++_stats.issued;
+    return true;
+}
+
+bool
+PrefetchQueue::touch(const TileKey& key, unsigned frame)
+{
+    std::lock_guard<Threading::Mutex> lock(_mutex);
+    auto i = _entries.find(key);
+    if (i == _entries.end())
+        return false;
+    i->second._lastPredictedFrame = frame;
+    return true;
+}
+
+void
+PrefetchQueue::prune(
+    unsigned frame,
+    bool cancelStale,
+    unsigned graceFrames,
+    unsigned expiryFrames)
+{
+    std::lock_guard<Threading::Mutex> lock(_mutex);
+
+    for (auto i = _entries.begin(); i != _entries.end(); )
+    {
+        Entry& entry = i->second;
+        unsigned age = frame - entry._lastPredictedFrame;
+
+        if (!entry._result.available())
+        {
+            // dropping the future cancels the job
+            if (cancelStale && age > graceFrames)
+            {
+                ++_stats.canceled;
+                i = _entries.erase(i);
+                continue;
+            }
+        }
+        else if (!entry._result.value().valid() || age > expiryFrames)
+        {
+            ++_stats.expired;
+            i = _entries.erase(i);
+            continue;
+        }
+        ++i;
+    }
+}
+
+bool
+PrefetchQueue::claim(
+    const TileKey& key,
+    const std::function<float()>& priority,
+    Threading::Future<Result>& out)
+{
+    std::lock_guard<Threading::Mutex> lock(_mutex);
+
+    // Either way, this tile is now loading; don't speculate on it again.
+    remember(key);
+
+    auto i = _entries.find(key);
+    if (i == _entries.end())
+        return false;
+
+    Entry& entry = i->second;
+
+    if (entry._result.available())
+    {
+        if (!entry._result.value().valid())
+        {
+            _entries.erase(i);
+            return false;
+        }
+        ++_stats.hits;
+    }
+    else
+    {
+        // still in the queue or running: follow the tile's priority from now on
+        std::atomic_store(&entry._priority->_func,
+            std::make_shared<const std::function<float()>>(priority));
+        ++_stats.lateHits;
+    }
+
+    // Hand over the future; erasing our copy leaves the caller as the only
+    // owner, so the normal cancelation rules apply from here on.
+    out = entry._result;
+    _entries.erase(i);
+    return true;
+}
+
+void
+PrefetchQueue::cancelAll()
+{
+    std::lock_guard<Threading::Mutex> lock(_mutex);
+    _entries.clear();
+}
+
+void
+PrefetchQueue::clear()
+{
+    std::lock_guard<Threading::Mutex> lock(_mutex);
+    _entries.clear();
+    _claimed.clear();
+    _claimedOrder.clear();
+}
+
+std::size_t
+PrefetchQueue::size() const
+{
+    std::lock_guard<Threading::Mutex> lock(_mutex);
+    return _entries.size();
+}
+
+PrefetchQueue::Stats
+PrefetchQueue::getStats() const
+{
+    std::lock_guard<Threading::Mutex> lock(_mutex);
+    return _stats;
+}
@@ -0,0 +1,239 @@
+/* osgEarth
+ * Copyright 2008-2014 Pelican Mapping
+ * MIT License
+ */
+#include "Prefetcher"
+#include "EngineContext"
+#include "SelectionInfo"
+
+#include <osgEarth/TerrainEngineNode>
+#include <osgEarth/FrameClock>
+#include <osgEarth/Progress>
+#include <osgEarth/Metrics>
+#include <algorithm>
+
+using namespace osgEarth;
+using namespace osgEarth::REX;
+
+#undef LC
+#define LC "[Prefetcher] "
+
+namespace
+{
+    // number of eye samples used to estimate camera velocity
+    constexpr unsigned HISTORY_SIZE = 8u;
+
+    // frames a pending load may drop off the predicted path before we cancel it;
+    // absorbs jitter when the prediction sits right on a tile boundary
+    constexpr unsigned CANCEL_GRACE_FRAMES = 2u;
+
+    // below this predicted displacement (meters) the camera is considered
+    // stationary and we leave the current speculative loads alone
+    constexpr double MIN_DISPLACEMENT = 1.0;
+}
+
+Prefetcher::Prefetcher() :
+    _lookaheadFrames(0u),
+    _prefetchesPerFrame(4u),
+    _lastFrame(~0u)
+{
+    //nop
+}
+
+void
+Prefetcher::setLookaheadFrames(unsigned value)
+{
+    std::lock_guard<Threading::Mutex> lock(_mutex);
+    _lookaheadFrames = value;
+    if (_lookaheadFrames == 0u)
+    {
+        _queue.cancelAll();
+        _history.clear();
+    }
+}
+
+void
+Prefetcher::setPrefetchesPerFrame(unsigned value)
+{
+    std::lock_guard<Threading::Mutex> lock(_mutex);
+    _prefetchesPerFrame = value;
+}
+
+void
+Prefetcher::clear()
+{
+    std::lock_guard<Threading::Mutex> lock(_mutex);
+
+    // dropping the futures cancels any jobs still in the queue
+    _queue.clear();
+    _history.clear();
+    _camera = nullptr;
+    _lastFrame = ~0u;
+}
+
+Prefetcher::Stats
+Prefetcher::getStats() const
+{
+    return _queue.getStats();
+}
+
+void
+Prefetcher::forget(const TileKey& key)
+{
+    _queue.forget(key);
+}
+
+void
+Prefetcher::predict(
+    const osg::Vec3d& world,
+    EngineContext* context,
+    std::vector<TileKey>& out) const
+{
+    osg::ref_ptr<const Map> map = context->getMap();
+    if (!map.valid())
+        return;
+
+    const SelectionInfo& si = context->getSelectionInfo();
+    if (si.getNumLODs() == 0)
+        return;
+
+    GeoPoint point;
+    if (!point.fromWorld(map->getSRS(), world))
+        return;
+
+    // Choose the deepest LOD whose visibility range reaches the ground
+    // below the predicted eye; that's the tile the culler will ask for.
+    double height = std::max(point.z(), 1.0);
+    unsigned firstLOD = context->options().getFirstLOD();
+    unsigned maxLOD = std::min(context->options().getMaxLOD(), si.getNumLODs() - 1);
+    unsigned lod = firstLOD;
+    for (unsigned i = firstLOD; i <= maxLOD; ++i)
+    {
+        if (si.getLOD(i)._visibilityRange >= height)
+            lod = i;
+        else
+            break;
+    }
+
+    TileKey key = map->getProfile()->createTileKey(point, lod);
+    if (!key.valid())
+        return;
+
+    for (int dy = -1; dy <= 1; ++dy)
+    {
+        for (int dx = -1; dx <= 1; ++dx)
+        {
+            TileKey k = (dx == 0 && dy == 0) ? key : key.createNeighborKey(dx, dy);
+            if (k.valid() && std::find(out.begin(), out.end(), k) == out.end())
+                out.push_back(k);
+        }
+    }
+}
+
+void
+Prefetcher::cull(osgUtil::CullVisitor& cv, EngineContext* context)
+{
+    if (!isEnabled() || context == nullptr || context->getClock() == nullptr)
+        return;
+
+    // Only track one "real" camera; nested RTT/shadow cameras would
+    // scramble the motion history.
+    osg::Camera* camera = cv.getCurrentCamera();
+    if (camera == nullptr ||
+        camera->getView() == nullptr ||
+        camera->getReferenceFrame() == osg::Transform::ABSOLUTE_RF_INHERIT_VIEWPOINT)
+    {
+        return;
+    }
+
+    std::lock_guard<Threading::Mutex> lock(_mutex);
+
+    if (!_camera.valid())
+        _camera = camera;
+    else if (_camera.get() != camera)
+        return;
+
+    unsigned frame = context->getClock()->getFrame();
+    if (frame == _lastFrame)
+        return;
+    _lastFrame = frame;
+
+    OE_PROFILING_ZONE;
+
+    // record the eye position
+    osg::Vec3d eye = osg::Vec3d(0, 0, 0) * camera->getInverseViewMatrix();
+    _history.push_back(Sample{ context->getClock()->getTime(), eye });
+    if (_history.size() > HISTORY_SIZE)
+        _history.pop_front();
+
+    if (_history.size() < 3)
+        return;
+
+    double elapsed = _history.back()._time - _history.front()._time;
+    if (elapsed <= 0.0)
+        return;
+
+    // Linear extrapolation from the recent frames
+    osg::Vec3d velocity = (_history.back()._eye - _history.front()._eye) / elapsed;
+    double frameTime = elapsed / (double)(_history.size() - 1);
+    double lookahead = frameTime * (double)_lookaheadFrames;
+    osg::Vec3d displacement = velocity * lookahead;
+
+    bool moving = displacement.length() >= MIN_DISPLACEMENT;
+
+    if (moving)
+    {
+        std::vector<TileKey> keys;
+        predict(eye + displacement * 0.5, context, keys);
+        predict(eye + displacement, context, keys);
+
+        osg::ref_ptr<TerrainEngineNode> engine = context->getEngine();
+        osg::ref_ptr<const Map> map = context->getMap();
+
+        unsigned budget = _prefetchesPerFrame;
+
+        for (auto& key : keys)
+        {
+            if (_queue.touch(key, frame))
+                continue;
+
+            if (budget == 0u || !engine.valid() || !map.valid())
+                continue;
+
+            auto load = [engine, map, key](Cancelable& progress)
+            {
+                osg::ref_ptr<ProgressCallback> wrapper = new ProgressCallback(&progress);
+
+                osg::ref_ptr<TerrainTileModel> result = engine->createTileModel(
+                    map.get(),
+                    key,
+                    CreateTileManifest(),
+                    wrapper.get());
+
+                return result;
+            };
+
+            if (_queue.issue(key, load, frame, jobs::get_pool(ARENA_LOAD_TILE)))
+                --budget;
+        }
+    }
+
+    // Cancel pending loads that fell off the path, and expire finished
+    // results that nobody claimed.
+    unsigned expiry = std::max(60u, 4u * _lookaheadFrames);
+    _queue.prune(frame, moving, CANCEL_GRACE_FRAMES, expiry);
+
+    Stats stats = _queue.getStats();
+    OE_PROFILING_PLOT("REX prefetch hit rate", stats.hitRate());
+    OE_PROFILING_PLOT("REX prefetch pending", (float)_queue.size());
+    OE_PROFILING_PLOT("REX prefetch canceled", (float)stats.canceled);
+}
+
+bool
+Prefetcher::claim(
+    const TileKey& key,
+    const std::function<float()>& priority,
+    Future<osg::ref_ptr<TerrainTileModel>>& out)
+{
+    return _queue.claim(key, priority, out);
+}
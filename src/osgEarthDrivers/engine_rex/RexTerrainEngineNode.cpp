@@ -24,6 +24,7 @@
 #include <osg/Depth>
 #include <osg/CullFace>
 
+#include <algorithm>
 #include <cstdlib> // for getenv
 
 #define LC "[RexTerrainEngineNode] "
@@ -208,6 +209,8 @@ RexTerrainEngineNode::shutdown()
 {
     TerrainEngineNode::shutdown();
     _merger->clear();
+    if (_prefetcher.valid())
+        _prefetcher->clear();
 }
 
 std::string
@@ -282,6 +285,11 @@ RexTerrainEngineNode::onSetMap()
     _merger->setMergesPerFrame(options.getMergesPerFrame());
     this->addChild(_merger.get());
 
+    // Speculative tile loader (disabled unless prefetch_frames > 0)
+    _prefetcher = new Prefetcher();
+    _prefetcher->setLookaheadFrames(options.getPrefetchFrames());
+    _prefetcher->setPrefetchesPerFrame(options.getPrefetchesPerFrame());
+
     // Loader concurrency (size of the thread pool)
     unsigned concurrency = options.getConcurrency();
     const char* concurrency_str = ::getenv("OSGEARTH_TERRAIN_CONCURRENCY");
@@ -289,6 +297,10 @@ RexTerrainEngineNode::onSetMap()
         concurrency = Strings::as<unsigned>(concurrency_str, concurrency);
     jobs::get_pool(ARENA_LOAD_TILE)->set_concurrency(concurrency);
 
+    // Layer fetch pool: enough threads to keep every tile job's layers moving at once
+    if (options.getLoadLayersInParallel() == true)
+        jobs::get_pool(ARENA_TERRAIN_LAYERS)->set_concurrency(std::max(2u, 2u * concurrency));
+
     // Make a tile unloader
     _unloader = new UnloaderGroup(_tiles.get(), getOptions());
     _unloader->setFrameClock(&_clock);
@@ -316,6 +328,7 @@ RexTerrainEngineNode::onSetMap()
         this, // engine
         _geometryPool.get(),
         _merger.get(),
+        _prefetcher.get(),
         _tiles,
         _renderBindings,
         _selectionInfo,
@@ -511,6 +524,10 @@ RexTerrainEngineNode::refresh(bool forceDirty)
         // clear the loader:
         _merger->clear();
 
+        // cancel any speculative loads:
+        if (_prefetcher.valid())
+            _prefetcher->clear();
+
         // clear out the tile registry:
         if (_tiles)
         {
@@ -704,8 +721,14 @@ RexTerrainEngineNode::dirtyTerrainOptions()
 
     _merger->setMergesPerFrame(options.getMergesPerFrame());
 
+    _prefetcher->setLookaheadFrames(options.getPrefetchFrames());
+    _prefetcher->setPrefetchesPerFrame(options.getPrefetchesPerFrame());
+
     jobs::get_pool(ARENA_LOAD_TILE)->set_concurrency(options.getConcurrency());
 
+    if (options.getLoadLayersInParallel() == true)
+        jobs::get_pool(ARENA_TERRAIN_LAYERS)->set_concurrency(std::max(2u, 2u * options.getConcurrency()));
+
     updateState();
 }
 
@@ -748,6 +771,10 @@ RexTerrainEngineNode::cull_traverse(osg::NodeVisitor& nv)
     // Assemble the terrain drawables:
     _terrain->accept(culler);
 
+    // Speculatively load tiles along the camera's predicted path:
+    if (_prefetcher.valid())
+        _prefetcher->cull(*cv, getEngineContext());
+
     // If we're using geometry pooling, optimize the drawable forf shared state
     // by sorting the draw commands.
     // Skip if using GL4/indirect rendering. Actually seems to hurt?
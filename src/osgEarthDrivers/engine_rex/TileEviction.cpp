@@ -0,0 +1,87 @@
+/* osgEarth
+* Copyright 2008-2014 Pelican Mapping
+* MIT License
+*/
+#include "TileEviction"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace osgEarth::REX;
+
+std::vector<unsigned>
+TileEviction::select(
+    const std::vector<Tile>& tiles,
+    std::size_t totalBytes,
+    std::size_t maxBytes,
+    unsigned maxTiles)
+{
+    std::vector<unsigned> output;
+
+    if (totalBytes <= maxBytes)
+        return output;
+
+    struct Quad
+    {
+        std::vector<unsigned> members;
+        unsigned siblings = 0u;
+        float priority = 0.0f;
+        std::size_t bytes = 0u;
+        bool evictable = true;
+    };
+
+    // quads in order of first appearance, so equal priorities resolve
+    // the same way every time
+    std::vector<Quad> quads;
+    std::unordered_map<const void*, unsigned> quadIndex;
+
+    for (unsigned t = 0; t < tiles.size(); ++t)
+    {
+        const Tile& tile = tiles[t];
+        if (!tile.parent)
+            continue;
+
+        auto i = quadIndex.find(tile.parent);
+        if (i == quadIndex.end())
+        {
+            i = quadIndex.emplace(tile.parent, (unsigned)quads.size()).first;
+            quads.emplace_back();
+            quads.back().siblings = tile.siblings;
+        }
+
+        Quad& quad = quads[i->second];
+        quad.members.push_back(t);
+
+        if (!tile.idle)
+            quad.evictable = false;
+
+        quad.priority = std::max(quad.priority, tile.priority);
+        quad.bytes += tile.bytes;
+    }
+
+    std::vector<const Quad*> candidates;
+    for (auto& quad : quads)
+    {
+        if (quad.evictable && quad.siblings == quad.members.size())
+            candidates.push_back(&quad);
+    }
+
+    std::stable_sort(
+        candidates.begin(), candidates.end(),
+        [](const Quad* lhs, const Quad* rhs) {
+            return lhs->priority < rhs->priority;
+        });
+
+    std::size_t total = totalBytes;
+
+    for (auto* quad : candidates)
+    {
+        if (total <= maxBytes || output.size() >= maxTiles)
+            break;
+
+        output.insert(output.end(), quad->members.begin(), quad->members.end());
+        total -= std::min(total, quad->bytes);
+    }
+
+    return output;
+}
@@ -15,6 +15,7 @@
 #include <osgEarth/ImageUtils>
 #include <osgEarth/Metrics>
 #include <osgEarth/Notify>
+#include <algorithm>
 
 using namespace osgEarth::REX;
 using namespace osgEarth;
@@ -195,6 +196,7 @@ TileNode::initializeData()
     }
 
     // register me.
+    computeSizeInBytes();
     _context->tiles()->add( this );
 
     // tell the world.
@@ -523,7 +525,8 @@ TileNode::traverse(osg::NodeVisitor& nv)
         // update the timestamp so this tile doesn't become dormant.
         _lastTraversalFrame.exchange(_context->getClock()->getFrame());
         _lastTraversalTime = _context->getClock()->getTime();
-        _lastTraversalRange = std::min(_lastTraversalRange, nv.getDistanceToViewPoint(getBound().center(), true));
+        _lastVisitRange = nv.getDistanceToViewPoint(getBound().center(), true);
+        _lastTraversalRange = std::min(_lastTraversalRange, _lastVisitRange);
 
         _context->tiles()->touch(this, nv);
 
@@ -1089,6 +1092,101 @@ TileNode::merge(const TerrainTileModel* model, const CreateTileManifest& manifes
 
     // Bump the data revision for the tile.
     ++_revision;
+
+    // Update the memory accounting.
+    computeSizeInBytes();
+    _context->tiles()->updateSizeInBytes(this);
+}
+
+namespace
+{
+    // Estimated bytes held by one texture: the CPU image copy (if kept)
+    // plus the GPU allocation, including a mipmap chain if one will be generated.
+    std::size_t getTextureSizeInBytes(const Texture::Ptr& tex)
+    {
+        const osg::Texture* osgTex = tex->osgTexture().get();
+        if (!osgTex)
+            return 0u;
+
+        std::size_t total = 0u;
+        for (unsigned i = 0; i < osgTex->getNumImages(); ++i)
+        {
+            const osg::Image* image = osgTex->getImage(i);
+            if (!image)
+                continue;
+
+            std::size_t bytes = image->getTotalSizeInBytesIncludingMipmaps();
+            std::size_t gpu = bytes;
+            if (tex->mipmap() && !image->isMipmap())
+                gpu += bytes / 3u;
+
+            total += gpu + (tex->keepImage() ? bytes : 0u);
+        }
+        return total;
+    }
+}
+
+void
+TileNode::computeSizeInBytes()
+{
+    std::size_t total = 0u;
+
+    // count each owned texture once (COLOR and COLOR_PARENT may share one)
+    std::vector<const Texture*> counted;
+    auto add = [&](const Sampler& sampler)
+    {
+        if (sampler.ownsTexture() &&
+            std::find(counted.begin(), counted.end(), sampler._texture.get()) == counted.end())
+        {
+            counted.push_back(sampler._texture.get());
+            total += getTextureSizeInBytes(sampler._texture);
+        }
+    };
+
+    for (const auto& pass : _renderModel._passes)
+        for (unsigned s = 0; s < pass.samplers().size(); ++s)
+            add(pass.sampler(s));
+
+    for (unsigned s = 0; s < _renderModel._sharedSamplers.size(); ++s)
+        add(_renderModel._sharedSamplers[s]);
+
+    // Pooled geometry is shared by many tiles, so only count it
+    // when this tile has its own copy.
+    if (_surface.valid() && _surface->_drawable.valid())
+    {
+        const SharedGeometry* geom = _surface->_drawable->_geom.get();
+        if (geom && (geom->hasConstraints() || !_context->getGeometryPool()->isEnabled()))
+        {
+            auto arrayBytes = [](const osg::Array* a) -> std::size_t {
+                return a ? a->getTotalDataSize() : 0u;
+            };
+            total += arrayBytes(geom->getVertexArray());
+            total += arrayBytes(geom->getNormalArray());
+            total += arrayBytes(geom->getTexCoordArray());
+            total += arrayBytes(geom->getNeighborArray());
+            total += arrayBytes(geom->getNeighborNormalArray());
+            if (geom->getDrawElements())
+                total += geom->getDrawElements()->getTotalDataSize();
+            total += geom->_verts.size() * sizeof(GL4Vertex);
+        }
+    }
+
+    _sizeInBytes = total;
+}
+
+float
+TileNode::getRetentionPriority(double now) const
+{
+    if (_lastVisitRange == FLT_MAX)
+        return 0.0f;
+
+    // A tile's screen-space error scales with its size over its distance;
+    // its LOD's visibility range stands in for the size term.
+    const SelectionInfo& si = _context->getSelectionInfo();
+    float range = si.getLOD(_key.getLOD())._visibilityRange;
+    float error = range / std::max(_lastVisitRange, 1.0f);
+    double age = std::max(now - _lastTraversalTime, 0.0);
+    return error / (float)(1.0 + age);
 }
 
 void TileNode::inheritSharedSampler(int binding)
@@ -1352,9 +1450,16 @@ void
 TileNode::removeSubTiles()
 {
     _childrenReady = false;
+
+    // unloaded tiles may be prefetched again
+    Prefetcher* prefetcher = _context.valid() ? _context->getPrefetcher() : nullptr;
+
     for(int i=0; i<(int)getNumChildren(); ++i)
     {
         getChild(i)->releaseGLObjects(nullptr);
+
+        if (prefetcher)
+            prefetcher->forget(getSubTile(i)->getKey());
     }
     this->removeChildren(0, this->getNumChildren());
 
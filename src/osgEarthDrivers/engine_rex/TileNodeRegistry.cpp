@@ -3,8 +3,10 @@
 * MIT License
 */
 #include "TileNodeRegistry"
+#include "TileEviction"
 
 #include <osgEarth/Metrics>
+#include <algorithm>
 
 using namespace osgEarth::REX;
 using namespace osgEarth;
@@ -16,10 +18,12 @@ using namespace osgEarth;
 #define SENTRY_VALUE nullptr
 
 #define PROFILING_REX_TILES "Live Terrain Tiles"
+#define PROFILING_REX_TILE_MEMORY "Live Terrain Tile Memory (MB)"
 
 //----------------------------------------------------------------------------
 
 TileNodeRegistry::TileNodeRegistry() :
+    _totalBytes(0u),
     _notifyNeighbors(false)
 {
     //nop
@@ -65,6 +69,9 @@ TileNodeRegistry::add(TileNode* tile)
 
     auto& entry = _tiles[tile->getKey()];
     entry._tile = tile;
+    _totalBytes -= entry._bytes;
+    entry._bytes = tile->getSizeInBytes();
+    _totalBytes += entry._bytes;
     bool recyclingOrphan = entry._trackerToken != nullptr;
     entry._trackerToken = _tracker.use(tile, nullptr);
 
@@ -108,6 +115,29 @@ TileNodeRegistry::add(TileNode* tile)
     }
 }
 
+void
+TileNodeRegistry::updateSizeInBytes(TileNode* tile)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto i = _tiles.find(tile->getKey());
+    if (i != _tiles.end() && i->second._tile.get() == tile)
+    {
+        _totalBytes -= i->second._bytes;
+        i->second._bytes = tile->getSizeInBytes();
+        _totalBytes += i->second._bytes;
+
+        plotMemory();
+    }
+}
+
+void
+TileNodeRegistry::plotMemory() const
+{
+    // ASSUME EXCLUSIVE LOCK
+    OE_PROFILING_PLOT(PROFILING_REX_TILE_MEMORY, (float)((double)_totalBytes / 1048576.0));
+}
+
 void
 TileNodeRegistry::startListeningFor(
     const TileKey& tileToWaitFor,
@@ -163,6 +193,7 @@ TileNodeRegistry::releaseAll(osg::State* state)
         tile.second._tile->releaseGLObjects(state);
     }
     _tiles.clear();
+    _totalBytes = 0u;
 
     _tracker.reset();
 
@@ -171,6 +202,7 @@ TileNodeRegistry::releaseAll(osg::State* state)
     _tilesToUpdate.clear();
 
     OE_PROFILING_PLOT(PROFILING_REX_TILES, (float)(_tiles.size()));
+    plotMemory();
 }
 
 void
@@ -254,7 +286,12 @@ TileNodeRegistry::collectDormantTiles(
 
             output.push_back(tile);
 
-            _tiles.erase(key);
+            auto i = _tiles.find(key);
+            if (i != _tiles.end())
+            {
+                _totalBytes -= i->second._bytes;
+                _tiles.erase(i);
+            }
 
             return true; // dispose it
         }
@@ -269,4 +306,72 @@ TileNodeRegistry::collectDormantTiles(
     _tracker.flush(maxTiles, disposeTile);
 
     OE_PROFILING_PLOT(PROFILING_REX_TILES, (float)(_tiles.size()));
+    plotMemory();
+}
+
+void
+TileNodeRegistry::collectTilesOverBudget(
+    std::size_t maxBytes,
+    unsigned maxTiles,
+    std::vector<osg::observer_ptr<TileNode>>& output)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_totalBytes <= maxBytes || _clock == nullptr)
+        return;
+
+    OE_PROFILING_ZONE;
+
+    // Same minimum as TileNode::isDormant; anything visited more recently
+    // than this is probably still on screen.
+    const unsigned minIdleFrames = 3u;
+    unsigned frame = _clock->getFrame();
+    double now = _clock->getTime();
+
+    // Describe each tile to the eviction planner, which picks whole quads
+    // of idle leaves in order of retention priority.
+    std::vector<TileTable::iterator> entries;
+    std::vector<TileEviction::Tile> tiles;
+    entries.reserve(_tiles.size());
+    tiles.reserve(_tiles.size());
+
+    for (auto i = _tiles.begin(); i != _tiles.end(); ++i)
+    {
+        TileNode* tile = i->second._tile.get();
+        const TileNode* parent = tile->getParentTile();
+
+        TileEviction::Tile t;
+        t.parent = parent;
+        t.siblings = parent ? parent->getNumChildren() : 0u;
+        t.idle =
+            !tile->getDoNotExpire() &&
+            tile->getNumChildren() == 0 &&
+            frame - (unsigned)tile->getLastTraversalFrame() > minIdleFrames;
+        t.priority = t.idle ? tile->getRetentionPriority(now) : 0.0f;
+        t.bytes = i->second._bytes;
+
+        entries.push_back(i);
+        tiles.push_back(t);
+    }
+
+    for (auto index : TileEviction::select(tiles, _totalBytes, maxBytes, maxTiles))
+    {
+        auto i = entries[index];
+        const TileKey& key = i->first;
+
+        if (_notifyNeighbors)
+        {
+            stopListeningFor(key.createNeighborKey(1, 0), key);
+            stopListeningFor(key.createNeighborKey(0, 1), key);
+        }
+
+        output.push_back(i->second._tile.get());
+
+        _tracker.remove(i->second._trackerToken);
+        _totalBytes -= i->second._bytes;
+        _tiles.erase(i);
+    }
+
+    OE_PROFILING_PLOT(PROFILING_REX_TILES, (float)(_tiles.size()));
+    plotMemory();
 }
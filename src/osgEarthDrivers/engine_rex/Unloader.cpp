@@ -35,6 +35,22 @@ UnloaderGroup::traverse(osg::NodeVisitor& nv)
         unsigned frame = _clock->getFrame();
         bool runUpdate = (_frameLastUpdated < frame);
 
+        // Hard memory budget: collect the least important idle tiles first,
+        // regardless of the expiry thresholds.
+        std::size_t budget = (std::size_t)_options.getMemoryBudget() * 1048576u;
+
+        if (runUpdate && budget > 0u && _tiles->getTotalSizeInBytes() > budget)
+        {
+            _frameLastUpdated = frame;
+
+            OE_PROFILING_ZONE_NAMED("Enforce Memory Budget");
+
+            _tiles->collectTilesOverBudget(
+                budget,
+                _options.getMaxTilesToUnloadPerFrame(),
+                _deadpool);
+        }
+
         if (runUpdate && _tiles->size() > _options.getMinResidentTiles())
         {
             _frameLastUpdated = frame;
@@ -43,8 +59,6 @@ UnloaderGroup::traverse(osg::NodeVisitor& nv)
 
             double now = _clock->getTime();
 
-            unsigned count = 0u;
-
             // Have to enforce both the time delay AND a frame delay since the frames can
             // stop while the time rolls on (e.g., if you are dragging the window)
             double oldestAllowableTime = now - _options.getMinExpiryTime();
@@ -58,6 +72,11 @@ UnloaderGroup::traverse(osg::NodeVisitor& nv)
                 _options.getMinExpiryRange(),
                 _options.getMaxTilesToUnloadPerFrame(),
                 _deadpool);
+        }
+
+        if (_deadpool.empty() == false)
+        {
+            unsigned count = 0u;
 
             // Remove them from the scene graph:
             for(auto& tile_weakptr : _deadpool)
@@ -83,10 +102,7 @@ UnloaderGroup::traverse(osg::NodeVisitor& nv)
                 }
             }
 
-            if (_deadpool.empty() == false)
-            {
-                //OE_DEBUG << LC << "Unloaded " << count << " of " << _deadpool.size() << " dormant tiles; " << _tiles->size() << " remain active." << std::endl;
-            }
+            //OE_DEBUG << LC << "Unloaded " << count << " of " << _deadpool.size() << " dormant tiles; " << _tiles->size() << " remain active." << std::endl;
 
             _deadpool.clear();
         }
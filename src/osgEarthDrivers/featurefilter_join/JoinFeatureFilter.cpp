@@ -96,10 +96,10 @@ public: // FeatureFilter
                     if (boundary->getGeometry()->intersects(feature->getGeometry()))
                     {
                         // Copy the attributes from the boundary to the feature (and overwrite)
-                        for (const auto& attr : boundary->getAttrs())
+                        boundary->forEachAttr([&](const std::string& name, const AttributeValue& value)
                         {
-                            feature->set(attr.first, attr.second);
-                        }
+                            feature->set(name, value);
+                        });
 
                         // upon success, don't check any more boundaries:
                         break;
@@ -162,22 +162,21 @@ namespace
 
                 duk_idx_t props_i = duk_push_object(ctx);   // [global] [feature] [properties]
                 {
-                    const AttributeTable& attrs = feature->getAttrs();
-                    for(AttributeTable::const_iterator a = attrs.begin(); a != attrs.end(); ++a)
+                    feature->forEachAttr([&](const std::string& name, const AttributeValue& value)
                     {
-                        AttributeType type = a->second.type;
+                        AttributeType type = value.type;
                         switch(type) {
-                        case ATTRTYPE_DOUBLE: duk_push_number (ctx, a->second.getDouble()); break;          // [global] [feature] [properties] [name]
-                        case ATTRTYPE_INT:    duk_push_number(ctx, (double)a->second.getInt()); break;             // [global] [feature] [properties] [name]
-                        case ATTRTYPE_BOOL:   duk_push_boolean(ctx, a->second.getBool()?1:0); break;            // [global] [feature] [properties] [name]
+                        case ATTRTYPE_DOUBLE: duk_push_number (ctx, value.getDouble()); break;          // [global] [feature] [properties] [name]
+                        case ATTRTYPE_INT:    duk_push_number(ctx, (double)value.getInt()); break;             // [global] [feature] [properties] [name]
+                        case ATTRTYPE_BOOL:   duk_push_boolean(ctx, value.getBool()?1:0); break;            // [global] [feature] [properties] [name]
 #if 0
                         case ATTRTYPE_DOUBLEARRAY: break;
 #endif
                         case ATTRTYPE_STRING:
-                        default:              duk_push_string (ctx, a->second.getString().c_str()); break;  // [global] [feature] [properties] [name]
+                        default:              duk_push_string (ctx, value.getString().c_str()); break;  // [global] [feature] [properties] [name]
                         }
-                        duk_put_prop_string(ctx, props_i, a->first.c_str()); // [global] [feature] [properties]
-                    }
+                        duk_put_prop_string(ctx, props_i, name.c_str()); // [global] [feature] [properties]
+                    });
                 }
                 duk_put_prop_string(ctx, feature_i, "properties"); // [global] [feature]
 
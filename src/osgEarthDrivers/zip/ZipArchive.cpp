@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <sstream>
 #include <cstdio>
 
@@ -48,17 +49,23 @@ void ZipArchive::close()
         std::lock_guard<std::mutex> lock(_zipMutex);
         if ( _zipLoaded )
         {
-            // close the file (on one thread since it's a shared file)
-            const PerThreadData& data = getDataNoLock();
+            _zipLoaded = false;
 
-            zip_close(data._zipHandle);
-            // clear out the file handles
-            _perThreadData.clear();
+            // close the idle handles. A handle still checked out by a
+            // reader is closed when that reader releases it.
+            std::vector<zip_t*> handles;
+            {
+                std::lock_guard<std::mutex> lock(_handlesMutex);
+                handles.swap(_idleHandles);
+            }
+            for (auto handle : handles)
+            {
+                zip_close(handle);
+            }
 
             // clear out the index.
             _zipIndex.clear();
-
-            _zipLoaded = false;
+            _zipNames.clear();
         }
     }
 }
@@ -91,13 +98,7 @@ bool ZipArchive::getFileNames(osgDB::Archive::FileNameList& fileNameList) const
 {
     if(_zipLoaded)
     {
-        ZipEntryMap::const_iterator iter = _zipIndex.begin();
-
-        for(;iter != _zipIndex.end(); ++iter)
-        {
-            fileNameList.push_back((*iter).first);
-        }
-
+        fileNameList.insert(fileNameList.end(), _zipNames.begin(), _zipNames.end());
         return true;
     }
     else
@@ -125,13 +126,15 @@ bool ZipArchive::open(const std::string& file, ArchiveStatus /*status*/, const o
             _password = ReadPassword(options);
 
             // open the zip file in this thread:
-            const PerThreadData& data = getDataNoLock();
+            zip_t* handle = acquireHandle();
 
-            // establish a shared (read-only) index:
-            if ( data._zipHandle != NULL )
+            // establish a shared (read-only) index, and keep the handle
+            // around for the first read:
+            if ( handle != NULL )
             {
-                IndexZipFiles( data._zipHandle );
+                IndexZipFiles( handle );
                 _zipLoaded = true;
+                releaseHandle( handle );
             }
         }
     }
@@ -345,12 +348,13 @@ osgDB::ReaderWriter* ZipArchive::ReadFromZipIndex(const std::string& filename, c
     zip_uint64_t idx;
     if (GetZipIndex(filename, idx))
     {
-        // fetch the handle for the current thread:
-        const PerThreadData& data = getData();
-        if (data._zipHandle != NULL)
+        // check out a handle for the duration of the read:
+        zip_t* handle = acquireHandle();
+        if (handle != NULL)
         {
             zip_file_t* zf;
-            if ((zf = zip_fopen_index(data._zipHandle, idx, 0)) != NULL)
+            bool read = false;
+            if ((zf = zip_fopen_index(handle, idx, 0)) != NULL)
             {
                 char buf[8192];
                 zip_int64_t n;
@@ -358,14 +362,19 @@ osgDB::ReaderWriter* ZipArchive::ReadFromZipIndex(const std::string& filename, c
                     streamIn.write(buf, (size_t)n);
                 }
                 zip_fclose(zf);
+                read = true;
+            }
+
+            releaseHandle(handle);
 
+            if (read)
+            {
                 std::string file_ext = osgDB::getFileExtension(filename);
                 osgDB::ReaderWriter* rw = osgDB::Registry::instance()->getReaderWriterForExtension(file_ext);
                 if (rw != NULL)
                 {
                     return rw;
                 }
-
             }
         }
     }
@@ -408,15 +417,20 @@ void ZipArchive::IndexZipFiles(zip_t* zip)
             CleanupFileString(name);
             if (!name.empty())
             {
-                _zipIndex.insert(ZipEntryMapping(name, i));
+                if (_zipIndex.insert(ZipEntryMapping(name, i)).second)
+                {
+                    _zipNames.push_back(name);
+                }
             }
         }
+
+        std::sort(_zipNames.begin(), _zipNames.end());
     }
 }
 
 bool ZipArchive::GetZipIndex(const std::string& filename, zip_uint64_t& idx) const
 {
-    const ZipEntryMap::iterator iter = const_cast<ZipEntryMap*>(&_zipIndex)->find(filename);
+    ZipEntryMap::const_iterator iter = _zipIndex.find(filename);
     if (iter != _zipIndex.end())
     {
         idx = (*iter).second;
@@ -440,22 +454,19 @@ osgDB::DirectoryContents ZipArchive::getDirectoryContents(const std::string& dir
 {
     osgDB::DirectoryContents dirContents;
 
-    ZipEntryMap::const_iterator iter = _zipIndex.begin();
-    ZipEntryMap::const_iterator iterEnd = _zipIndex.end();
+    std::string searchPath = dirName;
+    CleanupFileString(searchPath);
 
-    for(; iter != iterEnd; ++iter)
+    for(const auto& name : _zipNames)
     {
-        std::string searchPath = dirName;
-        CleanupFileString(searchPath);
-
-        if(iter->first.size() > searchPath.size())
+        if(name.size() > searchPath.size())
         {
-            size_t endSubElement = iter->first.find(searchPath);
+            size_t endSubElement = name.find(searchPath);
 
             //we match the whole string in the beginning of the path
             if(endSubElement == 0)
             {
-                std::string remainingFile = iter->first.substr(searchPath.size() + 1, std::string::npos);
+                std::string remainingFile = name.substr(searchPath.size() + 1, std::string::npos);
                 size_t endFileToken = remainingFile.find_first_of('/');
 
                 if(endFileToken == std::string::npos)
@@ -507,49 +518,54 @@ std::string ZipArchive::ReadPassword(const osgDB::ReaderWriter::Options* options
     return password;
 }
 
-const ZipArchive::PerThreadData&
-ZipArchive::getData() const
+zip_t*
+ZipArchive::acquireHandle() const
 {
-    std::lock_guard<std::mutex> lock(_zipMutex);
-    return getDataNoLock();
-}
-
+    // reuse an idle handle if there is one:
+    {
+        std::lock_guard<std::mutex> lock(_handlesMutex);
+        if (!_idleHandles.empty())
+        {
+            zip_t* handle = _idleHandles.back();
+            _idleHandles.pop_back();
+            return handle;
+        }
+    }
 
-const ZipArchive::PerThreadData&
-ZipArchive::getDataNoLock() const
-{
-    // get/create data for the currently running thread:
-    auto current = std::this_thread::get_id();
+    // otherwise open another one, outside the lock:
+    if (_filename.empty())
+    {
+        return NULL;
+    }
 
-    PerThreadDataMap::const_iterator i = _perThreadData.find( current );
+    int errorCode;
+    zip_t* handle = zip_open(_filename.c_str(), ZIP_RDONLY, &errorCode);
+    if (!handle)
+    {
+        zip_error_t error;
+        zip_error_init_with_code(&error, errorCode);
+        OSG_WARN << "Failed to open zip " << _filename << ": " << zip_error_strerror(&error) << std::endl;
+        zip_error_fini(&error);
+    }
+    return handle;
+}
 
-    if ( i == _perThreadData.end() || i->second._zipHandle == NULL )
+void
+ZipArchive::releaseHandle(zip_t* handle) const
+{
+    if (handle == NULL)
     {
-        // cache pattern: cast to const for caching purposes
-        ZipArchive* ncThis = const_cast<ZipArchive*>(this);
+        return;
+    }
 
-        // data does not already exist, so open the ZIP with a handle exclusively for this thread:
-        PerThreadData& data = ncThis->_perThreadData[current];
-        if ( !_filename.empty() )
-        {
-            int errorCode;
-            data._zipHandle = zip_open(_filename.c_str(), ZIP_RDONLY, &errorCode);
-            if (!data._zipHandle)
-            {
-                zip_error_t error;
-                zip_error_init_with_code(&error, errorCode);
-                OSG_WARN << "Failed to open zip " << _filename << ": " << zip_error_strerror(&error) << std::endl;
-                zip_error_fini(&error);
-            }
-        }
-        else
-        {
-            data._zipHandle = NULL;
-        }
-        return data;
+    std::lock_guard<std::mutex> lock(_handlesMutex);
+    if (_zipLoaded)
+    {
+        _idleHandles.push_back(handle);
     }
     else
     {
-        return i->second;
+        // archive was closed while this handle was out
+        zip_close(handle);
     }
 }
@@ -5,8 +5,10 @@
 #include <osgDB/FileUtils>
 
 #include <osgDB/Archive>
+#include <atomic>
 #include <mutex>
-#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include <zip.h>
 
@@ -71,23 +73,24 @@ class ZipArchive : public osgDB::Archive
     private:
 
         typedef std::pair<std::string, zip_uint64_t > ZipEntryMapping;
-        typedef std::map<std::string, zip_uint64_t > ZipEntryMap;
+        typedef std::unordered_map<std::string, zip_uint64_t > ZipEntryMap;
 
         std::string _filename, _password, _membuffer;
 
         mutable std::mutex _zipMutex;
-        bool _zipLoaded;
+        std::atomic<bool> _zipLoaded;
         ZipEntryMap _zipIndex;
+        std::vector<std::string> _zipNames; // sorted, for listings
 
-        struct PerThreadData {
-            zip_t* _zipHandle;
-        };
+        // Read-only handles not currently in use. A read checks one out
+        // (opening a new one if none is idle) and returns it when done, so
+        // reads only share a lock for the push/pop and never during
+        // decompression.
+        mutable std::mutex _handlesMutex;
+        mutable std::vector<zip_t*> _idleHandles;
 
-        typedef std::map<std::thread::id, PerThreadData> PerThreadDataMap;
-        PerThreadDataMap _perThreadData;
-
-        const PerThreadData& getData() const;
-        const PerThreadData& getDataNoLock() const;
+        zip_t* acquireHandle() const;
+        void releaseHandle(zip_t* handle) const;
 };
 
 
@@ -3,6 +3,7 @@
 * MIT License
 */
 #include "VegetationLayer"
+#include "VegetationPlacement"
 #include "ProceduralShaders"
 
 #include <osgEarth/NoiseTextureFactory>
@@ -17,7 +18,6 @@
 #include <osgEarth/Metrics>
 #include <osgEarth/GLUtils>
 #include <osgEarth/Chonk>
-#include <osgEarth/rtree.h>
 #include <osgEarth/TerrainConstraintLayer>
 #include <osgEarth/AnnotationUtils>
 #include <osgEarth/Threading>
@@ -120,6 +120,7 @@ VegetationLayer::Options::getConfig() const
     conf.set("max_texture_size", maxTextureSize());
     conf.set("render_bin_number", renderBinNumber());
     conf.set("threads", threads());
+    conf.set("placement_cache_size", placementCacheSize());
 
     Config layers("layers");
     for (auto group_name : { GROUP_TREES, GROUP_BUSHES, GROUP_UNDERGROWTH })
@@ -179,6 +180,9 @@ namespace
         }
         return false;
     }
+
+    // don't go parallel unless each thread gets at least this many candidates
+    constexpr unsigned MIN_CANDIDATES_PER_THREAD = 256u;
 }
 
 void
@@ -197,6 +201,7 @@ VegetationLayer::Options::fromConfig(const Config& conf)
     conf.get("max_texture_size", maxTextureSize());
     conf.get("render_bin_number", renderBinNumber());
     conf.get("threads", threads());
+    conf.get("placement_cache_size", placementCacheSize());
 
     // some nice default group settings
     groups()[GROUP_TREES].lod().setDefault(14);
@@ -299,6 +304,7 @@ VegetationLayer::init()
     PatchLayer::init();
 
     _biomeRevision = 0;
+    _assetsRevision = 0;
     setAcceptCallback(new LayerAcceptor(this));
 
     // make a 4-channel noise texture to use
@@ -401,8 +407,12 @@ VegetationLayer::update(osg::NodeVisitor& nv)
 
         if (_newAssets.available())
         {
-            std::lock_guard<std::mutex> lock(_assets.mutex());
-            _assets = std::move(_newAssets.release());
+            {
+                std::lock_guard<std::mutex> lock(_assets.mutex());
+                _assets = std::move(_newAssets.release());
+                ++_assetsRevision;
+            }
+            clearPlacementCache();
         }
 
         // do we need to activate A2C?
@@ -419,6 +429,8 @@ VegetationLayer::dirty()
             _placeholders.clear();
         });
 
+    clearPlacementCache();
+
     _cameraState.scoped_lock([this]()
         {
             _cameraState.clear();
@@ -1164,8 +1176,11 @@ VegetationLayer::reset()
     _assets.scoped_lock([this]()
         {
             _assets.clear();
+            ++_assetsRevision;
         });
 
+    clearPlacementCache();
+
     _tiles.scoped_lock([this]()
         {
             _tiles.clear();
@@ -1244,6 +1259,26 @@ VegetationLayer::getAssetPlacements(
         return false;
     }
 
+    // Placement is deterministic for a tile, group, and data revision,
+    // so a revisited tile reuses its last result.
+    const bool useCache = options().placementCacheSize() > 0u;
+    int dataRevision = getPlacementDataRevision(map.get());
+    int assetsRevision = _assetsRevision;
+
+    if (useCache)
+    {
+        PlacementKey cacheKey{ { key, (int)hash_value_unsigned(dataRevision, assetsRevision) }, group };
+
+        std::lock_guard<std::mutex> lock(_placementCache.mutex());
+        auto iter = _placementCache._entries.find(cacheKey);
+        if (iter != _placementCache._entries.end())
+        {
+            _placementCache._lru.splice(_placementCache._lru.begin(), _placementCache._lru, iter->second.second);
+            output = *iter->second.first;
+            return true;
+        }
+    }
+
     std::vector<Placement> result;
 
     // Safely copy the instance list. The object is immutable
@@ -1265,6 +1300,7 @@ VegetationLayer::getAssetPlacements(
         else
         {
             groupAssets = iter->second; //shallow copy
+            assetsRevision = _assetsRevision;
         }
 
         // if it's empty, bail out (and probably return later)
@@ -1328,8 +1364,12 @@ VegetationLayer::getAssetPlacements(
             AssetsByGroup newAssets = _newAssets.release();
             if (!newAssets.empty())
             {
-                std::lock_guard<std::mutex> lock(_assets.mutex());
-                _assets = std::move(newAssets);
+                {
+                    std::lock_guard<std::mutex> lock(_assets.mutex());
+                    _assets = std::move(newAssets);
+                    ++_assetsRevision;
+                }
+                clearPlacementCache();
             }
         }
 
@@ -1345,6 +1385,7 @@ VegetationLayer::getAssetPlacements(
             else
             {
                 groupAssets = iter->second; // shallow copy
+                assetsRevision = _assetsRevision;
             }
         }
 
@@ -1358,13 +1399,9 @@ VegetationLayer::getAssetPlacements(
 
     const Biome* default_biome = groupAssets.begin()->second.biome;
 
-    osg::Vec4f noise;
     ImageUtils::PixelReader readNoise(_noiseTex->osgTexture()->getImage(0));
     readNoise.setSampleAsRepeatingTexture(true);
 
-    using Index = RTree<int, double, 2>;
-    Index index;
-
     std::default_random_engine gen(key.hash());
     Random prng(0);
 
@@ -1386,10 +1423,6 @@ VegetationLayer::getAssetPlacements(
 
     const GeoExtent& e = key.getExtent();
 
-    osg::Vec4f lifemap_value;
-    osg::Vec4f biomemap_value;
-    std::vector<double> hits;
-
     auto catalog = getBiomeLayer()->getBiomeCatalog();
 
     bool scaleWithDensity = (group == GROUP_UNDERGROWTH);
@@ -1406,15 +1439,6 @@ VegetationLayer::getAssetPlacements(
     double local_width = x1 - x0;
     double local_height = y1 - y0;
 
-    // keep track of biomes with no assets (for a possible error condition?)
-    std::set<const Biome*> empty_biomes;
-
-    // indicies of assets selected based on their lushness
-    std::vector<unsigned> assetIndices;
-
-    // cumulative density function based on asset weights
-    std::vector<float> assetCDF;
-
 
     //TEMP - DEBUGGING DETERMINISTIC BEHAVIOR.
     bool debug = false; // key.is(14, 17117, 4120);
@@ -1426,170 +1450,230 @@ VegetationLayer::getAssetPlacements(
     // normal distribution for lushness
     std::normal_distribution<float> normal_dist(0.0f, 1.0f / 6.0f);
 
-    // Generate random instances within the tile:
-    for (unsigned i = 0; i < max_instances; ++i)
+    // One candidate instance. Candidates are generated independently (in
+    // parallel), and then resolved against each other in order.
+    struct Candidate
     {
-        // perform all random number generations first to preserve determinism
-        // in the even of an early loop break.
+        float u, v;
+        float asset_index_rand;
+        float rotation_rand;
+        float lush_offset;
+
+        const Biome* biome = nullptr;
+        const ResidentModelAssetInstance* instance = nullptr; // null = rejected
+        osg::Vec3d scale;
+        float density = 1.0f;
+        osg::Vec2d local;
+        double a_min[2], a_max[2]; // collision box
+    };
 
-        // random tile-normalized position:
-        float u = RAND();
-        float v = RAND();
+    std::vector<Candidate> candidates(max_instances);
 
-        float asset_index_rand = RAND();
-        float rotation_rand = RAND();
-        float normal_rand = RAND();
-        float lush_offset = normal_dist(gen);
+    // perform all random number generations first, and in order, to preserve
+    // determinism no matter which candidates are rejected or how the work is split.
+    drawPlacementCandidates(candidates, prng, gen, normal_dist);
 
+    const ImageUtils::PixelReader& readBiomes = biomemap.getReader();
+    const ImageUtils::PixelReader& readLifeMap = lifemap.getReader();
 
-        // resolve the biome at this position:
-        const Biome* biome = nullptr;
-        if (biomemap.valid())
+    // Generate candidate instances within the tile:
+    Threading::parallelFor("Vegetation placement", max_instances, MIN_CANDIDATES_PER_THREAD, MIN_CANDIDATES_PER_THREAD,
+        [&](unsigned begin, unsigned end)
+    {
+        osg::Vec4f noise;
+        osg::Vec4f lifemap_value;
+        osg::Vec4f biomemap_value;
+
+        // indicies of assets selected based on their lushness
+        std::vector<unsigned> assetIndices;
+
+        // cumulative density function based on asset weights
+        std::vector<float> assetCDF;
+
+        for (unsigned i = begin; i < end; ++i)
         {
-            float uu = u * biomemap_sb(0, 0) + biomemap_sb(3, 0);
-            float vv = v * biomemap_sb(1, 1) + biomemap_sb(3, 1);
-            biomemap.getReader()(biomemap_value, uu, vv);
-            int index = (int)biomemap_value.r();
-            biome = catalog->getBiomeByIndex(index);
-            if (!biome)
+            Candidate& candidate = candidates[i];
+            float u = candidate.u;
+            float v = candidate.v;
+
+            // resolve the biome at this position:
+            const Biome* biome = nullptr;
+            if (biomemap.valid())
+            {
+                float uu = u * biomemap_sb(0, 0) + biomemap_sb(3, 0);
+                float vv = v * biomemap_sb(1, 1) + biomemap_sb(3, 1);
+                readBiomes(biomemap_value, uu, vv);
+                int index = (int)biomemap_value.r();
+                biome = catalog->getBiomeByIndex(index);
+                if (!biome)
+                {
+                    if (debug) OE_INFO << LC << "Instance " << i << " has invalid biome index " << index << std::endl;
+                    continue;
+                }
+            }
+
+            if (biome == nullptr)
+            {
+                // not sure this is even possible
+                biome = default_biome;
+            }
+
+            // fetch the collection of assets belonging to the selected biome:
+            auto iter = groupAssets.find(biome->id());
+            if (iter == groupAssets.end())
             {
-                if (debug) OE_INFO << LC << "Instance " << i << " has invalid biome index " << index << std::endl;
+                if (debug) OE_INFO << LC << "Instance " << i << " has no assets for biome " << biome->id() << std::endl;
                 continue;
             }
-        }
+            const ResidentBiomeModelAssetInstances& biome_assets = iter->second;
 
-        if (biome == nullptr)
-        {
-            // not sure this is even possible
-            biome = default_biome;
-        }
+            // sample the noise texture at this (u,v)
+            readNoise(noise, u, v);
 
-        // fetch the collection of assets belonging to the selected biome:
-        auto iter = groupAssets.find(biome->id());
-        if (iter == groupAssets.end())
-        {
-            empty_biomes.insert(biome);
-            if (debug) OE_INFO << LC << "Instance " << i << " has no assets for biome " << biome->id() << std::endl;
-            continue;
-        }
-        ResidentBiomeModelAssetInstances& biome_assets = iter->second;
+            // read the life map at this point:
+            float density = 1.0f;
+            float lush = 1.0f;
+            if (lifemap.valid())
+            {
+                float uu = u * lifemap_sb(0, 0) + lifemap_sb(3, 0);
+                float vv = v * lifemap_sb(1, 1) + lifemap_sb(3, 1);
+                readLifeMap(lifemap_value, uu, vv);
+                density = lifemap_value[LIFEMAP_DENSE];
+                lush = lifemap_value[LIFEMAP_LUSH];
+            }
 
-        // sample the noise texture at this (u,v)
-        readNoise(noise, u, v);
+            auto& assetInstances = biome_assets.instances;
 
-        // read the life map at this point:
-        float density = 1.0f;
-        float lush = 1.0f;
-        if (lifemap.valid())
-        {
-            float uu = u * lifemap_sb(0, 0) + lifemap_sb(3, 0);
-            float vv = v * lifemap_sb(1, 1) + lifemap_sb(3, 1);
-            lifemap.getReader()(lifemap_value, uu, vv);
-            density = lifemap_value[LIFEMAP_DENSE];
-            lush = lifemap_value[LIFEMAP_LUSH];
-        }
+            // RNG with normal distribution between approx lush-1..lush+1
+            lush = clamp(lush + candidate.lush_offset, 0.0f, 1.0f);
+
+            assetIndices.clear();
+            assetCDF.clear();
+            float cumulativeWeight = 0.0f;
+            for (unsigned i = 0; i < assetInstances.size(); ++i)
+            {
+                float min_lush = assetInstances[i].residentAsset()->assetDef()->minLush().get();
+                float max_lush = assetInstances[i].residentAsset()->assetDef()->maxLush().get();
+
+                if (lush >= min_lush && lush <= max_lush)
+                {
+                    assetIndices.push_back(i);
+                    cumulativeWeight += assetInstances[i].weight();
+                    assetCDF.push_back(cumulativeWeight);
+                }
+            }
+
+            // if there are no assets that match the lushness criteria, move on.
+            if (assetIndices.empty())
+            {
+                if (debug) OE_INFO << LC << "Instance " << i << " has no assets for lushness " << lush << std::endl;
+                continue;
+            }
 
-        auto& assetInstances = biome_assets.instances;
+            int assetIndex = 0;
+            if (assetIndices.size() > 1)
+            {
+                float k = candidate.asset_index_rand * cumulativeWeight;
+                for (assetIndex = 0;
+                    assetIndex < assetCDF.size() - 1 && k > assetCDF[assetIndex];
+                    ++assetIndex);
+            }
+            auto& instance = assetInstances[assetIndices[assetIndex]];
+            auto& asset = instance.residentAsset();
 
-        // RNG with normal distribution between approx lush-1..lush+1
-        // Note: moved this earlier in the loop to make it deterministic
-        //std::normal_distribution<float> normal_dist(lush, 1.0f / 6.0f);
-        lush = clamp(lush + lush_offset, 0.0f, 1.0f);
+            // if there's no geometry... bye
+            if (asset->chonk() == nullptr)
+            {
+                if (debug) OE_INFO << LC << "Instance " << i << " has no geometry" << std::endl;
+                continue;
+            }
 
-        assetIndices.clear();
-        assetCDF.clear();
-        float cumulativeWeight = 0.0f;
-        for (unsigned i = 0; i < assetInstances.size(); ++i)
-        {
-            float min_lush = assetInstances[i].residentAsset()->assetDef()->minLush().get();
-            float max_lush = assetInstances[i].residentAsset()->assetDef()->maxLush().get();
+            osg::Vec3d scale(1, 1, 1);
 
-            if (lush >= min_lush && lush <= max_lush)
+            // Apply a size variation with some randomness
+            if (asset->assetDef()->sizeVariation().isSet())
             {
-                assetIndices.push_back(i);
-                cumulativeWeight += assetInstances[i].weight();
-                assetCDF.push_back(cumulativeWeight);
+                scale *= 1.0 + (asset->assetDef()->sizeVariation().get() *
+                    (noise[N_CLUMPY] * 2.0f - 1.0f));
             }
-        }
 
-        // if there are no assets that match the lushness criteria, move on.
-        if (assetIndices.empty())
-        {
-            if (debug) OE_INFO << LC << "Instance " << i << " has no assets for lushness " << lush << std::endl;
-            continue;
-        }
+            // apply instance-specific density adjustment:
+            density *= instance.coverage();
 
-        int assetIndex = 0;
-        if (assetIndices.size() > 1)
-        {
-            float k = asset_index_rand * cumulativeWeight;
-            for (assetIndex = 0;
-                assetIndex < assetCDF.size() - 1 && k > assetCDF[assetIndex];
-                ++assetIndex);
-        }
-        auto& instance = assetInstances[assetIndices[assetIndex]];
-        auto& asset = instance.residentAsset();
+#if 0
+            // Removed, because this is causing the placement to go non-deterministic
+            // for some reason that I have not yet identified.
+            const float edge_threshold = 0.10f;
+            if (scaleWithDensity && density < edge_threshold)
+            {
+                float edginess = (density / edge_threshold);
+                scale *= edginess;
+            }
+#endif
 
-        // if there's no geometry... bye
-        if (asset->chonk() == nullptr)
-        {
-            if (debug) OE_INFO << LC << "Instance " << i << " has no geometry" << std::endl;
-            continue;
-        }
+            // tile-local coordinates of the position:
+            candidate.local.set(
+                local_bbox.xMin() + u * local_width,
+                local_bbox.yMin() + v * local_height);
 
-        osg::Vec3d scale(1, 1, 1);
+            if (overlap < 1.0f)
+            {
+                // scale the asset bounding box in preparation for collision:
+                const auto& aabb = asset->boundingBox();
+
+                double so = (1.0 - overlap);
+                candidate.a_min[0] = candidate.local.x() + aabb.xMin() * scale.x() * so;
+                candidate.a_min[1] = candidate.local.y() + aabb.yMin() * scale.y() * so;
+                candidate.a_max[0] = candidate.local.x() + aabb.xMax() * scale.x() * so;
+                candidate.a_max[1] = candidate.local.y() + aabb.yMax() * scale.y() * so;
+            }
 
-        // Apply a size variation with some randomness
-        if (asset->assetDef()->sizeVariation().isSet())
+            candidate.biome = biome;
+            candidate.instance = &instance;
+            candidate.scale = scale;
+            candidate.density = density;
+        }
+    });
+
+    // To prevent overlap, resolve collisions in candidate order (first come,
+    // first placed) so the result does not depend on the threading above.
+    // TODO: consider using a Blend2d raster to update the 
+    // density/lifemap raster as we place objects..?
+    double maxCollisionSize = 0.0;
+    if (overlap < 1.0f)
+    {
+        for (auto& candidate : candidates)
         {
-            scale *= 1.0 + (asset->assetDef()->sizeVariation().get() *
-                (noise[N_CLUMPY] * 2.0f - 1.0f));
+            if (candidate.instance)
+            {
+                maxCollisionSize = std::max(maxCollisionSize, std::abs(candidate.a_max[0] - candidate.a_min[0]));
+                maxCollisionSize = std::max(maxCollisionSize, std::abs(candidate.a_max[1] - candidate.a_min[1]));
+            }
         }
+    }
 
-        // apply instance-specific density adjustment:
-        density *= instance.coverage();
+    CollisionGrid collisions(
+        local_bbox.xMin(), local_bbox.yMin(), local_bbox.xMax(), local_bbox.yMax(),
+        maxCollisionSize);
 
-#if 0
-        // Removed, because this is causing the placement to go non-deterministic
-        // for some reason that I have not yet identified.
-        const float edge_threshold = 0.10f;
-        if (scaleWithDensity && density < edge_threshold)
-        {
-            float edginess = (density / edge_threshold);
-            scale *= edginess;
-        }
-#endif
+    for (unsigned i = 0; i < max_instances; ++i)
+    {
+        const Candidate& candidate = candidates[i];
 
-        // tile-local coordinates of the position:
-        osg::Vec2d local(
-            local_bbox.xMin() + u * local_width,
-            local_bbox.yMin() + v * local_height);
+        if (!candidate.instance)
+            continue;
 
         bool pass = true;
 
         if (overlap < 1.0f)
         {
-            // To prevent overlap, write positions and radii to an r-tree. 
-            // TODO: consider using a Blend2d raster to update the 
-            // density/lifemap raster as we place objects..?
-            pass = false;
-
-            // scale the asset bounding box in preparation for collision:
-            const auto& aabb = asset->boundingBox();
-
-            double so = (1.0 - overlap);
-            double a_min[2] = { local.x() + aabb.xMin() * scale.x() * so, local.y() + aabb.yMin() * scale.y() * so };
-            double a_max[2] = { local.x() + aabb.xMax() * scale.x() * so, local.y() + aabb.yMax() * scale.y() * so };
-            
-            if (index.Search(a_min, a_max) == 0)
-            {
-                index.Insert(a_min, a_max, 0);
-                pass = true;
-            }
+            pass = collisions.insertIfClear(candidate.a_min, candidate.a_max);
         }
 
         if (pass)
         {
+            float u = candidate.u;
+            float v = candidate.v;
             osg::Vec3d map_point(e.xMin() + u * e.width(), e.yMin() + v * e.height(), 0);
 
             if (!inConstrainedRegion(map_point.x(), map_point.y(), constraints))
@@ -1597,13 +1681,13 @@ VegetationLayer::getAssetPlacements(
                 map_points.emplace_back(map_point);
 
                 Placement p;
-                p.localPoint() = local;
+                p.localPoint() = candidate.local;
                 p.uv().set(u, v);
-                p.scale() = scale;
-                p.rotation() = rotation_rand * 3.1415927 * 2.0;
-                p.asset() = asset;
-                p.density() = density;
-                p.biome = biome;
+                p.scale() = candidate.scale;
+                p.rotation() = candidate.rotation_rand * 3.1415927 * 2.0;
+                p.asset() = candidate.instance->residentAsset();
+                p.density() = candidate.density;
+                p.biome = candidate.biome;
 
                 result.emplace_back(std::move(p));
             }
@@ -1658,21 +1742,62 @@ VegetationLayer::getAssetPlacements(
         result[i].mapPoint() = std::move(map_points[i]);
     }
 
-#if 0
-    // print warnings about empty biomes
-    if (!empty_biomes.empty())
+    // Remember the result, unless it may be incomplete:
+    bool complete =
+        !(progress && progress->isCanceled()) &&
+        (lifemap.valid() || !getLifeMapLayer()) &&
+        (biomemap.valid() || !getBiomeLayer());
+
+    if (useCache && complete)
     {
-        for (auto biome : empty_biomes)
+        PlacementKey cacheKey{ { key, (int)hash_value_unsigned(dataRevision, assetsRevision) }, group };
+        auto placements = std::make_shared<const std::vector<Placement>>(result);
+
+        std::lock_guard<std::mutex> lock(_placementCache.mutex());
+        auto iter = _placementCache._entries.find(cacheKey);
+
+        // skip it if the assets changed (and the cache was cleared) meanwhile
+        if (iter == _placementCache._entries.end() && assetsRevision == _assetsRevision)
         {
-            OE_WARN << LC << "No assets defined in group " << AssetGroup::name(group) << " for biome " << biome->id() << std::endl;
+            _placementCache._lru.push_front(cacheKey);
+            _placementCache._entries[cacheKey] = std::make_pair(placements, _placementCache._lru.begin());
+
+            while (_placementCache._lru.size() > options().placementCacheSize().get())
+            {
+                _placementCache._entries.erase(_placementCache._lru.back());
+                _placementCache._lru.pop_back();
+            }
         }
     }
-#endif
 
     output = std::move(result);
     return true;
 }
 
+void
+VegetationLayer::clearPlacementCache() const
+{
+    _placementCache.scoped_lock([this]()
+        {
+            _placementCache._lru.clear();
+            _placementCache._entries.clear();
+        });
+}
+
+int
+VegetationLayer::getPlacementDataRevision(const Map* map) const
+{
+    // Any layer can feed the placements (life map, biomes, elevation,
+    // constraints...) so fold in the revision of each one.
+    LayerVector layers;
+    std::size_t seed = hash_value_unsigned((int)map->getLayers(layers));
+    for (auto& layer : layers)
+    {
+        seed = hash_value_unsigned(seed, layer->getRevision());
+    }
+    return (int)seed;
+}
+
 
 std::string
 VegetationLayer::simulateAssetPlacement(const GeoPoint& point, const std::string& group) const
@@ -1785,8 +1910,12 @@ VegetationLayer::simulateAssetPlacement(const GeoPoint& point, const std::string
             AssetsByGroup newAssets = _newAssets.release();
             if (!newAssets.empty())
             {
-                std::lock_guard<std::mutex> lock(_assets.mutex());
-                _assets = std::move(newAssets);
+                {
+                    std::lock_guard<std::mutex> lock(_assets.mutex());
+                    _assets = std::move(newAssets);
+                    ++_assetsRevision;
+                }
+                clearPlacementCache();
             }
         }
 